@@ -0,0 +1,119 @@
+// Aggregation speed without GROUP BY and with GROUP BY over a growing
+// number of groups, aggregated by one worker and by one worker per core.
+#include <CLI/CLI.hpp>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <librdb/exec/Aggregation.hpp>
+#include <librdb/exec/Table.hpp>
+#include <librdb/sql/Parser.hpp>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using rdb::exec::Column;
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+rdb::sql::SelectStatementPtr parse_select(const std::string& sql) {
+  rdb::sql::Lexer lexer(sql);
+  rdb::sql::Parser parser(lexer);
+  rdb::sql::Parser::Result result = parser.parse_sql_script();
+  return rdb::sql::SelectStatementPtr(
+      static_cast<const rdb::sql::SelectStatement*>(
+          result.script_.statements_.at(0).release()));
+}
+
+// Seconds per run of the aggregation.
+double measure(
+    const rdb::exec::Table& table,
+    const std::string& sql,
+    const std::vector<size_t>& selection,
+    size_t workers,
+    int repeats) {
+  const auto statement = parse_select(sql);
+  const rdb::exec::Aggregation aggregation(table, *statement);
+  size_t groups = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (int repeat = 0; repeat < repeats; ++repeat) {
+    groups += aggregation.run(selection, workers).size();
+  }
+  const double seconds = seconds_since(start) / repeats;
+  if (groups == 0) {
+    std::cerr << sql << " returned no groups\n";
+  }
+  return seconds;
+}
+
+void print(const std::string& name, double one, double all) {
+  std::cout << std::left << std::setw(14) << name << std::right << std::fixed
+            << std::setprecision(1) << std::setw(12) << one * 1e3 << " ms"
+            << std::setw(12) << all * 1e3 << " ms\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  CLI::App app("Aggregation speed across group counts");
+  size_t rows = 10'000'000;
+  int repeats = 3;
+  app.add_option("-r,--rows", rows, "Rows in the table");
+  app.add_option("-n,--repeats", repeats, "Runs per measurement")
+      ->check(CLI::PositiveNumber);
+  CLI11_PARSE(app, argc, argv);
+
+  const size_t cores = std::max(1U, std::thread::hardware_concurrency());
+  std::vector<size_t> cardinalities;
+  for (size_t groups = 10; groups <= std::min<size_t>(rows, 10'000'000);
+       groups *= 10) {
+    cardinalities.push_back(groups);
+  }
+
+  std::vector<Column> columns;
+  columns.emplace_back("Value", Column::Kind::Int);
+  columns.emplace_back("Price", Column::Kind::Real);
+  for (const size_t groups : cardinalities) {
+    columns.emplace_back("G" + std::to_string(groups), Column::Kind::Int);
+  }
+  std::mt19937 random(1);
+  std::uniform_int_distribution<int> values(-1000, 1000);
+  for (size_t row = 0; row < rows; ++row) {
+    const int value = values(random);
+    columns[0].push_back(value);
+    columns[1].push_back(static_cast<float>(value) / 8);
+    for (size_t i = 0; i < cardinalities.size(); ++i) {
+      columns[i + 2].push_back(static_cast<int>(random() % cardinalities[i]));
+    }
+  }
+  const rdb::exec::Table table("T", std::move(columns));
+  std::vector<size_t> selection(rows);
+  std::iota(selection.begin(), selection.end(), size_t{0});
+
+  std::cout << rows << " rows, " << cores << " cores\n"
+            << std::left << std::setw(14) << "groups" << std::right
+            << std::setw(15) << "1 worker" << std::setw(15)
+            << std::to_string(cores) + " workers" << '\n';
+  const std::string ungrouped =
+      "SELECT COUNT(*) SUM(Value) MIN(Value) MAX(Price) AVG(Price) FROM T;";
+  print(
+      "none", measure(table, ungrouped, selection, 1, repeats),
+      measure(table, ungrouped, selection, cores, repeats));
+  for (const size_t groups : cardinalities) {
+    const std::string key = "G" + std::to_string(groups);
+    const std::string grouped = "SELECT " + key +
+                                " COUNT(*) SUM(Value) MAX(Price) FROM T "
+                                "GROUP BY " +
+                                key + ";";
+    print(
+        std::to_string(groups), measure(table, grouped, selection, 1, repeats),
+        measure(table, grouped, selection, cores, repeats));
+  }
+  return 0;
+}
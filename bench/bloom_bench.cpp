@@ -0,0 +1,122 @@
+// Point lookups on a TEXT column of random UUIDs: `Key = "..."`, which
+// skips the blocks whose bloom filter rules the key out, next to the same
+// lookup as `Key >= "..." AND Key <= "..."`, which compares every row.
+#include <CLI/CLI.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <librdb/exec/Executor.hpp>
+#include <librdb/sql/Parser.hpp>
+#include <librdb/sync/Epoch.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using rdb::exec::Column;
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+std::string random_uuid(std::mt19937_64& random) {
+  const uint64_t high = random();
+  const uint64_t low = random();
+  char text[37];
+  std::snprintf(
+      text, sizeof(text), "%08x-%04x-%04x-%04x-%012llx",
+      static_cast<unsigned>(high >> 32),
+      static_cast<unsigned>(high >> 16 & 0xFFFF),
+      static_cast<unsigned>(high & 0xFFFF), static_cast<unsigned>(low >> 48),
+      static_cast<unsigned long long>(low & 0xFFFFFFFFFFFFULL));
+  return text;
+}
+
+// Runs every statement of `sql` and returns the rows of the last one.
+std::vector<std::vector<rdb::exec::Cell>> run(
+    rdb::exec::Executor& executor,
+    const std::string& sql) {
+  rdb::sql::Lexer lexer(sql);
+  rdb::sql::Parser parser(lexer);
+  const rdb::sql::Parser::Result parsed = parser.parse_sql_script();
+  std::vector<std::vector<rdb::exec::Cell>> rows;
+  for (const auto& statement : parsed.script_.statements_) {
+    rows = executor.execute(*statement).rows_;
+  }
+  return rows;
+}
+
+// Milliseconds per lookup of every key with the condition `make(key)`.
+double measure(
+    rdb::exec::Executor& executor,
+    const std::vector<std::string>& keys,
+    std::string (*make)(const std::string&)) {
+  const auto start = std::chrono::steady_clock::now();
+  size_t found = 0;
+  for (const auto& key : keys) {
+    found += run(executor, "SELECT Id FROM T WHERE " + make(key) + ";").size();
+  }
+  const double seconds = seconds_since(start);
+  if (found != keys.size() / 2) {
+    std::cerr << "Found " << found << " of " << keys.size() / 2 << " keys\n";
+  }
+  return seconds * 1e3 / static_cast<double>(keys.size());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  CLI::App app("TEXT point lookups with per-block bloom filters");
+  size_t rows = 1'000'000;
+  size_t lookups = 100;
+  app.add_option("-r,--rows", rows, "Rows in the table");
+  app.add_option("-l,--lookups", lookups, "Lookups, half of them misses");
+  CLI11_PARSE(app, argc, argv);
+
+  rdb::exec::Catalog catalog;
+  rdb::exec::Executor executor(catalog);
+  run(executor, "CREATE TABLE T (Id INT, Key TEXT);");
+  const rdb::sync::EpochGuard guard;
+  rdb::exec::Table* table = catalog.find("T");
+  std::mt19937_64 random(42);
+  // Half of the keys are spread over the table, the other half missing.
+  std::vector<std::string> keys;
+  const size_t stride =
+      std::max<size_t>(1, rows / std::max<size_t>(1, lookups / 2));
+  for (size_t row = 0; row < rows; ++row) {
+    std::string key = random_uuid(random);
+    if (row % stride == 0 && keys.size() < lookups / 2) {
+      keys.push_back(key);
+    }
+    table->append_row({static_cast<int>(row), std::move(key)});
+  }
+  while (keys.size() < lookups) {
+    keys.push_back(random_uuid(random));
+  }
+
+  const double equal = measure(executor, keys, [](const std::string& key) {
+    return "Key = \"" + key + "\"";
+  });
+  const double range = measure(executor, keys, [](const std::string& key) {
+    return "Key >= \"" + key + "\" AND Key <= \"" + key + "\"";
+  });
+  std::cout << std::fixed << std::setprecision(3)
+            << "Key = ...            " << std::setw(10) << equal
+            << " ms/lookup\n"
+            << "Key >= ... <= ...    " << std::setw(10) << range
+            << " ms/lookup\n";
+  for (const auto& key : {keys.front(), keys.back()}) {
+    for (const auto& row : run(
+             executor,
+             "EXPLAIN ANALYZE SELECT Id FROM T WHERE Key = \"" + key + "\";")) {
+      const std::string line = rdb::exec::cell_to_str(row[0]);
+      if (line.find("Bloom Filter") != std::string::npos) {
+        std::cout << line.substr(line.find_first_not_of(' ')) << "\n";
+      }
+    }
+  }
+}
@@ -0,0 +1,117 @@
+// Table lookups per second from 1 up to N threads while another thread
+// keeps creating and dropping a table: the lock-free Catalog next to a
+// std::unordered_map behind a mutex.
+#include <CLI/CLI.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <librdb/exec/Catalog.hpp>
+#include <librdb/sync/Epoch.hpp>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+using rdb::exec::Column;
+using rdb::exec::Table;
+using rdb::exec::TablePtr;
+
+TablePtr make_table(const std::string& name) {
+  std::vector<Column> columns;
+  columns.emplace_back("Id", Column::Kind::Int);
+  return std::make_shared<Table>(name, std::move(columns));
+}
+
+class LockedCatalog {
+ public:
+  TablePtr find(const std::string& name) const {
+    const std::lock_guard lock(mutex_);
+    const auto it = tables_.find(name);
+    return it == tables_.end() ? nullptr : it->second;
+  }
+
+  void create(TablePtr table) {
+    const std::lock_guard lock(mutex_);
+    tables_.emplace(table->name(), std::move(table));
+  }
+
+  void drop(const std::string& name) {
+    const std::lock_guard lock(mutex_);
+    tables_.erase(name);
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, TablePtr> tables_;
+};
+
+// Lookups per second of `threads` readers over `seconds`.
+template <typename Catalog>
+double measure(Catalog& catalog, unsigned threads, double seconds) {
+  std::atomic<bool> stop{false};
+  std::atomic<size_t> lookups{0};
+  std::vector<std::thread> readers;
+  const std::vector<std::string> names = {"Users", "Orders", "Items"};
+  for (unsigned thread = 0; thread < threads; ++thread) {
+    readers.emplace_back([&] {
+      size_t count = 0;
+      while (!stop.load(std::memory_order_relaxed)) {
+        const rdb::sync::EpochGuard guard;
+        for (const auto& name : names) {
+          count += catalog.find(name) != nullptr ? 1 : 0;
+        }
+      }
+      lookups += count;
+    });
+  }
+  std::thread writer([&] {
+    while (!stop.load(std::memory_order_relaxed)) {
+      catalog.create(make_table("Scratch"));
+      catalog.drop("Scratch");
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+  std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+  stop = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  writer.join();
+  return static_cast<double>(lookups) / seconds;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  CLI::App app("Catalog lookups per second per reader thread count");
+  unsigned max_threads = std::max(1U, std::thread::hardware_concurrency());
+  double seconds = 1;
+  app.add_option("-t,--threads", max_threads, "Most reader threads")
+      ->check(CLI::PositiveNumber);
+  app.add_option("-s,--seconds", seconds, "Duration of each measurement")
+      ->check(CLI::PositiveNumber);
+  CLI11_PARSE(app, argc, argv);
+
+  rdb::exec::Catalog catalog;
+  LockedCatalog locked_catalog;
+  for (const char* name : {"Users", "Orders", "Items"}) {
+    catalog.create(make_table(name));
+    locked_catalog.create(make_table(name));
+  }
+
+  std::cout << std::setw(8) << "threads" << std::setw(16) << "lock-free M/s"
+            << std::setw(16) << "mutex M/s" << '\n';
+  for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+    const double lock_free = measure(catalog, threads, seconds);
+    const double locked = measure(locked_catalog, threads, seconds);
+    std::cout << std::setw(8) << threads << std::setw(16) << std::fixed
+              << std::setprecision(2) << lock_free / 1e6 << std::setw(16)
+              << locked / 1e6 << '\n';
+  }
+}
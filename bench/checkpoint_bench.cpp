@@ -0,0 +1,94 @@
+// Compares startup from a checkpoint with replaying the statement log that
+// built the same tables.
+#include <CLI/CLI.hpp>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <librdb/storage/Checkpoint.hpp>
+#include <string>
+#include <vector>
+
+namespace {
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+// Selects rows with a positive Id, which reads the whole Id column.
+size_t scan(rdb::exec::Executor& executor) {
+  const rdb::sql::SelectStatement select(
+      {"Id"},
+      "T",
+      rdb::sql::Expression(
+          rdb::sql::Operand(rdb::sql::Operand::Kind::Id, "Id"),
+          rdb::sql::Expression::Operation::Greater,
+          rdb::sql::Operand(rdb::sql::Operand::Kind::Int, 0)));
+  return executor.execute(select).rows_.size();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  CLI::App app("Startup time from a checkpoint versus a log replay");
+  size_t rows = 2'000'000;
+  std::string directory = "/tmp/rdb_checkpoint_bench";
+  app.add_option("-r,--rows", rows, "Rows in the table");
+  app.add_option("-d,--dir", directory, "Scratch directory");
+  CLI11_PARSE(app, argc, argv);
+
+  std::filesystem::remove_all(directory);
+  rdb::exec::Catalog catalog;
+  const uint64_t generation = rdb::storage::load_checkpoint(catalog, directory);
+  const std::string log_path = rdb::storage::log_path(directory, generation);
+  {
+    rdb::storage::StatementLog log(log_path, false);
+    rdb::exec::Executor executor(catalog, nullptr, &log);
+    const std::vector<rdb::sql::ColumnDef> columns = {
+        {"Id", rdb::sql::ColumnDef::Kind::Int},
+        {"Price", rdb::sql::ColumnDef::Kind::Real},
+        {"Name", rdb::sql::ColumnDef::Kind::Text}};
+    executor.execute(rdb::sql::CreateTableStatement("T", columns));
+    const std::vector<std::string_view> names = {"Id", "Price", "Name"};
+    for (size_t row = 0; row < rows; ++row) {
+      executor.execute(rdb::sql::InsertStatement(
+          "T",
+          names,
+          {static_cast<int>(row), static_cast<float>(row) / 4,
+           std::string_view("\"customer name\"")}));
+    }
+  }
+  std::cout << "rows: " << rows << ", log: "
+            << std::filesystem::file_size(log_path) / (1 << 20) << " MiB\n";
+
+  auto start = std::chrono::steady_clock::now();
+  {
+    rdb::exec::Catalog replayed;
+    rdb::exec::Executor executor(replayed);
+    start = std::chrono::steady_clock::now();
+    rdb::storage::StatementLog::replay(log_path, executor);
+    std::cout << "log replay startup: " << seconds_since(start) << " s\n";
+    start = std::chrono::steady_clock::now();
+    const size_t selected = scan(executor);
+    std::cout << "  first scan: " << seconds_since(start) << " s, " << selected
+              << " rows\n";
+  }
+  // Writing the checkpoint removes the log it supersedes.
+  start = std::chrono::steady_clock::now();
+  rdb::storage::write_checkpoint(catalog, directory);
+  std::cout << "checkpoint write: " << seconds_since(start) << " s\n";
+
+  {
+    rdb::exec::Catalog loaded;
+    rdb::exec::Executor executor(loaded);
+    start = std::chrono::steady_clock::now();
+    rdb::storage::load_checkpoint(loaded, directory);
+    std::cout << "checkpoint startup: " << seconds_since(start) << " s\n";
+    start = std::chrono::steady_clock::now();
+    const size_t selected = scan(executor);
+    std::cout << "  first scan: " << seconds_since(start) << " s, " << selected
+              << " rows\n";
+  }
+  std::filesystem::remove_all(directory);
+  return 0;
+}
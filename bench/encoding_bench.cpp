@@ -0,0 +1,105 @@
+// Compression ratio and filter speed of encoded INT columns compared with
+// filtering the same values as a plain array.
+#include <CLI/CLI.hpp>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <librdb/exec/Table.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Operation = rdb::sql::Expression::Operation;
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+struct Dataset {
+  std::string name_;
+  std::function<int(size_t)> value_;
+};
+
+void run(const Dataset& dataset, size_t rows, int repeats) {
+  rdb::exec::Column column("Value", rdb::exec::Column::Kind::Int);
+  std::vector<int> plain;
+  plain.reserve(rows);
+  for (size_t row = 0; row < rows; ++row) {
+    const int value = dataset.value_(row);
+    column.push_back(value);
+    plain.push_back(value);
+  }
+  // A constant in the middle of the values keeps about half of the rows.
+  std::vector<int> sorted = plain;
+  std::nth_element(sorted.begin(), sorted.begin() + rows / 2, sorted.end());
+  const int constant = sorted[rows / 2];
+
+  std::vector<size_t> selection;
+  selection.reserve(rows);
+  auto start = std::chrono::steady_clock::now();
+  for (int repeat = 0; repeat < repeats; ++repeat) {
+    selection.clear();
+    for (size_t row = 0; row < rows; ++row) {
+      if (plain[row] < constant) {
+        selection.push_back(row);
+      }
+    }
+  }
+  const double plain_seconds = seconds_since(start) / repeats;
+  const size_t expected = selection.size();
+
+  start = std::chrono::steady_clock::now();
+  for (int repeat = 0; repeat < repeats; ++repeat) {
+    selection.clear();
+    for (size_t block = 0; block < column.block_count(); ++block) {
+      column.filter_block(block, Operation::Less, constant, selection);
+    }
+  }
+  const double encoded_seconds = seconds_since(start) / repeats;
+  if (selection.size() != expected) {
+    std::cerr << dataset.name_ << ": encoded filter returned "
+              << selection.size() << " rows instead of " << expected << '\n';
+  }
+
+  const double ratio =
+      static_cast<double>(rows * sizeof(int)) / column.byte_size();
+  std::cout << std::left << std::setw(12) << dataset.name_ << std::right
+            << std::fixed << std::setprecision(1) << std::setw(8) << ratio
+            << "x" << std::setprecision(2) << std::setw(12)
+            << plain_seconds * 1e3 << " ms" << std::setw(12)
+            << encoded_seconds * 1e3 << " ms\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  CLI::App app("Compression and filter speed of encoded INT columns");
+  size_t rows = 4'000'000;
+  int repeats = 5;
+  app.add_option("-r,--rows", rows, "Rows in the column");
+  app.add_option("-n,--repeats", repeats, "Scans per measurement")
+      ->check(CLI::PositiveNumber);
+  CLI11_PARSE(app, argc, argv);
+
+  std::mt19937 random(1);
+  std::uniform_int_distribution<int> small(0, 100);
+  std::uniform_int_distribution<int> any;
+  const std::vector<Dataset> datasets = {
+      {"sorted", [](size_t row) { return static_cast<int>(row) * 3; }},
+      {"small", [&](size_t /*row*/) { return 1'000'000 + small(random); }},
+      {"runs", [](size_t row) { return static_cast<int>(row / 1000 % 7); }},
+      {"random", [&](size_t /*row*/) { return any(random); }}};
+
+  std::cout << std::left << std::setw(12) << "data" << std::right
+            << std::setw(9) << "ratio" << std::setw(15) << "plain scan"
+            << std::setw(15) << "encoded scan" << '\n';
+  for (const auto& dataset : datasets) {
+    run(dataset, rows, repeats);
+  }
+  return 0;
+}
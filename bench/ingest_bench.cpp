@@ -0,0 +1,75 @@
+// INSERT throughput into 1 up to N tables: one executor applying the
+// statements in order next to a WriteDispatcher with a worker per table.
+#include <CLI/CLI.hpp>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <librdb/exec/Executor.hpp>
+#include <librdb/exec/WriteDispatcher.hpp>
+#include <librdb/sql/Parser.hpp>
+#include <sstream>
+#include <string>
+
+namespace {
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+// CREATEs `tables` tables, then spreads `rows` INSERTs over them.
+std::string make_script(size_t tables, size_t rows) {
+  std::stringstream sql;
+  for (size_t table = 0; table < tables; ++table) {
+    sql << "CREATE TABLE T" << table << " (Id INT, Price REAL, Name TEXT);";
+  }
+  for (size_t row = 0; row < rows; ++row) {
+    sql << "INSERT INTO T" << row % tables << " (Id, Price, Name) VALUES ("
+        << row << ", " << row % 1000 << ".5, \"customer " << row % 100
+        << "\");";
+  }
+  return sql.str();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  CLI::App app("INSERT throughput with and without per-table writers");
+  size_t rows = 200'000;
+  size_t max_tables = 8;
+  size_t queue_capacity = 1024;
+  app.add_option("-r,--rows", rows, "Rows to insert");
+  app.add_option("-t,--tables", max_tables, "Most tables to write");
+  app.add_option("-q,--queue", queue_capacity, "Statements per worker queue");
+  CLI11_PARSE(app, argc, argv);
+
+  std::cout << std::setw(8) << "tables" << std::setw(16) << "serial"
+            << std::setw(16) << "dispatched" << "  (rows/s)\n";
+  for (size_t tables = 1; tables <= max_tables; tables *= 2) {
+    const std::string script = make_script(tables, rows);
+    rdb::sql::Lexer lexer(script);
+    rdb::sql::Parser parser(lexer);
+    const rdb::sql::Parser::Result parsed = parser.parse_sql_script();
+
+    rdb::exec::Catalog serial_catalog;
+    rdb::exec::Executor executor(serial_catalog);
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& statement : parsed.script_.statements_) {
+      executor.execute(*statement);
+    }
+    const double serial_seconds = seconds_since(start);
+
+    rdb::exec::Catalog catalog;
+    rdb::exec::WriteDispatcher dispatcher(catalog, tables, queue_capacity);
+    start = std::chrono::steady_clock::now();
+    for (const auto& statement : parsed.script_.statements_) {
+      dispatcher.dispatch(*statement);
+    }
+    dispatcher.wait();
+    const double dispatched_seconds = seconds_since(start);
+
+    std::cout << std::setw(8) << tables << std::fixed << std::setprecision(0)
+              << std::setw(16) << rows / serial_seconds << std::setw(16)
+              << rows / dispatched_seconds << "\n";
+  }
+}
@@ -0,0 +1,88 @@
+// Hash join speed for build sides from cache-resident to many times the
+// cache size, probed by a larger table where one row in ten has a match.
+#include <CLI/CLI.hpp>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <librdb/exec/HashJoin.hpp>
+#include <librdb/exec/Table.hpp>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using rdb::exec::Column;
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+std::vector<size_t> all_rows(size_t rows) {
+  std::vector<size_t> selection(rows);
+  std::iota(selection.begin(), selection.end(), size_t{0});
+  return selection;
+}
+
+void run(size_t build_rows, size_t probe_rows, size_t cores, int repeats) {
+  std::mt19937 random(1);
+  Column build("Id", Column::Kind::Int);
+  std::vector<int> ids(build_rows);
+  std::iota(ids.begin(), ids.end(), 0);
+  std::shuffle(ids.begin(), ids.end(), random);
+  for (const int id : ids) {
+    build.push_back(id);
+  }
+  Column probe("BuildId", Column::Kind::Int);
+  std::uniform_int_distribution<int> keys(0, static_cast<int>(build_rows) * 10);
+  for (size_t row = 0; row < probe_rows; ++row) {
+    probe.push_back(keys(random));
+  }
+  const std::vector<size_t> build_selection = all_rows(build_rows);
+  const std::vector<size_t> probe_selection = all_rows(probe_rows);
+  const rdb::exec::HashJoin join(build, probe);
+
+  std::cout << std::setw(10) << build_rows << std::setw(12) << std::fixed
+            << std::setprecision(1)
+            << static_cast<double>(build_rows * 20) / (1 << 20) << " MiB";
+  size_t matches = 0;
+  for (const size_t workers : {size_t{1}, cores}) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int repeat = 0; repeat < repeats; ++repeat) {
+      matches = join.run(build_selection, probe_selection, workers).size();
+    }
+    const double seconds = seconds_since(start) / repeats;
+    std::cout << std::setw(12) << seconds * 1e3 << " ms" << std::setw(10)
+              << probe_rows / seconds / 1e6 << " M/s";
+  }
+  std::cout << std::setw(10) << matches << '\n';
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  CLI::App app("Hash join speed across build side sizes");
+  size_t probe_rows = 10'000'000;
+  size_t max_build_rows = 10'000'000;
+  int repeats = 3;
+  app.add_option("-p,--probe-rows", probe_rows, "Rows of the probe side");
+  app.add_option("-b,--max-build-rows", max_build_rows, "Largest build side");
+  app.add_option("-n,--repeats", repeats, "Joins per measurement")
+      ->check(CLI::PositiveNumber);
+  CLI11_PARSE(app, argc, argv);
+
+  const size_t cores = std::max(1U, std::thread::hardware_concurrency());
+  std::cout << probe_rows << " probe rows, " << cores << " cores\n"
+            << std::setw(10) << "build rows" << std::setw(16) << "table size"
+            << std::setw(25) << "1 worker" << std::setw(25)
+            << std::to_string(cores) + " workers" << std::setw(10)
+            << "matches" << '\n';
+  for (size_t build_rows = 1'000; build_rows <= max_build_rows;
+       build_rows *= 10) {
+    run(build_rows, probe_rows, cores, repeats);
+  }
+  return 0;
+}
@@ -0,0 +1,107 @@
+// A long generated script run after parsing all of it, and run while it is
+// parsed on another thread: time until the first statement starts, total
+// time and the parser's peak memory.
+#include <CLI/CLI.hpp>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <librdb/exec/Executor.hpp>
+#include <librdb/memory/MemoryTracker.hpp>
+#include <librdb/sql/Parser.hpp>
+#include <librdb/sql/PipelinedParser.hpp>
+#include <librdb/workload/Generator.hpp>
+#include <optional>
+#include <sstream>
+#include <string>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double ms_between(Clock::time_point start, Clock::time_point end) {
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void report(
+    const char* label,
+    double first_ms,
+    double total_ms,
+    const rdb::memory::MemoryTracker& parser_memory) {
+  std::cout << std::left << std::setw(12) << label << std::right << std::fixed
+            << std::setprecision(1) << "first statement " << std::setw(9)
+            << first_ms << " ms   total " << std::setw(9) << total_ms
+            << " ms   parser peak " << std::setw(9)
+            << static_cast<double>(parser_memory.peak()) / 1024 << " KiB\n";
+}
+
+void execute(rdb::exec::Executor& executor, const rdb::sql::Statement& s) {
+  try {
+    executor.execute(s);
+  } catch (const rdb::exec::ExecutionError&) {
+    // Generated DELETEs may divide by zero.
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  CLI::App app("Pipelined parsing and execution of a long script");
+  size_t statements = 200'000;
+  size_t queue_capacity = 64;
+  app.add_option("-n,--statements", statements, "Statements in the script");
+  app.add_option("-q,--queue", queue_capacity, "Parsed statements in flight");
+  CLI11_PARSE(app, argc, argv);
+
+  rdb::workload::GeneratorOptions options;
+  options.mix_.select_ = 5;
+  options.mix_.explain_ = 0;
+  std::stringstream script;
+  rdb::workload::Generator(options).write(script, statements, 0);
+  const std::string sql = script.str();
+  std::cout << "Script of " << statements << " statements, "
+            << sql.size() / 1024 << " KiB\n";
+
+  {
+    rdb::exec::Catalog catalog;
+    rdb::exec::Executor executor(catalog);
+    rdb::memory::MemoryTracker parser_memory(
+        "parser", &rdb::memory::MemoryTracker::process());
+    const auto start = Clock::now();
+    std::optional<rdb::sql::Parser::Result> parsed;
+    {
+      const rdb::memory::MemoryScope scope(parser_memory);
+      rdb::sql::Lexer lexer(sql);
+      parsed = rdb::sql::Parser(lexer).parse_sql_script();
+    }
+    const auto first = Clock::now();
+    for (const auto& statement : parsed->script_.statements_) {
+      execute(executor, *statement);
+    }
+    report("whole", ms_between(start, first), ms_between(start, Clock::now()),
+           parser_memory);
+  }
+
+  {
+    rdb::exec::Catalog catalog;
+    rdb::exec::Executor executor(catalog);
+    rdb::memory::MemoryTracker parser_memory(
+        "parser", &rdb::memory::MemoryTracker::process());
+    const auto start = Clock::now();
+    std::optional<rdb::sql::PipelinedParser> parser;
+    {
+      const rdb::memory::MemoryScope scope(parser_memory);
+      parser.emplace(sql, queue_capacity);
+    }
+    std::optional<Clock::time_point> first;
+    while (const auto result = parser->next()) {
+      if (!first) {
+        first = Clock::now();
+      }
+      for (const auto& statement : result->script_.statements_) {
+        execute(executor, *statement);
+      }
+    }
+    report("pipelined", ms_between(start, *first),
+           ms_between(start, Clock::now()), parser_memory);
+  }
+}
@@ -0,0 +1,103 @@
+// INSERTs and point SELECTs built by string concatenation and parsed every
+// time, next to the same statements prepared once and executed with bound
+// values.
+#include <CLI/CLI.hpp>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <librdb/exec/Executor.hpp>
+#include <librdb/sql/Parser.hpp>
+#include <string>
+
+namespace {
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+// Rows of the result of the single statement in `sql`.
+size_t run(rdb::exec::Executor& executor, const std::string& sql) {
+  rdb::sql::Lexer lexer(sql);
+  rdb::sql::Parser parser(lexer);
+  const rdb::sql::Parser::Result parsed = parser.parse_sql_script();
+  size_t rows = 0;
+  for (const auto& statement : parsed.script_.statements_) {
+    rows += executor.execute(*statement).rows_.size();
+  }
+  return rows;
+}
+
+std::string name_of(size_t row) {
+  return "customer-" + std::to_string(row);
+}
+
+void report(const char* label, size_t statements, double seconds) {
+  std::cout << std::left << std::setw(24) << label << std::right
+            << std::setw(12) << std::fixed << std::setprecision(0)
+            << static_cast<double>(statements) / seconds << " statements/s\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  CLI::App app("Prepared statements against parsing every statement");
+  size_t rows = 100'000;
+  size_t lookups = 20'000;
+  app.add_option("-r,--rows", rows, "Rows inserted each way");
+  app.add_option("-l,--lookups", lookups, "Point SELECTs each way");
+  CLI11_PARSE(app, argc, argv);
+
+  rdb::exec::Catalog catalog;
+  rdb::exec::Executor executor(catalog);
+  run(executor, "CREATE TABLE A (Id INT, Price REAL, Name TEXT);");
+  run(executor, "CREATE TABLE B (Id INT, Price REAL, Name TEXT);");
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t row = 0; row < rows; ++row) {
+    run(executor,
+        "INSERT INTO A (Id, Price, Name) VALUES (" + std::to_string(row) +
+            ", " + std::to_string(static_cast<float>(row) / 4) + ", \"" +
+            name_of(row) + "\");");
+  }
+  report("INSERT parsed", rows, seconds_since(start));
+
+  start = std::chrono::steady_clock::now();
+  rdb::exec::PreparedStatement insert =
+      executor.prepare("INSERT INTO B (Id, Price, Name) VALUES (?, ?, ?);");
+  for (size_t row = 0; row < rows; ++row) {
+    insert.bind(0, static_cast<int>(row));
+    insert.bind(1, static_cast<float>(row) / 4);
+    insert.bind(2, name_of(row));
+    executor.execute(insert);
+  }
+  report("INSERT prepared", rows, seconds_since(start));
+
+  // Lookups on a small table, where parsing is a large part of the work.
+  run(executor, "CREATE TABLE C (Id INT, Name TEXT);");
+  for (size_t row = 0; row < 100; ++row) {
+    run(executor,
+        "INSERT INTO C (Id, Name) VALUES (" + std::to_string(row) + ", \"" +
+            name_of(row) + "\");");
+  }
+  size_t found = 0;
+  start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < lookups; ++i) {
+    found += run(
+        executor,
+        "SELECT Id Name FROM C WHERE Id = " + std::to_string(i % 100) + ";");
+  }
+  report("SELECT parsed", lookups, seconds_since(start));
+
+  start = std::chrono::steady_clock::now();
+  rdb::exec::PreparedStatement select =
+      executor.prepare("SELECT Id Name FROM C WHERE Id = ?;");
+  for (size_t i = 0; i < lookups; ++i) {
+    select.bind(0, static_cast<int>(i % 100));
+    found += executor.execute(select).rows_.size();
+  }
+  report("SELECT prepared", lookups, seconds_since(start));
+  if (found != 2 * lookups) {
+    std::cerr << "Found " << found << " of " << 2 * lookups << " rows\n";
+  }
+}
@@ -0,0 +1,99 @@
+// Statement text throughput of the stream-based to_str() next to
+// print_statement() into one reused buffer, with the heap allocations each
+// of them makes per statement.
+#include <CLI/CLI.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <librdb/sql/Parser.hpp>
+#include <librdb/sql/StatementPrinter.hpp>
+#include <librdb/workload/Generator.hpp>
+#include <new>
+#include <sstream>
+#include <string>
+
+namespace {
+
+size_t allocations = 0;
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+// Runs `print` on every statement and prints statements per second and
+// allocations per statement.
+template <typename Print>
+void measure(
+    const std::string& name,
+    const rdb::sql::Script& script,
+    Print print) {
+  size_t bytes = 0;
+  const size_t allocations_before = allocations;
+  const auto start = std::chrono::steady_clock::now();
+  for (const auto& statement : script.statements_) {
+    bytes += print(*statement);
+  }
+  const double seconds = seconds_since(start);
+  const size_t count = script.statements_.size();
+  std::cout << std::setw(16) << name << std::setw(12) << std::fixed
+            << std::setprecision(0) << count / seconds << " statements/s"
+            << std::setw(8) << std::setprecision(2)
+            << static_cast<double>(allocations - allocations_before) / count
+            << " allocations/statement" << std::setw(12) << bytes
+            << " bytes\n";
+}
+
+}  // namespace
+
+// Counts every allocation. GCC warns about free() on memory from operator
+// new once these are inlined, though they are the replacements.
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+void* operator new(size_t size) {
+  ++allocations;
+  if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t /*size*/) noexcept {
+  std::free(pointer);
+}
+
+int main(int argc, char** argv) {
+  CLI::App app("Statement printing with to_str() and print_statement()");
+  size_t statements = 100'000;
+  app.add_option("-s,--statements", statements, "Statements to print");
+  CLI11_PARSE(app, argc, argv);
+
+  rdb::workload::GeneratorOptions options;
+  options.mix_.explain_ = 5;
+  options.mix_.transaction_ = 5;
+  rdb::workload::Generator generator(options);
+  std::stringstream sql;
+  generator.write(sql, statements, 0);
+  const std::string text = sql.str();
+  rdb::sql::Lexer lexer(text);
+  rdb::sql::Parser parser(lexer);
+  const rdb::sql::Parser::Result result = parser.parse_sql_script();
+
+  measure("to_str", result.script_, [](const rdb::sql::Statement& statement) {
+    return statement.to_str().size();
+  });
+  std::string out;
+  measure(
+      "print_statement",
+      result.script_,
+      [&out](const rdb::sql::Statement& statement) {
+        out.clear();
+        rdb::sql::print_statement(statement, out);
+        return out.size();
+      });
+}
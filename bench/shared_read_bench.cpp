@@ -0,0 +1,159 @@
+// SELECT throughput of 1 to N reader processes that share one published
+// copy of a table, and the private memory each reader needs on top of it.
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <CLI/CLI.hpp>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <librdb/exec/Executor.hpp>
+#include <librdb/sql/Parser.hpp>
+#include <librdb/storage/SharedCatalog.hpp>
+#include <librdb/sync/Epoch.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+void run(rdb::exec::Executor& executor, const std::string& sql) {
+  rdb::sql::Lexer lexer(sql);
+  rdb::sql::Parser parser(lexer);
+  const rdb::sql::Parser::Result parsed = parser.parse_sql_script();
+  for (const auto& statement : parsed.script_.statements_) {
+    executor.execute(*statement);
+  }
+}
+
+// Anonymous memory of the process in KiB, which doesn't count the shared
+// region but does count pages still shared with the parent after fork().
+size_t private_kib() {
+  std::ifstream status("/proc/self/status");
+  std::string key;
+  size_t value = 0;
+  while (status >> key) {
+    if (key == "RssAnon:" && status >> value) {
+      return value;
+    }
+    status.ignore(256, '\n');
+  }
+  return 0;
+}
+
+struct ReaderReport {
+  size_t queries_;
+  double seconds_;
+  size_t private_kib_;
+};
+
+// Attaches to the catalog and runs the query for `seconds`.
+ReaderReport read(
+    const std::string& name,
+    const std::string& sql,
+    double seconds) {
+  const size_t inherited_kib = private_kib();
+  rdb::storage::SharedCatalogReader reader(name);
+  rdb::sql::Lexer lexer(sql);
+  rdb::sql::Parser parser(lexer);
+  const rdb::sql::Parser::Result parsed = parser.parse_sql_script();
+  const auto& select = static_cast<const rdb::sql::SelectStatement&>(
+      *parsed.script_.statements_.front());
+  size_t queries = 0;
+  const auto start = std::chrono::steady_clock::now();
+  while (seconds_since(start) < seconds) {
+    reader.execute(select);
+    ++queries;
+  }
+  return {queries, seconds_since(start), private_kib() - inherited_kib};
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  CLI::App app("Reader processes sharing a published catalog");
+  size_t rows = 1'000'000;
+  unsigned max_readers = 4;
+  double seconds = 2;
+  app.add_option("-r,--rows", rows, "Rows in the table");
+  app.add_option("-p,--processes", max_readers, "Most reader processes");
+  app.add_option("-s,--seconds", seconds, "Seconds each reader runs");
+  CLI11_PARSE(app, argc, argv);
+
+  rdb::exec::Catalog catalog;
+  rdb::exec::Executor executor(catalog);
+  run(executor, "CREATE TABLE T (Id INT, Price REAL, Name TEXT);");
+  const rdb::sync::EpochGuard guard;
+  rdb::exec::Table* table = catalog.find("T");
+  std::mt19937_64 random(42);
+  for (size_t row = 0; row < rows; ++row) {
+    std::string name(12, 'a');
+    for (char& c : name) {
+      c = static_cast<char>('a' + random() % 26);
+    }
+    table->append_row(
+        {static_cast<int>(row), static_cast<float>(random() % 1'000),
+         std::move(name)});
+  }
+  const std::string name = "/rdb_shared_read_bench_" + std::to_string(getpid());
+  rdb::storage::SharedCatalogWriter writer(name, rows * 64);
+  writer.publish(catalog);
+
+  const std::string sql = "SELECT COUNT(*) SUM(Price) FROM T WHERE Id < " +
+      std::to_string(rows / 2) + " AND Price > 100;";
+  std::cout << sql << "\n" << std::fixed << std::setprecision(1);
+  {
+    // The writer's own tables, for comparison.
+    size_t queries = 0;
+    const auto start = std::chrono::steady_clock::now();
+    while (seconds_since(start) < seconds) {
+      run(executor, sql);
+      ++queries;
+    }
+    std::cout << "in writer  " << std::setw(10)
+              << static_cast<double>(queries) / seconds_since(start)
+              << " queries/s\n";
+  }
+  for (unsigned readers = 1; readers <= max_readers; ++readers) {
+    std::vector<std::pair<pid_t, int>> children;
+    for (unsigned i = 0; i < readers; ++i) {
+      int fds[2];
+      if (::pipe(fds) != 0) {
+        return 1;
+      }
+      const pid_t child = ::fork();
+      if (child == 0) {
+        ::close(fds[0]);
+        const ReaderReport report = read(name, sql, seconds);
+        const bool written = ::write(fds[1], &report, sizeof(report)) ==
+            static_cast<ssize_t>(sizeof(report));
+        ::_exit(written ? 0 : 1);
+      }
+      ::close(fds[1]);
+      children.emplace_back(child, fds[0]);
+    }
+    double queries_per_second = 0;
+    size_t private_kib = 0;
+    for (const auto& [child, fd] : children) {
+      ReaderReport report{};
+      if (::read(fd, &report, sizeof(report)) == sizeof(report)) {
+        queries_per_second +=
+            static_cast<double>(report.queries_) / report.seconds_;
+        private_kib = std::max(private_kib, report.private_kib_);
+      }
+      ::close(fd);
+      ::waitpid(child, nullptr, 0);
+    }
+    std::cout << std::setw(2) << readers << " readers " << std::setw(10)
+              << queries_per_second << " queries/s " << std::setw(10)
+              << queries_per_second / readers << " per reader "
+              << std::setw(10) << static_cast<double>(private_kib) / 1024
+              << " MiB private\n";
+  }
+}
@@ -0,0 +1,88 @@
+// ORDER BY speed of the three strategies on one INT column: a top-k heap
+// for a small LIMIT, an in-memory radix sort, and a sort that spills runs
+// to temporary files, next to std::stable_sort of the same positions.
+#include <CLI/CLI.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <librdb/exec/Sort.hpp>
+#include <librdb/exec/Table.hpp>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using rdb::exec::Column;
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+template <typename Sort>
+void measure(const std::string& name, size_t rows, int repeats, Sort sort) {
+  const auto start = std::chrono::steady_clock::now();
+  size_t size = 0;
+  for (int repeat = 0; repeat < repeats; ++repeat) {
+    size = sort().size();
+  }
+  const double seconds = seconds_since(start) / repeats;
+  std::cout << std::setw(24) << name << std::setw(12) << std::fixed
+            << std::setprecision(1) << seconds * 1e3 << " ms" << std::setw(10)
+            << rows / seconds / 1e6 << " M/s" << std::setw(12) << size << '\n';
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  CLI::App app("ORDER BY speed per sort strategy");
+  size_t rows = 10'000'000;
+  size_t limit = 10;
+  size_t budget_mib = 64;
+  int repeats = 3;
+  app.add_option("-r,--rows", rows, "Rows to sort");
+  app.add_option("-l,--limit", limit, "LIMIT of the top-k sort");
+  app.add_option("-m,--budget-mib", budget_mib, "Budget of the spilling sort");
+  app.add_option("-n,--repeats", repeats, "Sorts per measurement")
+      ->check(CLI::PositiveNumber);
+  CLI11_PARSE(app, argc, argv);
+
+  std::mt19937 random(1);
+  std::uniform_int_distribution<int> values;
+  Column column("Time", Column::Kind::Int);
+  std::vector<int> plain(rows);
+  for (size_t row = 0; row < rows; ++row) {
+    plain[row] = values(random);
+    column.push_back(plain[row]);
+  }
+  std::vector<size_t> selection(rows);
+  std::iota(selection.begin(), selection.end(), size_t{0});
+  const size_t workers = std::max(1U, std::thread::hardware_concurrency());
+
+  std::cout << rows << " rows, " << workers << " workers\n";
+  measure("LIMIT " + std::to_string(limit), rows, repeats, [&] {
+    return rdb::exec::Sort(column, true, limit).run(selection, workers);
+  });
+  measure("in memory", rows, repeats, [&] {
+    const size_t budget = rows * 64;
+    return rdb::exec::Sort(column, true, std::nullopt, budget)
+        .run(selection, workers);
+  });
+  measure(
+      "spilled, " + std::to_string(budget_mib) + " MiB", rows, repeats, [&] {
+        return rdb::exec::Sort(column, true, std::nullopt, budget_mib << 20)
+            .run(selection, workers);
+      });
+  measure("std::stable_sort", rows, repeats, [&] {
+    std::vector<size_t> positions = selection;
+    std::stable_sort(
+        positions.begin(), positions.end(),
+        [&](size_t a, size_t b) { return plain[a] > plain[b]; });
+    return positions;
+  });
+}
@@ -0,0 +1,78 @@
+// INSERT throughput into a synced statement log with autocommit, where
+// every statement is flushed on its own, next to explicit transactions of
+// growing size, which are flushed once at COMMIT.
+#include <CLI/CLI.hpp>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <librdb/storage/StatementLog.hpp>
+#include <string>
+#include <vector>
+
+namespace {
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+// Inserts `rows` rows in transactions of `batch` statements, or with
+// autocommit for a batch of 0, and prints the rows per second.
+void measure(
+    const std::string& directory,
+    size_t rows,
+    size_t batch,
+    bool sync) {
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+  rdb::exec::Catalog catalog;
+  rdb::storage::StatementLog log(directory + "/log", sync);
+  rdb::exec::Executor executor(catalog, nullptr, &log);
+  const std::vector<rdb::sql::ColumnDef> columns = {
+      {"Id", rdb::sql::ColumnDef::Kind::Int},
+      {"Name", rdb::sql::ColumnDef::Kind::Text}};
+  executor.execute(rdb::sql::CreateTableStatement("T", columns));
+  const std::vector<std::string_view> names = {"Id", "Name"};
+  const rdb::sql::TransactionStatement begin(rdb::sql::Statement::Kind::Begin);
+  const rdb::sql::TransactionStatement commit(
+      rdb::sql::Statement::Kind::Commit);
+
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t row = 0; row < rows; ++row) {
+    if (batch != 0 && row % batch == 0) {
+      executor.execute(begin);
+    }
+    executor.execute(rdb::sql::InsertStatement(
+        "T",
+        names,
+        {static_cast<int>(row), std::string_view("\"customer name\"")}));
+    if (batch != 0 && (row % batch == batch - 1 || row == rows - 1)) {
+      executor.execute(commit);
+    }
+  }
+  const double seconds = seconds_since(start);
+  const std::string name =
+      batch == 0 ? "autocommit" : std::to_string(batch) + " per COMMIT";
+  std::cout << std::setw(18) << name << std::setw(12) << std::fixed
+            << std::setprecision(0) << rows / seconds << " rows/s"
+            << std::setw(10) << log.flush_count() << " flushes\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  CLI::App app("INSERT throughput with autocommit and with transactions");
+  size_t rows = 20'000;
+  bool no_sync = false;
+  std::string directory = "/tmp/rdb_transaction_bench";
+  app.add_option("-r,--rows", rows, "Rows to insert");
+  app.add_flag("--no-sync", no_sync, "Don't wait for the log to reach disk");
+  app.add_option("-d,--dir", directory, "Scratch directory");
+  CLI11_PARSE(app, argc, argv);
+
+  for (const size_t batch : {0, 10, 100, 1000}) {
+    measure(directory, rows, batch, !no_sync);
+  }
+  std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <librdb/exec/Table.hpp>
+#include <librdb/sql/Statements.hpp>
+#include <optional>
+#include <vector>
+
+namespace rdb::exec {
+
+// The GROUP BY and aggregates of a SELECT compiled for one table.
+//
+// Each worker thread aggregates a contiguous run of blocks into its own
+// hash table of groups, and the partial results are merged once all
+// workers are done. Without GROUP BY there is a single group, and the
+// aggregates of a block are reduced in loops with independent
+// accumulators that the compiler turns into vector instructions.
+class Aggregation {
+ public:
+  // Throws ExecutionError for unknown columns, columns that are neither
+  // aggregated nor grouped by, and SUM or AVG of TEXT.
+  Aggregation(const Table& table, const sql::SelectStatement& statement);
+
+  // Columns the aggregation reads, in ascending order.
+  const std::vector<size_t>& columns() const { return columns_; }
+
+  // One row per group of the selected rows, which must be in ascending
+  // order, ordered by the group key. Without GROUP BY it is always one
+  // row, with COUNT 0 and default values for an empty selection. Throws
+  // ExecutionError if an INT SUM doesn't fit into INT.
+  std::vector<std::vector<Cell>> run(
+      const std::vector<size_t>& selection,
+      size_t workers) const;
+
+ private:
+  using Aggregate = sql::SelectStatement::Aggregate;
+
+  // Which per-group vector of a partial result holds the aggregate.
+  enum class State : uint8_t { None, Int, Real, Text };
+
+  struct Item {
+    Aggregate aggregate_;
+    // Aggregated column, std::nullopt for COUNT(*).
+    std::optional<size_t> column_;
+    State state_ = State::None;
+    // Position of a grouped column in the group key.
+    size_t key_ = 0;
+    std::string name_;
+  };
+
+  class Partial;
+
+  const Table& table_;
+  std::vector<Item> items_;
+  std::vector<size_t> group_columns_;
+  std::vector<size_t> columns_;
+};
+
+}  // namespace rdb::exec
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+namespace rdb::exec {
+
+// Blocked bloom filter with about 16 bits per key. Each key sets three
+// bits of a single 64-bit word, so a lookup reads one cache line. Keys are
+// 64-bit hashes; the filter takes the word from the highest bits and the
+// bits within it from the lowest 18.
+class BloomFilter {
+ public:
+  // Sized for `keys` distinct keys.
+  explicit BloomFilter(size_t keys)
+      : shift_(64 - std::max(1U, log2_ceil(keys / 4))),
+        words_(size_t{1} << (64 - shift_), 0) {}
+
+  void add(uint64_t hash) { words_[hash >> shift_] |= bits(hash); }
+
+  bool may_contain(uint64_t hash) const {
+    const uint64_t key_bits = bits(hash);
+    return (words_[hash >> shift_] & key_bits) == key_bits;
+  }
+
+  size_t byte_size() const { return words_.size() * sizeof(uint64_t); }
+
+ private:
+  static unsigned log2_ceil(size_t value) {
+    unsigned bits = 0;
+    while ((size_t{1} << bits) < value) {
+      ++bits;
+    }
+    return bits;
+  }
+
+  static uint64_t bits(uint64_t hash) {
+    return uint64_t{1} << (hash & 63) | uint64_t{1} << (hash >> 6 & 63) |
+           uint64_t{1} << (hash >> 12 & 63);
+  }
+
+  unsigned shift_;
+  std::vector<uint64_t> words_;
+};
+
+// The finalizer of MurmurHash3: a bijection that mixes every bit of the
+// key into every bit of the hash.
+inline uint64_t mix_hash(uint64_t key) {
+  key ^= key >> 33;
+  key *= 0xFF51AFD7ED558CCDULL;
+  key ^= key >> 33;
+  key *= 0xC4CEB9FE1A85EC53ULL;
+  key ^= key >> 33;
+  return key;
+}
+
+// The hash of a TEXT value, for joins and the block filters of TEXT
+// columns.
+inline uint64_t text_hash(std::string_view text) {
+  return std::hash<std::string_view>()(text);
+}
+
+}  // namespace rdb::exec
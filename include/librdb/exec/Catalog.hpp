@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <librdb/exec/Table.hpp>
+#include <librdb/sync/Epoch.hpp>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace rdb::exec {
+
+// The tables by name. Lookups read an immutable snapshot without taking a
+// lock; CREATE and DROP serialize on a mutex, publish a modified copy of
+// the snapshot, and retire the old one until no lookup can still read it.
+// DROP retires the dropped table the same way, so the tables that lookups
+// return stay valid for as long as the caller is pinned.
+class Catalog {
+ public:
+  Catalog();
+  ~Catalog();
+
+  Catalog(const Catalog&) = delete;
+  Catalog& operator=(const Catalog&) = delete;
+
+  // Returns nullptr if there is no such table. The caller holds an
+  // EpochGuard, taken before the call, for as long as it uses the table;
+  // the lookup itself doesn't touch the table's reference count.
+  Table* find(std::string_view table_name) const;
+
+  // Returns false if a table with the same name already exists.
+  bool create(TablePtr table);
+
+  // Returns false if there is no such table.
+  bool drop(std::string_view table_name);
+
+  // Every table, ordered by name.
+  std::vector<TablePtr> tables() const;
+
+  // Frees the retired snapshots and dropped tables that no pinned thread
+  // can still use. CREATE and DROP do so themselves; the executor calls it
+  // after every statement, so that memory doesn't wait for the next CREATE
+  // or DROP. Returns at once if a CREATE or DROP is running.
+  void reclaim();
+
+  // Incremented by every CREATE and DROP.
+  uint64_t version() const { return version_.load(); }
+
+ private:
+  // Ordered by name.
+  using Snapshot = std::vector<TablePtr>;
+
+  // Replaces the snapshot and retires `dropped`, if any; the caller holds
+  // the write mutex.
+  void publish(
+      std::unique_ptr<const Snapshot> snapshot,
+      TablePtr dropped = nullptr);
+
+  std::atomic<const Snapshot*> snapshot_;
+  std::atomic<uint64_t> version_{0};
+  std::mutex write_mutex_;
+  sync::RetireList<Snapshot> retired_;
+  // The catalog's references to dropped tables.
+  sync::RetireList<TablePtr> retired_tables_;
+};
+
+}  // namespace rdb::exec
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <librdb/sql/Statements.hpp>
+#include <string_view>
+#include <vector>
+
+namespace rdb::exec {
+
+// Calls `function` with the comparison for `operation` as a function object,
+// so the loops it runs are compiled once per comparison without a switch.
+template <typename Function>
+void with_comparison(
+    sql::Expression::Operation operation,
+    Function&& function) {
+  switch (operation) {
+    case sql::Expression::Operation::Less:
+      function(std::less<>());
+      break;
+    case sql::Expression::Operation::Greater:
+      function(std::greater<>());
+      break;
+    case sql::Expression::Operation::LessEq:
+      function(std::less_equal<>());
+      break;
+    case sql::Expression::Operation::GreaterEq:
+      function(std::greater_equal<>());
+      break;
+    case sql::Expression::Operation::Equal:
+      function(std::equal_to<>());
+      break;
+    case sql::Expression::Operation::NotEqual:
+      function(std::not_equal_to<>());
+      break;
+  }
+}
+
+// The comparison with its operands swapped: `a < b` is `b > a`.
+inline sql::Expression::Operation flip(sql::Expression::Operation operation) {
+  switch (operation) {
+    case sql::Expression::Operation::Less:
+      return sql::Expression::Operation::Greater;
+    case sql::Expression::Operation::Greater:
+      return sql::Expression::Operation::Less;
+    case sql::Expression::Operation::LessEq:
+      return sql::Expression::Operation::GreaterEq;
+    case sql::Expression::Operation::GreaterEq:
+      return sql::Expression::Operation::LessEq;
+    default:
+      return operation;
+  }
+}
+
+enum class Encoding : uint8_t { Plain, FrameOfReference, Delta, RunLength };
+
+std::string_view encoding_to_str(Encoding encoding);
+
+// Maps INT and REAL values to unsigned keys with the same order, so blocks
+// of both kinds are encoded and filtered the same way. -0.0 and 0.0 get
+// different keys although they compare equal.
+inline uint32_t to_key(int value) {
+  return static_cast<uint32_t>(value) ^ 0x80000000U;
+}
+
+inline uint32_t to_key(float value) {
+  uint32_t bits = 0;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return (bits & 0x80000000U) != 0 ? ~bits : bits | 0x80000000U;
+}
+
+template <typename T>
+T from_key(uint32_t key);
+
+template <>
+inline int from_key<int>(uint32_t key) {
+  return static_cast<int>(key ^ 0x80000000U);
+}
+
+template <>
+inline float from_key<float>(uint32_t key) {
+  const uint32_t bits = (key & 0x80000000U) != 0 ? key & 0x7FFFFFFFU : ~key;
+  float value = 0;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+// An immutable run of keys in whichever encoding is smallest:
+// - Plain: the keys as they are;
+// - FrameOfReference: bit-packed differences from the smallest key;
+// - Delta: the first key and bit-packed differences between neighbours,
+//   small for sorted data;
+// - RunLength: one key per run of equal keys.
+class EncodedBlock {
+ public:
+  static EncodedBlock encode(const uint32_t* keys, size_t count);
+
+  Encoding encoding() const { return encoding_; }
+  size_t size() const { return count_; }
+  // Bytes of encoded data.
+  size_t byte_size() const;
+  uint32_t min_key() const { return min_; }
+  uint32_t max_key() const { return max_; }
+
+  void decode(uint32_t* out) const;
+  // Random access; linear in `index` for Delta blocks.
+  uint32_t at(size_t index) const;
+
+  // Appends `first_row + i` to the selection for every key i for which
+  // `key operation constant` holds. Works on the encoded data: whole blocks
+  // are decided from the key range, runs are tested once and packed
+  // differences are compared without decoding the keys.
+  void filter(
+      sql::Expression::Operation operation,
+      uint32_t constant,
+      size_t first_row,
+      std::vector<size_t>& selection) const;
+
+ private:
+  void filter_codes(
+      sql::Expression::Operation operation,
+      uint32_t constant,
+      size_t first_row,
+      std::vector<size_t>& selection) const;
+  void filter_deltas(
+      sql::Expression::Operation operation,
+      uint32_t constant,
+      size_t first_row,
+      std::vector<size_t>& selection) const;
+
+  Encoding encoding_ = Encoding::Plain;
+  uint32_t count_ = 0;
+  uint32_t min_ = 0;
+  uint32_t max_ = 0;
+  // FrameOfReference: the smallest key. Delta: the smallest difference.
+  int64_t reference_ = 0;
+  uint8_t bit_width_ = 0;
+  // FrameOfReference and Delta codes, `bit_width_` bits each.
+  std::vector<uint64_t> packed_;
+  // Plain: every key. Delta: the first key. RunLength: one key per run.
+  std::vector<uint32_t> keys_;
+  // RunLength: index one past the end of each run.
+  std::vector<uint16_t> run_ends_;
+};
+
+}  // namespace rdb::exec
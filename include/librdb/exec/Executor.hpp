@@ -0,0 +1,162 @@
+#pragma once
+
+#include <librdb/exec/Catalog.hpp>
+#include <librdb/exec/Table.hpp>
+#include <librdb/memory/MemoryTracker.hpp>
+#include <librdb/sql/Statements.hpp>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rdb::exec {
+
+class ExecutionError : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+struct Result {
+  std::vector<std::string> column_names_;
+  std::vector<std::vector<Cell>> rows_;
+  size_t affected_rows_ = 0;
+  // Most memory the statement had charged at any time while it ran.
+  size_t peak_memory_bytes_ = 0;
+};
+
+class ResultCache;
+
+// Returns true for statements that change the catalog or table rows. For
+// EXPLAIN that is the explained statement when it is analyzed, which runs
+// it.
+bool is_write(const sql::Statement& statement);
+
+// The table that an INSERT or DELETE writes, empty for other statements.
+std::string_view written_table(const sql::Statement& statement);
+
+// The writes of a session between BEGIN and COMMIT. They are checked
+// against the catalog as the transaction sees it and buffered, then COMMIT
+// applies them together with a single log flush, and ROLLBACK discards
+// them. Reads inside a transaction see the last committed state.
+struct Transaction {
+  bool active() const { return catalog_ != nullptr; }
+
+  // The tables as of BEGIN with the transaction's CREATEs and DROPs
+  // applied; the rows are shared with the catalog and never written.
+  std::unique_ptr<Catalog> catalog_;
+  // Catalog::version() at BEGIN. If it changed, COMMIT checks the writes
+  // against the tables again.
+  uint64_t catalog_version_ = 0;
+  // Copies of the write statements, pointing into `text_`.
+  std::vector<sql::StatementPtr> statements_;
+  std::deque<std::string> text_;
+};
+
+// A statement parsed once and executed any number of times with values
+// bound to its `?` placeholders, without lexing or parsing it again. Made
+// by Executor::prepare(). Its memory is charged to the tracker that was
+// current then, as a Reservation, so it may outlive that tracker.
+class PreparedStatement {
+ public:
+  const sql::Statement& statement() const { return *statement_; }
+  size_t placeholder_count() const { return values_.size(); }
+
+  // Binds a value to placeholder `index`, counted from 0 in the order of
+  // the statement's text. Throws ExecutionError if there is no such
+  // placeholder or the value doesn't fit the column it stands for; INT
+  // values fit REAL columns.
+  void bind(size_t index, int value);
+  void bind(size_t index, float value);
+  // `text` is the value itself, without quotes.
+  void bind(size_t index, std::string_view text);
+  void clear_bindings();
+
+ private:
+  friend class Executor;
+
+  PreparedStatement() = default;
+
+  void check_kind(size_t index, Column::Kind kind) const;
+
+  // The statement points into the text, which stays in place when the
+  // prepared statement is moved.
+  std::unique_ptr<const std::string> sql_;
+  sql::StatementPtr statement_;
+  memory::Reservation memory_;
+  // The kind of the column each placeholder stands for, if it was known
+  // when the statement was prepared.
+  std::vector<std::optional<Column::Kind>> kinds_;
+  std::vector<std::optional<sql::Value>> values_;
+  // The bound TEXT values in quotes, as the parser leaves them.
+  std::vector<std::string> texts_;
+};
+
+// Durable record of the write statements an executor applies.
+class WriteLog {
+ public:
+  virtual ~WriteLog() = default;
+  virtual void append(const sql::Statement& statement) = 0;
+  // Makes the appended statements durable.
+  virtual void flush() = 0;
+};
+
+class Executor {
+ public:
+  // SELECT results are served from and stored into `cache` if it is given.
+  // Write statements are applied first and then appended to `log` and
+  // flushed one by one; those of a transaction are flushed together when
+  // it commits. If the log throws, the exception leaves the write applied
+  // but not durable, and the caller must stop serving the catalog.
+  explicit Executor(
+      Catalog& catalog,
+      ResultCache* cache = nullptr,
+      WriteLog* log = nullptr)
+      : catalog_(catalog), cache_(cache), log_(log) {}
+
+  // Every statement charges its memory to a tracker of its own, a child
+  // of the thread's current tracker, with this limit.
+  void set_statement_memory_limit(std::optional<size_t> bytes) {
+    statement_memory_limit_ = bytes;
+  }
+
+  // Throws ExecutionError if the statement can't be applied to the catalog
+  // or needs more memory than its limit or an enclosing one allows.
+  // Transaction statements apply to the executor's own transaction.
+  Result execute(const sql::Statement& statement) {
+    return execute(statement, transaction_);
+  }
+  // Executes the statement as part of a session's `transaction`.
+  Result execute(const sql::Statement& statement, Transaction& transaction);
+
+  // Parses `sql`, a single statement that may have `?` placeholders, and
+  // resolves the columns they stand for. Throws ExecutionError if it
+  // doesn't parse.
+  PreparedStatement prepare(std::string sql) const;
+  // Executes a prepared statement with the values bound to it. Throws
+  // ExecutionError if a placeholder isn't bound.
+  Result execute(const PreparedStatement& statement) {
+    return execute(statement, transaction_);
+  }
+  Result execute(const PreparedStatement& statement, Transaction& transaction);
+
+ private:
+  Result execute_cached(const sql::Statement& statement);
+  Result execute_in_transaction(
+      const sql::Statement& statement,
+      Transaction& transaction);
+  // Applies the buffered writes and logs them as one unit. Throws
+  // ExecutionError, applying nothing, if one of them no longer fits the
+  // catalog.
+  Result commit(Transaction& transaction);
+
+  Catalog& catalog_;
+  ResultCache* cache_;
+  WriteLog* log_;
+  std::optional<size_t> statement_memory_limit_;
+  Transaction transaction_;
+};
+
+}  // namespace rdb::exec
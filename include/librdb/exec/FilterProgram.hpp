@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstdint>
+#include <librdb/exec/Profile.hpp>
+#include <librdb/exec/Table.hpp>
+#include <librdb/sql/Statements.hpp>
+#include <string>
+#include <vector>
+
+namespace rdb::exec {
+
+// A WHERE condition compiled for one table into bytecode that runs a block
+// of kBlockRows rows at a time. Every instruction processes the rows of a
+// selection vector: arithmetic and comparisons loop over the selected rows
+// and conditions narrow selections, so AND evaluates its second operand
+// only for the rows that passed the first, OR only for those that failed
+// it, and a division by zero is an error only in a row that gets that far.
+//
+// `column op constant` on an INT or REAL column runs on the encoded block
+// while the block's selection is still complete. `column = "text"` on a
+// TEXT column first asks the block's bloom filter, and skips the block if
+// the filter rules the text out.
+class FilterProgram {
+ public:
+  // Throws ExecutionError for unknown columns and mismatched types.
+  FilterProgram(const Table& table, const sql::Expression& expression);
+
+  // Columns the program reads, in ascending order.
+  const std::vector<size_t>& columns() const { return columns_; }
+  size_t instruction_count() const { return instructions_.size(); }
+
+  // Appends the matching rows in ascending order. Throws ExecutionError on
+  // an integer division by zero. Adds the bloom filter counters to `stats`
+  // if it is given.
+  void run(std::vector<size_t>& selection, OperatorStats* stats = nullptr)
+      const;
+
+ private:
+  enum class Type : uint8_t { Int, Real, Text };
+
+  enum class OpCode : uint8_t {
+    // value[output] = column `column_` at the selected rows.
+    LoadColumn,
+    // value[output] = value[first] converted from INT to REAL.
+    IntToReal,
+    // value[output] = value[first] `arithmetic_` value[second].
+    Arithmetic,
+    // selection[output] = rows of selection[input] where
+    // value[first] `comparison_` value[second].
+    Compare,
+    // selection[output] = rows of selection[input] where
+    // column `column_` `comparison_` the constant.
+    FilterColumn,
+    // selection[output] = selection[input] if the bloom filter of column
+    // `column_`'s block may hold the text hashing to `text_hash_`, else
+    // nothing. selection[second] is the result of the comparison that the
+    // probe guards.
+    ProbeText,
+    // selection[output] = selection[first] without selection[second].
+    Difference,
+    // selection[output] = selection[first] merged with selection[second].
+    Union,
+  };
+
+  struct Instruction {
+    OpCode code_;
+    // Type of the operands.
+    Type type_ = Type::Int;
+    sql::Expression::Kind arithmetic_ = sql::Expression::Kind::Add;
+    sql::Expression::Operation comparison_ = sql::Expression::Operation::Equal;
+    uint16_t output_ = 0;
+    uint16_t input_ = 0;
+    uint16_t first_ = 0;
+    uint16_t second_ = 0;
+    uint32_t column_ = 0;
+    // FilterColumn's constant, converted to the column's type.
+    int int_constant_ = 0;
+    float real_constant_ = 0;
+    // ProbeText's text_hash() of the constant.
+    uint64_t text_hash_ = 0;
+  };
+
+  // A value register filled before the first block.
+  struct Constant {
+    uint16_t register_;
+    Type type_;
+    int64_t int_;
+    double real_;
+    std::string text_;
+  };
+
+  struct Value {
+    uint16_t register_;
+    Type type_;
+  };
+
+  class Frame;
+
+  uint16_t compile_condition(const sql::Expression& expression, uint16_t input);
+  Value compile_value(const sql::Expression& expression, uint16_t input);
+  Value compile_operand(const sql::Operand& operand, uint16_t input);
+  bool compile_filter(
+      const sql::Expression& expression,
+      uint16_t input,
+      uint16_t output);
+  uint16_t compile_probe(
+      const sql::Expression& expression,
+      uint16_t input,
+      uint16_t output);
+  Value to_real(Value value, uint16_t input);
+  uint16_t new_value(Type type);
+  uint16_t new_selection();
+
+  void execute(const Instruction& instruction, Frame& frame) const;
+
+  const Table& table_;
+  std::vector<Instruction> instructions_;
+  std::vector<Constant> constants_;
+  std::vector<Type> value_types_;
+  // Selection 0 is every row of the block.
+  uint16_t selection_count_ = 1;
+  uint16_t result_ = 0;
+  std::vector<size_t> columns_;
+};
+
+}  // namespace rdb::exec
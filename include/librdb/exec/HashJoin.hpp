@@ -0,0 +1,33 @@
+#pragma once
+
+#include <librdb/exec/Table.hpp>
+#include <utility>
+#include <vector>
+
+namespace rdb::exec {
+
+// Equality join of the selected rows of two columns of the same kind.
+//
+// The hash table is built on the side with fewer rows. A bloom filter of
+// its keys drops most probe rows without a match before any more work is
+// done on them. Both sides are then radix-partitioned on their hashes
+// into partitions whose hash table fits into the cache, and workers join
+// the partitions in parallel.
+class HashJoin {
+ public:
+  // Throws ExecutionError if the columns are of different kinds.
+  HashJoin(const Column& left, const Column& right);
+
+  // Matching pairs of rows of the left and the right column, ordered by
+  // left row, then right row. The selections must be in ascending order.
+  std::vector<std::pair<size_t, size_t>> run(
+      const std::vector<size_t>& left_rows,
+      const std::vector<size_t>& right_rows,
+      size_t workers) const;
+
+ private:
+  const Column& left_;
+  const Column& right_;
+};
+
+}  // namespace rdb::exec
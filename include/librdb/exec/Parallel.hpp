@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace rdb::exec {
+
+// Threads worth starting to process `row_count` rows: one per 16 blocks, up
+// to the number of cores.
+size_t workers_for(size_t row_count);
+
+// Calls `work(worker)` for every worker in [0, workers), worker 0 on the
+// calling thread and every other on a thread of its own, all charging the
+// caller's current memory tracker. Once all of them are done, rethrows the
+// exception of the first worker that threw one.
+void run_workers(size_t workers, const std::function<void(size_t)>& work);
+
+}  // namespace rdb::exec
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace rdb::exec {
+
+// Counters of one plan operator, collected only by EXPLAIN ANALYZE.
+struct OperatorStats {
+  std::chrono::nanoseconds time_{0};
+  size_t rows_in_ = 0;
+  size_t rows_out_ = 0;
+  size_t blocks_read_ = 0;
+  size_t bytes_read_ = 0;
+  // Blocks checked against the bloom filter of a TEXT column for an
+  // equality, those it ruled out, and those it let through that had no
+  // matching row.
+  size_t bloom_probes_ = 0;
+  size_t bloom_skipped_ = 0;
+  size_t bloom_false_positives_ = 0;
+};
+
+struct PlanNode {
+  std::string description_;
+  std::vector<std::string> details_;
+  OperatorStats stats_;
+  // Operators whose output this one consumes.
+  size_t inputs_ = 1;
+};
+
+// Plan of one statement in pre-order: the root operator first, every
+// operator followed by its inputs and theirs. The last operator has no
+// inputs whatever its count says.
+struct Profile {
+  std::vector<PlanNode> nodes_;
+  bool analyze_ = false;
+};
+
+std::vector<std::string> profile_to_lines(const Profile& profile);
+
+// Adds the lifetime of the timer to `stats`; does nothing if it is null, so
+// uninstrumented execution doesn't read the clock.
+class OperatorTimer {
+ public:
+  explicit OperatorTimer(OperatorStats* stats) : stats_(stats) {
+    if (stats_ != nullptr) {
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+
+  ~OperatorTimer() {
+    if (stats_ != nullptr) {
+      stats_->time_ += std::chrono::steady_clock::now() - start_;
+    }
+  }
+
+  OperatorTimer(const OperatorTimer&) = delete;
+  OperatorTimer& operator=(const OperatorTimer&) = delete;
+
+ private:
+  OperatorStats* stats_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace rdb::exec
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <librdb/exec/Executor.hpp>
+#include <librdb/exec/Table.hpp>
+#include <list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace rdb::exec {
+
+// Results of SELECT statements, keyed on the table and the normalized
+// column list and WHERE expression. An entry is only returned while the
+// table has the id and version it had when the entry was stored, so any
+// INSERT or DELETE that changes rows, or a DROP and re-CREATE, invalidates
+// it. The least recently used entries are evicted to stay within the byte
+// budget.
+class ResultCache {
+ public:
+  struct Stats {
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+    uint64_t invalidations_ = 0;
+    uint64_t evictions_ = 0;
+  };
+
+  explicit ResultCache(size_t budget_bytes) : budget_bytes_(budget_bytes) {}
+
+  // The part of the cache key that comes from the statement itself.
+  static std::string key(const sql::SelectStatement& statement);
+
+  std::optional<Result> find(const Table& table, const std::string& key);
+  // Results larger than the whole budget aren't stored.
+  void insert(const Table& table, std::string key, const Result& result);
+  // Drops every entry for the table.
+  void invalidate(std::string_view table_name);
+
+  size_t byte_size() const { return byte_size_; }
+  size_t size() const { return lru_.size(); }
+  const Stats& stats() const { return stats_; }
+
+ private:
+  struct Entry {
+    std::string table_name_;
+    std::string key_;
+    Result result_;
+    size_t bytes_;
+  };
+  using EntryList = std::list<Entry>;
+
+  struct TableEntries {
+    uint64_t id_;
+    uint64_t version_;
+    std::unordered_map<std::string, EntryList::iterator> entries_;
+  };
+
+  // Returns the table's entries, emptied if they are for an older version.
+  TableEntries& entries_for(const Table& table);
+  void clear(TableEntries& table_entries);
+  void erase(EntryList::iterator entry);
+
+  size_t budget_bytes_;
+  size_t byte_size_ = 0;
+  // Most recently used first.
+  EntryList lru_;
+  std::unordered_map<std::string, TableEntries> tables_;
+  Stats stats_;
+};
+
+}  // namespace rdb::exec
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <librdb/exec/Table.hpp>
+#include <optional>
+#include <vector>
+
+namespace rdb::exec {
+
+// ORDER BY one column, with an optional LIMIT.
+//
+// A LIMIT that is small next to the input keeps the first rows of every
+// worker's chunk in a bounded heap. Otherwise every worker radix-sorts its
+// chunk on an order-preserving 64-bit key of the values, and the sorted
+// chunks are merged. If the sort entries don't fit into the memory budget,
+// the input is sorted in runs that do, which are written to temporary
+// files and merged from there.
+class Sort {
+ public:
+  static constexpr size_t kDefaultMemoryBudget = size_t{256} << 20;
+
+  Sort(
+      const Column& column,
+      bool descending,
+      std::optional<size_t> limit,
+      size_t memory_budget = kDefaultMemoryBudget);
+
+  // Positions in `rows` ordered by the value of the row, equal values by
+  // position, and cut to the limit. Throws ExecutionError if a temporary
+  // file can't be written or read.
+  std::vector<size_t> run(const std::vector<size_t>& rows, size_t workers)
+      const;
+
+ private:
+  const Column& column_;
+  bool descending_;
+  std::optional<size_t> limit_;
+  size_t memory_budget_;
+};
+
+}  // namespace rdb::exec
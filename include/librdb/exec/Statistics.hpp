@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <librdb/sql/Statements.hpp>
+#include <vector>
+
+namespace rdb::exec {
+
+class Table;
+
+// HyperLogLog sketch of the number of distinct 64-bit hashes: 1 KiB of
+// registers with about 3% standard error.
+class HyperLogLog {
+ public:
+  void add(uint64_t hash);
+  double estimate() const;
+
+ private:
+  static constexpr unsigned kIndexBits = 10;
+
+  std::array<uint8_t, size_t{1} << kIndexBits> registers_{};
+};
+
+// Equi-depth histogram of INT or REAL values as to_key() keys. A rebuild
+// gives every bucket about the same number of rows; added and removed keys
+// then change the counts of the bucket they fall into, and keys outside
+// the range widen the first or last bucket.
+class Histogram {
+ public:
+  static constexpr size_t kMaxBuckets = 64;
+
+  void build(const std::vector<uint32_t>& sorted_keys);
+  void add(uint32_t key);
+  void remove(uint32_t key);
+
+  bool empty() const { return counts_.empty(); }
+  size_t bucket_count() const { return counts_.size(); }
+  size_t row_count() const;
+  uint32_t min_key() const { return lower_; }
+  uint32_t max_key() const { return upper_.back(); }
+
+  // Estimated fraction of the rows with a key below `key`, interpolating
+  // linearly within its bucket.
+  double fraction_below(uint32_t key) const;
+
+ private:
+  size_t bucket_of(uint32_t key) const;
+
+  uint32_t lower_ = 0;
+  // Bucket i holds the keys from upper_[i - 1] + 1 (or lower_) up to and
+  // including upper_[i].
+  std::vector<uint32_t> upper_;
+  std::vector<size_t> counts_;
+};
+
+struct ColumnStatistics {
+  HyperLogLog distinct_;
+  // INT and REAL columns only.
+  Histogram histogram_;
+};
+
+// Statistics of every column of a table. Appended rows update them right
+// away; erased rows leave the distinct counts too high until they are
+// rebuilt from the rows, which ANALYZE does, and which the table does by
+// itself once as many rows changed as it had at the last rebuild.
+struct TableStatistics {
+  std::vector<ColumnStatistics> columns_;
+  // Rows appended or erased since the last rebuild.
+  size_t changed_rows_ = 0;
+  size_t rebuilt_rows_ = 0;
+};
+
+// Estimated fraction of the table's rows that satisfy `condition`: from
+// the histogram for ranges on INT and REAL columns, from the distinct count
+// for equality, and 1/3 for any other comparison. Operands of AND and OR
+// are taken as independent.
+double estimate_selectivity(
+    const Table& table,
+    const sql::Expression& condition);
+
+}  // namespace rdb::exec
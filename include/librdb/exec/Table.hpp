@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <librdb/exec/BloomFilter.hpp>
+#include <librdb/exec/Encoding.hpp>
+#include <librdb/exec/Statistics.hpp>
+#include <librdb/sql/Statements.hpp>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace rdb::exec {
+
+using Cell = std::variant<int, float, std::string>;
+
+// Rows per column block, the unit in which scans account for the data read.
+constexpr size_t kBlockRows = 4096;
+
+std::string cell_to_str(const Cell& cell);
+
+// INT or REAL values. Every full block of kBlockRows values is encoded
+// when it fills up; the values after the last full block stay plain.
+template <typename T>
+struct EncodedValues {
+  std::vector<EncodedBlock> blocks_;
+  std::vector<T> tail_;
+};
+
+class Column {
+ public:
+  using Kind = sql::ColumnDef::Kind;
+
+  // Values that live in read-only memory owned by someone else, such as a
+  // mapped checkpoint file. INT and REAL values are plain arrays; TEXT is
+  // `size_ + 1` offsets into a byte array.
+  struct MappedData {
+    // Keeps the memory alive for as long as the column uses it.
+    std::shared_ptr<const void> owner_;
+    const void* values_;
+    const uint64_t* offsets_;
+    size_t size_;
+  };
+
+  Column(std::string name, Kind kind);
+  Column(std::string name, Kind kind, MappedData data);
+
+  const std::string& name() const { return name_; }
+  Kind kind() const { return kind_; }
+  size_t size() const;
+  bool mapped() const { return std::holds_alternative<MappedData>(data_); }
+
+  // INT (T = int) and REAL (T = float) columns are read a block at a time.
+  size_t block_count() const { return (size() + kBlockRows - 1) / kBlockRows; }
+  size_t block_rows(size_t block) const;
+  // The block's values, decoded into `scratch` if they are encoded.
+  template <typename T>
+  const T* block_values(size_t block, std::vector<T>& scratch) const;
+  // Appends the rows of the block whose value satisfies
+  // `value operation constant`, evaluated on the encoded data if possible.
+  template <typename T>
+  void filter_block(
+      size_t block,
+      sql::Expression::Operation operation,
+      T constant,
+      std::vector<size_t>& selection) const;
+  // Encoding of an encoded block, std::nullopt for plain values.
+  std::optional<Encoding> block_encoding(size_t block) const;
+
+  // Value of a TEXT column.
+  std::string_view text(size_t row) const;
+  // TEXT columns: false if no value of the block has the text_hash()
+  // `hash`. Every block has a bloom filter of its values, filled as rows are
+  // appended and rebuilt when rows are erased.
+  bool block_may_contain(size_t block, uint64_t hash) const {
+    return text_filters_[block].may_contain(hash);
+  }
+
+  // Bytes of value data as stored, not counting container overhead.
+  size_t byte_size() const;
+  size_t byte_size(size_t row) const;
+
+  // Random access; ColumnReader is faster for reading many rows.
+  Cell at(size_t row) const;
+  // Changing a mapped column first copies its values into memory.
+  void push_back(Cell cell);
+  void erase_rows(const std::vector<bool>& erase_mask);
+
+ private:
+  template <typename T>
+  std::vector<T> decode_all() const;
+  template <typename T>
+  void assign(const std::vector<T>& values);
+  void materialize();
+  void add_to_text_filter(size_t row, std::string_view value);
+  void build_text_filters();
+
+  std::string name_;
+  Kind kind_;
+  std::variant<
+      EncodedValues<int>,
+      EncodedValues<float>,
+      std::vector<std::string>,
+      MappedData>
+      data_;
+  std::vector<BloomFilter> text_filters_;
+};
+
+// Reads cells of a column in ascending row order, decoding each INT or
+// REAL block once instead of once per row.
+class ColumnReader {
+ public:
+  explicit ColumnReader(const Column& column) : column_(&column) {}
+
+  Cell at(size_t row);
+
+ private:
+  const Column* column_;
+  size_t block_ = std::numeric_limits<size_t>::max();
+  const int* ints_ = nullptr;
+  const float* floats_ = nullptr;
+  std::vector<int> int_scratch_;
+  std::vector<float> float_scratch_;
+};
+
+class Table {
+ public:
+  Table(std::string name, std::vector<Column> columns);
+
+  const std::string& name() const { return name_; }
+
+  // Unique across all tables created by the process, so a table that is
+  // dropped and created again under the same name is told apart.
+  uint64_t id() const { return id_; }
+  // Incremented by every change to the table's rows.
+  uint64_t version() const { return version_; }
+
+  const std::vector<Column>& columns() const { return columns_; }
+  size_t row_count() const;
+
+  std::optional<size_t> find_column(std::string_view column_name) const;
+
+  // Cells must be given in schema order and match the column kinds.
+  void append_row(std::vector<Cell> row);
+  size_t erase_rows(const std::vector<bool>& erase_mask);
+
+  const TableStatistics& statistics() const { return statistics_; }
+  // Rebuilds the statistics from the rows.
+  void analyze();
+
+ private:
+  // Rebuilds the statistics once they drifted too far.
+  void row_changed(size_t rows);
+
+  std::string name_;
+  std::vector<Column> columns_;
+  uint64_t id_;
+  uint64_t version_ = 0;
+  TableStatistics statistics_;
+};
+
+using TablePtr = std::shared_ptr<Table>;
+
+}  // namespace rdb::exec
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <librdb/exec/Catalog.hpp>
+#include <librdb/exec/Executor.hpp>
+#include <librdb/sql/Statements.hpp>
+#include <librdb/sync/MpscQueue.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace rdb::exec {
+
+// Applies a stream of statements with the INSERTs and DELETEs spread over
+// worker threads by table. Every table is written by a single worker, which
+// takes its statements in order from a queue of its own, so writes to
+// different tables don't wait for each other and those to one table apply
+// in the order they were dispatched. Any other statement, and every one
+// inside a transaction, waits for the workers to catch up and then runs on
+// the dispatching thread. Writes aren't logged.
+class WriteDispatcher {
+ public:
+  struct Error {
+    // Position of the statement among all the dispatched ones.
+    size_t statement_ = 0;
+    std::string message_;
+  };
+
+  // Workers charge their memory to the tracker that is current here. A
+  // worker that finds its queue of `queue_capacity` statements full holds
+  // up the dispatching thread until it has made room.
+  WriteDispatcher(Catalog& catalog, size_t workers, size_t queue_capacity);
+  // Applies what is still queued.
+  ~WriteDispatcher();
+
+  WriteDispatcher(const WriteDispatcher&) = delete;
+  WriteDispatcher& operator=(const WriteDispatcher&) = delete;
+
+  // Called from one thread only. The statement must stay alive until the
+  // next wait() returns.
+  void dispatch(const sql::Statement& statement);
+
+  // Waits until every dispatched statement is applied. Returns the errors
+  // since the previous call, in statement order.
+  std::vector<Error> wait();
+
+  size_t worker_count() const { return workers_.size(); }
+
+ private:
+  class Worker;
+
+  // Waits until the workers have applied their queues.
+  void drain();
+
+  Executor executor_;
+  Transaction transaction_;
+  size_t dispatched_ = 0;
+  // Written by the workers and the dispatching thread; outlives both.
+  sync::MpscQueue<Error> errors_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+};
+
+}  // namespace rdb::exec
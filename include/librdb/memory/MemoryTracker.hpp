@@ -0,0 +1,166 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace rdb::memory {
+
+// Thrown when an allocation would take a tracker over its limit.
+class MemoryLimitError : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+// Bytes in use by one level of the process → session → statement
+// hierarchy. Every allocation is charged to the tracker and all of its
+// ancestors, and is refused as a whole if any of them would exceed its
+// limit. Charges are atomic, so worker threads of a statement can share its
+// tracker.
+class MemoryTracker {
+ public:
+  // The root of the hierarchy, without a limit.
+  static MemoryTracker& process();
+
+  // The tracker that allocations of this thread are charged to: the one of
+  // the innermost MemoryScope, or the process tracker.
+  static MemoryTracker& current();
+
+  MemoryTracker(
+      std::string name,
+      MemoryTracker* parent,
+      std::optional<size_t> limit = std::nullopt);
+  // Releases whatever is still charged from the ancestors.
+  ~MemoryTracker();
+
+  MemoryTracker(const MemoryTracker&) = delete;
+  MemoryTracker& operator=(const MemoryTracker&) = delete;
+
+  // Throws MemoryLimitError without charging anything if a limit would be
+  // exceeded.
+  void allocate(size_t bytes);
+  void release(size_t bytes);
+
+  const std::string& name() const { return name_; }
+  const std::optional<size_t>& limit() const { return limit_; }
+  size_t used() const { return used_.load(std::memory_order_relaxed); }
+  // Highest usage since construction.
+  size_t peak() const { return peak_.load(std::memory_order_relaxed); }
+
+ private:
+  friend class Reservation;
+
+  // Shared with the reservations on the tracker. The destructor clears the
+  // pointer, so that reservations that outlive the tracker find it gone.
+  struct Anchor {
+    std::mutex mutex_;
+    MemoryTracker* tracker_;
+  };
+
+  // Charges this tracker only; returns false if that exceeds the limit.
+  bool try_charge(size_t bytes);
+  void update_peak();
+
+  std::shared_ptr<Anchor> anchor_;
+  std::string name_;
+  MemoryTracker* parent_;
+  std::optional<size_t> limit_;
+  std::atomic<size_t> used_{0};
+  std::atomic<size_t> peak_{0};
+};
+
+// Makes `tracker` the current one of this thread for the scope's lifetime.
+class MemoryScope {
+ public:
+  explicit MemoryScope(MemoryTracker& tracker);
+  ~MemoryScope();
+
+  MemoryScope(const MemoryScope&) = delete;
+  MemoryScope& operator=(const MemoryScope&) = delete;
+
+ private:
+  MemoryTracker* previous_;
+};
+
+// Bytes charged to a tracker for as long as the reservation lives, for
+// memory that isn't allocated through TrackingAllocator. A reservation may
+// outlive its tracker, such as a prepared statement kept after its session
+// ended: the tracker's destructor releases the bytes from the ancestors,
+// and the reservation charges and releases nothing from then on.
+class Reservation {
+ public:
+  Reservation() = default;
+  explicit Reservation(MemoryTracker& tracker) : anchor_(tracker.anchor_) {}
+  ~Reservation() { resize(0); }
+
+  Reservation(Reservation&& other) noexcept
+      : anchor_(other.anchor_), bytes_(other.bytes_) {
+    other.bytes_ = 0;
+  }
+  Reservation& operator=(Reservation&& other) noexcept;
+
+  // Charges or releases the difference to the reserved bytes. Throws
+  // MemoryLimitError, keeping the reservation as it was, if a limit would
+  // be exceeded.
+  void resize(size_t bytes);
+  void add(size_t bytes) { resize(bytes_ + bytes); }
+
+  size_t bytes() const { return bytes_; }
+
+ private:
+  std::shared_ptr<MemoryTracker::Anchor> anchor_;
+  size_t bytes_ = 0;
+};
+
+// Standard allocator that charges the tracker that was current when it was
+// created.
+template <typename T>
+class TrackingAllocator {
+ public:
+  using value_type = T;
+
+  TrackingAllocator() : tracker_(&MemoryTracker::current()) {}
+  template <typename U>
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  TrackingAllocator(const TrackingAllocator<U>& other)
+      : tracker_(other.tracker()) {}
+
+  T* allocate(size_t count) {
+    tracker_->allocate(count * sizeof(T));
+    try {
+      return std::allocator<T>().allocate(count);
+    } catch (...) {
+      tracker_->release(count * sizeof(T));
+      throw;
+    }
+  }
+
+  void deallocate(T* pointer, size_t count) {
+    std::allocator<T>().deallocate(pointer, count);
+    tracker_->release(count * sizeof(T));
+  }
+
+  MemoryTracker* tracker() const { return tracker_; }
+
+  template <typename U>
+  bool operator==(const TrackingAllocator<U>& other) const {
+    return tracker_ == other.tracker();
+  }
+  template <typename U>
+  bool operator!=(const TrackingAllocator<U>& other) const {
+    return tracker_ != other.tracker();
+  }
+
+ private:
+  MemoryTracker* tracker_;
+};
+
+template <typename T>
+using Vector = std::vector<T, TrackingAllocator<T>>;
+
+}  // namespace rdb::memory
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace rdb::metrics {
+
+using Labels = std::vector<std::pair<std::string, std::string>>;
+
+namespace detail {
+
+constexpr size_t kShards = 16;
+
+// The calling thread's shard of Counter and Histogram.
+size_t shard_index();
+
+}  // namespace detail
+
+// Monotonic counter split into cache-line sized shards. Each thread adds to
+// its own shard with a relaxed atomic, so increments from different threads
+// don't contend; reads sum the shards.
+class Counter {
+ public:
+  void add(uint64_t value = 1) {
+    shards_[detail::shard_index()].value_.fetch_add(
+        value, std::memory_order_relaxed);
+  }
+
+  uint64_t value() const;
+
+ private:
+  struct alignas(64) Shard {
+    std::atomic<uint64_t> value_{0};
+  };
+
+  std::array<Shard, detail::kShards> shards_;
+};
+
+// Log-linear histogram in the style of HdrHistogram: every power of two is
+// split into 16 sub-buckets, so any recorded value is known within 1/16 of
+// its magnitude. Values are nanoseconds and are exported in seconds.
+// Sharded like Counter, at about 8 KiB per shard.
+class Histogram {
+ public:
+  static constexpr size_t kSubBucketBits = 4;
+  static constexpr size_t kSubBuckets = size_t{1} << kSubBucketBits;
+  static constexpr size_t kBuckets = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+  // The shards merged. Its count is the sum of its buckets, even while
+  // other threads record.
+  struct Snapshot {
+    // Largest value of the bucket holding the given quantile, 0 if empty.
+    uint64_t quantile(double fraction) const;
+
+    std::array<uint64_t, kBuckets> buckets_{};
+    uint64_t count_ = 0;
+    uint64_t sum_ = 0;
+  };
+
+  void record(uint64_t value) {
+    Shard& shard = shards_[detail::shard_index()];
+    shard.buckets_[bucket_of(value)].fetch_add(1, std::memory_order_relaxed);
+    shard.count_.fetch_add(1, std::memory_order_relaxed);
+    shard.sum_.fetch_add(value, std::memory_order_relaxed);
+  }
+
+  Snapshot snapshot() const;
+
+  uint64_t count() const;
+  uint64_t sum() const;
+  uint64_t quantile(double fraction) const {
+    return snapshot().quantile(fraction);
+  }
+
+  static size_t bucket_of(uint64_t value);
+  static uint64_t bucket_upper_bound(size_t bucket);
+
+ private:
+  struct alignas(64) Shard {
+    std::array<std::atomic<uint64_t>, kBuckets> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+  };
+
+  std::array<Shard, detail::kShards> shards_;
+};
+
+// Owns all metrics of the process. Registration takes a lock and is meant to
+// happen once per metric; the returned references stay valid for the
+// registry's lifetime and are updated without locking.
+class Registry {
+ public:
+  static Registry& global();
+
+  // Registering an existing name and label set returns the same metric.
+  // Throws std::logic_error if the name is registered with another type.
+  Counter& counter(
+      const std::string& name,
+      const std::string& help,
+      const Labels& labels = {});
+  Histogram& histogram(
+      const std::string& name,
+      const std::string& help,
+      const Labels& labels = {});
+
+  // Snapshot of all metrics in the Prometheus text exposition format.
+  std::string render_prometheus() const;
+
+  // Writes the snapshot through a temporary file and a rename, so readers
+  // never see a partial file. Throws std::system_error on failure.
+  void write_prometheus(const std::string& path) const;
+
+ private:
+  enum class Type { Counter, Histogram };
+
+  struct Series {
+    Labels labels_;
+    std::unique_ptr<Counter> counter_;
+    std::unique_ptr<Histogram> histogram_;
+  };
+
+  struct Family {
+    Type type_;
+    std::string help_;
+    std::vector<Series> series_;
+  };
+
+  Series& series(
+      const std::string& name,
+      const std::string& help,
+      const Labels& labels,
+      Type type);
+
+  mutable std::mutex mutex_;
+  std::map<std::string, Family> families_;
+};
+
+}  // namespace rdb::metrics
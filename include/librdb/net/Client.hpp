@@ -0,0 +1,34 @@
+#pragma once
+
+#include <librdb/net/Protocol.hpp>
+#include <string>
+#include <string_view>
+
+namespace rdb::net {
+
+// Blocking client for Server. Scripts may be pipelined: several send_script()
+// calls can precede the read_frame() calls that collect their results.
+class Client {
+ public:
+  // Throws std::system_error if the server is unreachable.
+  explicit Client(const std::string& socket_path);
+  ~Client();
+
+  Client(const Client&) = delete;
+  Client& operator=(const Client&) = delete;
+
+  void send_script(std::string_view sql);
+  // Tells the server that no more scripts follow. It still answers those
+  // sent so far, and then closes the connection.
+  void finish_sending();
+
+  // Throws std::system_error on I/O errors and ProtocolError if the server
+  // closes the connection.
+  Frame read_frame();
+
+ private:
+  int fd_ = -1;
+  FrameReader reader_;
+};
+
+}  // namespace rdb::net
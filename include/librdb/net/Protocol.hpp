@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <librdb/exec/Executor.hpp>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rdb::net {
+
+// Every frame is a 4-byte payload length, a 1-byte frame type and the
+// payload. Integers are in host byte order since both ends share a host.
+// A client may send any number of Script frames without waiting; the
+// server answers them in order, one Ok or Error frame per statement,
+// followed by a Done frame carrying the number of statements that were
+// executed. A SELECT is answered with a Columns frame and its rows in Rows
+// frames of about kRowsChunkBytes each, sent as they are encoded; an empty
+// Rows frame ends the result, or an Error frame if the rows can't be sent.
+enum class FrameType : uint8_t {
+  Script = 1,
+  Rows = 2,
+  Ok = 3,
+  Error = 4,
+  Done = 5,
+  Columns = 6
+};
+
+constexpr size_t kFrameHeaderSize = 5;
+constexpr size_t kMaxFramePayload = size_t{64} << 20U;
+constexpr size_t kRowsChunkBytes = size_t{64} << 10U;
+
+class ProtocolError : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+struct Frame {
+  FrameType type_;
+  std::string payload_;
+};
+
+// The encoders throw ProtocolError if a frame would exceed
+// kMaxFramePayload.
+void encode_frame(std::string& out, FrameType type, std::string_view payload);
+void encode_ok(std::string& out, uint64_t affected_rows);
+void encode_columns(std::string& out, const std::vector<std::string>& names);
+// Encodes rows from `begin` on into one Rows frame, stopping after the row
+// that reaches kRowsChunkBytes, and returns the index of the first row
+// left. Encodes at least one row.
+size_t encode_rows(
+    std::string& out,
+    const std::vector<std::vector<exec::Cell>>& rows,
+    size_t begin);
+void encode_rows_end(std::string& out);
+// Encodes a whole result: an Ok frame, or the frames of a SELECT.
+void encode_result(std::string& out, const exec::Result& result);
+void encode_done(std::string& out, uint32_t statement_count);
+
+std::vector<std::string> decode_columns(std::string_view payload);
+// Empty for the frame that ends a result.
+std::vector<std::vector<exec::Cell>> decode_rows(std::string_view payload);
+uint64_t decode_ok(std::string_view payload);
+uint32_t decode_done(std::string_view payload);
+
+// Splits a byte stream into frames.
+class FrameReader {
+ public:
+  void append(const char* data, size_t size) { buffer_.append(data, size); }
+
+  // Throws ProtocolError on a malformed header.
+  std::optional<Frame> next();
+
+  size_t buffered() const { return buffer_.size() - consumed_; }
+
+ private:
+  std::string buffer_;
+  size_t consumed_ = 0;
+};
+
+}  // namespace rdb::net
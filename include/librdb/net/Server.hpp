@@ -0,0 +1,73 @@
+#pragma once
+
+#include <librdb/exec/Executor.hpp>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace rdb::net {
+
+// Serves SQL scripts over a Unix domain socket. All connections are handled
+// by a single epoll loop, so statements from different clients never run
+// concurrently and share one catalog. Scripts run a statement at a time
+// while their output drains, so statements of other connections may run in
+// between; every connection has a transaction of its own for isolation,
+// which is rolled back if the connection closes before COMMIT.
+class Server {
+ public:
+  // Throws std::system_error if the socket can't be bound. Statements of a
+  // connection fail once its parsed script and running statement together
+  // would use more than `session_memory_limit` bytes.
+  Server(
+      exec::Executor& executor,
+      std::string socket_path,
+      std::optional<size_t> session_memory_limit = std::nullopt);
+  ~Server();
+
+  Server(const Server&) = delete;
+  Server& operator=(const Server&) = delete;
+
+  // Blocks until stop() is called. If the executor's log fails, answers
+  // the script with an Error frame and throws storage::StorageError: the
+  // write is applied but not durable, so the server stops instead of
+  // serving it.
+  void run();
+
+  // Safe to call from another thread or from a signal handler.
+  void stop();
+
+ private:
+  struct Script;
+  struct Connection;
+
+  // Closes the descriptors opened so far, removes the socket file if it was
+  // bound, and throws std::system_error for errno.
+  [[noreturn]] void fail_setup(const char* what, bool bound);
+  void accept_connections();
+  void handle_readable(Connection& connection);
+  void handle_writable(Connection& connection);
+  void process_frames(Connection& connection);
+  // Parses the script and, unless it has syntax errors, makes it the
+  // connection's running script.
+  void start_script(Connection& connection, std::string sql);
+  // Encodes the next frame of the running script: executes its next
+  // statement or sends a chunk of the current SELECT's rows, and ends the
+  // script after its last statement or an error.
+  void continue_script(Connection& connection);
+  [[noreturn]] void fail_stop();
+  void update_events(Connection& connection);
+  void close_connection(int fd);
+
+  exec::Executor& executor_;
+  std::string socket_path_;
+  std::optional<size_t> session_memory_limit_;
+  int listen_fd_ = -1;
+  int epoll_fd_ = -1;
+  int stop_fd_ = -1;
+  std::unordered_map<int, std::unique_ptr<Connection>> connections_;
+  // Set once the log fails; no further frames are executed.
+  std::optional<std::string> log_error_;
+};
+
+}  // namespace rdb::net
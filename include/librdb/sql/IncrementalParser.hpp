@@ -0,0 +1,63 @@
+#pragma once
+
+#include <librdb/sql/Location.hpp>
+#include <librdb/sql/Parser.hpp>
+#include <librdb/sql/Token.hpp>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rdb::sql {
+
+// Keeps the tokens and statements of a script up to date while it is being
+// edited. The script is stored as segments that each end with a semicolon
+// token, the points where both the lexer and the parser's error recovery
+// restart from scratch. An edit re-lexes and re-parses the segments it
+// touches, continuing until a semicolon lands on an old segment boundary,
+// and only shifts the locations of everything after that.
+class IncrementalParser {
+ public:
+  explicit IncrementalParser(std::string_view text);
+
+  // Replaces `removed` characters at `offset` with `inserted`. Throws
+  // std::out_of_range if the range is outside the script.
+  void edit(size_t offset, size_t removed, std::string_view inserted);
+
+  std::string text() const;
+  size_t size() const { return size_; }
+
+  // Tokens of the whole script, without Eof. Texts point into the parser's
+  // own copy of the script and stay valid until the segment is re-parsed.
+  const std::vector<Token>& tokens() const { return tokens_; }
+  const Parser::Result& result() const { return result_; }
+
+  // Segments lexed and parsed by the last edit.
+  size_t reparsed_segments() const { return reparsed_segments_; }
+
+ private:
+  struct Segment {
+    std::unique_ptr<const std::string> text_;
+    Location begin_;
+    size_t token_count_;
+    size_t statement_count_;
+    size_t error_count_;
+  };
+
+  struct Reparsed {
+    std::vector<Segment> segments_;
+    std::vector<Token> tokens_;
+    Parser::Result result_;
+  };
+
+  void reparse(size_t first, size_t last, std::string text);
+  void parse_segment(std::string text, const Location& begin, Reparsed& out);
+
+  std::vector<Segment> segments_;
+  std::vector<Token> tokens_;
+  Parser::Result result_;
+  size_t size_ = 0;
+  size_t reparsed_segments_ = 0;
+};
+
+}  // namespace rdb::sql
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <librdb/sql/Location.hpp>
+#include <librdb/sql/NewlineIndex.hpp>
 #include <librdb/sql/Token.hpp>
 #include <optional>
 #include <string_view>
@@ -10,25 +10,27 @@ namespace rdb::sql {
 class Lexer {
    public:
     explicit Lexer(std::string_view input)
-        : input_(input), location_(0, 0, 0) {}
+        : input_(input), newlines_(input) {}
+    ~Lexer();
+
+    Lexer(const Lexer&) = delete;
+    Lexer& operator=(const Lexer&) = delete;
 
     Token get();
     Token peek();
 
    private:
-    bool eof() const;
-    char peek_char() const;
-    char get_char();
-    void skip_spaces();
-    Token get_id_or_kw();
-    Token get_punct();
-    Token get_number();
-    Token get_string();
-    Token get_operation();
-    Token make_token(Token::Kind kind, const Location& begin) const;
+    void report_tokens();
     std::string_view input_;
-    Location location_;
+    // Only the offset is tracked while scanning; rows and columns come from
+    // the newline index once per token.
+    size_t offset_ = 0;
+    NewlineIndex newlines_;
+    size_t row_ = 0;
     std::optional<Token> next_token_;
+    // Tokens not yet added to the global metrics, which are updated in
+    // batches to keep an atomic increment off the per-token path.
+    size_t unreported_tokens_ = 0;
 };
 
 } // namespace rdb::sql
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <librdb/sql/Location.hpp>
+#include <string_view>
+#include <vector>
+
+namespace rdb::sql {
+
+// Offsets of every '\n' in a text, found with memchr, for turning offsets
+// into rows and columns only when a location is actually needed.
+class NewlineIndex {
+ public:
+  explicit NewlineIndex(std::string_view text);
+
+  // Binary search over the newlines.
+  Location locate(size_t offset) const;
+
+  // Same as locate() for callers whose offsets never decrease: `row` is
+  // the row of the previous call (0 initially) and is moved forward.
+  Location locate(size_t offset, size_t& row) const;
+
+  size_t newline_count() const { return newlines_.size(); }
+
+ private:
+  Location location(size_t offset, size_t row) const;
+
+  std::vector<size_t> newlines_;
+};
+
+}  // namespace rdb::sql
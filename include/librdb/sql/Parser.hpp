@@ -1,7 +1,10 @@
 #pragma once
 
+#include <librdb/memory/MemoryTracker.hpp>
 #include <librdb/sql/Lexer.hpp>
 #include <librdb/sql/Script.hpp>
+#include <librdb/sql/TokenBuffer.hpp>
+#include <optional>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -13,11 +16,30 @@ class Parser {
   struct Result {
     Script script_;
     std::vector<std::string> errors_;
+    // The statements' memory, charged to the tracker that was current
+    // while parsing. A statement that doesn't fit is left out with an
+    // error.
+    memory::Reservation memory_;
   };
 
-  explicit Parser(Lexer& lexer) : lexer_(lexer) {}
+  explicit Parser(Lexer& lexer) : lexer_(&lexer) {}
+  // Parses pre-lexed tokens, which avoids copying a Token per lookahead.
+  explicit Parser(const TokenBuffer& tokens) : cursor_(tokens) {}
 
   Result parse_sql_script();
+  // Parses the next statement of a script into `result`, adding either the
+  // statement or an error, for callers that take the statements one at a
+  // time. The statement's memory is charged to `result.memory_`. Returns
+  // false at the end of the script.
+  bool parse_next_statement(Result& result);
+  // Parses a single statement in which `?` placeholders may stand for the
+  // values of a VALUES list and the operands of a WHERE condition. Scripts
+  // can't have placeholders.
+  Result parse_prepared_statement();
+
+  // Placeholders of the statement parse_prepared_statement() parsed last.
+  size_t placeholder_count() const { return placeholder_count_; }
+
  private:
   StatementPtr parse_sql_statement();
   DropTableStatementPtr parse_drop_table_statement();
@@ -25,16 +47,43 @@ class Parser {
   SelectStatementPtr parse_select_statement();
   DeleteStatementPtr parse_delete_statement();
   CreateTableStatementPtr parse_create_table_statement();
+  ExplainStatementPtr parse_explain_statement();
+  TransactionStatementPtr parse_transaction_statement();
+  AnalyzeStatementPtr parse_analyze_statement();
   
+  void parse_select_item(
+      std::vector<std::string_view>& column_list,
+      std::vector<SelectStatement::Aggregate>& aggregates);
   Value parse_value();
   Operand parse_operand();
+  Placeholder parse_placeholder();
+  // A WHERE condition.
+  Expression parse_condition();
+  // Precedence climbing from OR, the weakest operator, to operands. Returns
+  // a value for an arithmetic expression, which is only allowed in
+  // parentheses.
   Expression parse_expression();
+  Expression parse_conjunction();
+  Expression parse_negation();
+  Expression parse_comparison();
+  Expression parse_sum();
+  Expression parse_product(Expression first);
+  Expression parse_factor();
   ColumnDef parse_column_def();
   
+  void require_condition(const Expression& expression);
+
   void panic();
-  Token fetch_token(Token::Kind expected_kind);
+  Token::Kind peek_kind();
+  std::string_view peek_text();
+  void skip_token();
+  std::string_view fetch_token(Token::Kind expected_kind);
 
-  Lexer& lexer_;
+  // Exactly one of the two token sources is set.
+  Lexer* lexer_ = nullptr;
+  std::optional<TokenCursor> cursor_;
+  bool placeholders_allowed_ = false;
+  size_t placeholder_count_ = 0;
 };
 
 }  // namespace rdb::sql
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <librdb/sql/Parser.hpp>
+#include <librdb/sync/SpscQueue.hpp>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <thread>
+
+namespace rdb::sql {
+
+// Parses a script on a thread of its own, ahead of a caller that takes the
+// statements one at a time, so that the first statement can run as soon as
+// it is parsed and parsing the next ones overlaps running it. At most
+// `queue_capacity` parsed statements wait in between, however long the
+// script is. Unlike with parse_sql_script(), a caller that executes the
+// statements as they come has run those before a syntax error by the time
+// it sees it.
+class PipelinedParser {
+ public:
+  // `sql` must outlive the parser and the statements. Their memory is
+  // charged to the tracker that is current here.
+  PipelinedParser(std::string_view sql, size_t queue_capacity);
+  // Stops parsing what the caller hasn't taken.
+  ~PipelinedParser();
+
+  PipelinedParser(const PipelinedParser&) = delete;
+  PipelinedParser& operator=(const PipelinedParser&) = delete;
+
+  // Waits for the next statement. The result holds either that statement
+  // or the error of a statement that didn't parse. Returns std::nullopt at
+  // the end of the script.
+  std::optional<Parser::Result> next();
+
+ private:
+  void run(std::string_view sql, memory::MemoryTracker& tracker);
+  // Waits until `ready()` holds.
+  template <typename Ready>
+  void wait(Ready ready);
+  // Wakes the other thread, if it waits, after a push, a pop or the end.
+  void notify();
+
+  sync::SpscQueue<Parser::Result> queue_;
+  std::atomic<bool> finished_{false};
+  std::atomic<bool> stop_{false};
+  // Threads in wait(), so that notify() takes the lock only for them.
+  std::atomic<unsigned> waiting_{0};
+  std::mutex mutex_;
+  std::condition_variable changed_;
+  std::thread thread_;
+};
+
+}  // namespace rdb::sql
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <librdb/sql/Token.hpp>
+#include <string_view>
+#include <utility>
+
+// Lexical rules shared by the runtime Lexer and the compile-time parser. The
+// scanner works on offsets only; the Lexer adds rows and columns on top.
+namespace rdb::sql::scanner {
+
+struct ScannedToken {
+  Token::Kind kind_;
+  size_t begin_;
+  size_t end_;
+};
+
+constexpr bool is_space(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' ||
+         c == '\r';
+}
+
+constexpr bool is_digit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+constexpr bool is_alpha(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+constexpr bool is_alnum(char c) {
+  return is_alpha(c) || is_digit(c);
+}
+
+constexpr Token::Kind id_or_keyword_kind(std::string_view text) {
+  constexpr std::array<std::pair<std::string_view, Token::Kind>, 34> keywords =
+      {{
+          {"SELECT", Token::Kind::KwSelect},
+          {"FROM", Token::Kind::KwFrom},
+          {"CREATE", Token::Kind::KwCreate},
+          {"TABLE", Token::Kind::KwTable},
+          {"WHERE", Token::Kind::KwWhere},
+          {"INSERT", Token::Kind::KwInsert},
+          {"INTO", Token::Kind::KwInto},
+          {"VALUES", Token::Kind::KwValues},
+          {"DELETE", Token::Kind::KwDelete},
+          {"DROP", Token::Kind::KwDrop},
+          {"INT", Token::Kind::KwInt},
+          {"REAL", Token::Kind::KwReal},
+          {"TEXT", Token::Kind::KwText},
+          {"EXPLAIN", Token::Kind::KwExplain},
+          {"ANALYZE", Token::Kind::KwAnalyze},
+          {"AND", Token::Kind::KwAnd},
+          {"OR", Token::Kind::KwOr},
+          {"NOT", Token::Kind::KwNot},
+          {"COUNT", Token::Kind::KwCount},
+          {"SUM", Token::Kind::KwSum},
+          {"MIN", Token::Kind::KwMin},
+          {"MAX", Token::Kind::KwMax},
+          {"AVG", Token::Kind::KwAvg},
+          {"GROUP", Token::Kind::KwGroup},
+          {"BY", Token::Kind::KwBy},
+          {"JOIN", Token::Kind::KwJoin},
+          {"ON", Token::Kind::KwOn},
+          {"ORDER", Token::Kind::KwOrder},
+          {"ASC", Token::Kind::KwAsc},
+          {"DESC", Token::Kind::KwDesc},
+          {"LIMIT", Token::Kind::KwLimit},
+          {"BEGIN", Token::Kind::KwBegin},
+          {"COMMIT", Token::Kind::KwCommit},
+          {"ROLLBACK", Token::Kind::KwRollback},
+      }};
+  for (const auto& [keyword, kind] : keywords) {
+    if (keyword == text) {
+      return kind;
+    }
+  }
+  return Token::Kind::Id;
+}
+
+constexpr size_t skip_spaces(std::string_view input, size_t offset) {
+  while (offset < input.size() && is_space(input[offset])) {
+    ++offset;
+  }
+  return offset;
+}
+
+// A column name may be qualified with its table name, as in `T.Id`, which
+// is scanned as one Id.
+constexpr ScannedToken scan_id_or_keyword(
+    std::string_view input,
+    size_t begin) {
+  size_t end = begin;
+  while (end < input.size() && is_alnum(input[end])) {
+    ++end;
+  }
+  if (end + 1 < input.size() && input[end] == '.' &&
+      is_alpha(input[end + 1])) {
+    ++end;
+    while (end < input.size() && is_alnum(input[end])) {
+      ++end;
+    }
+    return {Token::Kind::Id, begin, end};
+  }
+  return {id_or_keyword_kind(input.substr(begin, end - begin)), begin, end};
+}
+
+constexpr ScannedToken scan_number(std::string_view input, size_t begin) {
+  size_t end = begin;
+  const auto eof = [&input, &end] { return end == input.size(); };
+  if (input[end] == '+' || input[end] == '-') {
+    ++end;
+    if (eof() || !is_digit(input[end])) {
+      return {Token::Kind::Unknown, begin, end};
+    }
+  }
+  if (input[end] == '0') {
+    ++end;
+    if (!eof() && is_digit(input[end])) {
+      return {Token::Kind::Int, begin, end};
+    }
+  }
+  while (!eof() && is_digit(input[end])) {
+    ++end;
+  }
+  if (!eof() && input[end] == '.') {
+    ++end;
+    if (eof() || !is_digit(input[end])) {
+      return {Token::Kind::Unknown, begin, end};
+    }
+    while (!eof() && is_digit(input[end])) {
+      ++end;
+    }
+    return {Token::Kind::Real, begin, end};
+  }
+  return {Token::Kind::Int, begin, end};
+}
+
+constexpr ScannedToken scan_string(std::string_view input, size_t begin) {
+  size_t end = begin + 1;
+  while (end < input.size() && input[end] != '"' && input[end] != '\n') {
+    ++end;
+  }
+  if (end == input.size() || input[end] != '"') {
+    return {Token::Kind::Unknown, begin, end};
+  }
+  return {Token::Kind::String, begin, end + 1};
+}
+
+constexpr ScannedToken scan_operation(std::string_view input, size_t begin) {
+  size_t end = begin;
+  const char first_char = input[end++];
+  const bool equal_follows = end < input.size() && input[end] == '=';
+  if (first_char == '!') {
+    if (!equal_follows) {
+      return {Token::Kind::Unknown, begin, end};
+    }
+    return {Token::Kind::OpNotEqual, begin, end + 1};
+  }
+  if (equal_follows) {
+    ++end;
+    if (first_char == '<') {
+      return {Token::Kind::OpLessEq, begin, end};
+    }
+    if (first_char == '>') {
+      return {Token::Kind::OpGreaterEq, begin, end};
+    }
+  }
+  if (first_char == '<') {
+    return {Token::Kind::OpLess, begin, end};
+  }
+  if (first_char == '>') {
+    return {Token::Kind::OpGreater, begin, end};
+  }
+  return {Token::Kind::OpEqual, begin, end};
+}
+
+// Scans the token starting exactly at `begin`; spaces must be skipped first.
+constexpr ScannedToken scan_token(std::string_view input, size_t begin) {
+  if (begin == input.size()) {
+    return {Token::Kind::Eof, begin, begin};
+  }
+  const char next_char = input[begin];
+  if (is_alpha(next_char)) {
+    return scan_id_or_keyword(input, begin);
+  }
+  switch (next_char) {
+    case '+':
+    case '-':
+      // A sign directly followed by a digit starts a number; the parser
+      // splits it off again where a binary operator is expected.
+      if (begin + 1 < input.size() && is_digit(input[begin + 1])) {
+        return scan_number(input, begin);
+      }
+      return {
+          next_char == '+' ? Token::Kind::OpPlus : Token::Kind::OpMinus,
+          begin,
+          begin + 1};
+    case '*':
+      return {Token::Kind::OpMultiply, begin, begin + 1};
+    case '/':
+      return {Token::Kind::OpDivide, begin, begin + 1};
+    case '"':
+      return scan_string(input, begin);
+    case '!':
+    case '<':
+    case '>':
+    case '=':
+      return scan_operation(input, begin);
+    case ';':
+      return {Token::Kind::Semicolon, begin, begin + 1};
+    case ',':
+      return {Token::Kind::Comma, begin, begin + 1};
+    case '(':
+      return {Token::Kind::LBracket, begin, begin + 1};
+    case ')':
+      return {Token::Kind::RBracket, begin, begin + 1};
+    case '?':
+      return {Token::Kind::Placeholder, begin, begin + 1};
+    default:
+      break;  // do nothing;
+  }
+  if (is_digit(next_char)) {
+    return scan_number(input, begin);
+  }
+  return {Token::Kind::Unknown, begin, begin + 1};
+}
+
+}  // namespace rdb::sql::scanner
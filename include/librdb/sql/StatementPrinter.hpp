@@ -0,0 +1,17 @@
+#pragma once
+
+#include <librdb/sql/Statements.hpp>
+#include <string>
+
+namespace rdb::sql {
+
+// Appends the text of a statement, identical to its to_str(), to `out`.
+// Numbers are formatted with std::to_chars, so a caller that clears and
+// reuses `out` doesn't allocate once it holds the longest statement.
+void print_statement(const Statement& statement, std::string& out);
+
+// Appends the text of expression_to_str() and var_to_str() to `out`.
+void print_expression(const Expression& expression, std::string& out);
+void print_value(const Value& value, std::string& out);
+
+}  // namespace rdb::sql
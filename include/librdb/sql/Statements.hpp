@@ -1,20 +1,28 @@
 #pragma once
 
+#include <cstddef>
 #include <memory>
 #include <optional>
 #include <ostream>
 #include <string_view>
+#include <utility>
 #include <variant>
 #include <vector>
 
 namespace rdb::sql {
 
-using Value = std::variant<int, float, std::string_view>;
+// A `?` of a prepared statement, numbered from 0 in the order of the
+// statement's text.
+struct Placeholder {
+  size_t index_;
+};
+
+using Value = std::variant<int, float, std::string_view, Placeholder>;
 
 std::string var_to_str(const Value& value);
 
 typedef struct Operand {
-  enum class Kind { Int, Real, Text, Id };
+  enum class Kind { Int, Real, Text, Id, Placeholder };
 
  public:
   Operand(Kind kind, Value value) : kind_(kind), value_(value) {}
@@ -23,20 +31,76 @@ typedef struct Operand {
   Value value_;
 } Operand;
 
+// A WHERE condition: comparisons of arithmetic expressions over operands,
+// combined with AND, OR and NOT.
 typedef struct Expression {
+  enum class Kind {
+    Operand,
+    Comparison,
+    Add,
+    Subtract,
+    Multiply,
+    Divide,
+    And,
+    Or,
+    Not
+  };
+  // Comparisons.
   enum class Operation { Less, Greater, LessEq, GreaterEq, Equal, NotEqual };
-  Expression(Operand first_operand, Operation operation, Operand second_operand)
-      : first_operand_(first_operand),
+
+  // A single operand, which lets `Expression(operand, operation, operand)`
+  // build the simplest condition.
+  Expression(Operand operand)  // NOLINT(google-explicit-constructor)
+      : kind_(Kind::Operand), operand_(operand) {}
+  Expression(Expression first, Operation operation, Expression second)
+      : kind_(Kind::Comparison),
         operation_(operation),
-        second_operand_(second_operand) {}
+        operands_{std::move(first), std::move(second)} {}
+  // Arithmetic, AND and OR take two operands, NOT takes one.
+  Expression(Kind kind, std::vector<Expression> operands)
+      : kind_(kind), operands_(std::move(operands)) {}
+
+  // True for comparisons, AND, OR and NOT, false for values.
+  bool is_condition() const {
+    return kind_ == Kind::Comparison || kind_ == Kind::And ||
+           kind_ == Kind::Or || kind_ == Kind::Not;
+  }
 
-  Operand first_operand_;
-  Operation operation_;
-  Operand second_operand_;
+  Kind kind_;
+  // Set for Kind::Operand.
+  std::optional<Operand> operand_;
+  // Used by Kind::Comparison.
+  Operation operation_ = Operation::Equal;
+  std::vector<Expression> operands_;
 } Expression;
 
 std::string operation_to_str(Expression::Operation operation);
 
+// Binding strength of an expression's operator: OR binds weakest, operands
+// strongest.
+int precedence(Expression::Kind kind);
+// The operator of a comparison, arithmetic, AND or OR, e.g. "<=".
+std::string binary_operator_to_str(const Expression& expression);
+
+// `JOIN table_name_ ON left_column_ = right_column_`, where either column
+// may belong to either table.
+typedef struct Join {
+ public:
+  Join(
+      std::string_view table_name,
+      std::string_view left_column,
+      std::string_view right_column)
+      : table_name_(table_name),
+        left_column_(left_column),
+        right_column_(right_column) {}
+
+  std::string_view table_name_;
+  std::string_view left_column_;
+  std::string_view right_column_;
+} Join;
+
+std::string expression_to_str(const Expression& expression);
+
 typedef struct ColumnDef {
   enum class Kind { Int, Real, Text };
 
@@ -49,14 +113,54 @@ typedef struct ColumnDef {
 
 std::string column_kind_to_str(ColumnDef::Kind kind);
 
+class DropTableStatement;
+class InsertStatement;
+class SelectStatement;
+class DeleteStatement;
+class CreateTableStatement;
+class ExplainStatement;
+class TransactionStatement;
+class AnalyzeStatement;
+
+class StatementVisitor {
+ public:
+  virtual ~StatementVisitor() = default;
+  virtual void visit(const DropTableStatement& statement) = 0;
+  virtual void visit(const InsertStatement& statement) = 0;
+  virtual void visit(const SelectStatement& statement) = 0;
+  virtual void visit(const DeleteStatement& statement) = 0;
+  virtual void visit(const CreateTableStatement& statement) = 0;
+  virtual void visit(const ExplainStatement& statement) = 0;
+  virtual void visit(const TransactionStatement& statement) = 0;
+  virtual void visit(const AnalyzeStatement& statement) = 0;
+};
+
 class Statement {
  public:
+  enum class Kind {
+    DropTable,
+    Insert,
+    Select,
+    Delete,
+    CreateTable,
+    Explain,
+    Begin,
+    Commit,
+    Rollback,
+    Analyze
+  };
+  static constexpr size_t kKindCount = 10;
+
   virtual ~Statement() = 0;
+  virtual Kind kind() const = 0;
   virtual std::string to_str() const = 0;
+  virtual void accept(StatementVisitor& visitor) const = 0;
 };
 
 using StatementPtr = std::unique_ptr<const Statement>;
 
+std::string_view statement_kind_to_str(Statement::Kind kind);
+
 class DropTableStatement : public Statement {
  public:
   explicit DropTableStatement(std::string_view table_name)
@@ -64,6 +168,10 @@ class DropTableStatement : public Statement {
 
   std::string_view table_name() const { return table_name_; }
   virtual std::string to_str() const;
+  Kind kind() const override { return Kind::DropTable; }
+  void accept(StatementVisitor& visitor) const override {
+    visitor.visit(*this);
+  }
 
  private:
   std::string_view table_name_;
@@ -85,6 +193,10 @@ class InsertStatement : public Statement {
   }
   const std::vector<Value>& values() const { return values_; }
   std::string to_str() const override;
+  Kind kind() const override { return Kind::Insert; }
+  void accept(StatementVisitor& visitor) const override {
+    visitor.visit(*this);
+  }
 
  private:
   std::string_view table_name_;
@@ -96,27 +208,80 @@ using InsertStatementPtr = std::unique_ptr<const InsertStatement>;
 
 class SelectStatement : public Statement {
  public:
+  // Applied to the column of the same index in the column list. COUNT(*)
+  // has the column name "*".
+  enum class Aggregate { None, Count, Sum, Min, Max, Avg };
+
+  // `ORDER BY column_ [ASC|DESC]`, where the column may be aggregated.
+  typedef struct OrderBy {
+   public:
+    OrderBy(Aggregate aggregate, std::string_view column, bool descending)
+        : aggregate_(aggregate), column_(column), descending_(descending) {}
+
+    Aggregate aggregate_;
+    std::string_view column_;
+    bool descending_;
+  } OrderBy;
+
+  // `aggregates` is either empty or has an entry for every column.
   SelectStatement(
       const std::vector<std::string_view>& column_list,
       std::string_view table_name,
-      std::optional<Expression> expression = std::nullopt)
+      std::optional<Expression> expression = std::nullopt,
+      std::vector<Aggregate> aggregates = {},
+      std::vector<std::string_view> group_by = {},
+      std::optional<Join> join = std::nullopt,
+      std::optional<OrderBy> order_by = std::nullopt,
+      std::optional<size_t> limit = std::nullopt)
       : column_list_(column_list),
         table_name_(table_name),
-        expression_(expression) {}
+        expression_(expression),
+        aggregates_(std::move(aggregates)),
+        group_by_(std::move(group_by)),
+        join_(join),
+        order_by_(order_by),
+        limit_(limit) {
+    aggregates_.resize(column_list_.size(), Aggregate::None);
+  }
 
   const std::vector<std::string_view>& column_list() const {
     return column_list_;
   }
   const std::string_view table_name() const { return table_name_; }
-  const std::optional<Expression> expression() const { return expression_; }
+  const std::optional<Expression>& expression() const { return expression_; }
+  const std::vector<Aggregate>& aggregates() const { return aggregates_; }
+  const std::vector<std::string_view>& group_by() const { return group_by_; }
+  // The second table of a two-table SELECT.
+  const std::optional<Join>& join() const { return join_; }
+  const std::optional<OrderBy>& order_by() const { return order_by_; }
+  // Maximum number of result rows.
+  const std::optional<size_t>& limit() const { return limit_; }
+  // True if the rows are aggregated into groups: with GROUP BY or any
+  // aggregate in the column list.
+  bool aggregated() const;
+  // The column or the aggregate at `index` as written, e.g. "SUM(Price)".
+  std::string item_to_str(size_t index) const;
+  // The ORDER BY item as written, e.g. "SUM(Price) DESC".
+  std::string order_by_to_str() const;
   virtual std::string to_str() const;
+  Kind kind() const override { return Kind::Select; }
+  void accept(StatementVisitor& visitor) const override {
+    visitor.visit(*this);
+  }
 
  private:
   std::vector<std::string_view> column_list_;
   std::string_view table_name_;
   std::optional<Expression> expression_;
+  std::vector<Aggregate> aggregates_;
+  std::vector<std::string_view> group_by_;
+  std::optional<Join> join_;
+  std::optional<OrderBy> order_by_;
+  std::optional<size_t> limit_;
 };
 
+std::string_view aggregate_to_str(SelectStatement::Aggregate aggregate);
+
 using SelectStatementPtr = std::unique_ptr<const SelectStatement>;
 
 class DeleteStatement : public Statement {
@@ -127,8 +292,12 @@ class DeleteStatement : public Statement {
       : table_name_(table_name), expression_(expression) {}
 
   const std::string_view table_name() const { return table_name_; }
-  const std::optional<Expression> expression() const { return expression_; }
+  const std::optional<Expression>& expression() const { return expression_; }
   std::string to_str() const override;
+  Kind kind() const override { return Kind::Delete; }
+  void accept(StatementVisitor& visitor) const override {
+    visitor.visit(*this);
+  }
 
  private:
   std::string_view table_name_;
@@ -147,6 +316,10 @@ class CreateTableStatement : public Statement {
   const std::string_view table_name() const { return table_name_; }
   const std::vector<ColumnDef>& column_defs() const { return column_defs_; }
   std::string to_str() const override;
+  Kind kind() const override { return Kind::CreateTable; }
+  void accept(StatementVisitor& visitor) const override {
+    visitor.visit(*this);
+  }
 
  private:
   std::string_view table_name_;
@@ -155,6 +328,62 @@ class CreateTableStatement : public Statement {
 
 using CreateTableStatementPtr = std::unique_ptr<const CreateTableStatement>;
 
+class ExplainStatement : public Statement {
+ public:
+  ExplainStatement(StatementPtr statement, bool analyze)
+      : statement_(std::move(statement)), analyze_(analyze) {}
+
+  const Statement& statement() const { return *statement_; }
+  bool analyze() const { return analyze_; }
+  std::string to_str() const override;
+  Kind kind() const override { return Kind::Explain; }
+  void accept(StatementVisitor& visitor) const override {
+    visitor.visit(*this);
+  }
+
+ private:
+  StatementPtr statement_;
+  bool analyze_;
+};
+
+using ExplainStatementPtr = std::unique_ptr<const ExplainStatement>;
+
+// BEGIN, COMMIT or ROLLBACK.
+class TransactionStatement : public Statement {
+ public:
+  explicit TransactionStatement(Kind kind) : kind_(kind) {}
+
+  std::string to_str() const override;
+  Kind kind() const override { return kind_; }
+  void accept(StatementVisitor& visitor) const override {
+    visitor.visit(*this);
+  }
+
+ private:
+  Kind kind_;
+};
+
+using TransactionStatementPtr = std::unique_ptr<const TransactionStatement>;
+
+// Rebuilds the statistics of a table.
+class AnalyzeStatement : public Statement {
+ public:
+  explicit AnalyzeStatement(std::string_view table_name)
+      : table_name_(table_name) {}
+
+  std::string_view table_name() const { return table_name_; }
+  std::string to_str() const override;
+  Kind kind() const override { return Kind::Analyze; }
+  void accept(StatementVisitor& visitor) const override {
+    visitor.visit(*this);
+  }
+
+ private:
+  std::string_view table_name_;
+};
+
+using AnalyzeStatementPtr = std::unique_ptr<const AnalyzeStatement>;
+
 std::ostream& operator<<(std::ostream& os, const Statement& statement);
 
 }  // namespace rdb::sql
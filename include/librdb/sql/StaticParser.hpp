@@ -0,0 +1,339 @@
+#pragma once
+
+#include <array>
+#include <climits>
+#include <cstdint>
+#include <librdb/sql/Scanner.hpp>
+#include <librdb/sql/Statements.hpp>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+// Parses a single statement at compile time:
+//
+//   using namespace rdb::sql::literals;
+//   constexpr auto kSelect = "SELECT Id FROM T WHERE Id > 5;"_sql;
+//   StatementPtr statement = kSelect.make();
+//
+// A syntax error in a constexpr context is a compile error. The grammar is the
+// one of Parser, restricted to one statement with at most kMaxStaticItems
+// columns or values and a single comparison of two operands in WHERE.
+namespace rdb::sql {
+
+constexpr size_t kMaxStaticItems = 16;
+
+class StaticSyntaxError : public std::logic_error {
+ public:
+  using std::logic_error::logic_error;
+};
+
+struct StaticOperand {
+  Operand::Kind kind_ = Operand::Kind::Int;
+  Value value_{};
+};
+
+// Text fields point into the source literal and numbers are already
+// converted, so make() neither lexes nor parses.
+struct StaticStatement {
+  enum class Kind { DropTable, Insert, Select, Delete, CreateTable };
+
+  Kind kind_ = Kind::DropTable;
+  std::string_view table_name_;
+  // Column names of INSERT, SELECT and CREATE TABLE.
+  std::array<std::string_view, kMaxStaticItems> names_{};
+  size_t name_count_ = 0;
+  std::array<ColumnDef::Kind, kMaxStaticItems> column_kinds_{};
+  std::array<Value, kMaxStaticItems> values_{};
+  size_t value_count_ = 0;
+  bool has_expression_ = false;
+  StaticOperand first_operand_;
+  Expression::Operation operation_ = Expression::Operation::Equal;
+  StaticOperand second_operand_;
+
+  StatementPtr make() const;
+};
+
+namespace detail {
+
+constexpr int parse_static_int(std::string_view text) {
+  const bool negative = text.front() == '-';
+  const size_t digits_begin =
+      (text.front() == '-' || text.front() == '+') ? 1 : 0;
+  constexpr int64_t kLimit = int64_t{INT_MAX} + 1;
+  int64_t value = 0;
+  for (size_t i = digits_begin; i < text.size(); ++i) {
+    value = value * 10 + (text[i] - '0');
+    if (value > kLimit) {
+      throw StaticSyntaxError("Integer literal is out of range");
+    }
+  }
+  if (!negative && value == kLimit) {
+    throw StaticSyntaxError("Integer literal is out of range");
+  }
+  return static_cast<int>(negative ? -value : value);
+}
+
+// Exact for literals with at most 15 digits: both the mantissa and the power
+// of ten are representable in a double, so the single division is correctly
+// rounded, just like strtod.
+constexpr float parse_static_real(std::string_view text) {
+  constexpr size_t kMaxDigits = 15;
+  const bool negative = text.front() == '-';
+  const size_t digits_begin =
+      (text.front() == '-' || text.front() == '+') ? 1 : 0;
+  uint64_t mantissa = 0;
+  size_t digits = 0;
+  double scale = 1;
+  bool fraction = false;
+  for (size_t i = digits_begin; i < text.size(); ++i) {
+    if (text[i] == '.') {
+      fraction = true;
+      continue;
+    }
+    mantissa = mantissa * 10 + static_cast<uint64_t>(text[i] - '0');
+    if (fraction) {
+      scale *= 10;
+    }
+    if (++digits > kMaxDigits) {
+      throw StaticSyntaxError("Real literal has too many digits");
+    }
+  }
+  const double value = static_cast<double>(mantissa) / scale;
+  return static_cast<float>(negative ? -value : value);
+}
+
+class StaticParser {
+ public:
+  constexpr explicit StaticParser(std::string_view input) : input_(input) {}
+
+  constexpr StaticStatement parse_statement() {
+    StaticStatement statement;
+    switch (peek().kind_) {
+      case Token::Kind::KwDrop:
+        parse_drop_table_statement(statement);
+        break;
+      case Token::Kind::KwInsert:
+        parse_insert_statement(statement);
+        break;
+      case Token::Kind::KwSelect:
+        parse_select_statement(statement);
+        break;
+      case Token::Kind::KwDelete:
+        parse_delete_statement(statement);
+        break;
+      case Token::Kind::KwCreate:
+        parse_create_table_statement(statement);
+        break;
+      default:
+        throw StaticSyntaxError("Expected statement type");
+    }
+    fetch(Token::Kind::Eof);
+    return statement;
+  }
+
+ private:
+  constexpr void parse_drop_table_statement(StaticStatement& statement) {
+    statement.kind_ = StaticStatement::Kind::DropTable;
+    fetch(Token::Kind::KwDrop);
+    fetch(Token::Kind::KwTable);
+    statement.table_name_ = fetch(Token::Kind::Id);
+    fetch(Token::Kind::Semicolon);
+  }
+
+  constexpr void parse_insert_statement(StaticStatement& statement) {
+    statement.kind_ = StaticStatement::Kind::Insert;
+    fetch(Token::Kind::KwInsert);
+    fetch(Token::Kind::KwInto);
+    statement.table_name_ = fetch(Token::Kind::Id);
+
+    fetch(Token::Kind::LBracket);
+    add_name(statement, fetch(Token::Kind::Id));
+    while (peek().kind_ == Token::Kind::Comma) {
+      fetch(Token::Kind::Comma);
+      add_name(statement, fetch(Token::Kind::Id));
+    }
+    fetch(Token::Kind::RBracket);
+    fetch(Token::Kind::KwValues);
+    fetch(Token::Kind::LBracket);
+
+    add_value(statement, parse_value());
+    while (peek().kind_ == Token::Kind::Comma) {
+      fetch(Token::Kind::Comma);
+      add_value(statement, parse_value());
+    }
+    fetch(Token::Kind::RBracket);
+    fetch(Token::Kind::Semicolon);
+  }
+
+  constexpr void parse_select_statement(StaticStatement& statement) {
+    statement.kind_ = StaticStatement::Kind::Select;
+    fetch(Token::Kind::KwSelect);
+    add_name(statement, fetch(Token::Kind::Id));
+    while (peek().kind_ == Token::Kind::Id) {
+      add_name(statement, fetch(Token::Kind::Id));
+    }
+    fetch(Token::Kind::KwFrom);
+    statement.table_name_ = fetch(Token::Kind::Id);
+    parse_where(statement);
+    fetch(Token::Kind::Semicolon);
+  }
+
+  constexpr void parse_delete_statement(StaticStatement& statement) {
+    statement.kind_ = StaticStatement::Kind::Delete;
+    fetch(Token::Kind::KwDelete);
+    fetch(Token::Kind::KwFrom);
+    statement.table_name_ = fetch(Token::Kind::Id);
+    parse_where(statement);
+    fetch(Token::Kind::Semicolon);
+  }
+
+  constexpr void parse_create_table_statement(StaticStatement& statement) {
+    statement.kind_ = StaticStatement::Kind::CreateTable;
+    fetch(Token::Kind::KwCreate);
+    fetch(Token::Kind::KwTable);
+    statement.table_name_ = fetch(Token::Kind::Id);
+
+    fetch(Token::Kind::LBracket);
+    parse_column_def(statement);
+    while (peek().kind_ == Token::Kind::Comma) {
+      fetch(Token::Kind::Comma);
+      parse_column_def(statement);
+    }
+    fetch(Token::Kind::RBracket);
+    fetch(Token::Kind::Semicolon);
+  }
+
+  constexpr void parse_where(StaticStatement& statement) {
+    if (peek().kind_ != Token::Kind::KwWhere) {
+      return;
+    }
+    fetch(Token::Kind::KwWhere);
+    statement.has_expression_ = true;
+    statement.first_operand_ = parse_operand();
+    switch (peek().kind_) {
+      case Token::Kind::OpLess:
+        statement.operation_ = Expression::Operation::Less;
+        break;
+      case Token::Kind::OpGreater:
+        statement.operation_ = Expression::Operation::Greater;
+        break;
+      case Token::Kind::OpLessEq:
+        statement.operation_ = Expression::Operation::LessEq;
+        break;
+      case Token::Kind::OpGreaterEq:
+        statement.operation_ = Expression::Operation::GreaterEq;
+        break;
+      case Token::Kind::OpEqual:
+        statement.operation_ = Expression::Operation::Equal;
+        break;
+      case Token::Kind::OpNotEqual:
+        statement.operation_ = Expression::Operation::NotEqual;
+        break;
+      default:
+        throw StaticSyntaxError("Expected OperationType");
+    }
+    fetch(peek().kind_);
+    statement.second_operand_ = parse_operand();
+  }
+
+  constexpr void parse_column_def(StaticStatement& statement) {
+    add_name(statement, fetch(Token::Kind::Id));
+    ColumnDef::Kind kind = ColumnDef::Kind::Int;
+    switch (peek().kind_) {
+      case Token::Kind::KwInt:
+        kind = ColumnDef::Kind::Int;
+        break;
+      case Token::Kind::KwReal:
+        kind = ColumnDef::Kind::Real;
+        break;
+      case Token::Kind::KwText:
+        kind = ColumnDef::Kind::Text;
+        break;
+      default:
+        throw StaticSyntaxError("Expected INT, REAL or TEXT");
+    }
+    fetch(peek().kind_);
+    statement.column_kinds_[statement.name_count_ - 1] = kind;
+  }
+
+  constexpr Value parse_value() {
+    const auto kind = peek().kind_;
+    if (kind == Token::Kind::Int) {
+      return parse_static_int(fetch(Token::Kind::Int));
+    }
+    if (kind == Token::Kind::Real) {
+      return parse_static_real(fetch(Token::Kind::Real));
+    }
+    if (kind == Token::Kind::String) {
+      return fetch(Token::Kind::String);
+    }
+    throw StaticSyntaxError("Expected Int, Real or String");
+  }
+
+  constexpr StaticOperand parse_operand() {
+    const auto kind = peek().kind_;
+    if (kind == Token::Kind::Id) {
+      return {Operand::Kind::Id, fetch(Token::Kind::Id)};
+    }
+    if (kind == Token::Kind::Int) {
+      return {Operand::Kind::Int, parse_value()};
+    }
+    if (kind == Token::Kind::Real) {
+      return {Operand::Kind::Real, parse_value()};
+    }
+    if (kind == Token::Kind::String) {
+      return {Operand::Kind::Text, parse_value()};
+    }
+    throw StaticSyntaxError("Expected Int, Real, String or Id");
+  }
+
+  static constexpr void add_name(
+      StaticStatement& statement,
+      std::string_view name) {
+    if (statement.name_count_ == kMaxStaticItems) {
+      throw StaticSyntaxError("Too many columns for a compile-time statement");
+    }
+    statement.names_[statement.name_count_++] = name;
+  }
+
+  static constexpr void add_value(StaticStatement& statement, Value value) {
+    if (statement.value_count_ == kMaxStaticItems) {
+      throw StaticSyntaxError("Too many values for a compile-time statement");
+    }
+    statement.values_[statement.value_count_++] = value;
+  }
+
+  constexpr scanner::ScannedToken peek() const {
+    return scanner::scan_token(input_, scanner::skip_spaces(input_, offset_));
+  }
+
+  constexpr std::string_view fetch(Token::Kind expected_kind) {
+    const auto token = peek();
+    if (token.kind_ != expected_kind) {
+      throw StaticSyntaxError(
+          "Expected " + std::string(kind_to_str(expected_kind)) + ", got " +
+          std::string(kind_to_str(token.kind_)));
+    }
+    offset_ = token.end_;
+    return input_.substr(token.begin_, token.end_ - token.begin_);
+  }
+
+  std::string_view input_;
+  size_t offset_ = 0;
+};
+
+}  // namespace detail
+
+constexpr StaticStatement parse_static(std::string_view input) {
+  return detail::StaticParser(input).parse_statement();
+}
+
+namespace literals {
+
+constexpr StaticStatement operator""_sql(const char* input, size_t size) {
+  return parse_static(std::string_view(input, size));
+}
+
+}  // namespace literals
+
+}  // namespace rdb::sql
@@ -20,12 +20,17 @@ class Token {
     Comma,
     LBracket,
     RBracket,
+    Placeholder,
     OpLess,
     OpGreater,
     OpLessEq,
     OpGreaterEq,
     OpEqual,
     OpNotEqual,
+    OpPlus,
+    OpMinus,
+    OpMultiply,
+    OpDivide,
     KwSelect,
     KwFrom,
     KwCreate,
@@ -38,7 +43,28 @@ class Token {
     KwDrop,
     KwInt,
     KwReal,
-    KwText
+    KwText,
+    KwExplain,
+    KwAnalyze,
+    KwAnd,
+    KwOr,
+    KwNot,
+    KwCount,
+    KwSum,
+    KwMin,
+    KwMax,
+    KwAvg,
+    KwGroup,
+    KwBy,
+    KwJoin,
+    KwOn,
+    KwOrder,
+    KwAsc,
+    KwDesc,
+    KwLimit,
+    KwBegin,
+    KwCommit,
+    KwRollback
   };
   Token(Kind kind, std::string_view text, const Location location)
       : kind_(kind), text_(text), location_(location) {}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <librdb/sql/Location.hpp>
+#include <librdb/sql/NewlineIndex.hpp>
+#include <librdb/sql/Token.hpp>
+#include <string_view>
+#include <vector>
+
+namespace rdb::sql {
+
+// All tokens of a script, lexed up front and stored as parallel arrays of
+// 1-byte kinds and 32-bit offsets and lengths: 9 bytes per token instead of
+// a Token's 48. The last token is always Eof. Rows and columns aren't
+// stored; location() looks them up in a newline index when needed.
+class TokenBuffer {
+ public:
+  // Throws std::length_error for inputs of 4 GiB and more.
+  explicit TokenBuffer(std::string_view input);
+
+  // Number of tokens, including the final Eof.
+  size_t size() const { return kinds_.size(); }
+
+  Token::Kind kind(size_t index) const { return Token::Kind(kinds_[index]); }
+  size_t offset(size_t index) const { return offsets_[index]; }
+  std::string_view text(size_t index) const;
+  Location location(size_t index) const;
+  Token token(size_t index) const;
+
+  std::string_view input() const { return input_; }
+
+ private:
+  std::string_view input_;
+  std::vector<uint8_t> kinds_;
+  std::vector<uint32_t> offsets_;
+  std::vector<uint32_t> lengths_;
+  NewlineIndex newlines_;
+};
+
+// Reads a TokenBuffer front to back with arbitrary lookahead. Reading past
+// the end keeps returning the final Eof.
+class TokenCursor {
+ public:
+  explicit TokenCursor(const TokenBuffer& tokens) : tokens_(&tokens) {}
+
+  Token::Kind kind(size_t ahead = 0) const {
+    return tokens_->kind(index(ahead));
+  }
+  std::string_view text(size_t ahead = 0) const {
+    return tokens_->text(index(ahead));
+  }
+
+  void advance() {
+    if (position_ + 1 < tokens_->size()) {
+      ++position_;
+    }
+  }
+  size_t position() const { return position_; }
+
+ private:
+  size_t index(size_t ahead) const {
+    return position_ + ahead < tokens_->size() ? position_ + ahead
+                                               : tokens_->size() - 1;
+  }
+
+  const TokenBuffer* tokens_;
+  size_t position_ = 0;
+};
+
+}  // namespace rdb::sql
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <librdb/exec/Catalog.hpp>
+#include <librdb/storage/StatementLog.hpp>
+#include <string>
+
+namespace rdb::storage {
+
+// A checkpoint is a CATALOG file naming the tables of a generation and one
+// file per table holding its table image, so loading maps the files and the
+// columns read their values in place; a column is only copied into memory
+// once it is written to.
+//
+// Generations start at 1; generation 0 is the empty state before the first
+// checkpoint. Statements applied on top of a generation are logged to
+// log_path() of that generation, so a crash right after a checkpoint never
+// replays statements that the checkpoint already holds.
+//
+// Writes the catalog into `directory` as a new generation, switches the
+// CATALOG file over to it atomically and then removes the table files and
+// the log of older generations. Returns the new generation. Throws
+// StorageError.
+uint64_t write_checkpoint(
+    const exec::Catalog& catalog,
+    const std::string& directory);
+
+// Adds the tables of the checkpoint in `directory`, which is created if
+// needed, to the catalog and returns its generation. Throws StorageError
+// if a file is damaged.
+uint64_t load_checkpoint(exec::Catalog& catalog, const std::string& directory);
+
+std::string log_path(const std::string& directory, uint64_t generation);
+
+}  // namespace rdb::storage
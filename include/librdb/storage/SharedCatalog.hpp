@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <librdb/exec/Catalog.hpp>
+#include <librdb/exec/Executor.hpp>
+#include <librdb/sql/Statements.hpp>
+#include <librdb/storage/StatementLog.hpp>
+#include <memory>
+#include <string>
+
+namespace rdb::storage {
+
+// A catalog published in POSIX shared memory, so that processes on one
+// host query the same tables without a copy of their own. The writer
+// process lays the tables out as table images in one of two slots and
+// publishes them under the next version; reader processes map the region
+// and run SELECTs on columns that read the images in place.
+//
+// Version v lives in slot v % 2. A slot's sequence is odd while the writer
+// fills it and 2 * v once it holds version v, as in a seqlock. For every
+// SELECT a reader counts itself into the slot of the last version and then
+// checks the sequence, and the writer waits for a slot's readers to leave
+// before it fills it again; so a slot never changes under a running
+// SELECT, and the writer only waits for SELECTs still running on the
+// version before the current one. A reader process that dies in the middle
+// of a SELECT blocks the writer.
+
+class SharedCatalogWriter {
+ public:
+  // Creates the shared memory object `name`, as named for shm_open(), with
+  // room for `slot_bytes` of table images per version. Throws StorageError
+  // if it exists or can't be created.
+  SharedCatalogWriter(std::string name, size_t slot_bytes);
+  // Removes the name; attached readers keep the region.
+  ~SharedCatalogWriter();
+
+  SharedCatalogWriter(const SharedCatalogWriter&) = delete;
+  SharedCatalogWriter& operator=(const SharedCatalogWriter&) = delete;
+
+  // Publishes the tables of `catalog`, which no statement may write to
+  // meanwhile, as the next version and returns it. Throws StorageError if
+  // they don't fit into a slot.
+  uint64_t publish(const exec::Catalog& catalog);
+
+  // The last published version, 0 before the first.
+  uint64_t version() const;
+
+ private:
+  std::string name_;
+  std::shared_ptr<void> region_;
+};
+
+class SharedCatalogReader {
+ public:
+  // Attaches to the region of a writer. Throws StorageError if there is
+  // none.
+  explicit SharedCatalogReader(const std::string& name);
+
+  SharedCatalogReader(const SharedCatalogReader&) = delete;
+  SharedCatalogReader& operator=(const SharedCatalogReader&) = delete;
+
+  // Runs the SELECT on the last published version; before the first there
+  // are no tables. Throws ExecutionError as Executor::execute() does.
+  exec::Result execute(const sql::SelectStatement& statement);
+
+  // The version the last SELECT ran on.
+  uint64_t version() const { return version_; }
+
+ private:
+  // Counts the reader into the slot of the last published version and
+  // returns the slot, switching the tables to that version if it's newer.
+  size_t enter();
+  void leave(size_t slot);
+  // Replaces the tables with those of `version` in `slot`.
+  void load(uint64_t version, size_t slot);
+
+  std::string name_;
+  std::shared_ptr<void> region_;
+  uint64_t version_ = 0;
+  // The tables of the version, valid while its slot's sequence is 2 *
+  // version_.
+  std::unique_ptr<exec::Catalog> catalog_;
+  std::unique_ptr<exec::Executor> executor_;
+};
+
+}  // namespace rdb::storage
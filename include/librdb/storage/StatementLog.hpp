@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <librdb/exec/Executor.hpp>
+#include <librdb/sql/Statements.hpp>
+#include <stdexcept>
+#include <string>
+
+namespace rdb::storage {
+
+class StorageError : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+// Append-only log of the write statements applied since the last
+// checkpoint. Records are a 4-byte payload length, a 4-byte checksum and a
+// binary encoding of the statement, in host byte order. A record that is
+// cut short or fails its checksum ends the log, so a crash in the middle of
+// a write loses only that record. A transaction is logged between BEGIN and
+// COMMIT records, and is lost as a whole if its COMMIT record is.
+class StatementLog : public exec::WriteLog {
+ public:
+  // Opens or creates the log. With `sync`, flush() waits for the data to
+  // reach the disk. Throws StorageError.
+  explicit StatementLog(std::string path, bool sync = true);
+  ~StatementLog();
+
+  StatementLog(const StatementLog&) = delete;
+  StatementLog& operator=(const StatementLog&) = delete;
+
+  // Buffers a record; nothing is written before flush().
+  void append(const sql::Statement& statement) override;
+  // Writes the buffered records. Throws StorageError.
+  void flush() override;
+  size_t flush_count() const { return flush_count_; }
+
+  struct Replayed {
+    size_t statements_ = 0;
+    // Where the last applied record ends. A torn record or a transaction
+    // without its COMMIT follows; truncate the log here before appending,
+    // or the next replay stops at them again.
+    uint64_t end_offset_ = 0;
+  };
+
+  // Executes the logged statements in order. The executor must not log
+  // them again. A missing log is empty. Throws StorageError if a logged
+  // statement fails, which means the log doesn't match the catalog.
+  static Replayed replay(const std::string& path, exec::Executor& executor);
+
+ private:
+  std::string path_;
+  bool sync_;
+  int fd_ = -1;
+  std::string buffer_;
+  size_t flush_count_ = 0;
+};
+
+}  // namespace rdb::storage
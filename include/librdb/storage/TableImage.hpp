@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <librdb/exec/Table.hpp>
+#include <librdb/storage/StatementLog.hpp>
+#include <memory>
+#include <string>
+
+namespace rdb::storage {
+
+// A table image holds a table's schema and column arrays, laid out so that
+// columns can read their values in place: every array starts at a 64-byte
+// aligned offset from the start of the image. Checkpoint table files and
+// shared catalogs are table images.
+
+// Receives an image front to back.
+class ImageWriter {
+ public:
+  virtual ~ImageWriter() = default;
+  virtual void append(const void* data, size_t size) = 0;
+};
+
+void write_table_image(const exec::Table& table, ImageWriter& writer);
+
+// A table whose columns read the `size` bytes at `image`, which must be
+// 64-byte aligned and stay unchanged while `owner` lives. Throws
+// StorageError naming `source` if the image is damaged.
+exec::TablePtr read_table_image(
+    std::shared_ptr<const void> owner,
+    const char* image,
+    size_t size,
+    const std::string& source);
+
+}  // namespace rdb::storage
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace rdb::sync {
+
+// Epoch-based reclamation: readers pin the global epoch while they use
+// objects of a shared structure, without taking any lock. A writer that
+// unlinks an object retires it, and the object is freed once every reader
+// that was pinned at that time has left its guard.
+
+// Pins the calling thread for its lifetime. Guards nest; only the outermost
+// one pins.
+class EpochGuard {
+ public:
+  EpochGuard();
+  ~EpochGuard();
+
+  EpochGuard(const EpochGuard&) = delete;
+  EpochGuard& operator=(const EpochGuard&) = delete;
+};
+
+// Starts a new epoch and returns the one that ended. Readers pinned after
+// this call see everything that was published before it.
+uint64_t advance_epoch();
+
+// The oldest epoch some thread is pinned at, or UINT64_MAX if none is.
+uint64_t oldest_pinned_epoch();
+
+// Objects retired by the writers of one structure. Not thread-safe: the
+// writers of the structure serialize on their own lock.
+template <typename T>
+class RetireList {
+ public:
+  // Call after the object has been unlinked, so that new readers can't
+  // reach it.
+  void retire(std::unique_ptr<const T> object) {
+    retired_.emplace_back(advance_epoch(), std::move(object));
+  }
+
+  // Frees the retired objects that no pinned reader can still see.
+  void reclaim() {
+    if (retired_.empty()) {
+      return;
+    }
+    const uint64_t oldest = oldest_pinned_epoch();
+    size_t kept = 0;
+    for (auto& retired : retired_) {
+      if (retired.first >= oldest) {
+        retired_[kept++] = std::move(retired);
+      }
+    }
+    retired_.resize(kept);
+  }
+
+  size_t size() const { return retired_.size(); }
+
+ private:
+  // The epoch that ended when the object was retired, and the object.
+  std::vector<std::pair<uint64_t, std::unique_ptr<const T>>> retired_;
+};
+
+}  // namespace rdb::sync
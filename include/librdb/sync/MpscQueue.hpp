@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <optional>
+#include <utility>
+
+namespace rdb::sync {
+
+// Unbounded queue from any number of producer threads to one consumer,
+// without locks: a linked list that producers append to with a single
+// exchange. Values pushed by one thread are popped in the order it pushed
+// them. A value whose push hasn't returned yet may not be visible to the
+// consumer, nor anything pushed after it by other threads.
+template <typename T>
+class MpscQueue {
+ public:
+  MpscQueue() : tail_(new Node), head_(tail_) {}
+  ~MpscQueue() {
+    while (tail_ != nullptr) {
+      Node* next = tail_->next_.load(std::memory_order_relaxed);
+      delete tail_;
+      tail_ = next;
+    }
+  }
+
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+
+  void push(T value) {
+    Node* node = new Node;
+    node->value_ = std::move(value);
+    Node* previous = head_.exchange(node, std::memory_order_acq_rel);
+    previous->next_.store(node, std::memory_order_release);
+  }
+
+  // Consumer only.
+  std::optional<T> try_pop() {
+    Node* next = tail_->next_.load(std::memory_order_acquire);
+    if (next == nullptr) {
+      return std::nullopt;
+    }
+    std::optional<T> value = std::move(next->value_);
+    delete tail_;
+    // The popped node stays as the list's sentinel.
+    tail_ = next;
+    return value;
+  }
+
+ private:
+  struct Node {
+    std::atomic<Node*> next_{nullptr};
+    T value_{};
+  };
+
+  // The sentinel, owned by the consumer; its successor is the oldest value.
+  Node* tail_;
+  // The newest node, where producers append.
+  std::atomic<Node*> head_;
+};
+
+}  // namespace rdb::sync
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace rdb::sync {
+
+// Bounded ring buffer between one producer and one consumer thread,
+// without locks. Each side keeps its index on a cache line of its own,
+// along with the last index it read of the other side, so it touches the
+// other side's line only when the queue looks full or empty.
+template <typename T>
+class SpscQueue {
+ public:
+  // The capacity is rounded up to a power of two.
+  explicit SpscQueue(size_t capacity) : slots_(round_up(capacity)) {}
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  // Producer only. Returns false, leaving `value` alone, if the queue is
+  // full.
+  bool try_push(T&& value) {
+    const size_t tail = producer_.index_.load(std::memory_order_relaxed);
+    if (tail - producer_.other_ == slots_.size()) {
+      producer_.other_ = consumer_.index_.load(std::memory_order_acquire);
+      if (tail - producer_.other_ == slots_.size()) {
+        return false;
+      }
+    }
+    slots_[tail & (slots_.size() - 1)] = std::move(value);
+    producer_.index_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer only.
+  std::optional<T> try_pop() {
+    const size_t head = consumer_.index_.load(std::memory_order_relaxed);
+    if (head == consumer_.other_) {
+      consumer_.other_ = producer_.index_.load(std::memory_order_acquire);
+      if (head == consumer_.other_) {
+        return std::nullopt;
+      }
+    }
+    std::optional<T> value = std::move(slots_[head & (slots_.size() - 1)]);
+    consumer_.index_.store(head + 1, std::memory_order_release);
+    return value;
+  }
+
+  // Either side; the other one may change it right away.
+  bool empty() const {
+    return consumer_.index_.load(std::memory_order_acquire) ==
+           producer_.index_.load(std::memory_order_acquire);
+  }
+
+  // Either side, with the same caveat.
+  size_t size() const {
+    // The consumer's index first, so that it can't pass the producer's.
+    const size_t head = consumer_.index_.load(std::memory_order_acquire);
+    return producer_.index_.load(std::memory_order_acquire) - head;
+  }
+
+  size_t capacity() const { return slots_.size(); }
+
+ private:
+  static size_t round_up(size_t capacity) {
+    size_t size = 1;
+    while (size < capacity) {
+      size *= 2;
+    }
+    return size;
+  }
+
+  struct alignas(64) Side {
+    // Slots taken by the consumer or filled by the producer so far.
+    std::atomic<size_t> index_{0};
+    // This side's latest view of the other side's index.
+    size_t other_ = 0;
+  };
+
+  std::vector<T> slots_;
+  Side producer_;
+  Side consumer_;
+};
+
+}  // namespace rdb::sync
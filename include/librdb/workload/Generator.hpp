@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace rdb::workload {
+
+// Relative frequencies of generated statement kinds.
+struct StatementMix {
+  unsigned create_table_ = 1;
+  unsigned drop_table_ = 1;
+  unsigned insert_ = 70;
+  unsigned select_ = 20;
+  unsigned delete_ = 5;
+  unsigned explain_ = 3;
+  // A transaction of up to 16 INSERTs and DELETEs, mostly committed.
+  unsigned transaction_ = 0;
+  unsigned analyze_ = 0;
+};
+
+struct GeneratorOptions {
+  uint64_t seed_ = 1;
+  StatementMix mix_;
+  // Tables alive at any moment, and the maximum number of columns in each.
+  size_t tables_ = 4;
+  size_t max_columns_ = 8;
+  // INT and REAL literals are drawn from `distinct_values_` ranks with a Zipf
+  // distribution of exponent `skew_`; 0 gives a uniform distribution.
+  size_t distinct_values_ = 1000;
+  double skew_ = 0;
+  size_t max_string_length_ = 16;
+  // Fraction of TEXT literals that are `long_string_length_` long.
+  double long_string_rate_ = 0;
+  size_t long_string_length_ = 4096;
+  // Fraction of DML statements made syntactically invalid.
+  double error_rate_ = 0;
+};
+
+// Generates a deterministic stream of SQL statements for a seed. The stream
+// starts with CREATE TABLE statements and only refers to tables and columns
+// that exist at that point, so without injected errors it executes cleanly.
+class Generator {
+ public:
+  explicit Generator(const GeneratorOptions& options);
+
+  std::string next_statement();
+
+  // Writes statements, one per line, until either limit is reached; a zero
+  // limit is ignored. Returns the number of statements written.
+  size_t write(std::ostream& out, size_t max_statements, size_t max_bytes);
+
+ private:
+  enum class ColumnKind { Int, Real, Text };
+
+  struct Table {
+    std::string name_;
+    std::vector<ColumnKind> columns_;
+  };
+
+  uint64_t next_random();
+  size_t uniform(size_t bound);
+  // Index of a weight, drawn in proportion to it, or `count` if all are 0.
+  size_t weighted(const unsigned* weights, size_t count);
+  bool chance(double probability);
+
+  std::string create_table();
+  std::string drop_table();
+  std::string insert();
+  std::string select();
+  std::string aggregate_select(const Table& table, bool grouped);
+  std::string aggregate(const Table& table);
+  // A JOIN on columns of one kind, if the tables have any.
+  std::optional<std::string> join_select(const Table& left, const Table& right);
+  std::string order_by(const std::string& item);
+  std::string delete_rows();
+  std::string explain();
+  std::string transaction_write();
+  std::string analyze();
+
+  std::string where(const Table& table);
+  // Column names start with `prefix`, which qualifies them in a JOIN.
+  std::string condition(
+      const Table& table,
+      size_t depth,
+      const std::string& prefix);
+  std::string comparison(const Table& table, const std::string& prefix);
+  std::string literal(ColumnKind kind);
+  std::string text_literal();
+  size_t value_rank();
+  std::string inject_error(std::string statement);
+
+  GeneratorOptions options_;
+  uint64_t state_;
+  std::vector<double> rank_cdf_;
+  std::vector<Table> tables_;
+  size_t next_table_id_ = 0;
+  // Writes left in the open transaction, which has none open at 0.
+  size_t transaction_writes_ = 0;
+};
+
+}  // namespace rdb::workload
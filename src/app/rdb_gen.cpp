@@ -0,0 +1,89 @@
+#include <CLI/CLI.hpp>
+#include <fstream>
+#include <iostream>
+#include <librdb/workload/Generator.hpp>
+#include <string>
+
+int main(int argc, char** argv) {
+  CLI::App app("Generates deterministic SQL workloads");
+  rdb::workload::GeneratorOptions options;
+  rdb::workload::StatementMix& mix = options.mix_;
+  size_t statements = 0;
+  std::string size;
+  std::string output;
+
+  app.add_option("--seed", options.seed_, "Random seed");
+  app.add_option("-n,--statements", statements, "Number of statements");
+  app.add_option("--size", size, "Approximate script size, e.g. 512M or 2G");
+  app.add_option("-o,--output", output, "Output file (stdout by default)");
+  app.add_option("--tables", options.tables_, "Tables alive at a time");
+  app.add_option("--columns", options.max_columns_, "Maximum table width");
+  app.add_option(
+      "--distinct", options.distinct_values_, "Distinct numeric values");
+  app.add_option("--skew", options.skew_, "Zipf exponent of numeric values");
+  app.add_option(
+      "--string-length",
+      options.max_string_length_,
+      "Maximum short string length");
+  app.add_option(
+         "--long-string-rate",
+         options.long_string_rate_,
+         "Fraction of long strings")
+      ->check(CLI::Range(0.0, 1.0));
+  app.add_option(
+      "--long-string-length",
+      options.long_string_length_,
+      "Long string length");
+  app.add_option(
+         "--error-rate",
+         options.error_rate_,
+         "Fraction of invalid DML statements")
+      ->check(CLI::Range(0.0, 1.0));
+  app.add_option("--create", mix.create_table_, "Weight of CREATE TABLE");
+  app.add_option("--drop", mix.drop_table_, "Weight of DROP TABLE");
+  app.add_option("--insert", mix.insert_, "Weight of INSERT");
+  app.add_option("--select", mix.select_, "Weight of SELECT");
+  app.add_option("--delete", mix.delete_, "Weight of DELETE");
+  app.add_option("--explain", mix.explain_, "Weight of EXPLAIN");
+  app.add_option(
+      "--transaction", mix.transaction_, "Weight of BEGIN ... COMMIT");
+  app.add_option("--analyze", mix.analyze_, "Weight of ANALYZE");
+  CLI11_PARSE(app, argc, argv);
+
+  size_t max_bytes = 0;
+  if (!size.empty()) {
+    try {
+      size_t suffix_pos = 0;
+      max_bytes = std::stoull(size, &suffix_pos);
+      const std::string suffix = size.substr(suffix_pos);
+      if (suffix == "K") {
+        max_bytes <<= 10U;
+      } else if (suffix == "M") {
+        max_bytes <<= 20U;
+      } else if (suffix == "G") {
+        max_bytes <<= 30U;
+      } else if (!suffix.empty()) {
+        throw std::invalid_argument(suffix);
+      }
+    } catch (const std::logic_error&) {
+      std::cerr << "Invalid --size " << size << '\n';
+      return 1;
+    }
+  }
+  if (statements == 0 && max_bytes == 0) {
+    statements = 1000;
+  }
+
+  rdb::workload::Generator generator(options);
+  if (output.empty()) {
+    generator.write(std::cout, statements, max_bytes);
+    return 0;
+  }
+  std::ofstream out(output);
+  if (!out) {
+    std::cerr << "Can't open " << output << '\n';
+    return 1;
+  }
+  generator.write(out, statements, max_bytes);
+  return out ? 0 : 1;
+}
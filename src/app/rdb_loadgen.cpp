@@ -0,0 +1,153 @@
+#include <CLI/CLI.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <iostream>
+#include <librdb/net/Client.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct WorkerStats {
+  std::vector<double> latencies_us_;
+  uint64_t statements_ = 0;
+  uint64_t errors_ = 0;
+};
+
+// Collects frames up to and including the Done frame of one script.
+void read_script_response(rdb::net::Client& client, WorkerStats& stats) {
+  while (true) {
+    const rdb::net::Frame frame = client.read_frame();
+    if (frame.type_ == rdb::net::FrameType::Error) {
+      ++stats.errors_;
+    }
+    if (frame.type_ == rdb::net::FrameType::Done) {
+      stats.statements_ += rdb::net::decode_done(frame.payload_);
+      return;
+    }
+  }
+}
+
+void run_worker(
+    const std::string& socket_path,
+    const std::string& script,
+    size_t requests,
+    size_t pipeline_depth,
+    WorkerStats& stats) {
+  rdb::net::Client client(socket_path);
+  std::deque<Clock::time_point> in_flight;
+  size_t sent = 0;
+  while (sent < requests || !in_flight.empty()) {
+    while (sent < requests && in_flight.size() < pipeline_depth) {
+      in_flight.push_back(Clock::now());
+      client.send_script(script);
+      ++sent;
+    }
+    read_script_response(client, stats);
+    const std::chrono::duration<double, std::micro> latency =
+        Clock::now() - in_flight.front();
+    in_flight.pop_front();
+    stats.latencies_us_.push_back(latency.count());
+  }
+}
+
+double percentile(const std::vector<double>& sorted, double fraction) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  const auto index = static_cast<size_t>(fraction * double(sorted.size() - 1));
+  return sorted[index];
+}
+
+bool run_setup(const std::string& socket_path, const std::string& setup) {
+  rdb::net::Client client(socket_path);
+  client.send_script(setup);
+  WorkerStats stats;
+  read_script_response(client, stats);
+  return stats.errors_ == 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  CLI::App app("Load generator for rdb_server");
+  std::string socket_path = "/tmp/rdb.sock";
+  std::string setup =
+      "CREATE TABLE Bench (Id INT, Value REAL, Name TEXT);"
+      "INSERT INTO Bench (Id, Value, Name) VALUES (1, 1.5, \"one\");";
+  std::string script = "SELECT Id Value Name FROM Bench WHERE Id = 1;";
+  std::vector<size_t> concurrency_levels = {1, 2, 4, 8};
+  size_t requests = 10000;
+  size_t pipeline_depth = 1;
+  app.add_option("-s,--socket", socket_path, "Server socket path");
+  app.add_option("--setup", setup, "Script sent once before the run");
+  app.add_option("--script", script, "Script sent by every request");
+  app.add_option("-c,--concurrency", concurrency_levels, "Connection counts")
+      ->delimiter(',');
+  app.add_option("-n,--requests", requests, "Requests per connection");
+  app.add_option(
+         "-p,--pipeline", pipeline_depth, "Requests in flight per connection")
+      ->check(CLI::PositiveNumber);
+  CLI11_PARSE(app, argc, argv);
+
+  try {
+    if (!setup.empty() && !run_setup(socket_path, setup)) {
+      std::cerr << "Setup script failed\n";
+    }
+
+    std::printf(
+        "%11s %12s %14s %10s %10s %8s\n",
+        "connections",
+        "scripts/s",
+        "statements/s",
+        "p50 us",
+        "p99 us",
+        "errors");
+    for (const size_t connections : concurrency_levels) {
+      std::vector<WorkerStats> stats(connections);
+      std::vector<std::thread> workers;
+      const auto start = Clock::now();
+      for (size_t i = 0; i < connections; ++i) {
+        workers.emplace_back(
+            run_worker,
+            std::cref(socket_path),
+            std::cref(script),
+            requests,
+            pipeline_depth,
+            std::ref(stats[i]));
+      }
+      for (auto& worker : workers) {
+        worker.join();
+      }
+      const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+      WorkerStats total;
+      for (const auto& worker_stats : stats) {
+        total.latencies_us_.insert(
+            total.latencies_us_.end(),
+            worker_stats.latencies_us_.begin(),
+            worker_stats.latencies_us_.end());
+        total.statements_ += worker_stats.statements_;
+        total.errors_ += worker_stats.errors_;
+      }
+      std::sort(total.latencies_us_.begin(), total.latencies_us_.end());
+      std::printf(
+          "%11zu %12.0f %14.0f %10.1f %10.1f %8llu\n",
+          connections,
+          double(total.latencies_us_.size()) / elapsed.count(),
+          double(total.statements_) / elapsed.count(),
+          percentile(total.latencies_us_, 0.5),
+          percentile(total.latencies_us_, 0.99),
+          static_cast<unsigned long long>(total.errors_));
+    }
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,268 @@
+#include <unistd.h>
+
+#include <CLI/CLI.hpp>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <librdb/exec/Executor.hpp>
+#include <librdb/exec/ResultCache.hpp>
+#include <librdb/metrics/Metrics.hpp>
+#include <librdb/net/Server.hpp>
+#include <librdb/storage/Checkpoint.hpp>
+#include <librdb/sql/Parser.hpp>
+#include <librdb/sql/PipelinedParser.hpp>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace {
+
+rdb::net::Server* running_server = nullptr;
+
+void handle_signal(int /*signal*/) {
+  if (running_server != nullptr) {
+    running_server->stop();
+  }
+}
+
+// Runs the statements while the rest of the script is parsed, up to the
+// first error of either kind.
+bool load_script_pipelined(
+    rdb::exec::Executor& executor,
+    const std::string& path,
+    const std::string& sql) {
+  constexpr size_t kQueueCapacity = 64;
+  rdb::sql::PipelinedParser parser(sql, kQueueCapacity);
+  size_t executed = 0;
+  while (const auto result = parser.next()) {
+    for (const auto& error : result->errors_) {
+      std::cerr << path << ": " << error << '\n';
+      return false;
+    }
+    try {
+      executor.execute(*result->script_.statements_.front());
+    } catch (const rdb::exec::ExecutionError& e) {
+      std::cerr << path << ": " << e.what() << '\n';
+      return false;
+    }
+    ++executed;
+  }
+  std::cout << "Loaded " << executed << " statements from " << path << '\n';
+  return true;
+}
+
+bool load_script(
+    rdb::exec::Executor& executor,
+    const std::string& path,
+    bool pipelined) {
+  std::ifstream input(path);
+  if (!input) {
+    std::cerr << "Can't open " << path << '\n';
+    return false;
+  }
+  std::stringstream buffer;
+  buffer << input.rdbuf();
+  const std::string sql = buffer.str();
+  if (pipelined) {
+    return load_script_pipelined(executor, path, sql);
+  }
+
+  const rdb::sql::TokenBuffer tokens(sql);
+  rdb::sql::Parser parser(tokens);
+  const auto result = parser.parse_sql_script();
+  for (const auto& error : result.errors_) {
+    std::cerr << path << ": " << error << '\n';
+  }
+  if (!result.errors_.empty()) {
+    return false;
+  }
+  try {
+    for (const auto& statement : result.script_.statements_) {
+      executor.execute(*statement);
+    }
+  } catch (const rdb::exec::ExecutionError& e) {
+    std::cerr << path << ": " << e.what() << '\n';
+    return false;
+  }
+  std::cout << "Loaded " << result.script_.statements_.size()
+            << " statements from " << path << '\n';
+  return true;
+}
+
+// Periodically writes the metrics snapshot for a textfile collector.
+class MetricsWriter {
+ public:
+  MetricsWriter(std::string path, std::chrono::seconds interval)
+      : path_(std::move(path)),
+        interval_(interval),
+        thread_([this] { run(); }) {}
+
+  ~MetricsWriter() {
+    {
+      const std::lock_guard lock(mutex_);
+      stopped_ = true;
+    }
+    stop_.notify_one();
+    thread_.join();
+    write();
+  }
+
+  MetricsWriter(const MetricsWriter&) = delete;
+  MetricsWriter& operator=(const MetricsWriter&) = delete;
+
+ private:
+  void run() {
+    std::unique_lock lock(mutex_);
+    while (!stop_.wait_for(lock, interval_, [this] { return stopped_; })) {
+      write();
+    }
+  }
+
+  void write() const {
+    try {
+      rdb::metrics::Registry::global().write_prometheus(path_);
+    } catch (const std::system_error& e) {
+      std::cerr << e.what() << '\n';
+    }
+  }
+
+  std::string path_;
+  std::chrono::seconds interval_;
+  std::mutex mutex_;
+  std::condition_variable stop_;
+  bool stopped_ = false;
+  std::thread thread_;
+};
+
+// Loads the last checkpoint, replays the statements logged after it and
+// opens the log for new ones after the last good record.
+std::unique_ptr<rdb::storage::StatementLog> recover(
+    rdb::exec::Catalog& catalog, const std::string& data_dir) {
+  const auto start = std::chrono::steady_clock::now();
+  const uint64_t generation = rdb::storage::load_checkpoint(catalog, data_dir);
+  const std::string log_path = rdb::storage::log_path(data_dir, generation);
+  rdb::exec::Executor replay_executor(catalog);
+  const auto replayed =
+      rdb::storage::StatementLog::replay(log_path, replay_executor);
+  // New records would otherwise follow a torn one, and the next recovery
+  // would stop before them.
+  const auto end = static_cast<off_t>(replayed.end_offset_);
+  if (::truncate(log_path.c_str(), end) != 0 && errno != ENOENT) {
+    throw rdb::storage::StorageError(
+        "Can't truncate " + log_path + ": " + std::strerror(errno));
+  }
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  std::cout << "Recovered " << catalog.tables().size() << " tables and "
+            << replayed.statements_ << " logged statements in "
+            << elapsed.count() << " s" << std::endl;
+  return std::make_unique<rdb::storage::StatementLog>(log_path);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  CLI::App app("Serves SQL scripts over a Unix domain socket");
+  std::string socket_path = "/tmp/rdb.sock";
+  std::string init_script;
+  bool pipeline_init = false;
+  std::string metrics_file;
+  unsigned metrics_interval = 10;
+  size_t result_cache_bytes = 0;
+  std::string data_dir;
+  size_t statement_memory_limit = 0;
+  size_t session_memory_limit = 0;
+  app.add_option("-s,--socket", socket_path, "Socket path");
+  app.add_option("-i,--init", init_script, "SQL script to run at startup")
+      ->check(CLI::ExistingFile);
+  app.add_flag(
+      "--pipeline-init",
+      pipeline_init,
+      "Run the init script while it is parsed, so that a syntax error stops "
+      "it after the statements before it instead of rejecting it whole");
+  app.add_option(
+      "--metrics-file", metrics_file, "Prometheus text file to update");
+  app.add_option(
+         "--metrics-interval", metrics_interval, "Seconds between updates")
+      ->check(CLI::PositiveNumber);
+  app.add_option(
+      "--result-cache-bytes",
+      result_cache_bytes,
+      "Memory for cached SELECT results, 0 to disable");
+  app.add_option(
+      "--data-dir",
+      data_dir,
+      "Directory for the checkpoint and the statement log; tables are kept "
+      "in memory only without it");
+  app.add_option(
+      "--statement-memory-limit",
+      statement_memory_limit,
+      "Bytes a statement may use for its buffers, 0 for no limit");
+  app.add_option(
+      "--session-memory-limit",
+      session_memory_limit,
+      "Bytes the statements of a connection may use, 0 for no limit");
+  CLI11_PARSE(app, argc, argv);
+
+  std::optional<MetricsWriter> metrics_writer;
+  if (!metrics_file.empty()) {
+    metrics_writer.emplace(
+        metrics_file, std::chrono::seconds(metrics_interval));
+  }
+
+  rdb::exec::Catalog catalog;
+  std::optional<rdb::exec::ResultCache> result_cache;
+  if (result_cache_bytes != 0) {
+    result_cache.emplace(result_cache_bytes);
+  }
+  std::unique_ptr<rdb::storage::StatementLog> log;
+  if (!data_dir.empty()) {
+    try {
+      log = recover(catalog, data_dir);
+    } catch (const rdb::storage::StorageError& e) {
+      std::cerr << e.what() << '\n';
+      return 1;
+    }
+  }
+  rdb::exec::Executor executor(
+      catalog, result_cache ? &*result_cache : nullptr, log.get());
+  if (statement_memory_limit != 0) {
+    executor.set_statement_memory_limit(statement_memory_limit);
+  }
+  if (!init_script.empty() &&
+      !load_script(executor, init_script, pipeline_init)) {
+    return 1;
+  }
+
+  try {
+    rdb::net::Server server(
+        executor,
+        socket_path,
+        session_memory_limit != 0 ? std::optional(session_memory_limit)
+                                  : std::nullopt);
+    running_server = &server;
+    std::signal(SIGINT, handle_signal);
+    std::signal(SIGTERM, handle_signal);
+    std::cout << "Listening on " << socket_path << std::endl;
+    server.run();
+    running_server = nullptr;
+    if (log) {
+      // The next start maps the tables instead of replaying the log.
+      rdb::storage::write_checkpoint(catalog, data_dir);
+    }
+  } catch (const std::system_error& e) {
+    std::cerr << e.what() << '\n';
+    return 1;
+  } catch (const rdb::storage::StorageError& e) {
+    std::cerr << e.what() << '\n';
+    return 1;
+  }
+  return 0;
+}
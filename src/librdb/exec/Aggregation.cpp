@@ -0,0 +1,899 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <functional>
+#include <librdb/exec/Aggregation.hpp>
+#include <librdb/exec/Executor.hpp>
+#include <librdb/exec/Parallel.hpp>
+#include <librdb/memory/MemoryTracker.hpp>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace rdb::exec {
+
+namespace {
+
+using Aggregate = sql::SelectStatement::Aggregate;
+
+// Groups numbered in the order they are first seen, keyed by the bytes of
+// their GROUP BY values. Open addressing with linear probing, at most half
+// full.
+class GroupTable {
+ public:
+  size_t size() const { return hashes_.size(); }
+
+  std::string_view key(uint32_t group) const {
+    return std::string_view(keys_).substr(
+        offsets_[group], offsets_[group + 1] - offsets_[group]);
+  }
+
+  // Returns the group of the key, adding it if it is new.
+  uint32_t find_or_add(std::string_view key) {
+    if ((size() + 1) * 2 > slots_.size()) {
+      grow();
+    }
+    const size_t hash = std::hash<std::string_view>()(key);
+    const size_t mask = slots_.size() - 1;
+    size_t slot = hash & mask;
+    while (slots_[slot] != 0) {
+      const uint32_t group = slots_[slot] - 1;
+      if (hashes_[group] == hash && this->key(group) == key) {
+        return group;
+      }
+      slot = (slot + 1) & mask;
+    }
+    const auto group = static_cast<uint32_t>(size());
+    slots_[slot] = group + 1;
+    hashes_.push_back(hash);
+    keys_.append(key);
+    offsets_.push_back(keys_.size());
+    return group;
+  }
+
+ private:
+  void grow() {
+    memory::Vector<uint32_t> slots(std::max<size_t>(slots_.size() * 2, 16), 0);
+    const size_t mask = slots.size() - 1;
+    for (uint32_t group = 0; group < size(); ++group) {
+      size_t slot = hashes_[group] & mask;
+      while (slots[slot] != 0) {
+        slot = (slot + 1) & mask;
+      }
+      slots[slot] = group + 1;
+    }
+    slots_ = std::move(slots);
+  }
+
+  // Group + 1, 0 for an empty slot.
+  memory::Vector<uint32_t> slots_;
+  memory::Vector<size_t> hashes_;
+  std::string keys_;
+  memory::Vector<size_t> offsets_ = {0};
+};
+
+// Groups keyed by at most two INT or REAL values, packed into 64 bits in
+// an order that sorts the groups by their values. The common case of few
+// narrow GROUP BY columns is cheaper to hash and to sort this way.
+class PackedGroupTable {
+ public:
+  size_t size() const { return keys_.size(); }
+
+  uint64_t key(uint32_t group) const { return keys_[group]; }
+
+  // Returns the group of the key, adding it if it is new.
+  uint32_t find_or_add(uint64_t key) {
+    if ((size() + 1) * 2 > slots_.size()) {
+      grow();
+    }
+    const size_t mask = slots_.size() - 1;
+    size_t slot = hash(key);
+    while (slots_[slot].group_ != 0) {
+      if (slots_[slot].key_ == key) {
+        return slots_[slot].group_ - 1;
+      }
+      slot = (slot + 1) & mask;
+    }
+    const auto group = static_cast<uint32_t>(size());
+    slots_[slot] = {key, group + 1};
+    keys_.push_back(key);
+    return group;
+  }
+
+ private:
+  struct Slot {
+    uint64_t key_ = 0;
+    // Group + 1, 0 for an empty slot.
+    uint32_t group_ = 0;
+  };
+
+  // Fibonacci hashing: the high bits of the product depend on all bits of
+  // the key.
+  size_t hash(uint64_t key) const {
+    return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> shift_);
+  }
+
+  void grow() {
+    const size_t slot_count = std::max<size_t>(slots_.size() * 2, 16);
+    shift_ = 64;
+    for (size_t size = slot_count; size > 1; size /= 2) {
+      --shift_;
+    }
+    memory::Vector<Slot> slots(slot_count);
+    const size_t mask = slot_count - 1;
+    for (uint32_t group = 0; group < size(); ++group) {
+      size_t slot = hash(keys_[group]);
+      while (slots[slot].group_ != 0) {
+        slot = (slot + 1) & mask;
+      }
+      slots[slot] = {keys_[group], group + 1};
+    }
+    slots_ = std::move(slots);
+  }
+
+  memory::Vector<Slot> slots_;
+  unsigned shift_ = 64;
+  memory::Vector<uint64_t> keys_;
+};
+
+template <typename T>
+void append_bytes(std::string& key, T value) {
+  char bytes[sizeof(T)];
+  std::memcpy(bytes, &value, sizeof(T));
+  key.append(bytes, sizeof(T));
+}
+
+template <typename T>
+T read_bytes(std::string_view& key) {
+  T value;
+  std::memcpy(&value, key.data(), sizeof(T));
+  key.remove_prefix(sizeof(T));
+  return value;
+}
+
+// Sum of `count` contiguous values. Each lane adds every eighth value, so
+// the lanes are independent and the loop is vectorized even for floating
+// point, where the compiler may not reorder a single running sum.
+template <typename Sum, typename T>
+Sum sum_of(const T* values, size_t count) {
+  constexpr size_t kLanes = 8;
+  std::array<Sum, kLanes> sums{};
+  size_t i = 0;
+  for (; i + kLanes <= count; i += kLanes) {
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+      sums[lane] += static_cast<Sum>(values[i + lane]);
+    }
+  }
+  Sum sum = 0;
+  for (const Sum lane_sum : sums) {
+    sum += lane_sum;
+  }
+  for (; i < count; ++i) {
+    sum += static_cast<Sum>(values[i]);
+  }
+  return sum;
+}
+
+// Minimum (Compare = std::less<>) or maximum (std::greater<>) of `count`
+// contiguous values, at least one.
+template <typename Compare, typename T>
+T extremum_of(const T* values, size_t count) {
+  constexpr size_t kLanes = 8;
+  std::array<T, kLanes> best;
+  best.fill(values[0]);
+  size_t i = 0;
+  for (; i + kLanes <= count; i += kLanes) {
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+      best[lane] = Compare()(values[i + lane], best[lane]) ? values[i + lane]
+                                                          : best[lane];
+    }
+  }
+  T result = best[0];
+  for (const T value : best) {
+    result = Compare()(value, result) ? value : result;
+  }
+  for (; i < count; ++i) {
+    result = Compare()(values[i], result) ? values[i] : result;
+  }
+  return result;
+}
+
+// Combines `value` into the aggregate `state` of a group that already has
+// one.
+template <typename T>
+void combine(Aggregate aggregate, T& state, const T& value) {
+  switch (aggregate) {
+    case Aggregate::Min:
+      if (value < state) {
+        state = value;
+      }
+      break;
+    case Aggregate::Max:
+      if (state < value) {
+        state = value;
+      }
+      break;
+    default:
+      state += value;
+      break;
+  }
+}
+
+template <>
+void combine(
+    Aggregate aggregate,
+    std::string& state,
+    const std::string& value) {
+  if (aggregate == Aggregate::Min ? value < state : state < value) {
+    state = value;
+  }
+}
+
+// Combines the value of each row into the state of the row's group. A
+// group's state is added when its first row is seen, which happens in
+// group order because groups are numbered in the order of their rows.
+template <typename S, typename T, typename Combine>
+void accumulate(
+    memory::Vector<S>& states,
+    const uint32_t* groups,
+    const uint16_t* positions,
+    const T* values,
+    size_t count,
+    Combine combine) {
+  for (size_t i = 0; i < count; ++i) {
+    const uint32_t group = groups[i];
+    const auto value = static_cast<S>(values[positions[i]]);
+    if (group == states.size()) {
+      states.push_back(value);
+    } else {
+      combine(states[group], value);
+    }
+  }
+}
+
+template <typename S, typename T>
+void accumulate(
+    Aggregate aggregate,
+    memory::Vector<S>& states,
+    const uint32_t* groups,
+    const uint16_t* positions,
+    const T* values,
+    size_t count) {
+  switch (aggregate) {
+    case Aggregate::Min:
+      accumulate(
+          states, groups, positions, values, count,
+          [](S& state, S value) { state = value < state ? value : state; });
+      break;
+    case Aggregate::Max:
+      accumulate(
+          states, groups, positions, values, count,
+          [](S& state, S value) { state = state < value ? value : state; });
+      break;
+    default:
+      accumulate(
+          states, groups, positions, values, count,
+          [](S& state, S value) { state += value; });
+      break;
+  }
+}
+
+}  // namespace
+
+class Aggregation::Partial {
+ public:
+  explicit Partial(const Aggregation& aggregation)
+      : aggregation_(aggregation),
+        packed_(aggregation.group_columns_.size() <= 2),
+        states_(aggregation.items_.size()),
+        decoded_blocks_(
+            aggregation.table_.columns().size(),
+            std::numeric_limits<size_t>::max()),
+        block_data_(aggregation.table_.columns().size()),
+        int_scratch_(aggregation.table_.columns().size()),
+        float_scratch_(aggregation.table_.columns().size()) {
+    for (const size_t column_index : aggregation.group_columns_) {
+      packed_ = packed_ && column(column_index).kind() != Column::Kind::Text;
+    }
+    if (grouped()) {
+      return;
+    }
+    // Without GROUP BY there is one group even if there are no rows.
+    packed_groups_.find_or_add(0);
+    counts_.push_back(0);
+    for (size_t i = 0; i < states_.size(); ++i) {
+      states_[i].ints_.resize(1);
+      states_[i].reals_.resize(1);
+      states_[i].texts_.resize(1);
+    }
+  }
+
+  // Aggregates `count` rows in ascending order.
+  void add(const size_t* rows, size_t count) {
+    const size_t* end = rows + count;
+    while (rows != end) {
+      const size_t block = *rows / kBlockRows;
+      const size_t* block_end =
+          std::lower_bound(rows, end, (block + 1) * kBlockRows);
+      add_block(block, rows, static_cast<size_t>(block_end - rows));
+      rows = block_end;
+    }
+  }
+
+  void merge(const Partial& other) {
+    for (uint32_t other_group = 0; other_group < other.counts_.size();
+         ++other_group) {
+      const int64_t other_count = other.counts_[other_group];
+      if (other_count == 0) {
+        continue;
+      }
+      const uint32_t group =
+          packed_ ? packed_groups_.find_or_add(
+                        other.packed_groups_.key(other_group))
+                  : groups_.find_or_add(other.groups_.key(other_group));
+      const bool added = group == counts_.size();
+      if (added) {
+        counts_.push_back(0);
+      }
+      const bool assign = counts_[group] == 0;
+      counts_[group] += other_count;
+      for (size_t i = 0; i < states_.size(); ++i) {
+        const Aggregate aggregate = aggregation_.items_[i].aggregate_;
+        switch (aggregation_.items_[i].state_) {
+          case State::None:
+            break;
+          case State::Int:
+            merge_state(
+                aggregate, added, assign, states_[i].ints_, group,
+                other.states_[i].ints_[other_group]);
+            break;
+          case State::Real:
+            merge_state(
+                aggregate, added, assign, states_[i].reals_, group,
+                other.states_[i].reals_[other_group]);
+            break;
+          case State::Text:
+            merge_state(
+                aggregate, added, assign, states_[i].texts_, group,
+                other.states_[i].texts_[other_group]);
+            break;
+        }
+      }
+    }
+  }
+
+  std::vector<std::vector<Cell>> rows() const {
+    const auto& items = aggregation_.items_;
+    std::vector<uint32_t> order(counts_.size());
+    std::vector<std::vector<Cell>> keys;
+    if (packed_) {
+      // Sorted next to their keys, which is faster than looking them up.
+      std::vector<std::pair<uint64_t, uint32_t>> sorted(order.size());
+      for (uint32_t group = 0; group < order.size(); ++group) {
+        sorted[group] = {packed_groups_.key(group), group};
+      }
+      std::sort(sorted.begin(), sorted.end());
+      for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = sorted[i].second;
+      }
+    } else {
+      for (uint32_t group = 0; group < order.size(); ++group) {
+        order[group] = group;
+      }
+      keys.reserve(groups_.size());
+      for (uint32_t group = 0; group < groups_.size(); ++group) {
+        keys.push_back(decode_key(groups_.key(group)));
+      }
+      std::sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs) {
+        return keys[lhs] < keys[rhs];
+      });
+    }
+
+    // Rows are built in group order, which reads the states sequentially,
+    // and only then put into key order.
+    std::vector<std::vector<Cell>> rows(order.size());
+    std::vector<Cell> key;
+    for (uint32_t group = 0; group < rows.size(); ++group) {
+      if (packed_) {
+        decode_packed_key(packed_groups_.key(group), key);
+      } else {
+        key = std::move(keys[group]);
+      }
+      std::vector<Cell>& row = rows[group];
+      row.reserve(items.size());
+      for (size_t i = 0; i < items.size(); ++i) {
+        if (items[i].aggregate_ == Aggregate::None) {
+          row.push_back(key[items[i].key_]);
+        } else {
+          row.push_back(value(i, group));
+        }
+      }
+    }
+    std::vector<std::vector<Cell>> sorted_rows;
+    sorted_rows.reserve(rows.size());
+    for (const uint32_t group : order) {
+      sorted_rows.push_back(std::move(rows[group]));
+    }
+    return sorted_rows;
+  }
+
+ private:
+  // Per-group values of an aggregate, of its item's state type.
+  struct States {
+    memory::Vector<int64_t> ints_;
+    memory::Vector<double> reals_;
+    memory::Vector<std::string> texts_;
+  };
+
+  bool grouped() const { return !aggregation_.group_columns_.empty(); }
+
+  const Column& column(size_t index) const {
+    return aggregation_.table_.columns()[index];
+  }
+
+  // The values of an INT or REAL column in a block, decoded once for all
+  // the keys and aggregates that read them.
+  template <typename T>
+  const T* values(size_t column_index, size_t block) {
+    auto& scratch = [&]() -> std::vector<T>& {
+      if constexpr (std::is_same_v<T, int>) {
+        return int_scratch_[column_index];
+      } else {
+        return float_scratch_[column_index];
+      }
+    }();
+    if (decoded_blocks_[column_index] != block) {
+      block_data_[column_index] =
+          column(column_index).block_values(block, scratch);
+      decoded_blocks_[column_index] = block;
+    }
+    return static_cast<const T*>(block_data_[column_index]);
+  }
+
+  template <typename T>
+  static void merge_state(
+      Aggregate aggregate,
+      bool added,
+      bool assign,
+      memory::Vector<T>& states,
+      uint32_t group,
+      const T& value) {
+    if (added) {
+      states.push_back(value);
+    } else if (assign) {
+      states[group] = value;
+    } else {
+      combine(aggregate, states[group], value);
+    }
+  }
+
+  void add_block(size_t block, const size_t* rows, size_t count) {
+    positions_.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+      positions_[i] = static_cast<uint16_t>(rows[i] - block * kBlockRows);
+    }
+    if (grouped()) {
+      assign_groups(block, rows, count);
+      for (size_t i = 0; i < states_.size(); ++i) {
+        accumulate_grouped(i, block, rows, count);
+      }
+    } else {
+      const size_t block_rows = std::min(
+          kBlockRows, aggregation_.table_.row_count() - block * kBlockRows);
+      const bool complete = count == block_rows;
+      for (size_t i = 0; i < states_.size(); ++i) {
+        reduce(i, block, rows, count, complete);
+      }
+      counts_[0] += static_cast<int64_t>(count);
+    }
+  }
+
+  // Fills groups_of_rows_ with the group of every row.
+  void assign_groups(size_t block, const size_t* rows, size_t count) {
+    groups_of_rows_.resize(count);
+    if (packed_) {
+      packed_keys_.assign(count, 0);
+      for (const size_t column_index : aggregation_.group_columns_) {
+        if (column(column_index).kind() == Column::Kind::Int) {
+          pack_keys(values<int>(column_index, block), count);
+        } else {
+          pack_keys(values<float>(column_index, block), count);
+        }
+      }
+      for (size_t i = 0; i < count; ++i) {
+        add_row(i, packed_groups_.find_or_add(packed_keys_[i]));
+      }
+      return;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+      key_.clear();
+      for (const size_t column_index : aggregation_.group_columns_) {
+        const Column& key_column = column(column_index);
+        switch (key_column.kind()) {
+          case Column::Kind::Int:
+            append_bytes(key_, values<int>(column_index, block)[positions_[i]]);
+            break;
+          case Column::Kind::Real:
+            append_bytes(
+                key_,
+                normalize(values<float>(column_index, block)[positions_[i]]));
+            break;
+          case Column::Kind::Text: {
+            const std::string_view text = key_column.text(rows[i]);
+            append_bytes(key_, static_cast<uint32_t>(text.size()));
+            key_.append(text);
+            break;
+          }
+        }
+      }
+      add_row(i, groups_.find_or_add(key_));
+    }
+  }
+
+  // -0.0 and 0.0 are one group.
+  static float normalize(float value) { return value == 0 ? 0 : value; }
+  static int normalize(int value) { return value; }
+
+  // Appends the column's 32-bit keys to the packed keys of the rows.
+  template <typename T>
+  void pack_keys(const T* block_values, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      packed_keys_[i] = packed_keys_[i] << 32 |
+                        to_key(normalize(block_values[positions_[i]]));
+    }
+  }
+
+  void add_row(size_t i, uint32_t group) {
+    if (group == counts_.size()) {
+      counts_.push_back(0);
+    }
+    ++counts_[group];
+    groups_of_rows_[i] = group;
+  }
+
+  void accumulate_grouped(
+      size_t item_index,
+      size_t block,
+      const size_t* rows,
+      size_t count) {
+    const Item& item = aggregation_.items_[item_index];
+    States& states = states_[item_index];
+    if (item.state_ == State::None) {
+      return;
+    }
+    const Column& values = column(*item.column_);
+    switch (values.kind()) {
+      case Column::Kind::Int: {
+        const int* ints = this->values<int>(*item.column_, block);
+        if (item.state_ == State::Int) {
+          accumulate(
+              item.aggregate_, states.ints_, groups_of_rows_.data(),
+              positions_.data(), ints, count);
+        } else {
+          accumulate(
+              item.aggregate_, states.reals_, groups_of_rows_.data(),
+              positions_.data(), ints, count);
+        }
+        break;
+      }
+      case Column::Kind::Real:
+        accumulate(
+            item.aggregate_, states.reals_, groups_of_rows_.data(),
+            positions_.data(), this->values<float>(*item.column_, block),
+            count);
+        break;
+      case Column::Kind::Text:
+        for (size_t i = 0; i < count; ++i) {
+          const uint32_t group = groups_of_rows_[i];
+          const std::string_view text = values.text(rows[i]);
+          if (group == states.texts_.size()) {
+            states.texts_.emplace_back(text);
+          } else if (
+              item.aggregate_ == Aggregate::Min ? text < states.texts_[group]
+                                                : states.texts_[group] < text) {
+            states.texts_[group] = text;
+          }
+        }
+        break;
+    }
+  }
+
+  // Reduces the rows of a block into the single group.
+  void reduce(
+      size_t item_index,
+      size_t block,
+      const size_t* rows,
+      size_t count,
+      bool complete) {
+    const Item& item = aggregation_.items_[item_index];
+    States& states = states_[item_index];
+    const bool first = counts_[0] == 0;
+    switch (item.state_) {
+      case State::None:
+        break;
+      case State::Int: {
+        const int* ints = gather(
+            values<int>(*item.column_, block), int_gather_, count, complete);
+        if (item.aggregate_ == Aggregate::Sum) {
+          states.ints_[0] += sum_of<int64_t>(ints, count);
+          break;
+        }
+        const int64_t value =
+            item.aggregate_ == Aggregate::Min
+                ? extremum_of<std::less<>>(ints, count)
+                : extremum_of<std::greater<>>(ints, count);
+        if (first) {
+          states.ints_[0] = value;
+        } else {
+          combine(item.aggregate_, states.ints_[0], value);
+        }
+        break;
+      }
+      case State::Real: {
+        const Column& values = column(*item.column_);
+        if (values.kind() == Column::Kind::Int) {
+          // AVG of INT sums exactly in 64 bits.
+          const int* ints = gather(
+              this->values<int>(*item.column_, block), int_gather_, count,
+              complete);
+          states.reals_[0] += static_cast<double>(sum_of<int64_t>(ints, count));
+          break;
+        }
+        const float* floats = gather(
+            this->values<float>(*item.column_, block), float_gather_, count,
+            complete);
+        double value = 0;
+        switch (item.aggregate_) {
+          case Aggregate::Min:
+            value = extremum_of<std::less<>>(floats, count);
+            break;
+          case Aggregate::Max:
+            value = extremum_of<std::greater<>>(floats, count);
+            break;
+          default:
+            states.reals_[0] += sum_of<double>(floats, count);
+            return;
+        }
+        if (first) {
+          states.reals_[0] = value;
+        } else {
+          combine(item.aggregate_, states.reals_[0], value);
+        }
+        break;
+      }
+      case State::Text: {
+        const Column& values = column(*item.column_);
+        std::string& state = states.texts_[0];
+        for (size_t i = 0; i < count; ++i) {
+          const std::string_view text = values.text(rows[i]);
+          if (first && i == 0) {
+            state = text;
+          } else if (item.aggregate_ == Aggregate::Min ? text < state
+                                                       : state < text) {
+            state = text;
+          }
+        }
+        break;
+      }
+    }
+  }
+
+  // The values of the selected rows of a block, contiguous.
+  template <typename T>
+  const T* gather(
+      const T* block_values,
+      std::vector<T>& scratch,
+      size_t count,
+      bool complete) const {
+    if (complete) {
+      return block_values;
+    }
+    scratch.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+      scratch[i] = block_values[positions_[i]];
+    }
+    return scratch.data();
+  }
+
+  std::vector<Cell> decode_key(std::string_view key) const {
+    std::vector<Cell> cells;
+    for (const size_t column_index : aggregation_.group_columns_) {
+      switch (column(column_index).kind()) {
+        case Column::Kind::Int:
+          cells.emplace_back(read_bytes<int>(key));
+          break;
+        case Column::Kind::Real:
+          cells.emplace_back(read_bytes<float>(key));
+          break;
+        case Column::Kind::Text: {
+          const auto size = read_bytes<uint32_t>(key);
+          cells.emplace_back(std::string(key.substr(0, size)));
+          key.remove_prefix(size);
+          break;
+        }
+      }
+    }
+    return cells;
+  }
+
+  void decode_packed_key(uint64_t key, std::vector<Cell>& cells) const {
+    const auto& group_columns = aggregation_.group_columns_;
+    cells.resize(group_columns.size());
+    for (size_t k = group_columns.size(); k-- > 0;) {
+      const auto column_key = static_cast<uint32_t>(key);
+      if (column(group_columns[k]).kind() == Column::Kind::Int) {
+        cells[k] = from_key<int>(column_key);
+      } else {
+        cells[k] = from_key<float>(column_key);
+      }
+      key >>= 32;
+    }
+  }
+
+  Cell value(size_t item_index, uint32_t group) const {
+    const Item& item = aggregation_.items_[item_index];
+    const States& states = states_[item_index];
+    const int64_t count = counts_[group];
+    switch (item.aggregate_) {
+      case Aggregate::Count:
+        return static_cast<int>(count);
+      case Aggregate::Avg:
+        return count == 0 ? 0.0F
+                          : static_cast<float>(states.reals_[group] / count);
+      default:
+        break;
+    }
+    switch (item.state_) {
+      case State::Int: {
+        const int64_t value = states.ints_[group];
+        if (value < std::numeric_limits<int>::min() ||
+            value > std::numeric_limits<int>::max()) {
+          throw ExecutionError("Integer overflow in " + item.name_);
+        }
+        return static_cast<int>(value);
+      }
+      case State::Real:
+        return static_cast<float>(states.reals_[group]);
+      default:
+        return states.texts_[group];
+    }
+  }
+
+  const Aggregation& aggregation_;
+  // Whether the groups are in packed_groups_ instead of groups_.
+  bool packed_;
+  PackedGroupTable packed_groups_;
+  GroupTable groups_;
+  // Rows of each group.
+  memory::Vector<int64_t> counts_;
+  // Indexed by item.
+  std::vector<States> states_;
+
+  // Per block scratch.
+  std::vector<uint16_t> positions_;
+  std::vector<uint32_t> groups_of_rows_;
+  std::vector<uint64_t> packed_keys_;
+  std::string key_;
+  // Decoded block of each column.
+  std::vector<size_t> decoded_blocks_;
+  std::vector<const void*> block_data_;
+  std::vector<std::vector<int>> int_scratch_;
+  std::vector<std::vector<float>> float_scratch_;
+  std::vector<int> int_gather_;
+  std::vector<float> float_gather_;
+};
+
+Aggregation::Aggregation(
+    const Table& table,
+    const sql::SelectStatement& statement)
+    : table_(table) {
+  const auto find = [&](std::string_view column_name) {
+    const auto column = table.find_column(column_name);
+    if (!column) {
+      throw ExecutionError("Unknown column " + std::string(column_name));
+    }
+    return *column;
+  };
+
+  for (const auto column_name : statement.group_by()) {
+    group_columns_.push_back(find(column_name));
+  }
+
+  const auto& column_list = statement.column_list();
+  for (size_t i = 0; i < column_list.size(); ++i) {
+    Item item;
+    item.aggregate_ = statement.aggregates()[i];
+    item.name_ = statement.item_to_str(i);
+    if (item.aggregate_ == Aggregate::Count && column_list[i] == "*") {
+      items_.push_back(std::move(item));
+      continue;
+    }
+    const size_t column = find(column_list[i]);
+    const Column::Kind kind = table.columns()[column].kind();
+    switch (item.aggregate_) {
+      case Aggregate::None: {
+        const auto key = std::find(
+            group_columns_.begin(), group_columns_.end(), column);
+        if (key == group_columns_.end()) {
+          throw ExecutionError(
+              "Column " + std::string(column_list[i]) +
+              " must be aggregated or in GROUP BY");
+        }
+        item.key_ = static_cast<size_t>(key - group_columns_.begin());
+        break;
+      }
+      case Aggregate::Count:
+        break;
+      case Aggregate::Sum:
+      case Aggregate::Avg:
+        if (kind == Column::Kind::Text) {
+          throw ExecutionError(
+              "Can't compute " +
+              std::string(sql::aggregate_to_str(item.aggregate_)) +
+              " on TEXT");
+        }
+        item.state_ = item.aggregate_ == Aggregate::Sum &&
+                              kind == Column::Kind::Int
+                          ? State::Int
+                          : State::Real;
+        item.column_ = column;
+        break;
+      case Aggregate::Min:
+      case Aggregate::Max:
+        item.state_ = kind == Column::Kind::Int    ? State::Int
+                      : kind == Column::Kind::Real ? State::Real
+                                                   : State::Text;
+        item.column_ = column;
+        break;
+    }
+    items_.push_back(std::move(item));
+  }
+
+  columns_ = group_columns_;
+  for (const auto& item : items_) {
+    if (item.column_) {
+      columns_.push_back(*item.column_);
+    }
+  }
+  std::sort(columns_.begin(), columns_.end());
+  columns_.erase(std::unique(columns_.begin(), columns_.end()), columns_.end());
+}
+
+std::vector<std::vector<Cell>> Aggregation::run(
+    const std::vector<size_t>& selection,
+    size_t workers) const {
+  workers = std::max<size_t>(workers, 1);
+  // Workers split the selection at block boundaries, so that each block
+  // is decoded once.
+  std::vector<size_t> bounds = {0};
+  for (size_t worker = 1; worker < workers; ++worker) {
+    size_t bound =
+        std::max(bounds.back(), selection.size() * worker / workers);
+    while (bound > bounds.back() && bound < selection.size() &&
+           selection[bound] / kBlockRows == selection[bound - 1] / kBlockRows) {
+      ++bound;
+    }
+    bounds.push_back(bound);
+  }
+  bounds.push_back(selection.size());
+
+  std::vector<Partial> partials;
+  partials.reserve(workers);
+  for (size_t worker = 0; worker < workers; ++worker) {
+    partials.emplace_back(*this);
+  }
+  run_workers(workers, [&](size_t worker) {
+    partials[worker].add(
+        selection.data() + bounds[worker], bounds[worker + 1] - bounds[worker]);
+  });
+
+  for (size_t worker = 1; worker < workers; ++worker) {
+    partials[0].merge(partials[worker]);
+  }
+  return partials[0].rows();
+}
+
+}  // namespace rdb::exec
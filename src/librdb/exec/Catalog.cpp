@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <librdb/exec/Catalog.hpp>
+
+namespace rdb::exec {
+
+namespace {
+
+bool name_less(const TablePtr& table, std::string_view name) {
+  return table->name() < name;
+}
+
+}  // namespace
+
+Catalog::Catalog() : snapshot_(new Snapshot) {}
+
+Catalog::~Catalog() {
+  delete snapshot_.load();
+}
+
+Table* Catalog::find(std::string_view table_name) const {
+  const Snapshot& tables = *snapshot_.load();
+  const auto it =
+      std::lower_bound(tables.begin(), tables.end(), table_name, name_less);
+  if (it == tables.end() || (*it)->name() != table_name) {
+    return nullptr;
+  }
+  return it->get();
+}
+
+bool Catalog::create(TablePtr table) {
+  const std::lock_guard lock(write_mutex_);
+  const Snapshot& tables = *snapshot_.load();
+  const auto it =
+      std::lower_bound(tables.begin(), tables.end(), table->name(), name_less);
+  if (it != tables.end() && (*it)->name() == table->name()) {
+    return false;
+  }
+  auto snapshot = std::make_unique<Snapshot>();
+  snapshot->reserve(tables.size() + 1);
+  snapshot->insert(snapshot->end(), tables.begin(), it);
+  snapshot->push_back(std::move(table));
+  snapshot->insert(snapshot->end(), it, tables.end());
+  publish(std::move(snapshot));
+  return true;
+}
+
+bool Catalog::drop(std::string_view table_name) {
+  const std::lock_guard lock(write_mutex_);
+  const Snapshot& tables = *snapshot_.load();
+  const auto it =
+      std::lower_bound(tables.begin(), tables.end(), table_name, name_less);
+  if (it == tables.end() || (*it)->name() != table_name) {
+    return false;
+  }
+  auto snapshot = std::make_unique<Snapshot>();
+  snapshot->reserve(tables.size() - 1);
+  snapshot->insert(snapshot->end(), tables.begin(), it);
+  snapshot->insert(snapshot->end(), it + 1, tables.end());
+  publish(std::move(snapshot), *it);
+  return true;
+}
+
+std::vector<TablePtr> Catalog::tables() const {
+  const sync::EpochGuard guard;
+  return *snapshot_.load();
+}
+
+void Catalog::reclaim() {
+  const std::unique_lock lock(write_mutex_, std::try_to_lock);
+  if (lock) {
+    retired_.reclaim();
+    retired_tables_.reclaim();
+  }
+}
+
+void Catalog::publish(
+    std::unique_ptr<const Snapshot> snapshot,
+    TablePtr dropped) {
+  retired_.retire(std::unique_ptr<const Snapshot>(
+      snapshot_.exchange(snapshot.release())));
+  if (dropped) {
+    retired_tables_.retire(
+        std::make_unique<const TablePtr>(std::move(dropped)));
+  }
+  retired_.reclaim();
+  retired_tables_.reclaim();
+  ++version_;
+}
+
+}  // namespace rdb::exec
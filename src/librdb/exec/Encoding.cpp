@@ -0,0 +1,360 @@
+#include <algorithm>
+#include <cassert>
+#include <librdb/exec/Encoding.hpp>
+
+namespace rdb::exec {
+
+namespace {
+
+using Operation = sql::Expression::Operation;
+
+uint8_t bit_width(uint64_t value) {
+  uint8_t width = 0;
+  while (value != 0) {
+    ++width;
+    value >>= 1U;
+  }
+  return width;
+}
+
+size_t packed_words(size_t count, uint8_t width) {
+  return (count * width + 63) / 64;
+}
+
+void pack(
+    uint64_t code,
+    size_t index,
+    uint8_t width,
+    std::vector<uint64_t>& words) {
+  if (width == 0) {
+    return;
+  }
+  const size_t bit = index * width;
+  const size_t word = bit / 64;
+  const size_t shift = bit % 64;
+  words[word] |= code << shift;
+  if (shift + width > 64) {
+    words[word + 1] |= code >> (64 - shift);
+  }
+}
+
+uint64_t unpack(
+    const std::vector<uint64_t>& words,
+    size_t index,
+    uint8_t width) {
+  if (width == 0) {
+    return 0;
+  }
+  const size_t bit = index * width;
+  const size_t word = bit / 64;
+  const size_t shift = bit % 64;
+  uint64_t code = words[word] >> shift;
+  if (shift + width > 64) {
+    code |= words[word + 1] << (64 - shift);
+  }
+  return width == 64 ? code : code & ((uint64_t{1} << width) - 1);
+}
+
+template <typename T>
+bool holds(T key, Operation operation, T constant) {
+  switch (operation) {
+    case Operation::Less:
+      return key < constant;
+    case Operation::Greater:
+      return key > constant;
+    case Operation::LessEq:
+      return key <= constant;
+    case Operation::GreaterEq:
+      return key >= constant;
+    case Operation::Equal:
+      return key == constant;
+    case Operation::NotEqual:
+      return key != constant;
+  }
+  return false;
+}
+
+enum class Decision { None, All, Some };
+
+// Decides a predicate for a whole block from its key range.
+Decision decide(
+    Operation operation,
+    uint32_t min,
+    uint32_t max,
+    uint32_t constant) {
+  if (holds(min, operation, constant) && holds(max, operation, constant) &&
+      (operation != Operation::NotEqual || constant < min || constant > max)) {
+    return Decision::All;
+  }
+  switch (operation) {
+    case Operation::Less:
+      return min >= constant ? Decision::None : Decision::Some;
+    case Operation::LessEq:
+      return min > constant ? Decision::None : Decision::Some;
+    case Operation::Greater:
+      return max <= constant ? Decision::None : Decision::Some;
+    case Operation::GreaterEq:
+      return max < constant ? Decision::None : Decision::Some;
+    case Operation::Equal:
+      return constant < min || constant > max ? Decision::None : Decision::Some;
+    case Operation::NotEqual:
+      return min == max && min == constant ? Decision::None : Decision::Some;
+  }
+  return Decision::Some;
+}
+
+// Appends `first_row + i` for each i < count for which `matches(i)` holds.
+// Writes every row and advances past the matching ones, with no branch
+// to mispredict on unsorted data.
+template <typename Matches>
+void select_where(
+    size_t count,
+    size_t first_row,
+    std::vector<size_t>& selection,
+    Matches matches) {
+  size_t size = selection.size();
+  selection.resize(size + count);
+  for (size_t i = 0; i < count; ++i) {
+    selection[size] = first_row + i;
+    size += matches(i) ? 1 : 0;
+  }
+  selection.resize(size);
+}
+
+void select_range(size_t begin, size_t end, std::vector<size_t>& selection) {
+  for (size_t row = begin; row < end; ++row) {
+    selection.push_back(row);
+  }
+}
+
+}  // namespace
+
+std::string_view encoding_to_str(Encoding encoding) {
+  switch (encoding) {
+    case Encoding::Plain:
+      return "plain";
+    case Encoding::FrameOfReference:
+      return "for";
+    case Encoding::Delta:
+      return "delta";
+    case Encoding::RunLength:
+      return "rle";
+  }
+  return "";
+}
+
+EncodedBlock EncodedBlock::encode(const uint32_t* keys, size_t count) {
+  assert(count > 0 && count <= UINT16_MAX);
+  EncodedBlock block;
+  block.count_ = static_cast<uint32_t>(count);
+  const auto [min, max] = std::minmax_element(keys, keys + count);
+  block.min_ = *min;
+  block.max_ = *max;
+
+  int64_t min_delta = 0;
+  int64_t max_delta = 0;
+  size_t runs = 1;
+  for (size_t i = 1; i < count; ++i) {
+    const int64_t delta = int64_t{keys[i]} - int64_t{keys[i - 1]};
+    min_delta = i == 1 ? delta : std::min(min_delta, delta);
+    max_delta = i == 1 ? delta : std::max(max_delta, delta);
+    runs += keys[i] != keys[i - 1] ? 1 : 0;
+  }
+  const uint8_t for_width = bit_width(block.max_ - block.min_);
+  const uint8_t delta_width =
+      bit_width(static_cast<uint64_t>(max_delta - min_delta));
+
+  Encoding encoding = Encoding::Plain;
+  size_t best = count * sizeof(uint32_t);
+  const auto consider = [&encoding, &best](Encoding candidate, size_t size) {
+    if (size < best) {
+      encoding = candidate;
+      best = size;
+    }
+  };
+  consider(Encoding::FrameOfReference, packed_words(count, for_width) * 8);
+  consider(Encoding::RunLength, runs * (sizeof(uint32_t) + sizeof(uint16_t)));
+  consider(
+      Encoding::Delta,
+      sizeof(uint32_t) + packed_words(count - 1, delta_width) * 8);
+
+  block.encoding_ = encoding;
+  switch (encoding) {
+    case Encoding::Plain:
+      block.keys_.assign(keys, keys + count);
+      break;
+    case Encoding::FrameOfReference:
+      block.reference_ = block.min_;
+      block.bit_width_ = for_width;
+      block.packed_.assign(packed_words(count, for_width), 0);
+      for (size_t i = 0; i < count; ++i) {
+        pack(keys[i] - block.min_, i, for_width, block.packed_);
+      }
+      break;
+    case Encoding::Delta:
+      block.reference_ = min_delta;
+      block.bit_width_ = delta_width;
+      block.keys_.push_back(keys[0]);
+      block.packed_.assign(packed_words(count - 1, delta_width), 0);
+      for (size_t i = 1; i < count; ++i) {
+        const int64_t delta = int64_t{keys[i]} - int64_t{keys[i - 1]};
+        pack(
+            static_cast<uint64_t>(delta - min_delta),
+            i - 1,
+            delta_width,
+            block.packed_);
+      }
+      break;
+    case Encoding::RunLength:
+      for (size_t i = 0; i < count; ++i) {
+        if (i == 0 || keys[i] != keys[i - 1]) {
+          block.keys_.push_back(keys[i]);
+          block.run_ends_.push_back(0);
+        }
+        block.run_ends_.back() = static_cast<uint16_t>(i + 1);
+      }
+      break;
+  }
+  return block;
+}
+
+size_t EncodedBlock::byte_size() const {
+  return packed_.size() * sizeof(uint64_t) + keys_.size() * sizeof(uint32_t) +
+         run_ends_.size() * sizeof(uint16_t);
+}
+
+void EncodedBlock::decode(uint32_t* out) const {
+  switch (encoding_) {
+    case Encoding::Plain:
+      std::copy(keys_.begin(), keys_.end(), out);
+      break;
+    case Encoding::FrameOfReference:
+      for (size_t i = 0; i < count_; ++i) {
+        out[i] = static_cast<uint32_t>(
+            reference_ + int64_t(unpack(packed_, i, bit_width_)));
+      }
+      break;
+    case Encoding::Delta: {
+      int64_t key = keys_[0];
+      out[0] = keys_[0];
+      for (size_t i = 1; i < count_; ++i) {
+        key += reference_ + int64_t(unpack(packed_, i - 1, bit_width_));
+        out[i] = static_cast<uint32_t>(key);
+      }
+      break;
+    }
+    case Encoding::RunLength: {
+      size_t begin = 0;
+      for (size_t run = 0; run < keys_.size(); ++run) {
+        std::fill(out + begin, out + run_ends_[run], keys_[run]);
+        begin = run_ends_[run];
+      }
+      break;
+    }
+  }
+}
+
+uint32_t EncodedBlock::at(size_t index) const {
+  switch (encoding_) {
+    case Encoding::Plain:
+      return keys_[index];
+    case Encoding::FrameOfReference:
+      return static_cast<uint32_t>(
+          reference_ + int64_t(unpack(packed_, index, bit_width_)));
+    case Encoding::Delta: {
+      int64_t key = keys_[0];
+      for (size_t i = 0; i < index; ++i) {
+        key += reference_ + int64_t(unpack(packed_, i, bit_width_));
+      }
+      return static_cast<uint32_t>(key);
+    }
+    case Encoding::RunLength: {
+      const auto run = std::upper_bound(
+          run_ends_.begin(), run_ends_.end(), static_cast<uint16_t>(index));
+      return keys_[static_cast<size_t>(run - run_ends_.begin())];
+    }
+  }
+  return 0;
+}
+
+void EncodedBlock::filter(
+    Operation operation,
+    uint32_t constant,
+    size_t first_row,
+    std::vector<size_t>& selection) const {
+  switch (decide(operation, min_, max_, constant)) {
+    case Decision::None:
+      return;
+    case Decision::All:
+      select_range(first_row, first_row + count_, selection);
+      return;
+    case Decision::Some:
+      break;
+  }
+  switch (encoding_) {
+    case Encoding::Plain:
+      with_comparison(operation, [&](auto compare) {
+        select_where(count_, first_row, selection, [&](size_t i) {
+          return compare(keys_[i], constant);
+        });
+      });
+      break;
+    case Encoding::FrameOfReference:
+      filter_codes(operation, constant, first_row, selection);
+      break;
+    case Encoding::Delta:
+      filter_deltas(operation, constant, first_row, selection);
+      break;
+    case Encoding::RunLength: {
+      size_t begin = 0;
+      for (size_t run = 0; run < keys_.size(); ++run) {
+        if (holds(keys_[run], operation, constant)) {
+          select_range(
+              first_row + begin, first_row + run_ends_[run], selection);
+        }
+        begin = run_ends_[run];
+      }
+      break;
+    }
+  }
+}
+
+void EncodedBlock::filter_codes(
+    Operation operation,
+    uint32_t constant,
+    size_t first_row,
+    std::vector<size_t>& selection) const {
+  // The constant is within [min_, max_] here, so it has a code too and the
+  // comparison can stay on the packed differences.
+  const auto code = static_cast<uint64_t>(int64_t{constant} - reference_);
+  with_comparison(operation, [&](auto compare) {
+    select_where(count_, first_row, selection, [&](size_t i) {
+      return compare(unpack(packed_, i, bit_width_), code);
+    });
+  });
+}
+
+void EncodedBlock::filter_deltas(
+    Operation operation,
+    uint32_t constant,
+    size_t first_row,
+    std::vector<size_t>& selection) const {
+  // In a non-decreasing block the keys below the constant form a prefix,
+  // so Less and LessEq can stop at the first key that fails.
+  const bool sorted = reference_ >= 0;
+  const bool prefix = sorted && (operation == Operation::Less ||
+                                 operation == Operation::LessEq);
+  int64_t key = keys_[0];
+  for (size_t i = 0; i < count_; ++i) {
+    if (i != 0) {
+      key += reference_ + int64_t(unpack(packed_, i - 1, bit_width_));
+    }
+    if (holds(static_cast<uint32_t>(key), operation, constant)) {
+      selection.push_back(first_row + i);
+    } else if (prefix) {
+      break;
+    }
+  }
+}
+
+}  // namespace rdb::exec
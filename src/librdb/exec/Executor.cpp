@@ -0,0 +1,1437 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <librdb/exec/Aggregation.hpp>
+#include <librdb/exec/Executor.hpp>
+#include <librdb/exec/FilterProgram.hpp>
+#include <librdb/exec/HashJoin.hpp>
+#include <librdb/exec/Parallel.hpp>
+#include <librdb/exec/Profile.hpp>
+#include <librdb/exec/ResultCache.hpp>
+#include <librdb/exec/Sort.hpp>
+#include <librdb/memory/MemoryTracker.hpp>
+#include <librdb/metrics/Metrics.hpp>
+#include <librdb/sql/Parser.hpp>
+#include <librdb/sync/Epoch.hpp>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace rdb::exec {
+
+namespace {
+
+std::string unquote(std::string_view text) {
+  if (text.size() >= 2 && text.front() == '"' && text.back() == '"') {
+    text = text.substr(1, text.size() - 2);
+  }
+  return std::string(text);
+}
+
+Cell value_to_cell(const sql::Value& value) {
+  if (const int* i = std::get_if<int>(&value)) {
+    return *i;
+  }
+  if (const float* f = std::get_if<float>(&value)) {
+    return *f;
+  }
+  if (const auto* text = std::get_if<std::string_view>(&value)) {
+    return unquote(*text);
+  }
+  throw ExecutionError("Placeholders must be bound");
+}
+
+Cell convert_for_column(Cell cell, const Column& column) {
+  switch (column.kind()) {
+    case Column::Kind::Int:
+      if (std::holds_alternative<int>(cell)) {
+        return cell;
+      }
+      break;
+    case Column::Kind::Real:
+      if (const int* i = std::get_if<int>(&cell)) {
+        return static_cast<float>(*i);
+      }
+      if (std::holds_alternative<float>(cell)) {
+        return cell;
+      }
+      break;
+    case Column::Kind::Text:
+      if (std::holds_alternative<std::string>(cell)) {
+        return cell;
+      }
+      break;
+  }
+  throw ExecutionError(
+      "Column " + column.name() + " expects " +
+      sql::column_kind_to_str(column.kind()));
+}
+
+size_t blocks_of(size_t row_count) {
+  return (row_count + kBlockRows - 1) / kBlockRows;
+}
+
+// Sequential scan with an optional filter, returning the matching rows.
+// `buffers` is charged for a selection of every row.
+std::vector<size_t> scan(
+    const Table& table,
+    const std::optional<FilterProgram>& predicate,
+    memory::Reservation& buffers,
+    OperatorStats* stats) {
+  const OperatorTimer timer(stats);
+  const size_t row_count = table.row_count();
+  buffers.add(row_count * sizeof(size_t));
+  std::vector<size_t> selection;
+  if (predicate) {
+    predicate->run(selection, stats);
+  } else {
+    selection.resize(row_count);
+    std::iota(selection.begin(), selection.end(), size_t{0});
+  }
+  if (stats != nullptr) {
+    stats->rows_in_ += row_count;
+    stats->rows_out_ += selection.size();
+    if (predicate) {
+      for (const size_t column : predicate->columns()) {
+        stats->blocks_read_ += blocks_of(row_count);
+        stats->bytes_read_ += table.columns()[column].byte_size();
+      }
+    }
+  }
+  return selection;
+}
+
+std::vector<std::string> scan_details(
+    const std::optional<sql::Expression>& expression) {
+  std::vector<std::string> details = {"Workers: 1"};
+  if (expression) {
+    details.push_back("Filter: " + sql::expression_to_str(*expression));
+  }
+  return details;
+}
+
+// Reads `column` at `rows` into cell `index` of the result rows, in
+// ascending row order so that every block is decoded once.
+void read_cells(
+    const Column& column,
+    const std::vector<size_t>& rows,
+    size_t index,
+    std::vector<std::vector<Cell>>& result_rows) {
+  std::vector<size_t> order(rows.size());
+  std::iota(order.begin(), order.end(), size_t{0});
+  if (!std::is_sorted(rows.begin(), rows.end())) {
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+      return rows[a] < rows[b];
+    });
+  }
+  ColumnReader reader(column);
+  for (const size_t i : order) {
+    result_rows[i][index] = reader.at(rows[i]);
+  }
+}
+
+// The Sort node of a SELECT with ORDER BY, or the Limit node of one with
+// just a LIMIT.
+PlanNode sort_node(const sql::SelectStatement& statement, size_t workers) {
+  if (!statement.order_by()) {
+    return {"Limit " + std::to_string(*statement.limit()), {}, {}};
+  }
+  std::vector<std::string> details = {
+      "Sort Key: " + statement.order_by_to_str()};
+  if (statement.limit()) {
+    details.push_back("Limit: " + std::to_string(*statement.limit()));
+  }
+  details.push_back("Workers: " + std::to_string(workers));
+  return {"Sort", std::move(details), {}};
+}
+
+// Orders `items` by the values of `column` at `rows`, the row of every
+// item, and cuts them to the LIMIT. Without ORDER BY `column` is null and
+// the items keep their order.
+template <typename T>
+void sort_items(
+    const sql::SelectStatement& statement,
+    const Column* column,
+    const std::vector<size_t>& rows,
+    size_t workers,
+    std::vector<T>& items,
+    OperatorStats* stats) {
+  const OperatorTimer timer(stats);
+  const size_t rows_in = items.size();
+  if (column == nullptr) {
+    const size_t limit = statement.limit().value_or(items.size());
+    items.erase(items.begin() + std::min(items.size(), limit), items.end());
+  } else {
+    const Sort sort(
+        *column, statement.order_by()->descending_, statement.limit());
+    std::vector<T> sorted;
+    for (const size_t position : sort.run(rows, workers)) {
+      sorted.push_back(std::move(items[position]));
+    }
+    items = std::move(sorted);
+  }
+  if (stats != nullptr) {
+    stats->rows_in_ = rows_in;
+    stats->rows_out_ = items.size();
+    if (column != nullptr) {
+      stats->blocks_read_ += blocks_of(column->size());
+      stats->bytes_read_ += column->byte_size();
+    }
+  }
+}
+
+// A column of one of the two tables of a JOIN, given as `Table.Column` or,
+// if only one of the tables has it, as `Column`.
+struct JoinColumn {
+  size_t side_;
+  size_t column_;
+};
+
+JoinColumn resolve_column(
+    const std::array<const Table*, 2>& tables,
+    std::string_view name) {
+  const size_t dot = name.find('.');
+  if (dot != std::string_view::npos) {
+    const std::string_view table_name = name.substr(0, dot);
+    for (size_t side = 0; side < tables.size(); ++side) {
+      if (tables[side]->name() != table_name) {
+        continue;
+      }
+      if (const auto column = tables[side]->find_column(name.substr(dot + 1))) {
+        return {side, *column};
+      }
+      throw ExecutionError("Unknown column " + std::string(name));
+    }
+    throw ExecutionError("Unknown table " + std::string(table_name));
+  }
+  std::optional<JoinColumn> found;
+  for (size_t side = 0; side < tables.size(); ++side) {
+    if (const auto column = tables[side]->find_column(name)) {
+      if (found) {
+        throw ExecutionError("Ambiguous column " + std::string(name));
+      }
+      found = JoinColumn{side, *column};
+    }
+  }
+  if (!found) {
+    throw ExecutionError("Unknown column " + std::string(name));
+  }
+  return *found;
+}
+
+// The WHERE condition of a JOIN with unqualified column names, for the
+// scan of the one table whose columns it reads, which is stored in `side`.
+sql::Expression resolve_condition(
+    const std::array<const Table*, 2>& tables,
+    const sql::Expression& expression,
+    std::optional<size_t>& side) {
+  switch (expression.kind_) {
+    case sql::Expression::Kind::Operand: {
+      const sql::Operand& operand = *expression.operand_;
+      if (operand.kind_ != sql::Operand::Kind::Id) {
+        return expression;
+      }
+      const auto name = std::get<std::string_view>(operand.value_);
+      const JoinColumn column = resolve_column(tables, name);
+      if (side && *side != column.side_) {
+        throw ExecutionError("WHERE of a JOIN can only read one table");
+      }
+      side = column.side_;
+      return sql::Operand(
+          sql::Operand::Kind::Id, name.substr(name.find('.') + 1));
+    }
+    case sql::Expression::Kind::Comparison:
+      return sql::Expression(
+          resolve_condition(tables, expression.operands_[0], side),
+          expression.operation_,
+          resolve_condition(tables, expression.operands_[1], side));
+    default: {
+      std::vector<sql::Expression> operands;
+      for (const auto& operand : expression.operands_) {
+        operands.push_back(resolve_condition(tables, operand, side));
+      }
+      return sql::Expression(expression.kind_, std::move(operands));
+    }
+  }
+}
+
+class StatementExecutor : public sql::StatementVisitor {
+ public:
+  // With a profile, the visited statement's plan is recorded into it and,
+  // unless it is an EXPLAIN ANALYZE profile, the statement isn't executed.
+  StatementExecutor(Catalog& catalog, Profile* profile)
+      : catalog_(catalog), profile_(profile) {}
+
+  Result take_result() { return std::move(result_); }
+
+  void visit(const sql::DropTableStatement& statement) override {
+    if (!catalog_.find(statement.table_name())) {
+      throw ExecutionError(
+          "Unknown table " + std::string(statement.table_name()));
+    }
+    plan({{"Drop Table " + std::string(statement.table_name()), {}, {}}});
+    if (plan_only()) {
+      return;
+    }
+    const OperatorTimer timer(stats(0));
+    if (!catalog_.drop(statement.table_name())) {
+      throw ExecutionError(
+          "Unknown table " + std::string(statement.table_name()));
+    }
+  }
+
+  void visit(const sql::InsertStatement& statement) override {
+    Table* table = find_table(statement.table_name());
+    const auto& column_names = statement.column_names();
+    const auto& values = statement.values();
+    if (column_names.size() != values.size()) {
+      throw ExecutionError(
+          "Expected " + std::to_string(column_names.size()) + " values, got " +
+          std::to_string(values.size()));
+    }
+
+    plan({{"Insert on " + table->name(), {}, {}}});
+
+    const auto& columns = table->columns();
+    std::vector<Cell> row;
+    row.reserve(columns.size());
+    for (const auto& column : columns) {
+      row.push_back(default_cell(column.kind()));
+    }
+    for (size_t i = 0; i < column_names.size(); ++i) {
+      const auto column = table->find_column(column_names[i]);
+      if (!column) {
+        throw ExecutionError("Unknown column " + std::string(column_names[i]));
+      }
+      row[*column] =
+          convert_for_column(value_to_cell(values[i]), columns[*column]);
+    }
+    if (plan_only()) {
+      return;
+    }
+    OperatorStats* insert_stats = stats(0);
+    const OperatorTimer timer(insert_stats);
+    table->append_row(std::move(row));
+    result_.affected_rows_ = 1;
+    if (insert_stats != nullptr) {
+      insert_stats->rows_in_ = 1;
+      insert_stats->rows_out_ = 1;
+    }
+  }
+
+  void visit(const sql::SelectStatement& statement) override {
+    Table* table = find_table(statement.table_name());
+    if (statement.join()) {
+      join(*table, statement);
+      return;
+    }
+    if (statement.aggregated()) {
+      aggregate(*table, statement);
+      return;
+    }
+    std::vector<size_t> projection;
+    for (const auto column_name : statement.column_list()) {
+      const auto column = table->find_column(column_name);
+      if (!column) {
+        throw ExecutionError("Unknown column " + std::string(column_name));
+      }
+      projection.push_back(*column);
+      result_.column_names_.emplace_back(column_name);
+    }
+
+    const Column* sort_column = nullptr;
+    if (const auto& order_by = statement.order_by()) {
+      if (order_by->aggregate_ != sql::SelectStatement::Aggregate::None) {
+        throw ExecutionError(
+            "Can't ORDER BY " + statement.order_by_to_str() +
+            " without aggregates");
+      }
+      const auto column = table->find_column(order_by->column_);
+      if (!column) {
+        throw ExecutionError(
+            "Unknown column " + std::string(order_by->column_));
+      }
+      sort_column = &table->columns()[*column];
+    }
+
+    std::optional<FilterProgram> predicate;
+    if (statement.expression()) {
+      predicate.emplace(*table, *statement.expression());
+    }
+
+    std::string project = "Project";
+    for (const auto& column_name : result_.column_names_) {
+      project += " " + column_name;
+    }
+    const size_t workers = workers_for(table->row_count());
+    std::vector<PlanNode> nodes = {{project, {}, {}}};
+    if (statement.order_by() || statement.limit()) {
+      nodes.push_back(sort_node(statement, workers));
+    }
+    nodes.push_back(
+        {"Seq Scan on " + table->name(),
+         scan_details(statement.expression()),
+         {}});
+    const size_t scan_node = nodes.size() - 1;
+    plan(std::move(nodes));
+    if (plan_only()) {
+      result_.column_names_.clear();
+      return;
+    }
+
+    std::vector<size_t> selection =
+        scan(*table, predicate, buffers_, stats(scan_node));
+    if (scan_node == 2) {
+      sort_items(
+          statement, sort_column, selection, workers, selection, stats(1));
+    }
+    OperatorStats* project_stats = stats(0);
+    const OperatorTimer timer(project_stats);
+    const auto& columns = table->columns();
+    reserve_rows(selection.size(), projection.size());
+    result_.rows_.assign(
+        selection.size(), std::vector<Cell>(projection.size()));
+    for (size_t i = 0; i < projection.size(); ++i) {
+      read_cells(columns[projection[i]], selection, i, result_.rows_);
+    }
+
+    if (project_stats != nullptr) {
+      project_stats->rows_in_ = selection.size();
+      project_stats->rows_out_ = selection.size();
+      size_t blocks = 0;
+      for (size_t i = 0; i < selection.size(); ++i) {
+        if (i == 0 ||
+            selection[i] / kBlockRows != selection[i - 1] / kBlockRows) {
+          ++blocks;
+        }
+      }
+      for (const size_t column : projection) {
+        project_stats->blocks_read_ += blocks;
+        for (const size_t row : selection) {
+          project_stats->bytes_read_ += columns[column].byte_size(row);
+        }
+      }
+    }
+  }
+
+  void visit(const sql::DeleteStatement& statement) override {
+    Table* table = find_table(statement.table_name());
+    std::optional<FilterProgram> predicate;
+    if (statement.expression()) {
+      predicate.emplace(*table, *statement.expression());
+    }
+    plan(
+        {{"Delete on " + table->name(), {}, {}},
+         {"Seq Scan on " + table->name(),
+          scan_details(statement.expression()),
+          {}}});
+    if (plan_only()) {
+      return;
+    }
+
+    const std::vector<size_t> selection =
+        scan(*table, predicate, buffers_, stats(1));
+    OperatorStats* delete_stats = stats(0);
+    const OperatorTimer timer(delete_stats);
+    std::vector<bool> erase_mask(table->row_count(), false);
+    for (const size_t row : selection) {
+      erase_mask[row] = true;
+    }
+    result_.affected_rows_ = table->erase_rows(erase_mask);
+    if (delete_stats != nullptr) {
+      delete_stats->rows_in_ = selection.size();
+      delete_stats->rows_out_ = result_.affected_rows_;
+      for (const auto& column : table->columns()) {
+        delete_stats->blocks_read_ += blocks_of(table->row_count());
+        delete_stats->bytes_read_ += column.byte_size();
+      }
+    }
+  }
+
+  void visit(const sql::CreateTableStatement& statement) override {
+    std::vector<Column> columns;
+    for (const auto& column_def : statement.column_defs()) {
+      for (const auto& column : columns) {
+        if (column.name() == column_def.column_name_) {
+          throw ExecutionError(
+              "Duplicate column " + std::string(column_def.column_name_));
+        }
+      }
+      columns.emplace_back(
+          std::string(column_def.column_name_), column_def.kind_);
+    }
+    if (catalog_.find(statement.table_name())) {
+      throw ExecutionError(
+          "Table " + std::string(statement.table_name()) + " already exists");
+    }
+    plan({{"Create Table " + std::string(statement.table_name()), {}, {}}});
+    if (plan_only()) {
+      return;
+    }
+
+    const OperatorTimer timer(stats(0));
+    auto table = std::make_shared<Table>(
+        std::string(statement.table_name()), std::move(columns));
+    if (!catalog_.create(std::move(table))) {
+      throw ExecutionError(
+          "Table " + std::string(statement.table_name()) + " already exists");
+    }
+  }
+
+  void visit(const sql::TransactionStatement& /*statement*/) override {
+    throw std::logic_error("Transaction statements are run by Executor");
+  }
+
+  void visit(const sql::AnalyzeStatement& statement) override {
+    Table* table = find_table(statement.table_name());
+    plan({{"Analyze " + table->name(), {}, {}}});
+    if (plan_only()) {
+      return;
+    }
+    table->analyze();
+    result_.column_names_ = {"Column", "Distinct", "Buckets", "Min", "Max"};
+    const auto& columns = table->columns();
+    for (size_t i = 0; i < columns.size(); ++i) {
+      const ColumnStatistics& statistics = table->statistics().columns_[i];
+      const Histogram& histogram = statistics.histogram_;
+      const auto distinct = std::min(
+          static_cast<double>(table->row_count()),
+          std::round(statistics.distinct_.estimate()));
+      std::vector<Cell> row = {
+          columns[i].name(), static_cast<int>(distinct),
+          static_cast<int>(histogram.bucket_count()), std::string(),
+          std::string()};
+      if (!histogram.empty() && columns[i].kind() == Column::Kind::Int) {
+        row[3] = from_key<int>(histogram.min_key());
+        row[4] = from_key<int>(histogram.max_key());
+      } else if (!histogram.empty()) {
+        row[3] = from_key<float>(histogram.min_key());
+        row[4] = from_key<float>(histogram.max_key());
+      }
+      result_.rows_.push_back(std::move(row));
+    }
+  }
+
+  void visit(const sql::ExplainStatement& statement) override {
+    Profile profile;
+    profile.analyze_ = statement.analyze();
+    StatementExecutor explained(catalog_, &profile);
+    statement.statement().accept(explained);
+    result_.column_names_ = {"Plan"};
+    for (auto& line : profile_to_lines(profile)) {
+      result_.rows_.push_back({std::move(line)});
+    }
+  }
+
+ private:
+  void join(const Table& left, const sql::SelectStatement& statement) {
+    const sql::Join& join = *statement.join();
+    const Table* right = find_table(join.table_name_);
+    if (left.name() == right->name()) {
+      throw ExecutionError("Can't join " + left.name() + " with itself");
+    }
+    if (statement.aggregated()) {
+      throw ExecutionError("JOIN can't be combined with aggregates");
+    }
+    const std::array<const Table*, 2> tables = {&left, right};
+
+    std::vector<JoinColumn> projection;
+    for (const auto column_name : statement.column_list()) {
+      projection.push_back(resolve_column(tables, column_name));
+      result_.column_names_.emplace_back(column_name);
+    }
+
+    JoinColumn left_key = resolve_column(tables, join.left_column_);
+    JoinColumn right_key = resolve_column(tables, join.right_column_);
+    if (left_key.side_ == right_key.side_) {
+      throw ExecutionError("JOIN must compare columns of both tables");
+    }
+    if (left_key.side_ != 0) {
+      std::swap(left_key, right_key);
+    }
+    const HashJoin hash_join(
+        left.columns()[left_key.column_],
+        right->columns()[right_key.column_]);
+
+    std::optional<JoinColumn> sort_key;
+    if (const auto& order_by = statement.order_by()) {
+      if (order_by->aggregate_ != sql::SelectStatement::Aggregate::None) {
+        throw ExecutionError(
+            "Can't ORDER BY " + statement.order_by_to_str() +
+            " without aggregates");
+      }
+      sort_key = resolve_column(tables, order_by->column_);
+    }
+
+    std::optional<size_t> filtered_side;
+    std::optional<sql::Expression> condition;
+    std::array<std::optional<FilterProgram>, 2> predicates;
+    if (statement.expression()) {
+      condition =
+          resolve_condition(tables, *statement.expression(), filtered_side);
+      filtered_side = filtered_side.value_or(0);
+      predicates[*filtered_side].emplace(*tables[*filtered_side], *condition);
+    }
+
+    std::string project = "Project";
+    for (const auto& column_name : result_.column_names_) {
+      project += " " + column_name;
+    }
+    const size_t workers = workers_for(left.row_count() + right->row_count());
+    std::vector<PlanNode> nodes = {{project, {}, {}}};
+    if (statement.order_by() || statement.limit()) {
+      nodes.push_back(sort_node(statement, workers));
+    }
+    const size_t join_node = nodes.size();
+    nodes.push_back(
+        {"Hash Join",
+         {"Hash Cond: " + std::string(join.left_column_) + " = " +
+              std::string(join.right_column_),
+          "Workers: " + std::to_string(workers)},
+         {},
+         2});
+    for (size_t side = 0; side < tables.size(); ++side) {
+      nodes.push_back(
+          {"Seq Scan on " + tables[side]->name(),
+           scan_details(
+               filtered_side == side ? statement.expression() : std::nullopt),
+           {},
+           0});
+    }
+    plan(std::move(nodes));
+    if (plan_only()) {
+      result_.column_names_.clear();
+      return;
+    }
+
+    const std::vector<size_t> left_rows =
+        scan(left, predicates[0], buffers_, stats(join_node + 1));
+    const std::vector<size_t> right_rows =
+        scan(*right, predicates[1], buffers_, stats(join_node + 2));
+    std::vector<std::pair<size_t, size_t>> matches;
+    {
+      OperatorStats* join_stats = stats(join_node);
+      const OperatorTimer timer(join_stats);
+      matches = hash_join.run(left_rows, right_rows, workers);
+      // The matches and the rows of both sides of them.
+      buffers_.add(matches.size() * 2 * sizeof(matches.front()));
+      if (join_stats != nullptr) {
+        join_stats->rows_in_ = left_rows.size() + right_rows.size();
+        join_stats->rows_out_ = matches.size();
+        for (const JoinColumn& key : {left_key, right_key}) {
+          const Column& column = tables[key.side_]->columns()[key.column_];
+          join_stats->blocks_read_ += blocks_of(column.size());
+          join_stats->bytes_read_ += column.byte_size();
+        }
+      }
+    }
+
+    // Rows of either side of the matches.
+    const auto side_rows = [&](size_t side) {
+      std::vector<size_t> rows;
+      rows.reserve(matches.size());
+      for (const auto& [left_row, right_row] : matches) {
+        rows.push_back(side == 0 ? left_row : right_row);
+      }
+      return rows;
+    };
+    if (join_node == 2) {
+      const Column* sort_column = nullptr;
+      std::vector<size_t> sort_rows;
+      if (sort_key) {
+        sort_column = &tables[sort_key->side_]->columns()[sort_key->column_];
+        sort_rows = side_rows(sort_key->side_);
+      }
+      sort_items(statement, sort_column, sort_rows, workers, matches, stats(1));
+    }
+
+    OperatorStats* project_stats = stats(0);
+    const OperatorTimer timer(project_stats);
+    reserve_rows(matches.size(), projection.size());
+    result_.rows_.assign(matches.size(), std::vector<Cell>(projection.size()));
+    std::array<std::vector<size_t>, 2> rows = {side_rows(0), side_rows(1)};
+    for (size_t i = 0; i < projection.size(); ++i) {
+      const JoinColumn& column = projection[i];
+      read_cells(
+          tables[column.side_]->columns()[column.column_],
+          rows[column.side_],
+          i,
+          result_.rows_);
+    }
+    if (project_stats != nullptr) {
+      project_stats->rows_in_ = matches.size();
+      project_stats->rows_out_ = matches.size();
+    }
+  }
+
+  void aggregate(const Table& table, const sql::SelectStatement& statement) {
+    const Aggregation aggregation(table, statement);
+    std::optional<size_t> sort_item;
+    if (const auto& order_by = statement.order_by()) {
+      for (size_t i = 0; i < statement.column_list().size(); ++i) {
+        if (statement.aggregates()[i] == order_by->aggregate_ &&
+            statement.column_list()[i] == order_by->column_) {
+          sort_item = i;
+          break;
+        }
+      }
+      if (!sort_item) {
+        throw ExecutionError(
+            "ORDER BY " + statement.order_by_to_str() +
+            " must be in the column list");
+      }
+    }
+    std::optional<FilterProgram> predicate;
+    if (statement.expression()) {
+      predicate.emplace(table, *statement.expression());
+    }
+
+    std::string node = "Aggregate";
+    for (size_t i = 0; i < statement.column_list().size(); ++i) {
+      result_.column_names_.push_back(statement.item_to_str(i));
+      node += " " + result_.column_names_.back();
+    }
+    std::vector<std::string> details;
+    if (!statement.group_by().empty()) {
+      std::string group_key = "Group Key:";
+      for (const auto column_name : statement.group_by()) {
+        group_key += " " + std::string(column_name);
+      }
+      details.push_back(std::move(group_key));
+    }
+    const size_t workers = workers_for(table.row_count());
+    details.push_back("Workers: " + std::to_string(workers));
+    std::vector<PlanNode> nodes;
+    if (statement.order_by() || statement.limit()) {
+      nodes.push_back(sort_node(statement, workers));
+    }
+    const size_t aggregate_node = nodes.size();
+    nodes.push_back({node, std::move(details), {}});
+    nodes.push_back(
+        {"Seq Scan on " + table.name(),
+         scan_details(statement.expression()),
+         {}});
+    plan(std::move(nodes));
+    if (plan_only()) {
+      result_.column_names_.clear();
+      return;
+    }
+
+    const std::vector<size_t> selection =
+        scan(table, predicate, buffers_, stats(aggregate_node + 1));
+    {
+      OperatorStats* aggregate_stats = stats(aggregate_node);
+      const OperatorTimer timer(aggregate_stats);
+      result_.rows_ = aggregation.run(selection, workers);
+      if (aggregate_stats != nullptr) {
+        aggregate_stats->rows_in_ = selection.size();
+        aggregate_stats->rows_out_ = result_.rows_.size();
+        for (const size_t column : aggregation.columns()) {
+          aggregate_stats->blocks_read_ += blocks_of(table.row_count());
+          aggregate_stats->bytes_read_ += table.columns()[column].byte_size();
+        }
+      }
+    }
+    if (aggregate_node == 0) {
+      return;
+    }
+    // The result column is sorted as a column of its own.
+    std::optional<Column> sort_column;
+    std::vector<size_t> sort_rows;
+    if (sort_item && !result_.rows_.empty()) {
+      const Cell& first = result_.rows_.front()[*sort_item];
+      sort_column.emplace(
+          result_.column_names_[*sort_item],
+          std::holds_alternative<int>(first)     ? Column::Kind::Int
+          : std::holds_alternative<float>(first) ? Column::Kind::Real
+                                                 : Column::Kind::Text);
+      for (const auto& row : result_.rows_) {
+        sort_column->push_back(row[*sort_item]);
+      }
+      sort_rows.resize(result_.rows_.size());
+      std::iota(sort_rows.begin(), sort_rows.end(), size_t{0});
+    }
+    sort_items(
+        statement,
+        sort_column ? &*sort_column : nullptr,
+        sort_rows,
+        workers,
+        result_.rows_,
+        stats(0));
+  }
+
+  void plan(std::vector<PlanNode> nodes) {
+    if (profile_ != nullptr) {
+      profile_->nodes_ = std::move(nodes);
+    }
+  }
+
+  bool plan_only() const {
+    return profile_ != nullptr && !profile_->analyze_;
+  }
+
+  OperatorStats* stats(size_t node) const {
+    if (profile_ == nullptr || !profile_->analyze_) {
+      return nullptr;
+    }
+    return &profile_->nodes_[node].stats_;
+  }
+
+  static Cell default_cell(Column::Kind kind) {
+    switch (kind) {
+      case Column::Kind::Int:
+        return 0;
+      case Column::Kind::Real:
+        return 0.0F;
+      case Column::Kind::Text:
+        return std::string();
+    }
+    return 0;
+  }
+
+  // Charges the cells of result rows, not counting TEXT values.
+  void reserve_rows(size_t rows, size_t columns) {
+    buffers_.add(rows * (sizeof(std::vector<Cell>) + columns * sizeof(Cell)));
+  }
+
+  Table* find_table(std::string_view table_name) const {
+    Table* table = catalog_.find(table_name);
+    if (!table) {
+      throw ExecutionError("Unknown table " + std::string(table_name));
+    }
+    return table;
+  }
+
+  Catalog& catalog_;
+  Profile* profile_;
+  Result result_;
+  // Selections and result rows, which aren't allocated through a
+  // TrackingAllocator, charged to the statement's memory tracker.
+  memory::Reservation buffers_{memory::MemoryTracker::current()};
+};
+
+struct ExecutorMetrics {
+  std::array<metrics::Histogram*, sql::Statement::kKindCount> durations_;
+  std::array<metrics::Counter*, sql::Statement::kKindCount> errors_;
+};
+
+const ExecutorMetrics& executor_metrics() {
+  static const ExecutorMetrics executor_metrics = [] {
+    auto& registry = metrics::Registry::global();
+    ExecutorMetrics result{};
+    for (size_t i = 0; i < sql::Statement::kKindCount; ++i) {
+      const metrics::Labels labels = {
+          {"statement",
+           std::string(sql::statement_kind_to_str(sql::Statement::Kind(i)))}};
+      result.durations_[i] = &registry.histogram(
+          "rdb_statement_duration_seconds",
+          "Latency of successfully executed statements.",
+          labels);
+      result.errors_[i] = &registry.counter(
+          "rdb_statement_errors_total",
+          "Statements that failed to execute.",
+          labels);
+    }
+    return result;
+  }();
+  return executor_metrics;
+}
+
+Result execute_uncached(Catalog& catalog, const sql::Statement& statement) {
+  StatementExecutor statement_executor(catalog, nullptr);
+  statement.accept(statement_executor);
+  return statement_executor.take_result();
+}
+
+// Copies a statement into one whose strings point into `text` instead of
+// the script it was parsed from, so that it can be buffered across
+// scripts. Without `text` the strings stay where they are. Placeholders are
+// replaced with their values in `bound`.
+class StatementCopier : public sql::StatementVisitor {
+ public:
+  explicit StatementCopier(
+      std::deque<std::string>* text,
+      const std::vector<std::optional<sql::Value>>* bound = nullptr)
+      : text_(text), bound_(bound) {}
+
+  sql::StatementPtr take() { return std::move(copy_); }
+
+  void visit(const sql::DropTableStatement& statement) override {
+    copy_ = std::make_unique<const sql::DropTableStatement>(
+        keep(statement.table_name()));
+  }
+
+  void visit(const sql::InsertStatement& statement) override {
+    std::vector<std::string_view> column_names;
+    column_names.reserve(statement.column_names().size());
+    for (const auto column_name : statement.column_names()) {
+      column_names.push_back(keep(column_name));
+    }
+    std::vector<sql::Value> values;
+    values.reserve(statement.values().size());
+    for (const auto& value : statement.values()) {
+      values.push_back(keep(value));
+    }
+    copy_ = std::make_unique<const sql::InsertStatement>(
+        keep(statement.table_name()), column_names, values);
+  }
+
+  void visit(const sql::SelectStatement& statement) override {
+    std::vector<std::string_view> column_list;
+    column_list.reserve(statement.column_list().size());
+    for (const auto column : statement.column_list()) {
+      column_list.push_back(keep(column));
+    }
+    std::vector<std::string_view> group_by;
+    group_by.reserve(statement.group_by().size());
+    for (const auto column : statement.group_by()) {
+      group_by.push_back(keep(column));
+    }
+    std::optional<sql::Expression> expression;
+    if (statement.expression()) {
+      expression = keep(*statement.expression());
+    }
+    std::optional<sql::Join> join;
+    if (const auto& source = statement.join()) {
+      join.emplace(
+          keep(source->table_name_), keep(source->left_column_),
+          keep(source->right_column_));
+    }
+    std::optional<sql::SelectStatement::OrderBy> order_by;
+    if (const auto& source = statement.order_by()) {
+      order_by.emplace(
+          source->aggregate_, keep(source->column_), source->descending_);
+    }
+    copy_ = std::make_unique<const sql::SelectStatement>(
+        column_list, keep(statement.table_name()), std::move(expression),
+        statement.aggregates(), std::move(group_by), join, order_by,
+        statement.limit());
+  }
+
+  void visit(const sql::DeleteStatement& statement) override {
+    const std::string_view table_name = keep(statement.table_name());
+    if (!statement.expression()) {
+      copy_ = std::make_unique<const sql::DeleteStatement>(table_name);
+      return;
+    }
+    copy_ = std::make_unique<const sql::DeleteStatement>(
+        table_name, keep(*statement.expression()));
+  }
+
+  void visit(const sql::CreateTableStatement& statement) override {
+    std::vector<sql::ColumnDef> column_defs;
+    column_defs.reserve(statement.column_defs().size());
+    for (const auto& column_def : statement.column_defs()) {
+      column_defs.emplace_back(keep(column_def.column_name_), column_def.kind_);
+    }
+    copy_ = std::make_unique<const sql::CreateTableStatement>(
+        keep(statement.table_name()), column_defs);
+  }
+
+  void visit(const sql::ExplainStatement& statement) override {
+    statement.statement().accept(*this);
+    copy_ = std::make_unique<const sql::ExplainStatement>(
+        std::move(copy_), statement.analyze());
+  }
+
+  void visit(const sql::TransactionStatement& /*statement*/) override {
+    throw std::logic_error("Transaction statements aren't buffered");
+  }
+
+  void visit(const sql::AnalyzeStatement& /*statement*/) override {
+    throw std::logic_error("ANALYZE isn't buffered");
+  }
+
+ private:
+  std::string_view keep(std::string_view text) {
+    return text_ == nullptr ? text : text_->emplace_back(text);
+  }
+
+  sql::Value keep(const sql::Value& value) {
+    if (const auto* placeholder = std::get_if<sql::Placeholder>(&value)) {
+      return keep(*bound_->at(placeholder->index_));
+    }
+    if (const auto* text = std::get_if<std::string_view>(&value)) {
+      return keep(*text);
+    }
+    return value;
+  }
+
+  sql::Expression keep(const sql::Expression& expression) {
+    if (expression.kind_ == sql::Expression::Kind::Operand) {
+      const sql::Operand& operand = *expression.operand_;
+      if (operand.kind_ != sql::Operand::Kind::Placeholder) {
+        return sql::Operand(operand.kind_, keep(operand.value_));
+      }
+      const sql::Value value = keep(operand.value_);
+      const auto kind = std::holds_alternative<int>(value)
+          ? sql::Operand::Kind::Int
+          : std::holds_alternative<float>(value) ? sql::Operand::Kind::Real
+                                                 : sql::Operand::Kind::Text;
+      return sql::Operand(kind, value);
+    }
+    std::vector<sql::Expression> operands;
+    operands.reserve(expression.operands_.size());
+    for (const auto& operand : expression.operands_) {
+      operands.push_back(keep(operand));
+    }
+    if (expression.kind_ == sql::Expression::Kind::Comparison) {
+      return sql::Expression(
+          std::move(operands[0]), expression.operation_,
+          std::move(operands[1]));
+    }
+    return sql::Expression(expression.kind_, std::move(operands));
+  }
+
+  std::deque<std::string>* text_;
+  const std::vector<std::optional<sql::Value>>* bound_;
+  sql::StatementPtr copy_;
+};
+
+// The kind of the column every placeholder is inserted into or compared
+// with, where the table exists and the placeholder is a whole VALUES entry
+// or operand of a comparison with a column.
+class PlaceholderResolver : public sql::StatementVisitor {
+ public:
+  PlaceholderResolver(const Catalog& catalog, size_t placeholder_count)
+      : catalog_(catalog), kinds_(placeholder_count) {}
+
+  std::vector<std::optional<Column::Kind>> take() { return std::move(kinds_); }
+
+  void visit(const sql::DropTableStatement& /*statement*/) override {}
+
+  void visit(const sql::InsertStatement& statement) override {
+    const Table* table = catalog_.find(statement.table_name());
+    if (!table) {
+      return;
+    }
+    const auto& values = statement.values();
+    const auto& column_names = statement.column_names();
+    for (size_t i = 0; i < values.size() && i < column_names.size(); ++i) {
+      const auto* placeholder = std::get_if<sql::Placeholder>(&values[i]);
+      if (placeholder != nullptr) {
+        resolve(*table, column_names[i], *placeholder);
+      }
+    }
+  }
+
+  void visit(const sql::SelectStatement& statement) override {
+    resolve(statement.table_name(), statement.expression());
+  }
+
+  void visit(const sql::DeleteStatement& statement) override {
+    resolve(statement.table_name(), statement.expression());
+  }
+
+  void visit(const sql::CreateTableStatement& /*statement*/) override {}
+
+  void visit(const sql::ExplainStatement& statement) override {
+    statement.statement().accept(*this);
+  }
+
+  void visit(const sql::TransactionStatement& /*statement*/) override {}
+
+  void visit(const sql::AnalyzeStatement& /*statement*/) override {}
+
+ private:
+  void resolve(
+      const Table& table,
+      std::string_view column_name,
+      sql::Placeholder placeholder) {
+    if (const auto column = table.find_column(column_name)) {
+      kinds_.at(placeholder.index_) = table.columns()[*column].kind();
+    }
+  }
+
+  void resolve(
+      std::string_view table_name,
+      const std::optional<sql::Expression>& expression) {
+    const Table* table = catalog_.find(table_name);
+    if (table && expression) {
+      resolve(*table, *expression);
+    }
+  }
+
+  void resolve(const Table& table, const sql::Expression& expression) {
+    if (expression.kind_ != sql::Expression::Kind::Comparison) {
+      for (const auto& operand : expression.operands_) {
+        resolve(table, operand);
+      }
+      return;
+    }
+    const sql::Expression& first = expression.operands_[0];
+    const sql::Expression& second = expression.operands_[1];
+    if (first.kind_ != sql::Expression::Kind::Operand ||
+        second.kind_ != sql::Expression::Kind::Operand) {
+      return;
+    }
+    for (const auto& [column, value] :
+         {std::pair(&*first.operand_, &*second.operand_),
+          std::pair(&*second.operand_, &*first.operand_)}) {
+      if (column->kind_ == sql::Operand::Kind::Id &&
+          value->kind_ == sql::Operand::Kind::Placeholder) {
+        resolve(
+            table, std::get<std::string_view>(column->value_),
+            std::get<sql::Placeholder>(value->value_));
+      }
+    }
+  }
+
+  const Catalog& catalog_;
+  std::vector<std::optional<Column::Kind>> kinds_;
+};
+
+// Checks a write against `catalog` without changing any rows. CREATE and
+// DROP are applied, so `catalog` must be a transaction's own.
+void check_write(Catalog& catalog, const sql::Statement& statement) {
+  if (statement.kind() == sql::Statement::Kind::CreateTable ||
+      statement.kind() == sql::Statement::Kind::DropTable) {
+    execute_uncached(catalog, statement);
+    return;
+  }
+  Profile profile;
+  StatementExecutor checker(catalog, &profile);
+  statement.accept(checker);
+}
+
+std::unique_ptr<Catalog> copy_catalog(const Catalog& catalog) {
+  auto copy = std::make_unique<Catalog>();
+  for (auto& table : catalog.tables()) {
+    copy->create(std::move(table));
+  }
+  return copy;
+}
+
+bool divides(const sql::Expression& expression) {
+  if (expression.kind_ == sql::Expression::Kind::Divide) {
+    return true;
+  }
+  return std::any_of(
+      expression.operands_.begin(), expression.operands_.end(),
+      [](const sql::Expression& operand) { return divides(operand); });
+}
+
+// Checked writes can still fail while they are applied only by dividing
+// by zero in a DELETE condition.
+bool may_fail(const sql::Statement& statement) {
+  if (statement.kind() != sql::Statement::Kind::Delete) {
+    return false;
+  }
+  const auto& expression =
+      static_cast<const sql::DeleteStatement&>(statement).expression();
+  return expression && divides(*expression);
+}
+
+// The catalog and the rows of the tables a transaction writes, as they were
+// before COMMIT started to apply it.
+class CatalogBackup {
+ public:
+  CatalogBackup(
+      Catalog& catalog,
+      const std::vector<sql::StatementPtr>& statements)
+      : catalog_(catalog), tables_(catalog.tables()) {
+    for (const auto& statement : statements) {
+      const std::string_view table_name = written_table(*statement);
+      Table* table = table_name.empty() ? nullptr : catalog.find(table_name);
+      const bool copied = std::any_of(
+          rows_.begin(), rows_.end(),
+          [&](const auto& copy) { return copy.first == table; });
+      if (table && !copied) {
+        rows_.emplace_back(table, *table);
+      }
+    }
+  }
+
+  void restore() {
+    for (auto& [table, rows] : rows_) {
+      *table = std::move(rows);
+    }
+    for (const auto& table : catalog_.tables()) {
+      if (std::find(tables_.begin(), tables_.end(), table) == tables_.end()) {
+        catalog_.drop(table->name());
+      }
+    }
+    for (auto& table : tables_) {
+      if (catalog_.find(table->name()) != table.get()) {
+        catalog_.create(std::move(table));
+      }
+    }
+  }
+
+ private:
+  Catalog& catalog_;
+  std::vector<TablePtr> tables_;
+  // The tables are among `tables_`, which keeps them alive.
+  std::vector<std::pair<Table*, Table>> rows_;
+};
+
+}  // namespace
+
+std::string_view written_table(const sql::Statement& statement) {
+  if (statement.kind() == sql::Statement::Kind::Insert) {
+    return static_cast<const sql::InsertStatement&>(statement).table_name();
+  }
+  if (statement.kind() == sql::Statement::Kind::Delete) {
+    return static_cast<const sql::DeleteStatement&>(statement).table_name();
+  }
+  return {};
+}
+
+bool is_write(const sql::Statement& statement) {
+  switch (statement.kind()) {
+    case sql::Statement::Kind::Select:
+    case sql::Statement::Kind::Begin:
+    case sql::Statement::Kind::Commit:
+    case sql::Statement::Kind::Rollback:
+    case sql::Statement::Kind::Analyze:
+      return false;
+    case sql::Statement::Kind::Explain: {
+      const auto& explain =
+          static_cast<const sql::ExplainStatement&>(statement);
+      return explain.analyze() && is_write(explain.statement());
+    }
+    default:
+      return true;
+  }
+}
+
+Result Executor::execute(
+    const sql::Statement& statement,
+    Transaction& transaction) {
+  const ExecutorMetrics& metrics = executor_metrics();
+  const auto kind = size_t(statement.kind());
+  const auto start = std::chrono::steady_clock::now();
+  memory::MemoryTracker statement_memory(
+      "statement", &memory::MemoryTracker::current(), statement_memory_limit_);
+  Result result;
+  try {
+    // Keeps the tables the statement looks up alive, even if they are
+    // dropped meanwhile.
+    const sync::EpochGuard guard;
+    const memory::MemoryScope scope(statement_memory);
+    const bool control = statement.kind() == sql::Statement::Kind::Begin ||
+                         statement.kind() == sql::Statement::Kind::Commit ||
+                         statement.kind() == sql::Statement::Kind::Rollback;
+    if (control || (transaction.active() && is_write(statement))) {
+      result = execute_in_transaction(statement, transaction);
+    } else {
+      result = cache_ != nullptr ? execute_cached(statement)
+                                 : execute_uncached(catalog_, statement);
+      if (log_ != nullptr && is_write(statement)) {
+        log_->append(statement);
+        log_->flush();
+      }
+    }
+  } catch (const ExecutionError&) {
+    metrics.errors_[kind]->add();
+    throw;
+  } catch (const memory::MemoryLimitError& e) {
+    metrics.errors_[kind]->add();
+    throw ExecutionError(e.what());
+  }
+  // Frees what was dropped while this or another statement was pinned.
+  catalog_.reclaim();
+  result.peak_memory_bytes_ = statement_memory.peak();
+  const auto duration = std::chrono::steady_clock::now() - start;
+  metrics.durations_[kind]->record(static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()));
+  return result;
+}
+
+PreparedStatement Executor::prepare(std::string sql) const {
+  PreparedStatement prepared;
+  prepared.sql_ = std::make_unique<const std::string>(std::move(sql));
+  sql::Lexer lexer(*prepared.sql_);
+  sql::Parser parser(lexer);
+  sql::Parser::Result parsed = parser.parse_prepared_statement();
+  if (!parsed.errors_.empty()) {
+    throw ExecutionError(parsed.errors_.front());
+  }
+  prepared.statement_ = std::move(parsed.script_.statements_.front());
+  prepared.memory_ = std::move(parsed.memory_);
+  const sync::EpochGuard guard;
+  PlaceholderResolver resolver(catalog_, parser.placeholder_count());
+  prepared.statement_->accept(resolver);
+  prepared.kinds_ = resolver.take();
+  prepared.values_.resize(parser.placeholder_count());
+  prepared.texts_.resize(parser.placeholder_count());
+  return prepared;
+}
+
+Result Executor::execute(
+    const PreparedStatement& statement,
+    Transaction& transaction) {
+  if (statement.placeholder_count() == 0) {
+    return execute(*statement.statement_, transaction);
+  }
+  for (size_t i = 0; i < statement.values_.size(); ++i) {
+    if (!statement.values_[i]) {
+      throw ExecutionError("Placeholder " + std::to_string(i) + " isn't bound");
+    }
+  }
+  StatementCopier binder(nullptr, &statement.values_);
+  statement.statement_->accept(binder);
+  return execute(*binder.take(), transaction);
+}
+
+void PreparedStatement::bind(size_t index, int value) {
+  check_kind(index, Column::Kind::Int);
+  values_[index] = value;
+}
+
+void PreparedStatement::bind(size_t index, float value) {
+  check_kind(index, Column::Kind::Real);
+  values_[index] = value;
+}
+
+void PreparedStatement::bind(size_t index, std::string_view text) {
+  check_kind(index, Column::Kind::Text);
+  std::string& quoted = texts_[index];
+  quoted.assign(1, '"');
+  quoted += text;
+  quoted += '"';
+  values_[index] = std::string_view(quoted);
+}
+
+void PreparedStatement::clear_bindings() {
+  std::fill(values_.begin(), values_.end(), std::nullopt);
+}
+
+void PreparedStatement::check_kind(size_t index, Column::Kind kind) const {
+  if (index >= values_.size()) {
+    throw ExecutionError("No placeholder " + std::to_string(index));
+  }
+  const std::optional<Column::Kind>& expected = kinds_[index];
+  if (expected && *expected != kind &&
+      !(*expected == Column::Kind::Real && kind == Column::Kind::Int)) {
+    throw ExecutionError(
+        "Placeholder " + std::to_string(index) + " expects " +
+        sql::column_kind_to_str(*expected));
+  }
+}
+
+Result Executor::execute_cached(const sql::Statement& statement) {
+  switch (statement.kind()) {
+    case sql::Statement::Kind::Select: {
+      const auto& select = static_cast<const sql::SelectStatement&>(statement);
+      const Table* table = catalog_.find(select.table_name());
+      // Entries are invalidated by changes to the FROM table only.
+      if (!table || select.join()) {
+        break;
+      }
+      std::string key = ResultCache::key(select);
+      if (auto cached = cache_->find(*table, key)) {
+        return std::move(*cached);
+      }
+      Result result = execute_uncached(catalog_, statement);
+      cache_->insert(*table, std::move(key), result);
+      return result;
+    }
+    case sql::Statement::Kind::DropTable: {
+      Result result = execute_uncached(catalog_, statement);
+      // Other writes bump the table version, which the cache checks itself.
+      cache_->invalidate(
+          static_cast<const sql::DropTableStatement&>(statement).table_name());
+      return result;
+    }
+    default:
+      break;
+  }
+  return execute_uncached(catalog_, statement);
+}
+
+Result Executor::execute_in_transaction(
+    const sql::Statement& statement,
+    Transaction& transaction) {
+  switch (statement.kind()) {
+    case sql::Statement::Kind::Begin:
+      if (transaction.active()) {
+        throw ExecutionError("A transaction is already in progress");
+      }
+      transaction.catalog_version_ = catalog_.version();
+      transaction.catalog_ = copy_catalog(catalog_);
+      return {};
+    case sql::Statement::Kind::Commit:
+      if (!transaction.active()) {
+        throw ExecutionError("No transaction in progress");
+      }
+      return commit(transaction);
+    case sql::Statement::Kind::Rollback:
+      if (!transaction.active()) {
+        throw ExecutionError("No transaction in progress");
+      }
+      transaction = Transaction();
+      return {};
+    default:
+      break;
+  }
+  if (statement.kind() == sql::Statement::Kind::Explain) {
+    throw ExecutionError("Can't EXPLAIN ANALYZE a write in a transaction");
+  }
+  // A write that doesn't fit fails on its own; the transaction goes on.
+  check_write(*transaction.catalog_, statement);
+  StatementCopier copier(&transaction.text_);
+  statement.accept(copier);
+  transaction.statements_.push_back(copier.take());
+  return {};
+}
+
+Result Executor::commit(Transaction& transaction) {
+  // The transaction ends whether or not it can be applied.
+  const Transaction committed = std::exchange(transaction, Transaction());
+  const auto& statements = committed.statements_;
+  if (committed.catalog_version_ != catalog_.version()) {
+    // Another session created or dropped tables since BEGIN.
+    const std::unique_ptr<Catalog> catalog = copy_catalog(catalog_);
+    try {
+      for (const auto& statement : statements) {
+        check_write(*catalog, *statement);
+      }
+    } catch (const ExecutionError& e) {
+      throw ExecutionError(
+          std::string("Transaction rolled back: ") + e.what());
+    }
+  }
+
+  std::optional<CatalogBackup> backup;
+  if (std::any_of(statements.begin(), statements.end(), [](const auto& s) {
+        return may_fail(*s);
+      })) {
+    backup.emplace(catalog_, statements);
+  }
+  Result result;
+  try {
+    // The writes were checked, so they aren't held to the statement's
+    // memory limits, which could stop them half-way.
+    const memory::MemoryScope scope(memory::MemoryTracker::process());
+    for (const auto& statement : statements) {
+      result.affected_rows_ +=
+          (cache_ != nullptr ? execute_cached(*statement)
+                             : execute_uncached(catalog_, *statement))
+              .affected_rows_;
+    }
+  } catch (const ExecutionError& e) {
+    if (backup) {
+      backup->restore();
+    }
+    throw ExecutionError(std::string("Transaction rolled back: ") + e.what());
+  }
+
+  if (log_ != nullptr && !statements.empty()) {
+    log_->append(sql::TransactionStatement(sql::Statement::Kind::Begin));
+    for (const auto& statement : statements) {
+      log_->append(*statement);
+    }
+    log_->append(sql::TransactionStatement(sql::Statement::Kind::Commit));
+    log_->flush();
+  }
+  return result;
+}
+
+}  // namespace rdb::exec
@@ -0,0 +1,834 @@
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <librdb/exec/Encoding.hpp>
+#include <librdb/exec/Executor.hpp>
+#include <librdb/exec/FilterProgram.hpp>
+#include <librdb/exec/Statistics.hpp>
+#include <numeric>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace rdb::exec {
+
+namespace {
+
+// INT arithmetic is done in 64 bits and wraps instead of overflowing.
+int64_t wrap(uint64_t value) {
+  return static_cast<int64_t>(value);
+}
+
+int64_t apply(sql::Expression::Kind kind, int64_t lhs, int64_t rhs) {
+  switch (kind) {
+    case sql::Expression::Kind::Add:
+      return wrap(uint64_t(lhs) + uint64_t(rhs));
+    case sql::Expression::Kind::Subtract:
+      return wrap(uint64_t(lhs) - uint64_t(rhs));
+    case sql::Expression::Kind::Multiply:
+      return wrap(uint64_t(lhs) * uint64_t(rhs));
+    default:
+      if (rhs == 0) {
+        throw ExecutionError("Division by zero");
+      }
+      return rhs == -1 ? wrap(0 - uint64_t(lhs)) : lhs / rhs;
+  }
+}
+
+double apply(sql::Expression::Kind kind, double lhs, double rhs) {
+  switch (kind) {
+    case sql::Expression::Kind::Add:
+      return lhs + rhs;
+    case sql::Expression::Kind::Subtract:
+      return lhs - rhs;
+    case sql::Expression::Kind::Multiply:
+      return lhs * rhs;
+    default:
+      return lhs / rhs;
+  }
+}
+
+std::string_view unquote(std::string_view text) {
+  if (text.size() >= 2 && text.front() == '"' && text.back() == '"') {
+    return text.substr(1, text.size() - 2);
+  }
+  return text;
+}
+
+// A value for every row of a block, of the type the program gave it.
+struct Register {
+  // A constant has one element that stands for every row.
+  bool constant_ = false;
+  std::vector<int64_t> ints_;
+  std::vector<double> reals_;
+  std::vector<std::string_view> texts_;
+};
+
+template <typename T>
+const T* data(const Register& value) {
+  if constexpr (std::is_same_v<T, int64_t>) {
+    return value.ints_.data();
+  } else if constexpr (std::is_same_v<T, double>) {
+    return value.reals_.data();
+  } else {
+    return value.texts_.data();
+  }
+}
+
+// Calls `function` with accessors `value(i)` for the two registers, so
+// constants are read without an index and the loops over the rows are
+// compiled once per combination.
+template <typename T, typename Function>
+void with_operands(
+    const Register& first,
+    const Register& second,
+    Function&& function) {
+  const T* lhs = data<T>(first);
+  const T* rhs = data<T>(second);
+  const auto vector = [](const T* values) {
+    return [values](size_t i) { return values[i]; };
+  };
+  const auto scalar = [](const T* values) {
+    return [value = values[0]](size_t /*i*/) { return value; };
+  };
+  if (first.constant_ && second.constant_) {
+    function(scalar(lhs), scalar(rhs));
+  } else if (first.constant_) {
+    function(scalar(lhs), vector(rhs));
+  } else if (second.constant_) {
+    function(vector(lhs), scalar(rhs));
+  } else {
+    function(vector(lhs), vector(rhs));
+  }
+}
+
+// Writes the rows of `input` for which `matches(row)` holds to `output`,
+// without a branch per row.
+template <typename Matches>
+void select_where(
+    const std::vector<size_t>& input,
+    std::vector<size_t>& output,
+    Matches matches) {
+  output.resize(input.size());
+  size_t size = 0;
+  for (const size_t row : input) {
+    output[size] = row;
+    size += matches(row) ? 1 : 0;
+  }
+  output.resize(size);
+}
+
+template <typename T>
+void compare(
+    sql::Expression::Operation operation,
+    const Register& first,
+    const Register& second,
+    size_t first_row,
+    const std::vector<size_t>& input,
+    std::vector<size_t>& output) {
+  with_comparison(operation, [&](auto comparison) {
+    with_operands<T>(first, second, [&](auto lhs, auto rhs) {
+      select_where(input, output, [&](size_t row) {
+        return comparison(lhs(row - first_row), rhs(row - first_row));
+      });
+    });
+  });
+}
+
+template <typename T>
+void compute(
+    sql::Expression::Kind kind,
+    const Register& first,
+    const Register& second,
+    size_t first_row,
+    const std::vector<size_t>& input,
+    T* output) {
+  with_operands<T>(first, second, [&](auto lhs, auto rhs) {
+    // One loop per operation keeps the switch out of the loops.
+    const auto loop = [&](auto operation) {
+      for (const size_t row : input) {
+        const size_t i = row - first_row;
+        output[i] = apply(operation, lhs(i), rhs(i));
+      }
+    };
+    switch (kind) {
+      case sql::Expression::Kind::Add:
+        loop(std::integral_constant<
+             sql::Expression::Kind,
+             sql::Expression::Kind::Add>());
+        break;
+      case sql::Expression::Kind::Subtract:
+        loop(std::integral_constant<
+             sql::Expression::Kind,
+             sql::Expression::Kind::Subtract>());
+        break;
+      case sql::Expression::Kind::Multiply:
+        loop(std::integral_constant<
+             sql::Expression::Kind,
+             sql::Expression::Kind::Multiply>());
+        break;
+      default:
+        loop(std::integral_constant<
+             sql::Expression::Kind,
+             sql::Expression::Kind::Divide>());
+        break;
+    }
+  });
+}
+
+bool divides(const sql::Expression& expression) {
+  if (expression.kind_ == sql::Expression::Kind::Divide) {
+    return true;
+  }
+  return std::any_of(
+      expression.operands_.begin(), expression.operands_.end(),
+      [](const sql::Expression& operand) { return divides(operand); });
+}
+
+// Relative cost per row of evaluating an expression: 1 for every operation
+// and INT or REAL column, 4 for a TEXT column, nothing for a constant.
+double value_cost(const Table& table, const sql::Expression& expression) {
+  if (expression.kind_ == sql::Expression::Kind::Operand) {
+    const sql::Operand& operand = *expression.operand_;
+    if (operand.kind_ != sql::Operand::Kind::Id) {
+      return 0;
+    }
+    const auto column =
+        table.find_column(std::get<std::string_view>(operand.value_));
+    return column && table.columns()[*column].kind() == Column::Kind::Text
+        ? 4
+        : 1;
+  }
+  double cost = 1;
+  for (const sql::Expression& operand : expression.operands_) {
+    cost += value_cost(table, operand);
+  }
+  return cost;
+}
+
+double condition_cost(const Table& table, const sql::Expression& condition);
+
+// Cost per row of an AND or OR with its operands as written and swapped.
+// The second operand only sees the rows that passed the first for AND and
+// those that failed it for OR.
+std::pair<double, double> operand_order_costs(
+    const Table& table,
+    const sql::Expression& condition) {
+  const bool is_and = condition.kind_ == sql::Expression::Kind::And;
+  const auto reaching = [&](const sql::Expression& operand) {
+    const double selectivity = estimate_selectivity(table, operand);
+    return is_and ? selectivity : 1 - selectivity;
+  };
+  const sql::Expression& first = condition.operands_[0];
+  const sql::Expression& second = condition.operands_[1];
+  const double first_cost = condition_cost(table, first);
+  const double second_cost = condition_cost(table, second);
+  return {
+      first_cost + reaching(first) * second_cost,
+      second_cost + reaching(second) * first_cost};
+}
+
+// Operands that divide keep their order: a division by zero is an error
+// only on the rows the condition as written evaluates it for.
+bool evaluate_second_first(
+    const Table& table,
+    const sql::Expression& condition) {
+  if (divides(condition)) {
+    return false;
+  }
+  const auto [as_written, swapped] = operand_order_costs(table, condition);
+  return swapped < as_written;
+}
+
+double condition_cost(const Table& table, const sql::Expression& condition) {
+  switch (condition.kind_) {
+    case sql::Expression::Kind::And:
+    case sql::Expression::Kind::Or: {
+      const auto [as_written, swapped] = operand_order_costs(table, condition);
+      return divides(condition) ? as_written : std::min(as_written, swapped);
+    }
+    case sql::Expression::Kind::Not:
+      return condition_cost(table, condition.operands_[0]);
+    default:
+      return value_cost(table, condition);
+  }
+}
+
+}  // namespace
+
+// Registers and decoded column blocks of one run.
+class FilterProgram::Frame {
+ public:
+  explicit Frame(const FilterProgram& program)
+      : values_(program.value_types_.size()),
+        selections_(program.selection_count_),
+        decoded_blocks_(
+            program.table_.columns().size(),
+            std::numeric_limits<size_t>::max()),
+        int_scratch_(program.table_.columns().size()),
+        real_scratch_(program.table_.columns().size()),
+        ints_(program.table_.columns().size()),
+        reals_(program.table_.columns().size()) {
+    for (const auto& constant : program.constants_) {
+      Register& value = values_[constant.register_];
+      value.constant_ = true;
+      value.ints_.push_back(constant.int_);
+      value.reals_.push_back(constant.real_);
+      value.texts_.emplace_back(constant.text_);
+    }
+    for (size_t i = 0; i < values_.size(); ++i) {
+      if (values_[i].constant_) {
+        continue;
+      }
+      switch (program.value_types_[i]) {
+        case Type::Int:
+          values_[i].ints_.resize(kBlockRows);
+          break;
+        case Type::Real:
+          values_[i].reals_.resize(kBlockRows);
+          break;
+        case Type::Text:
+          values_[i].texts_.resize(kBlockRows);
+          break;
+      }
+    }
+  }
+
+  void start_block(size_t block, size_t rows) {
+    block_ = block;
+    first_row_ = block * kBlockRows;
+    rows_ = rows;
+    selections_[0].resize(rows);
+    std::iota(selections_[0].begin(), selections_[0].end(), first_row_);
+  }
+
+  // The current block of an INT (T = int) or REAL (T = float) column,
+  // decoded at most once per block.
+  template <typename T>
+  const T* block_values(const Column& column, size_t index) {
+    auto& values = values_of<T>();
+    if (decoded_blocks_[index] != block_) {
+      decoded_blocks_[index] = block_;
+      ints_[index] = nullptr;
+      reals_[index] = nullptr;
+    }
+    if (values[index] == nullptr) {
+      values[index] = column.block_values(block_, scratch_of<T>()[index]);
+    }
+    return values[index];
+  }
+
+  std::vector<Register> values_;
+  std::vector<std::vector<size_t>> selections_;
+  size_t block_ = 0;
+  size_t first_row_ = 0;
+  size_t rows_ = 0;
+  OperatorStats bloom_stats_;
+  // The comparisons of the block whose probe passed.
+  std::vector<uint16_t> probed_comparisons_;
+
+ private:
+  template <typename T>
+  std::vector<const T*>& values_of() {
+    if constexpr (std::is_same_v<T, int>) {
+      return ints_;
+    } else {
+      return reals_;
+    }
+  }
+
+  template <typename T>
+  std::vector<std::vector<T>>& scratch_of() {
+    if constexpr (std::is_same_v<T, int>) {
+      return int_scratch_;
+    } else {
+      return real_scratch_;
+    }
+  }
+
+  std::vector<size_t> decoded_blocks_;
+  std::vector<std::vector<int>> int_scratch_;
+  std::vector<std::vector<float>> real_scratch_;
+  std::vector<const int*> ints_;
+  std::vector<const float*> reals_;
+};
+
+FilterProgram::FilterProgram(
+    const Table& table,
+    const sql::Expression& expression)
+    : table_(table) {
+  result_ = compile_condition(expression, 0);
+  std::sort(columns_.begin(), columns_.end());
+  columns_.erase(std::unique(columns_.begin(), columns_.end()), columns_.end());
+}
+
+void FilterProgram::run(
+    std::vector<size_t>& selection,
+    OperatorStats* stats) const {
+  Frame frame(*this);
+  const size_t row_count = table_.row_count();
+  for (size_t first_row = 0; first_row < row_count; first_row += kBlockRows) {
+    frame.start_block(
+        first_row / kBlockRows, std::min(kBlockRows, row_count - first_row));
+    for (const auto& instruction : instructions_) {
+      execute(instruction, frame);
+    }
+    for (const uint16_t comparison : frame.probed_comparisons_) {
+      if (frame.selections_[comparison].empty()) {
+        ++frame.bloom_stats_.bloom_false_positives_;
+      }
+    }
+    frame.probed_comparisons_.clear();
+    const auto& matching = frame.selections_[result_];
+    selection.insert(selection.end(), matching.begin(), matching.end());
+  }
+  if (stats != nullptr) {
+    stats->bloom_probes_ += frame.bloom_stats_.bloom_probes_;
+    stats->bloom_skipped_ += frame.bloom_stats_.bloom_skipped_;
+    stats->bloom_false_positives_ +=
+        frame.bloom_stats_.bloom_false_positives_;
+  }
+}
+
+void FilterProgram::execute(
+    const Instruction& instruction,
+    Frame& frame) const {
+  const std::vector<size_t>& input = frame.selections_[instruction.input_];
+  const size_t first_row = frame.first_row_;
+  switch (instruction.code_) {
+    case OpCode::LoadColumn: {
+      const Column& column = table_.columns()[instruction.column_];
+      Register& output = frame.values_[instruction.output_];
+      if (instruction.type_ == Type::Int) {
+        const int* values =
+            frame.block_values<int>(column, instruction.column_);
+        for (const size_t row : input) {
+          output.ints_[row - first_row] = values[row - first_row];
+        }
+      } else if (instruction.type_ == Type::Real) {
+        const float* values =
+            frame.block_values<float>(column, instruction.column_);
+        for (const size_t row : input) {
+          output.reals_[row - first_row] = values[row - first_row];
+        }
+      } else {
+        for (const size_t row : input) {
+          output.texts_[row - first_row] = column.text(row);
+        }
+      }
+      break;
+    }
+    case OpCode::IntToReal: {
+      const Register& value = frame.values_[instruction.first_];
+      Register& output = frame.values_[instruction.output_];
+      for (const size_t row : input) {
+        output.reals_[row - first_row] =
+            static_cast<double>(value.ints_[row - first_row]);
+      }
+      break;
+    }
+    case OpCode::Arithmetic: {
+      const Register& first = frame.values_[instruction.first_];
+      const Register& second = frame.values_[instruction.second_];
+      Register& output = frame.values_[instruction.output_];
+      if (instruction.type_ == Type::Int) {
+        compute<int64_t>(
+            instruction.arithmetic_,
+            first,
+            second,
+            first_row,
+            input,
+            output.ints_.data());
+      } else {
+        compute<double>(
+            instruction.arithmetic_,
+            first,
+            second,
+            first_row,
+            input,
+            output.reals_.data());
+      }
+      break;
+    }
+    case OpCode::Compare: {
+      const Register& first = frame.values_[instruction.first_];
+      const Register& second = frame.values_[instruction.second_];
+      auto& output = frame.selections_[instruction.output_];
+      switch (instruction.type_) {
+        case Type::Int:
+          compare<int64_t>(
+              instruction.comparison_, first, second, first_row, input, output);
+          break;
+        case Type::Real:
+          compare<double>(
+              instruction.comparison_, first, second, first_row, input, output);
+          break;
+        case Type::Text:
+          compare<std::string_view>(
+              instruction.comparison_, first, second, first_row, input, output);
+          break;
+      }
+      break;
+    }
+    case OpCode::FilterColumn: {
+      const Column& column = table_.columns()[instruction.column_];
+      auto& output = frame.selections_[instruction.output_];
+      output.clear();
+      // While no row of the block is filtered out yet, the whole block can
+      // be filtered without decoding it.
+      const bool complete = input.size() == frame.rows_;
+      if (instruction.type_ == Type::Int) {
+        if (complete) {
+          column.filter_block(
+              frame.block_, instruction.comparison_, instruction.int_constant_,
+              output);
+          break;
+        }
+        const int* values =
+            frame.block_values<int>(column, instruction.column_);
+        const int constant = instruction.int_constant_;
+        with_comparison(instruction.comparison_, [&](auto comparison) {
+          select_where(input, output, [&](size_t row) {
+            return comparison(values[row - first_row], constant);
+          });
+        });
+      } else {
+        if (complete) {
+          column.filter_block(
+              frame.block_, instruction.comparison_,
+              instruction.real_constant_, output);
+          break;
+        }
+        const float* values =
+            frame.block_values<float>(column, instruction.column_);
+        const float constant = instruction.real_constant_;
+        with_comparison(instruction.comparison_, [&](auto comparison) {
+          select_where(input, output, [&](size_t row) {
+            return comparison(values[row - first_row], constant);
+          });
+        });
+      }
+      break;
+    }
+    case OpCode::ProbeText: {
+      auto& output = frame.selections_[instruction.output_];
+      output.clear();
+      if (input.empty()) {
+        break;
+      }
+      ++frame.bloom_stats_.bloom_probes_;
+      const Column& column = table_.columns()[instruction.column_];
+      if (!column.block_may_contain(frame.block_, instruction.text_hash_)) {
+        ++frame.bloom_stats_.bloom_skipped_;
+        break;
+      }
+      output = input;
+      frame.probed_comparisons_.push_back(instruction.second_);
+      break;
+    }
+    case OpCode::Difference: {
+      const auto& first = frame.selections_[instruction.first_];
+      const auto& second = frame.selections_[instruction.second_];
+      auto& output = frame.selections_[instruction.output_];
+      output.clear();
+      std::set_difference(
+          first.begin(), first.end(), second.begin(), second.end(),
+          std::back_inserter(output));
+      break;
+    }
+    case OpCode::Union: {
+      const auto& first = frame.selections_[instruction.first_];
+      const auto& second = frame.selections_[instruction.second_];
+      auto& output = frame.selections_[instruction.output_];
+      output.clear();
+      std::merge(
+          first.begin(), first.end(), second.begin(), second.end(),
+          std::back_inserter(output));
+      break;
+    }
+  }
+}
+
+uint16_t FilterProgram::compile_condition(
+    const sql::Expression& expression,
+    uint16_t input) {
+  switch (expression.kind_) {
+    case sql::Expression::Kind::And:
+    case sql::Expression::Kind::Or: {
+      // The operand that is cheaper and decides more rows by itself first,
+      // going by the table's statistics.
+      const bool swap = evaluate_second_first(table_, expression);
+      const sql::Expression& first_operand = expression.operands_[swap ? 1 : 0];
+      const sql::Expression& second_operand =
+          expression.operands_[swap ? 0 : 1];
+      const uint16_t first = compile_condition(first_operand, input);
+      if (expression.kind_ == sql::Expression::Kind::And) {
+        return compile_condition(second_operand, first);
+      }
+      Instruction rest{OpCode::Difference};
+      rest.output_ = new_selection();
+      rest.first_ = input;
+      rest.second_ = first;
+      instructions_.push_back(rest);
+      const uint16_t second = compile_condition(second_operand, rest.output_);
+      Instruction merge{OpCode::Union};
+      merge.output_ = new_selection();
+      merge.first_ = first;
+      merge.second_ = second;
+      instructions_.push_back(merge);
+      return merge.output_;
+    }
+    case sql::Expression::Kind::Not: {
+      const uint16_t inner = compile_condition(expression.operands_[0], input);
+      Instruction rest{OpCode::Difference};
+      rest.output_ = new_selection();
+      rest.first_ = input;
+      rest.second_ = inner;
+      instructions_.push_back(rest);
+      return rest.output_;
+    }
+    case sql::Expression::Kind::Comparison: {
+      const uint16_t output = new_selection();
+      if (compile_filter(expression, input, output)) {
+        return output;
+      }
+      input = compile_probe(expression, input, output);
+      const sql::Expression& first_operand = expression.operands_[0];
+      const sql::Expression& second_operand = expression.operands_[1];
+      Value first = compile_value(first_operand, input);
+      Value second = compile_value(second_operand, input);
+      if ((first.type_ == Type::Text) != (second.type_ == Type::Text)) {
+        throw ExecutionError(
+            "Can't compare " + sql::expression_to_str(first_operand) +
+            " with " + sql::expression_to_str(second_operand));
+      }
+      if (first.type_ != second.type_) {
+        first = to_real(first, input);
+        second = to_real(second, input);
+      }
+      Instruction instruction{OpCode::Compare};
+      instruction.type_ = first.type_;
+      instruction.comparison_ = expression.operation_;
+      instruction.output_ = output;
+      instruction.input_ = input;
+      instruction.first_ = first.register_;
+      instruction.second_ = second.register_;
+      instructions_.push_back(instruction);
+      return output;
+    }
+    default:
+      throw ExecutionError(
+          "Expected a condition, got " + sql::expression_to_str(expression));
+  }
+}
+
+FilterProgram::Value FilterProgram::compile_value(
+    const sql::Expression& expression,
+    uint16_t input) {
+  switch (expression.kind_) {
+    case sql::Expression::Kind::Operand:
+      return compile_operand(*expression.operand_, input);
+    case sql::Expression::Kind::Add:
+    case sql::Expression::Kind::Subtract:
+    case sql::Expression::Kind::Multiply:
+    case sql::Expression::Kind::Divide: {
+      Value first = compile_value(expression.operands_[0], input);
+      Value second = compile_value(expression.operands_[1], input);
+      if (first.type_ == Type::Text || second.type_ == Type::Text) {
+        throw ExecutionError(
+            "Can't compute " + sql::expression_to_str(expression) +
+            " on TEXT");
+      }
+      if (first.type_ != second.type_) {
+        first = to_real(first, input);
+        second = to_real(second, input);
+      }
+      Instruction instruction{OpCode::Arithmetic};
+      instruction.type_ = first.type_;
+      instruction.arithmetic_ = expression.kind_;
+      instruction.output_ = new_value(first.type_);
+      instruction.input_ = input;
+      instruction.first_ = first.register_;
+      instruction.second_ = second.register_;
+      instructions_.push_back(instruction);
+      return {instruction.output_, first.type_};
+    }
+    default:
+      throw ExecutionError(
+          "Expected a value, got " + sql::expression_to_str(expression));
+  }
+}
+
+FilterProgram::Value FilterProgram::compile_operand(
+    const sql::Operand& operand,
+    uint16_t input) {
+  if (operand.kind_ == sql::Operand::Kind::Id) {
+    const auto column_name = std::get<std::string_view>(operand.value_);
+    const auto column = table_.find_column(column_name);
+    if (!column) {
+      throw ExecutionError("Unknown column " + std::string(column_name));
+    }
+    Type type = Type::Int;
+    switch (table_.columns()[*column].kind()) {
+      case Column::Kind::Int:
+        type = Type::Int;
+        break;
+      case Column::Kind::Real:
+        type = Type::Real;
+        break;
+      case Column::Kind::Text:
+        type = Type::Text;
+        break;
+    }
+    Instruction instruction{OpCode::LoadColumn};
+    instruction.type_ = type;
+    instruction.output_ = new_value(type);
+    instruction.input_ = input;
+    instruction.column_ = static_cast<uint32_t>(*column);
+    instructions_.push_back(instruction);
+    columns_.push_back(*column);
+    return {instruction.output_, type};
+  }
+
+  Constant constant{0, Type::Int, 0, 0, {}};
+  if (const int* i = std::get_if<int>(&operand.value_)) {
+    constant.int_ = *i;
+  } else if (const float* f = std::get_if<float>(&operand.value_)) {
+    constant.type_ = Type::Real;
+    constant.real_ = *f;
+  } else if (const auto* t = std::get_if<std::string_view>(&operand.value_)) {
+    constant.type_ = Type::Text;
+    constant.text_ = unquote(*t);
+  } else {
+    throw ExecutionError("Placeholders must be bound");
+  }
+  constant.register_ = new_value(constant.type_);
+  constants_.push_back(constant);
+  return {constant.register_, constant.type_};
+}
+
+bool FilterProgram::compile_filter(
+    const sql::Expression& expression,
+    uint16_t input,
+    uint16_t output) {
+  const sql::Expression& first = expression.operands_[0];
+  const sql::Expression& second = expression.operands_[1];
+  if (first.kind_ != sql::Expression::Kind::Operand ||
+      second.kind_ != sql::Expression::Kind::Operand) {
+    return false;
+  }
+  const sql::Operand* column_operand = &*first.operand_;
+  const sql::Operand* constant = &*second.operand_;
+  sql::Expression::Operation operation = expression.operation_;
+  if (column_operand->kind_ != sql::Operand::Kind::Id) {
+    std::swap(column_operand, constant);
+    operation = flip(operation);
+  }
+  if (column_operand->kind_ != sql::Operand::Kind::Id ||
+      (constant->kind_ != sql::Operand::Kind::Int &&
+       constant->kind_ != sql::Operand::Kind::Real)) {
+    return false;
+  }
+  const auto column = table_.find_column(
+      std::get<std::string_view>(column_operand->value_));
+  if (!column) {
+    return false;
+  }
+
+  Instruction instruction{OpCode::FilterColumn};
+  instruction.comparison_ = operation;
+  instruction.output_ = output;
+  instruction.input_ = input;
+  instruction.column_ = static_cast<uint32_t>(*column);
+  const Column::Kind kind = table_.columns()[*column].kind();
+  const int* int_constant = std::get_if<int>(&constant->value_);
+  if (kind == Column::Kind::Int && int_constant != nullptr) {
+    instruction.type_ = Type::Int;
+    instruction.int_constant_ = *int_constant;
+  } else if (kind == Column::Kind::Real) {
+    // The comparison is on doubles; on floats it's the same only if the
+    // constant is exactly representable.
+    const double exact = int_constant != nullptr
+        ? *int_constant
+        : std::get<float>(constant->value_);
+    const auto real = static_cast<float>(exact);
+    if (static_cast<double>(real) != exact) {
+      return false;
+    }
+    instruction.type_ = Type::Real;
+    instruction.real_constant_ = real;
+  } else {
+    return false;
+  }
+  instructions_.push_back(instruction);
+  columns_.push_back(*column);
+  return true;
+}
+
+uint16_t FilterProgram::compile_probe(
+    const sql::Expression& expression,
+    uint16_t input,
+    uint16_t output) {
+  const sql::Expression& first = expression.operands_[0];
+  const sql::Expression& second = expression.operands_[1];
+  if (expression.operation_ != sql::Expression::Operation::Equal ||
+      first.kind_ != sql::Expression::Kind::Operand ||
+      second.kind_ != sql::Expression::Kind::Operand) {
+    return input;
+  }
+  const sql::Operand* column_operand = &*first.operand_;
+  const sql::Operand* constant = &*second.operand_;
+  if (column_operand->kind_ != sql::Operand::Kind::Id) {
+    std::swap(column_operand, constant);
+  }
+  if (column_operand->kind_ != sql::Operand::Kind::Id ||
+      constant->kind_ != sql::Operand::Kind::Text) {
+    return input;
+  }
+  const auto column = table_.find_column(
+      std::get<std::string_view>(column_operand->value_));
+  if (!column || table_.columns()[*column].kind() != Column::Kind::Text) {
+    return input;
+  }
+  Instruction instruction{OpCode::ProbeText};
+  instruction.output_ = new_selection();
+  instruction.input_ = input;
+  instruction.second_ = output;
+  instruction.column_ = static_cast<uint32_t>(*column);
+  instruction.text_hash_ =
+      text_hash(unquote(std::get<std::string_view>(constant->value_)));
+  instructions_.push_back(instruction);
+  return instruction.output_;
+}
+
+FilterProgram::Value FilterProgram::to_real(Value value, uint16_t input) {
+  if (value.type_ == Type::Real) {
+    return value;
+  }
+  for (const auto& constant : constants_) {
+    if (constant.register_ == value.register_) {
+      const auto real = static_cast<double>(constant.int_);
+      const uint16_t output = new_value(Type::Real);
+      constants_.push_back({output, Type::Real, 0, real, {}});
+      return {output, Type::Real};
+    }
+  }
+  Instruction instruction{OpCode::IntToReal};
+  instruction.type_ = Type::Int;
+  instruction.output_ = new_value(Type::Real);
+  instruction.input_ = input;
+  instruction.first_ = value.register_;
+  instructions_.push_back(instruction);
+  return {instruction.output_, Type::Real};
+}
+
+uint16_t FilterProgram::new_value(Type type) {
+  value_types_.push_back(type);
+  return static_cast<uint16_t>(value_types_.size() - 1);
+}
+
+uint16_t FilterProgram::new_selection() {
+  return selection_count_++;
+}
+
+}  // namespace rdb::exec
@@ -0,0 +1,256 @@
+#include <algorithm>
+#include <atomic>
+#include <librdb/exec/BloomFilter.hpp>
+#include <librdb/exec/Encoding.hpp>
+#include <librdb/exec/Executor.hpp>
+#include <librdb/exec/HashJoin.hpp>
+#include <librdb/exec/Parallel.hpp>
+#include <librdb/memory/MemoryTracker.hpp>
+#include <limits>
+#include <string_view>
+
+namespace rdb::exec {
+
+namespace {
+
+// -0.0 and 0.0 are equal.
+float normalize(float value) {
+  return value == 0 ? 0 : value;
+}
+
+int normalize(int value) {
+  return value;
+}
+
+unsigned log2_ceil(size_t value) {
+  unsigned bits = 0;
+  while ((size_t{1} << bits) < value) {
+    ++bits;
+  }
+  return bits;
+}
+
+// Radix bits that split the build side into partitions whose hash table
+// fits into a 256 KiB cache.
+unsigned partition_bits(size_t build_rows) {
+  constexpr size_t kCacheBytes = 256 * 1024;
+  // An entry and its chain link.
+  constexpr size_t kBytesPerRow = 20;
+  constexpr unsigned kMaxBits = 12;
+  unsigned bits = 0;
+  while (bits < kMaxBits && (build_rows * kBytesPerRow >> bits) > kCacheBytes) {
+    ++bits;
+  }
+  return bits;
+}
+
+// Partitions take hash bits 32 and up, buckets within a partition bits 18
+// and up, and the bloom filter the lowest 18 and the highest bits.
+size_t partition_of(uint64_t hash, unsigned bits) {
+  return static_cast<size_t>(hash >> 32) & ((size_t{1} << bits) - 1);
+}
+
+// [begin, end) of the chunk of `size` items that `worker` processes.
+std::pair<size_t, size_t> chunk(size_t size, size_t worker, size_t workers) {
+  return {size * worker / workers, size * (worker + 1) / workers};
+}
+
+// A row with the hash of its value. INT and REAL values are hashed without
+// collisions, so only TEXT values are compared on equal hashes.
+struct Entry {
+  uint64_t hash_;
+  size_t row_;
+};
+
+// Hashes the rows, keeping only those that may be in `filter` if it is
+// given. Every worker hashes a chunk of the rows.
+memory::Vector<Entry> hash_rows(
+    const Column& column,
+    const std::vector<size_t>& rows,
+    size_t workers,
+    const BloomFilter* filter) {
+  std::vector<memory::Vector<Entry>> chunks(workers);
+  run_workers(workers, [&](size_t worker) {
+    const auto [begin, end] = chunk(rows.size(), worker, workers);
+    memory::Vector<Entry>& entries = chunks[worker];
+    entries.reserve(filter == nullptr ? end - begin : (end - begin) / 8);
+    if (column.kind() == Column::Kind::Text) {
+      for (size_t i = begin; i < end; ++i) {
+        const uint64_t hash = text_hash(column.text(rows[i]));
+        if (filter == nullptr || filter->may_contain(hash)) {
+          entries.push_back({hash, rows[i]});
+        }
+      }
+      return;
+    }
+    // A block at a time, so that the rows are filtered without branches.
+    std::vector<int> int_scratch;
+    std::vector<float> float_scratch;
+    memory::Vector<Entry> block_entries(kBlockRows);
+    const size_t* const chunk_end = rows.data() + end;
+    for (const size_t* block_rows = rows.data() + begin;
+         block_rows != chunk_end;) {
+      const size_t block = *block_rows / kBlockRows;
+      const size_t* const block_end =
+          std::lower_bound(block_rows, chunk_end, (block + 1) * kBlockRows);
+      const size_t first_row = block * kBlockRows;
+      size_t count = 0;
+      const auto add_block = [&](const auto* values) {
+        for (const size_t* row = block_rows; row != block_end; ++row) {
+          const uint64_t hash =
+              mix_hash(to_key(normalize(values[*row - first_row])));
+          block_entries[count] = {hash, *row};
+          count += filter == nullptr || filter->may_contain(hash) ? 1 : 0;
+        }
+      };
+      if (column.kind() == Column::Kind::Int) {
+        add_block(column.block_values(block, int_scratch));
+      } else {
+        add_block(column.block_values(block, float_scratch));
+      }
+      entries.insert(
+          entries.end(), block_entries.begin(), block_entries.begin() + count);
+      block_rows = block_end;
+    }
+  });
+  memory::Vector<Entry> entries = std::move(chunks[0]);
+  for (size_t worker = 1; worker < workers; ++worker) {
+    entries.insert(entries.end(), chunks[worker].begin(), chunks[worker].end());
+  }
+  return entries;
+}
+
+}  // namespace
+
+HashJoin::HashJoin(const Column& left, const Column& right)
+    : left_(left), right_(right) {
+  if (left.kind() != right.kind()) {
+    throw ExecutionError(
+        "Can't join " + left.name() + " with " + right.name());
+  }
+}
+
+std::vector<std::pair<size_t, size_t>> HashJoin::run(
+    const std::vector<size_t>& left_rows,
+    const std::vector<size_t>& right_rows,
+    size_t workers) const {
+  if (left_rows.empty() || right_rows.empty()) {
+    return {};
+  }
+  workers = std::max<size_t>(workers, 1);
+  const bool build_left = left_rows.size() <= right_rows.size();
+  const Column& build_column = build_left ? left_ : right_;
+  const Column& probe_column = build_left ? right_ : left_;
+  const memory::Vector<Entry> build = hash_rows(
+      build_column, build_left ? left_rows : right_rows, workers, nullptr);
+  BloomFilter bloom_filter(build.size());
+  for (const Entry& entry : build) {
+    bloom_filter.add(entry.hash_);
+  }
+  const memory::Vector<Entry> probe = hash_rows(
+      probe_column, build_left ? right_rows : left_rows, workers,
+      &bloom_filter);
+
+  // Both sides are partitioned the same way: every worker counts the rows
+  // of its chunk per partition, then copies them to their place.
+  const unsigned bits = partition_bits(build.size());
+  const size_t partition_count = size_t{1} << bits;
+  const auto partition = [&](const memory::Vector<Entry>& entries,
+                             memory::Vector<Entry>& partitioned,
+                             std::vector<size_t>& offsets) {
+    std::vector<std::vector<size_t>> positions(
+        workers, std::vector<size_t>(partition_count, 0));
+    run_workers(workers, [&](size_t worker) {
+      const auto [begin, end] = chunk(entries.size(), worker, workers);
+      for (size_t i = begin; i < end; ++i) {
+        ++positions[worker][partition_of(entries[i].hash_, bits)];
+      }
+    });
+    offsets.assign(partition_count + 1, 0);
+    size_t offset = 0;
+    for (size_t p = 0; p < partition_count; ++p) {
+      offsets[p] = offset;
+      for (size_t worker = 0; worker < workers; ++worker) {
+        const size_t count = positions[worker][p];
+        positions[worker][p] = offset;
+        offset += count;
+      }
+    }
+    offsets[partition_count] = offset;
+    partitioned.resize(entries.size());
+    run_workers(workers, [&](size_t worker) {
+      const auto [begin, end] = chunk(entries.size(), worker, workers);
+      for (size_t i = begin; i < end; ++i) {
+        const size_t p = partition_of(entries[i].hash_, bits);
+        partitioned[positions[worker][p]++] = entries[i];
+      }
+    });
+  };
+  memory::Vector<Entry> build_partitions;
+  std::vector<size_t> build_offsets;
+  partition(build, build_partitions, build_offsets);
+  memory::Vector<Entry> probe_partitions;
+  std::vector<size_t> probe_offsets;
+  partition(probe, probe_partitions, probe_offsets);
+
+  const bool text = build_column.kind() == Column::Kind::Text;
+  std::atomic<size_t> next_partition{0};
+  std::vector<memory::Vector<std::pair<size_t, size_t>>> matches(workers);
+  run_workers(workers, [&](size_t worker) {
+    // Chained hash table: heads of the bucket chains and the link of every
+    // entry, both as entry index + 1.
+    memory::Vector<uint32_t> heads;
+    memory::Vector<uint32_t> links;
+    auto& worker_matches = matches[worker];
+    for (size_t p = next_partition++; p < partition_count;
+         p = next_partition++) {
+      const Entry* build_entries = build_partitions.data() + build_offsets[p];
+      const size_t build_size = build_offsets[p + 1] - build_offsets[p];
+      const size_t probe_begin = probe_offsets[p];
+      const size_t probe_end = probe_offsets[p + 1];
+      if (build_size == 0 || probe_begin == probe_end) {
+        continue;
+      }
+      const unsigned bucket_bits = log2_ceil(build_size);
+      const uint64_t bucket_mask = (uint64_t{1} << bucket_bits) - 1;
+      heads.assign(size_t{1} << bucket_bits, 0);
+      links.resize(build_size);
+      for (uint32_t i = 0; i < build_size; ++i) {
+        const size_t bucket = build_entries[i].hash_ >> 18 & bucket_mask;
+        links[i] = heads[bucket];
+        heads[bucket] = i + 1;
+      }
+      for (size_t j = probe_begin; j < probe_end; ++j) {
+        const Entry& probe_entry = probe_partitions[j];
+        const size_t bucket = probe_entry.hash_ >> 18 & bucket_mask;
+        for (uint32_t i = heads[bucket]; i != 0; i = links[i - 1]) {
+          const Entry& build_entry = build_entries[i - 1];
+          if (build_entry.hash_ != probe_entry.hash_ ||
+              (text && build_column.text(build_entry.row_) !=
+                           probe_column.text(probe_entry.row_))) {
+            continue;
+          }
+          if (build_left) {
+            worker_matches.emplace_back(build_entry.row_, probe_entry.row_);
+          } else {
+            worker_matches.emplace_back(probe_entry.row_, build_entry.row_);
+          }
+        }
+      }
+    }
+  });
+
+  size_t match_count = 0;
+  for (const auto& worker_matches : matches) {
+    match_count += worker_matches.size();
+  }
+  std::vector<std::pair<size_t, size_t>> result;
+  result.reserve(match_count);
+  for (const auto& worker_matches : matches) {
+    result.insert(result.end(), worker_matches.begin(), worker_matches.end());
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+}  // namespace rdb::exec
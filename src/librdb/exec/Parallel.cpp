@@ -0,0 +1,47 @@
+#include <algorithm>
+#include <exception>
+#include <librdb/exec/Parallel.hpp>
+#include <librdb/exec/Table.hpp>
+#include <librdb/memory/MemoryTracker.hpp>
+#include <thread>
+#include <vector>
+
+namespace rdb::exec {
+
+size_t workers_for(size_t row_count) {
+  constexpr size_t kBlocksPerWorker = 16;
+  const size_t blocks = (row_count + kBlockRows - 1) / kBlockRows;
+  const size_t cores = std::max(1U, std::thread::hardware_concurrency());
+  return std::clamp<size_t>(blocks / kBlocksPerWorker, 1, cores);
+}
+
+void run_workers(size_t workers, const std::function<void(size_t)>& work) {
+  std::vector<std::exception_ptr> errors(workers);
+  memory::MemoryTracker& tracker = memory::MemoryTracker::current();
+  const auto run = [&](size_t worker) {
+    const memory::MemoryScope scope(tracker);
+    try {
+      work(worker);
+    } catch (...) {
+      errors[worker] = std::current_exception();
+    }
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(workers);
+  for (size_t worker = 1; worker < workers; ++worker) {
+    threads.emplace_back(run, worker);
+  }
+  if (workers > 0) {
+    run(0);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (const auto& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+}  // namespace rdb::exec
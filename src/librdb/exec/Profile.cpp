@@ -0,0 +1,58 @@
+#include <iomanip>
+#include <librdb/exec/Profile.hpp>
+#include <sstream>
+
+namespace rdb::exec {
+
+std::vector<std::string> profile_to_lines(const Profile& profile) {
+  std::vector<std::string> lines;
+  // Inputs still to be printed of every operator on the path to the node.
+  std::vector<size_t> pending_inputs;
+  for (const PlanNode& node : profile.nodes_) {
+    while (!pending_inputs.empty() && pending_inputs.back() == 0) {
+      pending_inputs.pop_back();
+    }
+    const size_t depth = pending_inputs.size();
+    if (depth != 0) {
+      --pending_inputs.back();
+    }
+    pending_inputs.push_back(node.inputs_);
+    const size_t indent = depth * 4;
+    std::stringstream out;
+    out << std::string(indent, ' ') << (depth == 0 ? "" : "-> ")
+        << node.description_;
+    if (profile.analyze_) {
+      const std::chrono::duration<double, std::milli> time = node.stats_.time_;
+      out << " (time=" << std::fixed << std::setprecision(3) << time.count()
+          << " ms rows_in=" << node.stats_.rows_in_
+          << " rows_out=" << node.stats_.rows_out_
+          << " blocks=" << node.stats_.blocks_read_
+          << " bytes=" << node.stats_.bytes_read_ << ")";
+    }
+    lines.push_back(out.str());
+    const size_t details_indent = indent + (depth == 0 ? 2 : 5);
+    for (const auto& detail : node.details_) {
+      lines.push_back(std::string(details_indent, ' ') + detail);
+    }
+    const OperatorStats& stats = node.stats_;
+    if (profile.analyze_ && stats.bloom_probes_ != 0) {
+      // The share of the blocks without a match that the filter let through.
+      const size_t misses = stats.bloom_skipped_ + stats.bloom_false_positives_;
+      std::stringstream bloom;
+      bloom << std::string(details_indent, ' ')
+            << "Bloom Filter: probes=" << stats.bloom_probes_
+            << " skipped=" << stats.bloom_skipped_
+            << " false_positives=" << stats.bloom_false_positives_
+            << " false_positive_rate=" << std::fixed << std::setprecision(1)
+            << (misses == 0 ? 0.0
+                            : 100.0 * static_cast<double>(
+                                          stats.bloom_false_positives_) /
+                                  static_cast<double>(misses))
+            << "%";
+      lines.push_back(bloom.str());
+    }
+  }
+  return lines;
+}
+
+}  // namespace rdb::exec
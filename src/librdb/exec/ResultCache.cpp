@@ -0,0 +1,157 @@
+#include <librdb/exec/ResultCache.hpp>
+#include <librdb/metrics/Metrics.hpp>
+
+namespace rdb::exec {
+
+namespace {
+
+struct CacheMetrics {
+  metrics::Counter* hits_;
+  metrics::Counter* misses_;
+  metrics::Counter* invalidations_;
+  metrics::Counter* evictions_;
+};
+
+const CacheMetrics& cache_metrics() {
+  static const CacheMetrics cache_metrics = [] {
+    auto& registry = metrics::Registry::global();
+    return CacheMetrics{
+        &registry.counter(
+            "rdb_result_cache_hits_total", "SELECTs answered from the cache."),
+        &registry.counter(
+            "rdb_result_cache_misses_total",
+            "SELECTs that had to be executed."),
+        &registry.counter(
+            "rdb_result_cache_invalidations_total",
+            "Cached results dropped because their table changed."),
+        &registry.counter(
+            "rdb_result_cache_evictions_total",
+            "Cached results dropped to stay within the memory budget.")};
+  }();
+  return cache_metrics;
+}
+
+size_t result_bytes(const Result& result) {
+  size_t bytes = sizeof(Result);
+  for (const auto& name : result.column_names_) {
+    bytes += sizeof(std::string) + name.size();
+  }
+  for (const auto& row : result.rows_) {
+    bytes += sizeof(row) + row.size() * sizeof(Cell);
+    for (const auto& cell : row) {
+      if (const auto* text = std::get_if<std::string>(&cell)) {
+        bytes += text->size();
+      }
+    }
+  }
+  return bytes;
+}
+
+}  // namespace
+
+std::string ResultCache::key(const sql::SelectStatement& statement) {
+  std::string key;
+  for (size_t i = 0; i < statement.column_list().size(); ++i) {
+    key += statement.item_to_str(i);
+    key += ' ';
+  }
+  if (statement.expression()) {
+    key += "WHERE ";
+    key += sql::expression_to_str(*statement.expression());
+  }
+  if (!statement.group_by().empty()) {
+    key += " GROUP BY";
+    for (const auto column : statement.group_by()) {
+      key += ' ';
+      key += column;
+    }
+  }
+  if (statement.order_by()) {
+    key += " ORDER BY ";
+    key += statement.order_by_to_str();
+  }
+  if (statement.limit()) {
+    key += " LIMIT ";
+    key += std::to_string(*statement.limit());
+  }
+  return key;
+}
+
+std::optional<Result> ResultCache::find(
+    const Table& table,
+    const std::string& key) {
+  TableEntries& table_entries = entries_for(table);
+  const auto it = table_entries.entries_.find(key);
+  if (it == table_entries.entries_.end()) {
+    ++stats_.misses_;
+    cache_metrics().misses_->add();
+    return std::nullopt;
+  }
+  lru_.splice(lru_.begin(), lru_, it->second);
+  ++stats_.hits_;
+  cache_metrics().hits_->add();
+  return it->second->result_;
+}
+
+void ResultCache::insert(
+    const Table& table,
+    std::string key,
+    const Result& result) {
+  const size_t bytes = result_bytes(result) + key.size() + table.name().size();
+  if (bytes > budget_bytes_) {
+    return;
+  }
+  TableEntries& table_entries = entries_for(table);
+  if (const auto it = table_entries.entries_.find(key);
+      it != table_entries.entries_.end()) {
+    erase(it->second);
+  }
+  while (byte_size_ + bytes > budget_bytes_) {
+    ++stats_.evictions_;
+    cache_metrics().evictions_->add();
+    erase(std::prev(lru_.end()));
+  }
+  lru_.push_front(Entry{table.name(), key, result, bytes});
+  table_entries.entries_.emplace(std::move(key), lru_.begin());
+  byte_size_ += bytes;
+}
+
+void ResultCache::invalidate(std::string_view table_name) {
+  const auto it = tables_.find(std::string(table_name));
+  if (it == tables_.end()) {
+    return;
+  }
+  clear(it->second);
+  tables_.erase(it);
+}
+
+ResultCache::TableEntries& ResultCache::entries_for(const Table& table) {
+  const auto [it, inserted] = tables_.try_emplace(
+      table.name(), TableEntries{table.id(), table.version(), {}});
+  TableEntries& table_entries = it->second;
+  if (!inserted &&
+      (table_entries.id_ != table.id() ||
+       table_entries.version_ != table.version())) {
+    clear(table_entries);
+    table_entries.id_ = table.id();
+    table_entries.version_ = table.version();
+  }
+  return table_entries;
+}
+
+void ResultCache::clear(TableEntries& table_entries) {
+  stats_.invalidations_ += table_entries.entries_.size();
+  cache_metrics().invalidations_->add(table_entries.entries_.size());
+  while (!table_entries.entries_.empty()) {
+    erase(table_entries.entries_.begin()->second);
+  }
+}
+
+void ResultCache::erase(EntryList::iterator entry) {
+  auto& entries = tables_.at(entry->table_name_).entries_;
+  entries.erase(entry->key_);
+  byte_size_ -= entry->bytes_;
+  lru_.erase(entry);
+}
+
+}  // namespace rdb::exec
@@ -0,0 +1,485 @@
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <librdb/exec/Executor.hpp>
+#include <librdb/exec/Parallel.hpp>
+#include <librdb/exec/Sort.hpp>
+#include <librdb/memory/MemoryTracker.hpp>
+#include <memory>
+#include <numeric>
+#include <queue>
+#include <string_view>
+
+namespace rdb::exec {
+
+namespace {
+
+// A position with the order-preserving key of its row's value. INT and REAL
+// keys are exact; TEXT keys are the first 8 bytes of the value, so TEXT
+// entries with equal keys are ordered by comparing the values.
+struct Entry {
+  uint64_t key_;
+  size_t position_;
+};
+
+uint64_t text_key(std::string_view text) {
+  uint64_t key = 0;
+  for (size_t i = 0; i < sizeof(key); ++i) {
+    key = key << 8 | (i < text.size() ? uint8_t(text[i]) : 0);
+  }
+  return key;
+}
+
+// [begin, end) of the chunk of `size` items that `worker` processes.
+std::pair<size_t, size_t> chunk(size_t size, size_t worker, size_t workers) {
+  return {size * worker / workers, size * (worker + 1) / workers};
+}
+
+// Appends the entries of `rows[begin, end)`, which must be in ascending
+// order, decoding every block once.
+template <typename T>
+void append_keys(
+    const Column& column,
+    const size_t* rows,
+    size_t begin,
+    size_t end,
+    bool descending,
+    memory::Vector<Entry>& entries) {
+  std::vector<T> scratch;
+  const uint64_t flip = descending ? ~uint64_t{0} : 0;
+  for (size_t i = begin; i < end;) {
+    const size_t block = rows[i] / kBlockRows;
+    const size_t first_row = block * kBlockRows;
+    const size_t block_end =
+        std::lower_bound(rows + i, rows + end, first_row + kBlockRows) - rows;
+    const T* values = column.block_values(block, scratch);
+    for (; i < block_end; ++i) {
+      const T value = values[rows[i] - first_row];
+      // -0.0 and 0.0 are equal.
+      entries.push_back({to_key(value == 0 ? T{0} : value) ^ flip, i});
+    }
+  }
+}
+
+// Entries of the positions of a selection.
+class Keys {
+ public:
+  Keys(const Column& column, const std::vector<size_t>& rows, bool descending)
+      : column_(column), rows_(rows), descending_(descending) {
+    if (column.kind() == Column::Kind::Text ||
+        std::is_sorted(rows.begin(), rows.end())) {
+      return;
+    }
+    // Blocks are decoded once only if they are read in row order.
+    std::vector<size_t> order(rows.size());
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+      return rows[a] < rows[b];
+    });
+    std::vector<size_t> ordered_rows(rows.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+      ordered_rows[i] = rows[order[i]];
+    }
+    memory::Vector<Entry> entries;
+    entries.reserve(rows.size());
+    append(ordered_rows, 0, ordered_rows.size(), entries);
+    keys_.resize(rows.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+      keys_[order[i]] = entries[i].key_;
+    }
+  }
+
+  // Appends the entries of positions [begin, end).
+  void append(size_t begin, size_t end, memory::Vector<Entry>& entries) const {
+    if (!keys_.empty()) {
+      for (size_t i = begin; i < end; ++i) {
+        entries.push_back({keys_[i], i});
+      }
+      return;
+    }
+    append(rows_, begin, end, entries);
+  }
+
+ private:
+  void append(
+      const std::vector<size_t>& rows,
+      size_t begin,
+      size_t end,
+      memory::Vector<Entry>& entries) const {
+    switch (column_.kind()) {
+      case Column::Kind::Int:
+        append_keys<int>(
+            column_, rows.data(), begin, end, descending_, entries);
+        break;
+      case Column::Kind::Real:
+        append_keys<float>(
+            column_, rows.data(), begin, end, descending_, entries);
+        break;
+      case Column::Kind::Text: {
+        const uint64_t flip = descending_ ? ~uint64_t{0} : 0;
+        for (size_t i = begin; i < end; ++i) {
+          entries.push_back({text_key(column_.text(rows[i])) ^ flip, i});
+        }
+        break;
+      }
+    }
+  }
+
+  const Column& column_;
+  const std::vector<size_t>& rows_;
+  bool descending_;
+  // Keys by position of INT and REAL rows that aren't in ascending order.
+  std::vector<uint64_t> keys_;
+};
+
+// Strict total order of entries: by key, TEXT values with equal keys by
+// value, and equal values by position.
+class EntryOrder {
+ public:
+  EntryOrder(
+      const Column& column,
+      const std::vector<size_t>& rows,
+      bool descending)
+      : column_(column),
+        rows_(rows),
+        text_(column.kind() == Column::Kind::Text),
+        descending_(descending) {}
+
+  bool operator()(const Entry& a, const Entry& b) const {
+    if (a.key_ != b.key_) {
+      return a.key_ < b.key_;
+    }
+    if (text_) {
+      const int comparison = column_.text(rows_[a.position_])
+                                 .compare(column_.text(rows_[b.position_]));
+      if (comparison != 0) {
+        return descending_ ? comparison > 0 : comparison < 0;
+      }
+    }
+    return a.position_ < b.position_;
+  }
+
+  bool text() const { return text_; }
+
+ private:
+  const Column& column_;
+  const std::vector<size_t>& rows_;
+  bool text_;
+  bool descending_;
+};
+
+constexpr size_t kKeyBytes = sizeof(uint64_t);
+using ByteCounts = std::array<std::array<size_t, 256>, kKeyBytes>;
+
+ByteCounts count_bytes(const Entry* begin, const Entry* end) {
+  ByteCounts counts{};
+  for (const Entry* entry = begin; entry != end; ++entry) {
+    for (size_t byte = 0; byte < kKeyBytes; ++byte) {
+      ++counts[byte][entry->key_ >> (8 * byte) & 255];
+    }
+  }
+  return counts;
+}
+
+// Stably scatters [begin, end) into `out` on the key byte, turning its
+// counts into bucket offsets.
+void scatter(
+    const Entry* begin,
+    const Entry* end,
+    size_t byte,
+    std::array<size_t, 256>& counts,
+    Entry* out) {
+  size_t offset = 0;
+  for (size_t& count : counts) {
+    offset += count;
+    count = offset - count;
+  }
+  const size_t shift = 8 * byte;
+  for (const Entry* entry = begin; entry != end; ++entry) {
+    out[counts[entry->key_ >> shift & 255]++] = *entry;
+  }
+}
+
+// Stable LSD radix sort of [begin, end) on the key bytes below `bytes` in
+// which the entries differ, using `buffer` of the same size.
+void lsd_sort(Entry* begin, Entry* end, size_t bytes, Entry* buffer) {
+  if (end - begin < 2) {
+    return;
+  }
+  ByteCounts counts = count_bytes(begin, end);
+  const size_t size = end - begin;
+  Entry* in = begin;
+  Entry* out = buffer;
+  for (size_t byte = 0; byte < bytes; ++byte) {
+    if (counts[byte][in->key_ >> (8 * byte) & 255] == size) {
+      continue;
+    }
+    scatter(in, in + size, byte, counts[byte], out);
+    std::swap(in, out);
+  }
+  if (in != begin) {
+    std::copy(in, in + size, begin);
+  }
+}
+
+// Stable radix sort on the key bytes in which the entries differ. Entries
+// that start out in position order end up in `order`, but for TEXT entries
+// with equal keys, which are sorted afterwards.
+//
+// The first pass splits the entries on their highest differing byte into
+// buckets small enough to be sorted in the cache by LSD passes.
+void sort_entries(memory::Vector<Entry>& entries, const EntryOrder& order) {
+  constexpr size_t kCacheEntries = 16 * 1024;
+  memory::Vector<Entry> buffer(entries.size());
+  if (entries.size() <= kCacheEntries) {
+    lsd_sort(
+        entries.data(),
+        entries.data() + entries.size(),
+        kKeyBytes,
+        buffer.data());
+  } else {
+    ByteCounts counts =
+        count_bytes(entries.data(), entries.data() + entries.size());
+    size_t top = kKeyBytes;
+    while (top > 0 &&
+           counts[top - 1][entries.front().key_ >> (8 * (top - 1)) & 255] ==
+               entries.size()) {
+      --top;
+    }
+    if (top > 0) {
+      --top;
+      const std::array<size_t, 256> bucket_sizes = counts[top];
+      scatter(
+          entries.data(),
+          entries.data() + entries.size(),
+          top,
+          counts[top],
+          buffer.data());
+      size_t bucket_begin = 0;
+      for (const size_t bucket_size : bucket_sizes) {
+        lsd_sort(
+            buffer.data() + bucket_begin,
+            buffer.data() + bucket_begin + bucket_size,
+            top,
+            entries.data() + bucket_begin);
+        bucket_begin += bucket_size;
+      }
+      entries.swap(buffer);
+    }
+  }
+  if (!order.text()) {
+    return;
+  }
+  for (auto begin = entries.begin(); begin != entries.end();) {
+    const auto end = std::find_if(begin, entries.end(), [&](const Entry& e) {
+      return e.key_ != begin->key_;
+    });
+    if (end - begin > 1) {
+      std::sort(begin, end, order);
+    }
+    begin = end;
+  }
+}
+
+using File = std::unique_ptr<std::FILE, int (*)(std::FILE*)>;
+
+// Sorted entries, held in memory or read from a temporary file a buffer at
+// a time.
+class Run {
+ public:
+  explicit Run(memory::Vector<Entry> entries)
+      : file_(nullptr, &std::fclose), buffer_(std::move(entries)) {}
+
+  Run(File file, size_t size, size_t buffer_size)
+      : file_(std::move(file)), remaining_(size) {
+    buffer_.reserve(buffer_size);
+    refill();
+  }
+
+  bool done() const { return next_ == buffer_.size(); }
+  size_t size() const { return buffer_.size() - next_ + remaining_; }
+  const Entry& front() const { return buffer_[next_]; }
+
+  void pop() {
+    if (++next_ == buffer_.size() && remaining_ != 0) {
+      refill();
+    }
+  }
+
+ private:
+  void refill() {
+    const size_t count = std::min(remaining_, buffer_.capacity());
+    buffer_.resize(count);
+    if (std::fread(buffer_.data(), sizeof(Entry), count, file_.get()) !=
+        count) {
+      throw ExecutionError("Can't read a temporary file of ORDER BY");
+    }
+    remaining_ -= count;
+    next_ = 0;
+  }
+
+  File file_;
+  memory::Vector<Entry> buffer_;
+  size_t next_ = 0;
+  size_t remaining_ = 0;
+};
+
+// The first `limit` entries of the union of the runs.
+memory::Vector<Entry> merge(
+    std::vector<Run>& runs,
+    size_t limit,
+    const EntryOrder& order) {
+  const auto greater = [&](size_t a, size_t b) {
+    return order(runs[b].front(), runs[a].front());
+  };
+  std::priority_queue<size_t, std::vector<size_t>, decltype(greater)> heads(
+      greater);
+  for (size_t i = 0; i < runs.size(); ++i) {
+    if (!runs[i].done()) {
+      heads.push(i);
+    }
+  }
+  size_t size = 0;
+  for (const Run& run : runs) {
+    size += run.size();
+  }
+  memory::Vector<Entry> merged;
+  merged.reserve(std::min(size, limit));
+  while (merged.size() < limit && !heads.empty()) {
+    const size_t run = heads.top();
+    heads.pop();
+    merged.push_back(runs[run].front());
+    runs[run].pop();
+    if (!runs[run].done()) {
+      heads.push(run);
+    }
+  }
+  return merged;
+}
+
+File write_run(const memory::Vector<Entry>& entries) {
+  File file(std::tmpfile(), &std::fclose);
+  if (!file) {
+    throw ExecutionError("Can't create a temporary file for ORDER BY");
+  }
+  if (std::fwrite(entries.data(), sizeof(Entry), entries.size(), file.get()) !=
+          entries.size() ||
+      std::fflush(file.get()) != 0) {
+    throw ExecutionError("Can't write a temporary file of ORDER BY");
+  }
+  std::rewind(file.get());
+  return file;
+}
+
+}  // namespace
+
+Sort::Sort(
+    const Column& column,
+    bool descending,
+    std::optional<size_t> limit,
+    size_t memory_budget)
+    : column_(column),
+      descending_(descending),
+      limit_(limit),
+      memory_budget_(memory_budget) {}
+
+std::vector<size_t> Sort::run(const std::vector<size_t>& rows, size_t workers)
+    const {
+  const size_t size = rows.size();
+  const size_t limit = std::min(limit_.value_or(size), size);
+  if (limit == 0) {
+    return {};
+  }
+  workers = std::max<size_t>(workers, 1);
+  const Keys keys(column_, rows, descending_);
+  const EntryOrder order(column_, rows, descending_);
+
+  memory::Vector<Entry> sorted;
+  constexpr size_t kHeapFraction = 16;
+  if (limit <= size / kHeapFraction &&
+      limit * workers * sizeof(Entry) <= memory_budget_) {
+    std::vector<memory::Vector<Entry>> heaps(workers);
+    run_workers(workers, [&](size_t worker) {
+      const auto [begin, end] = chunk(size, worker, workers);
+      memory::Vector<Entry>& heap = heaps[worker];
+      heap.reserve(limit);
+      memory::Vector<Entry> batch;
+      for (size_t batch_begin = begin; batch_begin < end;
+           batch_begin += kBlockRows) {
+        batch.clear();
+        keys.append(
+            batch_begin, std::min(end, batch_begin + kBlockRows), batch);
+        for (const Entry& entry : batch) {
+          if (heap.size() < limit) {
+            heap.push_back(entry);
+            std::push_heap(heap.begin(), heap.end(), order);
+          } else if (order(entry, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), order);
+            heap.back() = entry;
+            std::push_heap(heap.begin(), heap.end(), order);
+          }
+        }
+      }
+    });
+    for (const auto& heap : heaps) {
+      sorted.insert(sorted.end(), heap.begin(), heap.end());
+    }
+    std::sort(sorted.begin(), sorted.end(), order);
+    sorted.resize(std::min(sorted.size(), limit));
+  } else {
+    // The first `keep` entries of [begin, end), every worker sorting a
+    // chunk of it.
+    const auto sort_range = [&](size_t begin, size_t end, size_t keep) {
+      std::vector<memory::Vector<Entry>> chunk_entries(workers);
+      run_workers(workers, [&](size_t worker) {
+        const auto [chunk_begin, chunk_end] =
+            chunk(end - begin, worker, workers);
+        memory::Vector<Entry>& entries = chunk_entries[worker];
+        entries.reserve(chunk_end - chunk_begin);
+        keys.append(begin + chunk_begin, begin + chunk_end, entries);
+        sort_entries(entries, order);
+      });
+      if (workers == 1) {
+        memory::Vector<Entry>& entries = chunk_entries.front();
+        entries.resize(std::min(entries.size(), keep));
+        return std::move(entries);
+      }
+      std::vector<Run> chunks;
+      for (auto& entries : chunk_entries) {
+        chunks.emplace_back(std::move(entries));
+      }
+      return merge(chunks, keep, order);
+    };
+
+    // Entries are sorted through a buffer of the same size.
+    const size_t run_size =
+        std::max(memory_budget_ / (2 * sizeof(Entry)), kBlockRows);
+    if (size <= run_size) {
+      sorted = sort_range(0, size, limit);
+    } else {
+      std::vector<std::pair<File, size_t>> files;
+      for (size_t begin = 0; begin < size; begin += run_size) {
+        const memory::Vector<Entry> entries =
+            sort_range(begin, std::min(size, begin + run_size), limit);
+        files.emplace_back(write_run(entries), entries.size());
+      }
+      constexpr size_t kMinBufferSize = 1024;
+      const size_t buffer_size = std::max(
+          memory_budget_ / (sizeof(Entry) * files.size()), kMinBufferSize);
+      std::vector<Run> runs;
+      for (auto& [file, run_entries] : files) {
+        runs.emplace_back(std::move(file), run_entries, buffer_size);
+      }
+      sorted = merge(runs, limit, order);
+    }
+  }
+
+  std::vector<size_t> positions;
+  positions.reserve(sorted.size());
+  for (const Entry& entry : sorted) {
+    positions.push_back(entry.position_);
+  }
+  return positions;
+}
+
+}  // namespace rdb::exec
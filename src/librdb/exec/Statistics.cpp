@@ -0,0 +1,250 @@
+#include <algorithm>
+#include <cmath>
+#include <librdb/exec/Encoding.hpp>
+#include <librdb/exec/Statistics.hpp>
+#include <librdb/exec/Table.hpp>
+#include <numeric>
+#include <optional>
+#include <string_view>
+
+namespace rdb::exec {
+
+namespace {
+
+constexpr double kDefaultSelectivity = 1.0 / 3;
+
+// `column operation constant`, with the constant as a key of the column's
+// type for INT and REAL columns.
+struct ColumnComparison {
+  size_t column_;
+  sql::Expression::Operation operation_;
+  std::optional<uint32_t> key_;
+};
+
+std::optional<ColumnComparison> column_comparison(
+    const Table& table,
+    const sql::Expression& comparison) {
+  const sql::Expression& first = comparison.operands_[0];
+  const sql::Expression& second = comparison.operands_[1];
+  if (first.kind_ != sql::Expression::Kind::Operand ||
+      second.kind_ != sql::Expression::Kind::Operand) {
+    return std::nullopt;
+  }
+  const sql::Operand* column_operand = &*first.operand_;
+  const sql::Operand* constant = &*second.operand_;
+  sql::Expression::Operation operation = comparison.operation_;
+  if (column_operand->kind_ != sql::Operand::Kind::Id) {
+    std::swap(column_operand, constant);
+    operation = flip(operation);
+  }
+  if (column_operand->kind_ != sql::Operand::Kind::Id ||
+      constant->kind_ == sql::Operand::Kind::Id) {
+    return std::nullopt;
+  }
+  const auto column = table.find_column(
+      std::get<std::string_view>(column_operand->value_));
+  if (!column) {
+    return std::nullopt;
+  }
+  const int* int_constant = std::get_if<int>(&constant->value_);
+  const float* real_constant = std::get_if<float>(&constant->value_);
+  switch (table.columns()[*column].kind()) {
+    case Column::Kind::Int:
+      if (int_constant == nullptr) {
+        return std::nullopt;
+      }
+      return ColumnComparison{*column, operation, to_key(*int_constant)};
+    case Column::Kind::Real: {
+      if (int_constant == nullptr && real_constant == nullptr) {
+        return std::nullopt;
+      }
+      const float value = int_constant != nullptr
+          ? static_cast<float>(*int_constant)
+          : *real_constant;
+      // -0.0 is counted as 0.0.
+      return ColumnComparison{
+          *column, operation, to_key(value == 0 ? 0.0F : value)};
+    }
+    case Column::Kind::Text:
+      if (constant->kind_ != sql::Operand::Kind::Text) {
+        return std::nullopt;
+      }
+      return ColumnComparison{*column, operation, std::nullopt};
+  }
+  return std::nullopt;
+}
+
+double comparison_selectivity(
+    const Table& table,
+    const ColumnComparison& comparison) {
+  const ColumnStatistics& statistics =
+      table.statistics().columns_[comparison.column_];
+  const Histogram& histogram = statistics.histogram_;
+  const auto rows = static_cast<double>(table.row_count());
+  const double distinct =
+      std::clamp(statistics.distinct_.estimate(), 1.0, std::max(rows, 1.0));
+  double equal = 1 / distinct;
+  double below = kDefaultSelectivity;
+  if (comparison.key_) {
+    const uint32_t key = *comparison.key_;
+    if (histogram.empty() || key < histogram.min_key() ||
+        key > histogram.max_key()) {
+      equal = 0;
+    }
+    below = histogram.empty() ? 0 : histogram.fraction_below(key);
+  }
+  double selectivity = kDefaultSelectivity;
+  switch (comparison.operation_) {
+    case sql::Expression::Operation::Equal:
+      selectivity = equal;
+      break;
+    case sql::Expression::Operation::NotEqual:
+      selectivity = 1 - equal;
+      break;
+    case sql::Expression::Operation::Less:
+      selectivity = comparison.key_ ? below : kDefaultSelectivity;
+      break;
+    case sql::Expression::Operation::LessEq:
+      selectivity = comparison.key_ ? below + equal : kDefaultSelectivity;
+      break;
+    case sql::Expression::Operation::Greater:
+      selectivity = comparison.key_ ? 1 - below - equal : kDefaultSelectivity;
+      break;
+    case sql::Expression::Operation::GreaterEq:
+      selectivity = comparison.key_ ? 1 - below : kDefaultSelectivity;
+      break;
+  }
+  return std::clamp(selectivity, 0.0, 1.0);
+}
+
+}  // namespace
+
+void HyperLogLog::add(uint64_t hash) {
+  const size_t index = hash >> (64 - kIndexBits);
+  // The set bit past the remaining bits caps the rank.
+  const uint64_t rest = hash << kIndexBits | uint64_t{1} << (kIndexBits - 1);
+  const auto rank = static_cast<uint8_t>(__builtin_clzll(rest) + 1);
+  registers_[index] = std::max(registers_[index], rank);
+}
+
+double HyperLogLog::estimate() const {
+  constexpr auto kRegisters = static_cast<double>(size_t{1} << kIndexBits);
+  constexpr double kAlpha = 0.7213 / (1 + 1.079 / kRegisters);
+  double sum = 0;
+  size_t zeros = 0;
+  for (const uint8_t rank : registers_) {
+    sum += std::ldexp(1.0, -rank);
+    zeros += rank == 0 ? 1 : 0;
+  }
+  const double estimate = kAlpha * kRegisters * kRegisters / sum;
+  // Linear counting is more accurate while many registers are empty.
+  if (estimate <= 2.5 * kRegisters && zeros != 0) {
+    return kRegisters * std::log(kRegisters / static_cast<double>(zeros));
+  }
+  return estimate;
+}
+
+void Histogram::build(const std::vector<uint32_t>& sorted_keys) {
+  upper_.clear();
+  counts_.clear();
+  if (sorted_keys.empty()) {
+    return;
+  }
+  lower_ = sorted_keys.front();
+  const size_t size = sorted_keys.size();
+  const size_t buckets = std::min(kMaxBuckets, size);
+  size_t begin = 0;
+  for (size_t bucket = 1; bucket <= buckets && begin < size; ++bucket) {
+    size_t end = std::max(begin + 1, size * bucket / buckets);
+    // Equal keys stay in one bucket, and a key frequent enough to fill a
+    // bucket gets one of its own, so that the rows of other keys aren't
+    // interpolated over its rows.
+    const uint32_t last = sorted_keys[end - 1];
+    const auto first = sorted_keys.begin();
+    const auto run_begin = static_cast<size_t>(
+        std::lower_bound(first + begin, first + end, last) - first);
+    const auto run_end = static_cast<size_t>(
+        std::upper_bound(first + end, sorted_keys.end(), last) - first);
+    end = bucket < buckets && run_begin > begin &&
+            run_end - run_begin > size / buckets
+        ? run_begin
+        : run_end;
+    upper_.push_back(sorted_keys[end - 1]);
+    counts_.push_back(end - begin);
+    begin = end;
+  }
+}
+
+void Histogram::add(uint32_t key) {
+  if (empty()) {
+    lower_ = key;
+    upper_.push_back(key);
+    counts_.push_back(1);
+    return;
+  }
+  lower_ = std::min(lower_, key);
+  upper_.back() = std::max(upper_.back(), key);
+  ++counts_[bucket_of(key)];
+}
+
+void Histogram::remove(uint32_t key) {
+  if (empty() || key < lower_ || key > upper_.back()) {
+    return;
+  }
+  size_t& count = counts_[bucket_of(key)];
+  count -= count == 0 ? 0 : 1;
+}
+
+size_t Histogram::row_count() const {
+  return std::accumulate(counts_.begin(), counts_.end(), size_t{0});
+}
+
+double Histogram::fraction_below(uint32_t key) const {
+  const size_t rows = row_count();
+  if (rows == 0 || key <= lower_) {
+    return 0;
+  }
+  if (key > upper_.back()) {
+    return 1;
+  }
+  const size_t bucket = bucket_of(key);
+  const size_t before = std::accumulate(
+      counts_.begin(), counts_.begin() + bucket, size_t{0});
+  const double first = bucket == 0 ? lower_ : upper_[bucket - 1] + 1.0;
+  const double width = upper_[bucket] - first + 1;
+  const double inside =
+      static_cast<double>(counts_[bucket]) * (key - first) / width;
+  return (static_cast<double>(before) + inside) / static_cast<double>(rows);
+}
+
+size_t Histogram::bucket_of(uint32_t key) const {
+  return static_cast<size_t>(
+      std::lower_bound(upper_.begin(), upper_.end(), key) - upper_.begin());
+}
+
+double estimate_selectivity(
+    const Table& table,
+    const sql::Expression& condition) {
+  switch (condition.kind_) {
+    case sql::Expression::Kind::And:
+      return estimate_selectivity(table, condition.operands_[0]) *
+             estimate_selectivity(table, condition.operands_[1]);
+    case sql::Expression::Kind::Or: {
+      const double first = estimate_selectivity(table, condition.operands_[0]);
+      const double second =
+          estimate_selectivity(table, condition.operands_[1]);
+      return first + second - first * second;
+    }
+    case sql::Expression::Kind::Not:
+      return 1 - estimate_selectivity(table, condition.operands_[0]);
+    case sql::Expression::Kind::Comparison:
+      if (const auto comparison = column_comparison(table, condition)) {
+        return comparison_selectivity(table, *comparison);
+      }
+      return kDefaultSelectivity;
+    default:
+      return kDefaultSelectivity;
+  }
+}
+
+}  // namespace rdb::exec
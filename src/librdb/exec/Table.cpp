@@ -0,0 +1,487 @@
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <librdb/exec/Table.hpp>
+#include <type_traits>
+
+namespace rdb::exec {
+
+namespace {
+
+static_assert(sizeof(int) == sizeof(float), "INT and REAL values are 4 bytes");
+
+template <typename T>
+void erase_masked(std::vector<T>& values, const std::vector<bool>& erase_mask) {
+  size_t kept = 0;
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (!erase_mask[i]) {
+      // Moving a string onto itself would empty it.
+      if (kept != i) {
+        values[kept] = std::move(values[i]);
+      }
+      ++kept;
+    }
+  }
+  values.resize(kept);
+}
+
+// The histogram key of an INT or REAL value; -0.0 is counted as 0.0.
+uint32_t statistics_key(int value) {
+  return to_key(value);
+}
+
+uint32_t statistics_key(float value) {
+  return to_key(value == 0 ? 0.0F : value);
+}
+
+// Calls `add(key)` for the rows of an INT or REAL column, in order, that
+// are set in `mask`, or for every row without a mask.
+template <typename T, typename Add>
+void for_each_key(
+    const Column& column,
+    const std::vector<bool>* mask,
+    const Add& add) {
+  std::vector<T> scratch;
+  for (size_t block = 0; block < column.block_count(); ++block) {
+    const size_t first_row = block * kBlockRows;
+    const T* values = column.block_values(block, scratch);
+    for (size_t i = 0; i < column.block_rows(block); ++i) {
+      if (mask == nullptr || (*mask)[first_row + i]) {
+        add(statistics_key(values[i]));
+      }
+    }
+  }
+}
+
+}  // namespace
+
+std::string cell_to_str(const Cell& cell) {
+  if (const int* i = std::get_if<int>(&cell)) {
+    return std::to_string(*i);
+  }
+  if (const float* f = std::get_if<float>(&cell)) {
+    return std::to_string(*f);
+  }
+  return std::get<std::string>(cell);
+}
+
+Column::Column(std::string name, Kind kind)
+    : name_(std::move(name)), kind_(kind) {
+  switch (kind) {
+    case Kind::Int:
+      data_ = EncodedValues<int>();
+      break;
+    case Kind::Real:
+      data_ = EncodedValues<float>();
+      break;
+    case Kind::Text:
+      data_ = std::vector<std::string>();
+      break;
+  }
+}
+
+Column::Column(std::string name, Kind kind, MappedData data)
+    : name_(std::move(name)), kind_(kind), data_(std::move(data)) {
+  if (kind_ == Kind::Text) {
+    build_text_filters();
+  }
+}
+
+size_t Column::size() const {
+  return std::visit(
+      [](const auto& values) {
+        using Values = std::decay_t<decltype(values)>;
+        if constexpr (std::is_same_v<Values, MappedData>) {
+          return values.size_;
+        } else if constexpr (std::is_same_v<Values, std::vector<std::string>>) {
+          return values.size();
+        } else {
+          return values.blocks_.size() * kBlockRows + values.tail_.size();
+        }
+      },
+      data_);
+}
+
+size_t Column::block_rows(size_t block) const {
+  return std::min(kBlockRows, size() - block * kBlockRows);
+}
+
+template <typename T>
+const T* Column::block_values(size_t block, std::vector<T>& scratch) const {
+  if (const auto* mapped = std::get_if<MappedData>(&data_)) {
+    return static_cast<const T*>(mapped->values_) + block * kBlockRows;
+  }
+  const auto& values = std::get<EncodedValues<T>>(data_);
+  if (block == values.blocks_.size()) {
+    return values.tail_.data();
+  }
+  const EncodedBlock& encoded = values.blocks_[block];
+  std::vector<uint32_t> keys(encoded.size());
+  encoded.decode(keys.data());
+  scratch.resize(keys.size());
+  std::transform(keys.begin(), keys.end(), scratch.begin(), from_key<T>);
+  return scratch.data();
+}
+
+template <typename T>
+void Column::filter_block(
+    size_t block,
+    sql::Expression::Operation operation,
+    T constant,
+    std::vector<size_t>& selection) const {
+  const size_t first_row = block * kBlockRows;
+  // 0.0 and -0.0 compare equal but have different keys.
+  const bool keys_compare = !std::is_same_v<T, float> || constant != 0;
+  if (const auto* values = std::get_if<EncodedValues<T>>(&data_)) {
+    if (block < values->blocks_.size() && keys_compare) {
+      values->blocks_[block].filter(
+          operation, to_key(constant), first_row, selection);
+      return;
+    }
+  }
+  std::vector<T> scratch;
+  const T* block_data = block_values(block, scratch);
+  const size_t rows = block_rows(block);
+  for (size_t i = 0; i < rows; ++i) {
+    bool matches = false;
+    switch (operation) {
+      case sql::Expression::Operation::Less:
+        matches = block_data[i] < constant;
+        break;
+      case sql::Expression::Operation::Greater:
+        matches = block_data[i] > constant;
+        break;
+      case sql::Expression::Operation::LessEq:
+        matches = block_data[i] <= constant;
+        break;
+      case sql::Expression::Operation::GreaterEq:
+        matches = block_data[i] >= constant;
+        break;
+      case sql::Expression::Operation::Equal:
+        matches = block_data[i] == constant;
+        break;
+      case sql::Expression::Operation::NotEqual:
+        matches = block_data[i] != constant;
+        break;
+    }
+    if (matches) {
+      selection.push_back(first_row + i);
+    }
+  }
+}
+
+template const int* Column::block_values(size_t, std::vector<int>&) const;
+template const float* Column::block_values(size_t, std::vector<float>&) const;
+template void Column::filter_block(
+    size_t, sql::Expression::Operation, int, std::vector<size_t>&) const;
+template void Column::filter_block(
+    size_t, sql::Expression::Operation, float, std::vector<size_t>&) const;
+
+std::optional<Encoding> Column::block_encoding(size_t block) const {
+  return std::visit(
+      [block](const auto& values) -> std::optional<Encoding> {
+        using Values = std::decay_t<decltype(values)>;
+        if constexpr (
+            std::is_same_v<Values, EncodedValues<int>> ||
+            std::is_same_v<Values, EncodedValues<float>>) {
+          if (block < values.blocks_.size()) {
+            return values.blocks_[block].encoding();
+          }
+        }
+        return std::nullopt;
+      },
+      data_);
+}
+
+std::string_view Column::text(size_t row) const {
+  if (const auto* mapped = std::get_if<MappedData>(&data_)) {
+    const auto* bytes = static_cast<const char*>(mapped->values_);
+    return std::string_view(
+        bytes + mapped->offsets_[row],
+        mapped->offsets_[row + 1] - mapped->offsets_[row]);
+  }
+  return std::get<std::vector<std::string>>(data_)[row];
+}
+
+size_t Column::byte_size() const {
+  return std::visit(
+      [this](const auto& values) {
+        using Values = std::decay_t<decltype(values)>;
+        size_t size = 0;
+        if constexpr (std::is_same_v<Values, MappedData>) {
+          size = kind_ == Kind::Text
+              ? values.offsets_[values.size_] - values.offsets_[0]
+              : values.size_ * sizeof(int);
+        } else if constexpr (std::is_same_v<Values, std::vector<std::string>>) {
+          for (const auto& text : values) {
+            size += text.size();
+          }
+        } else {
+          for (const auto& block : values.blocks_) {
+            size += block.byte_size();
+          }
+          size += values.tail_.size() * sizeof(int);
+        }
+        return size;
+      },
+      data_);
+}
+
+size_t Column::byte_size(size_t row) const {
+  if (kind_ == Kind::Text) {
+    return text(row).size();
+  }
+  return sizeof(int);
+}
+
+Cell Column::at(size_t row) const {
+  return std::visit(
+      [this, row](const auto& values) -> Cell {
+        using Values = std::decay_t<decltype(values)>;
+        if constexpr (std::is_same_v<Values, MappedData>) {
+          switch (kind_) {
+            case Kind::Int:
+              return static_cast<const int*>(values.values_)[row];
+            case Kind::Real:
+              return static_cast<const float*>(values.values_)[row];
+            case Kind::Text:
+              break;
+          }
+          return std::string(text(row));
+        } else if constexpr (std::is_same_v<Values, std::vector<std::string>>) {
+          return values[row];
+        } else {
+          using T = typename decltype(values.tail_)::value_type;
+          const size_t block = row / kBlockRows;
+          if (block < values.blocks_.size()) {
+            return from_key<T>(values.blocks_[block].at(row % kBlockRows));
+          }
+          return values.tail_[row - values.blocks_.size() * kBlockRows];
+        }
+      },
+      data_);
+}
+
+void Column::push_back(Cell cell) {
+  materialize();
+  std::visit(
+      [this, &cell](auto& values) {
+        using Values = std::decay_t<decltype(values)>;
+        if constexpr (std::is_same_v<Values, std::vector<std::string>>) {
+          values.push_back(std::move(std::get<std::string>(cell)));
+          add_to_text_filter(values.size() - 1, values.back());
+        } else if constexpr (!std::is_same_v<Values, MappedData>) {
+          using T = typename decltype(values.tail_)::value_type;
+          values.tail_.push_back(std::get<T>(cell));
+          if (values.tail_.size() == kBlockRows) {
+            std::vector<uint32_t> keys(kBlockRows);
+            std::transform(
+                values.tail_.begin(), values.tail_.end(), keys.begin(),
+                [](T value) { return to_key(value); });
+            values.blocks_.push_back(
+                EncodedBlock::encode(keys.data(), keys.size()));
+            values.tail_.clear();
+          }
+        }
+      },
+      data_);
+}
+
+void Column::erase_rows(const std::vector<bool>& erase_mask) {
+  materialize();
+  switch (kind_) {
+    case Kind::Int: {
+      auto values = decode_all<int>();
+      erase_masked(values, erase_mask);
+      assign(values);
+      break;
+    }
+    case Kind::Real: {
+      auto values = decode_all<float>();
+      erase_masked(values, erase_mask);
+      assign(values);
+      break;
+    }
+    case Kind::Text:
+      erase_masked(std::get<std::vector<std::string>>(data_), erase_mask);
+      build_text_filters();
+      break;
+  }
+}
+
+template <typename T>
+std::vector<T> Column::decode_all() const {
+  std::vector<T> values;
+  values.reserve(size());
+  std::vector<T> scratch;
+  for (size_t block = 0; block < block_count(); ++block) {
+    const T* block_data = block_values(block, scratch);
+    values.insert(values.end(), block_data, block_data + block_rows(block));
+  }
+  return values;
+}
+
+template <typename T>
+void Column::assign(const std::vector<T>& values) {
+  data_ = EncodedValues<T>();
+  for (const T value : values) {
+    push_back(value);
+  }
+}
+
+void Column::materialize() {
+  if (!mapped()) {
+    return;
+  }
+  switch (kind_) {
+    case Kind::Int:
+      assign(decode_all<int>());
+      break;
+    case Kind::Real:
+      assign(decode_all<float>());
+      break;
+    case Kind::Text: {
+      std::vector<std::string> values;
+      values.reserve(size());
+      for (size_t row = 0; row < size(); ++row) {
+        values.emplace_back(text(row));
+      }
+      data_ = std::move(values);
+      break;
+    }
+  }
+}
+
+void Column::add_to_text_filter(size_t row, std::string_view value) {
+  if (row % kBlockRows == 0) {
+    text_filters_.emplace_back(kBlockRows);
+  }
+  text_filters_.back().add(text_hash(value));
+}
+
+void Column::build_text_filters() {
+  text_filters_.clear();
+  for (size_t row = 0; row < size(); ++row) {
+    add_to_text_filter(row, text(row));
+  }
+}
+
+Cell ColumnReader::at(size_t row) {
+  if (column_->kind() == Column::Kind::Text) {
+    return std::string(column_->text(row));
+  }
+  const size_t block = row / kBlockRows;
+  if (block != block_) {
+    block_ = block;
+    if (column_->kind() == Column::Kind::Int) {
+      ints_ = column_->block_values(block, int_scratch_);
+    } else {
+      floats_ = column_->block_values(block, float_scratch_);
+    }
+  }
+  if (column_->kind() == Column::Kind::Int) {
+    return ints_[row % kBlockRows];
+  }
+  return floats_[row % kBlockRows];
+}
+
+Table::Table(std::string name, std::vector<Column> columns)
+    : name_(std::move(name)), columns_(std::move(columns)) {
+  static std::atomic<uint64_t> next_id{0};
+  id_ = next_id.fetch_add(1, std::memory_order_relaxed);
+  analyze();
+}
+
+size_t Table::row_count() const {
+  return columns_.empty() ? 0 : columns_.front().size();
+}
+
+std::optional<size_t> Table::find_column(std::string_view column_name) const {
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    if (columns_[i].name() == column_name) {
+      return i;
+    }
+  }
+  return std::nullopt;
+}
+
+void Table::append_row(std::vector<Cell> row) {
+  assert(row.size() == columns_.size());
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    ColumnStatistics& statistics = statistics_.columns_[i];
+    if (const auto* text = std::get_if<std::string>(&row[i])) {
+      statistics.distinct_.add(text_hash(*text));
+    } else {
+      const uint32_t key = std::holds_alternative<int>(row[i])
+          ? statistics_key(std::get<int>(row[i]))
+          : statistics_key(std::get<float>(row[i]));
+      statistics.distinct_.add(mix_hash(key));
+      statistics.histogram_.add(key);
+    }
+    columns_[i].push_back(std::move(row[i]));
+  }
+  ++version_;
+  row_changed(1);
+}
+
+size_t Table::erase_rows(const std::vector<bool>& erase_mask) {
+  const size_t before = row_count();
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    Histogram& histogram = statistics_.columns_[i].histogram_;
+    const auto remove = [&histogram](uint32_t key) { histogram.remove(key); };
+    if (columns_[i].kind() == Column::Kind::Int) {
+      for_each_key<int>(columns_[i], &erase_mask, remove);
+    } else if (columns_[i].kind() == Column::Kind::Real) {
+      for_each_key<float>(columns_[i], &erase_mask, remove);
+    }
+  }
+  for (auto& column : columns_) {
+    column.erase_rows(erase_mask);
+  }
+  const size_t erased = before - row_count();
+  if (erased != 0) {
+    ++version_;
+    row_changed(erased);
+  }
+  return erased;
+}
+
+void Table::analyze() {
+  statistics_ = TableStatistics();
+  statistics_.columns_.resize(columns_.size());
+  statistics_.rebuilt_rows_ = row_count();
+  std::vector<uint32_t> keys;
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    const Column& column = columns_[i];
+    ColumnStatistics& statistics = statistics_.columns_[i];
+    if (column.kind() == Column::Kind::Text) {
+      for (size_t row = 0; row < column.size(); ++row) {
+        statistics.distinct_.add(text_hash(column.text(row)));
+      }
+      continue;
+    }
+    keys.clear();
+    const auto add = [&](uint32_t key) {
+      statistics.distinct_.add(mix_hash(key));
+      keys.push_back(key);
+    };
+    if (column.kind() == Column::Kind::Int) {
+      for_each_key<int>(column, nullptr, add);
+    } else {
+      for_each_key<float>(column, nullptr, add);
+    }
+    std::sort(keys.begin(), keys.end());
+    statistics.histogram_.build(keys);
+  }
+}
+
+void Table::row_changed(size_t rows) {
+  constexpr size_t kMinRebuildRows = 1024;
+  statistics_.changed_rows_ += rows;
+  if (statistics_.changed_rows_ >=
+      std::max(kMinRebuildRows, statistics_.rebuilt_rows_)) {
+    analyze();
+  }
+}
+
+}  // namespace rdb::exec
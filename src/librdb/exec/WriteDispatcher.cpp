@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <librdb/exec/WriteDispatcher.hpp>
+#include <librdb/memory/MemoryTracker.hpp>
+#include <librdb/sync/SpscQueue.hpp>
+#include <mutex>
+#include <string_view>
+#include <thread>
+
+namespace rdb::exec {
+
+namespace {
+
+struct Task {
+  const sql::Statement* statement_ = nullptr;
+  size_t index_ = 0;
+};
+
+}  // namespace
+
+// A thread that applies the statements of its queue with an executor of its
+// own. It spins on an empty queue for a while, then parks until the
+// dispatcher pushes again.
+class WriteDispatcher::Worker {
+ public:
+  Worker(
+      Catalog& catalog,
+      size_t queue_capacity,
+      sync::MpscQueue<Error>& errors,
+      memory::MemoryTracker& tracker)
+      : queue_(queue_capacity),
+        executor_(catalog),
+        errors_(errors),
+        thread_([this, &tracker] { run(tracker); }) {}
+
+  // Applies what is still queued.
+  ~Worker() {
+    stop_.store(true);
+    wake();
+    thread_.join();
+  }
+
+  void push(const sql::Statement& statement, size_t index) {
+    Task task{&statement, index};
+    while (!queue_.try_push(std::move(task))) {
+      wake();
+      std::this_thread::yield();
+    }
+    ++pushed_;
+    wake();
+  }
+
+  // Waits until every pushed statement is applied.
+  void drain() const {
+    while (applied_.load(std::memory_order_acquire) != pushed_) {
+      std::this_thread::yield();
+    }
+  }
+
+ private:
+  void run(memory::MemoryTracker& tracker) {
+    constexpr unsigned kIdleSpins = 256;
+    const memory::MemoryScope scope(tracker);
+    unsigned idle = 0;
+    while (true) {
+      if (std::optional<Task> task = queue_.try_pop()) {
+        apply(*task);
+        idle = 0;
+        continue;
+      }
+      if (stop_.load()) {
+        return;
+      }
+      if (++idle < kIdleSpins) {
+        std::this_thread::yield();
+        continue;
+      }
+      std::unique_lock lock(mutex_);
+      parked_.store(true, std::memory_order_relaxed);
+      // Pairs with the fence in wake(): either the worker sees the push, or
+      // the pusher sees it parked.
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      wake_.wait(lock, [this] { return !queue_.empty() || stop_.load(); });
+      parked_.store(false, std::memory_order_relaxed);
+      idle = 0;
+    }
+  }
+
+  void apply(const Task& task) {
+    try {
+      executor_.execute(*task.statement_);
+    } catch (const ExecutionError& e) {
+      errors_.push({task.index_, e.what()});
+    }
+    applied_.fetch_add(1, std::memory_order_release);
+  }
+
+  void wake() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (parked_.load(std::memory_order_relaxed)) {
+      const std::lock_guard lock(mutex_);
+      wake_.notify_one();
+    }
+  }
+
+  sync::SpscQueue<Task> queue_;
+  Executor executor_;
+  sync::MpscQueue<Error>& errors_;
+  // Only the dispatching thread reads and writes it.
+  size_t pushed_ = 0;
+  std::atomic<size_t> applied_{0};
+  std::atomic<bool> stop_{false};
+  std::atomic<bool> parked_{false};
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::thread thread_;
+};
+
+WriteDispatcher::WriteDispatcher(
+    Catalog& catalog,
+    size_t workers,
+    size_t queue_capacity)
+    : executor_(catalog) {
+  memory::MemoryTracker& tracker = memory::MemoryTracker::current();
+  for (size_t worker = 0; worker < std::max<size_t>(workers, 1); ++worker) {
+    workers_.push_back(
+        std::make_unique<Worker>(catalog, queue_capacity, errors_, tracker));
+  }
+}
+
+WriteDispatcher::~WriteDispatcher() = default;
+
+void WriteDispatcher::dispatch(const sql::Statement& statement) {
+  const size_t index = dispatched_++;
+  const std::string_view table_name = written_table(statement);
+  if (!table_name.empty() && !transaction_.active()) {
+    const size_t worker =
+        std::hash<std::string_view>()(table_name) % workers_.size();
+    workers_[worker]->push(statement, index);
+    return;
+  }
+  // CREATE and DROP change what the workers see, and reads must see their
+  // writes.
+  drain();
+  try {
+    executor_.execute(statement, transaction_);
+  } catch (const ExecutionError& e) {
+    errors_.push({index, e.what()});
+  }
+}
+
+std::vector<WriteDispatcher::Error> WriteDispatcher::wait() {
+  drain();
+  std::vector<Error> errors;
+  while (std::optional<Error> error = errors_.try_pop()) {
+    errors.push_back(std::move(*error));
+  }
+  std::sort(errors.begin(), errors.end(), [](const auto& a, const auto& b) {
+    return a.statement_ < b.statement_;
+  });
+  return errors;
+}
+
+void WriteDispatcher::drain() {
+  for (const auto& worker : workers_) {
+    worker->drain();
+  }
+}
+
+}  // namespace rdb::exec
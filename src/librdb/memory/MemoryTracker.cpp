@@ -0,0 +1,122 @@
+#include <librdb/memory/MemoryTracker.hpp>
+#include <utility>
+
+namespace rdb::memory {
+
+namespace {
+
+thread_local MemoryTracker* current_tracker = nullptr;
+
+}  // namespace
+
+MemoryTracker& MemoryTracker::process() {
+  static MemoryTracker process_tracker("process", nullptr);
+  return process_tracker;
+}
+
+MemoryTracker& MemoryTracker::current() {
+  return current_tracker != nullptr ? *current_tracker : process();
+}
+
+MemoryTracker::MemoryTracker(
+    std::string name,
+    MemoryTracker* parent,
+    std::optional<size_t> limit)
+    : anchor_(std::make_shared<Anchor>()),
+      name_(std::move(name)),
+      parent_(parent),
+      limit_(limit) {
+  anchor_->tracker_ = this;
+}
+
+MemoryTracker::~MemoryTracker() {
+  {
+    const std::lock_guard lock(anchor_->mutex_);
+    anchor_->tracker_ = nullptr;
+  }
+  if (parent_ != nullptr) {
+    parent_->release(used());
+  }
+}
+
+bool MemoryTracker::try_charge(size_t bytes) {
+  const size_t used = used_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  if (limit_ && used > *limit_) {
+    used_.fetch_sub(bytes, std::memory_order_relaxed);
+    return false;
+  }
+  return true;
+}
+
+void MemoryTracker::update_peak() {
+  const size_t used = this->used();
+  size_t peak = peak_.load(std::memory_order_relaxed);
+  while (peak < used &&
+         !peak_.compare_exchange_weak(peak, used, std::memory_order_relaxed)) {
+  }
+}
+
+void MemoryTracker::allocate(size_t bytes) {
+  for (MemoryTracker* tracker = this; tracker != nullptr;
+       tracker = tracker->parent_) {
+    if (tracker->try_charge(bytes)) {
+      continue;
+    }
+    for (MemoryTracker* charged = this; charged != tracker;
+         charged = charged->parent_) {
+      charged->used_.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+    throw MemoryLimitError(
+        "Memory limit of " + tracker->name_ + " exceeded: " +
+        std::to_string(tracker->used() + bytes) + " of " +
+        std::to_string(*tracker->limit_) + " bytes");
+  }
+  // Only once all of them were charged, so that a refused allocation
+  // doesn't count towards any peak.
+  for (MemoryTracker* tracker = this; tracker != nullptr;
+       tracker = tracker->parent_) {
+    tracker->update_peak();
+  }
+}
+
+void MemoryTracker::release(size_t bytes) {
+  for (MemoryTracker* tracker = this; tracker != nullptr;
+       tracker = tracker->parent_) {
+    tracker->used_.fetch_sub(bytes, std::memory_order_relaxed);
+  }
+}
+
+MemoryScope::MemoryScope(MemoryTracker& tracker)
+    : previous_(current_tracker) {
+  current_tracker = &tracker;
+}
+
+MemoryScope::~MemoryScope() {
+  current_tracker = previous_;
+}
+
+Reservation& Reservation::operator=(Reservation&& other) noexcept {
+  if (this != &other) {
+    resize(0);
+    anchor_ = other.anchor_;
+    bytes_ = std::exchange(other.bytes_, 0);
+  }
+  return *this;
+}
+
+void Reservation::resize(size_t bytes) {
+  if (anchor_ == nullptr) {
+    return;
+  }
+  // Keeps the tracker from being destroyed meanwhile.
+  const std::lock_guard lock(anchor_->mutex_);
+  MemoryTracker* tracker = anchor_->tracker_;
+  if (tracker != nullptr && bytes > bytes_) {
+    tracker->allocate(bytes - bytes_);
+  } else if (tracker != nullptr) {
+    tracker->release(bytes_ - bytes);
+  }
+  bytes_ = bytes;
+}
+
+}  // namespace rdb::memory
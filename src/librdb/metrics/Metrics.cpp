@@ -0,0 +1,238 @@
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <librdb/metrics/Metrics.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+
+namespace rdb::metrics {
+
+namespace {
+
+// Histograms are exported with a bucket per power of two between ~1us and
+// ~69s. Internal buckets never straddle a power of two, so each exported
+// bucket counts exactly the values below its bound.
+constexpr size_t kFirstExportedPower = 10;
+constexpr size_t kLastExportedPower = 36;
+constexpr double kSecondsPerUnit = 1e-9;
+
+std::string escape_label_value(const std::string& value) {
+  std::string escaped;
+  for (const char c : value) {
+    if (c == '\\' || c == '"') {
+      escaped += '\\';
+      escaped += c;
+    } else if (c == '\n') {
+      escaped += "\\n";
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+std::string labels_to_str(const Labels& labels, const std::string& le = "") {
+  if (labels.empty() && le.empty()) {
+    return "";
+  }
+  std::string out = "{";
+  for (const auto& [name, value] : labels) {
+    if (out.size() > 1) {
+      out += ',';
+    }
+    out += name + "=\"" + escape_label_value(value) + '"';
+  }
+  if (!le.empty()) {
+    if (out.size() > 1) {
+      out += ',';
+    }
+    out += "le=\"" + le + '"';
+  }
+  return out + "}";
+}
+
+}  // namespace
+
+size_t detail::shard_index() {
+  static std::atomic<size_t> next_thread{0};
+  thread_local const size_t index =
+      next_thread.fetch_add(1, std::memory_order_relaxed) % kShards;
+  return index;
+}
+
+uint64_t Counter::value() const {
+  uint64_t value = 0;
+  for (const auto& shard : shards_) {
+    value += shard.value_.load(std::memory_order_relaxed);
+  }
+  return value;
+}
+
+Histogram::Snapshot Histogram::snapshot() const {
+  Snapshot snapshot;
+  for (const auto& shard : shards_) {
+    for (size_t bucket = 0; bucket < kBuckets; ++bucket) {
+      snapshot.buckets_[bucket] +=
+          shard.buckets_[bucket].load(std::memory_order_relaxed);
+    }
+    snapshot.sum_ += shard.sum_.load(std::memory_order_relaxed);
+  }
+  for (const uint64_t count : snapshot.buckets_) {
+    snapshot.count_ += count;
+  }
+  return snapshot;
+}
+
+uint64_t Histogram::count() const {
+  uint64_t count = 0;
+  for (const auto& shard : shards_) {
+    count += shard.count_.load(std::memory_order_relaxed);
+  }
+  return count;
+}
+
+uint64_t Histogram::sum() const {
+  uint64_t sum = 0;
+  for (const auto& shard : shards_) {
+    sum += shard.sum_.load(std::memory_order_relaxed);
+  }
+  return sum;
+}
+
+uint64_t Histogram::Snapshot::quantile(double fraction) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  const auto rank = static_cast<uint64_t>(fraction * double(count_ - 1)) + 1;
+  uint64_t seen = 0;
+  for (size_t bucket = 0; bucket < kBuckets; ++bucket) {
+    seen += buckets_[bucket];
+    if (seen >= rank) {
+      return bucket_upper_bound(bucket);
+    }
+  }
+  return bucket_upper_bound(kBuckets - 1);
+}
+
+size_t Histogram::bucket_of(uint64_t value) {
+  if (value < kSubBuckets) {
+    return value;
+  }
+  const auto magnitude = static_cast<size_t>(63 - __builtin_clzll(value));
+  const size_t shift = magnitude - kSubBucketBits;
+  const size_t sub_bucket = (value >> shift) & (kSubBuckets - 1);
+  return (shift + 1) * kSubBuckets + sub_bucket;
+}
+
+uint64_t Histogram::bucket_upper_bound(size_t bucket) {
+  if (bucket < kSubBuckets) {
+    return bucket;
+  }
+  const size_t shift = bucket / kSubBuckets - 1;
+  const uint64_t lower = (kSubBuckets + bucket % kSubBuckets) << shift;
+  return lower + ((uint64_t{1} << shift) - 1);
+}
+
+Registry& Registry::global() {
+  static Registry registry;
+  return registry;
+}
+
+Counter& Registry::counter(
+    const std::string& name,
+    const std::string& help,
+    const Labels& labels) {
+  return *series(name, help, labels, Type::Counter).counter_;
+}
+
+Histogram& Registry::histogram(
+    const std::string& name,
+    const std::string& help,
+    const Labels& labels) {
+  return *series(name, help, labels, Type::Histogram).histogram_;
+}
+
+Registry::Series& Registry::series(
+    const std::string& name,
+    const std::string& help,
+    const Labels& labels,
+    Type type) {
+  const std::lock_guard lock(mutex_);
+  auto [it, inserted] = families_.try_emplace(name, Family{type, help, {}});
+  Family& family = it->second;
+  if (family.type_ != type) {
+    throw std::logic_error("Metric " + name + " registered with another type");
+  }
+  for (auto& series : family.series_) {
+    if (series.labels_ == labels) {
+      return series;
+    }
+  }
+  Series series{labels, nullptr, nullptr};
+  if (type == Type::Counter) {
+    series.counter_ = std::make_unique<Counter>();
+  } else {
+    series.histogram_ = std::make_unique<Histogram>();
+  }
+  return family.series_.emplace_back(std::move(series));
+}
+
+std::string Registry::render_prometheus() const {
+  const std::lock_guard lock(mutex_);
+  std::stringstream out;
+  out.precision(9);
+  for (const auto& [name, family] : families_) {
+    const bool is_counter = family.type_ == Type::Counter;
+    out << "# HELP " << name << ' ' << family.help_ << '\n';
+    out << "# TYPE " << name << ' ' << (is_counter ? "counter" : "histogram")
+        << '\n';
+    for (const auto& series : family.series_) {
+      if (is_counter) {
+        out << name << labels_to_str(series.labels_) << ' '
+            << series.counter_->value() << '\n';
+        continue;
+      }
+      const Histogram::Snapshot histogram = series.histogram_->snapshot();
+      uint64_t cumulative = 0;
+      size_t bucket = 0;
+      for (size_t power = kFirstExportedPower; power <= kLastExportedPower;
+           ++power) {
+        const uint64_t bound = uint64_t{1} << power;
+        for (; Histogram::bucket_upper_bound(bucket) < bound; ++bucket) {
+          cumulative += histogram.buckets_[bucket];
+        }
+        std::stringstream le;
+        le.precision(9);
+        le << double(bound) * kSecondsPerUnit;
+        out << name << "_bucket" << labels_to_str(series.labels_, le.str())
+            << ' ' << cumulative << '\n';
+      }
+      out << name << "_bucket" << labels_to_str(series.labels_, "+Inf") << ' '
+          << histogram.count_ << '\n';
+      out << name << "_sum" << labels_to_str(series.labels_) << ' '
+          << double(histogram.sum_) * kSecondsPerUnit << '\n';
+      out << name << "_count" << labels_to_str(series.labels_) << ' '
+          << histogram.count_ << '\n';
+    }
+  }
+  return out.str();
+}
+
+void Registry::write_prometheus(const std::string& path) const {
+  const std::string temporary_path = path + ".tmp";
+  {
+    std::ofstream out(temporary_path, std::ios::trunc);
+    out << render_prometheus();
+    out.close();
+    if (!out) {
+      throw std::system_error(
+          std::make_error_code(std::errc::io_error), temporary_path);
+    }
+  }
+  if (std::rename(temporary_path.c_str(), path.c_str()) != 0) {
+    throw std::system_error(errno, std::generic_category(), path);
+  }
+}
+
+}  // namespace rdb::metrics
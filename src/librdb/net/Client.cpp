@@ -0,0 +1,91 @@
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <librdb/net/Client.hpp>
+#include <system_error>
+
+namespace rdb::net {
+
+namespace {
+
+[[noreturn]] void throw_errno(const char* what) {
+  throw std::system_error(errno, std::generic_category(), what);
+}
+
+}  // namespace
+
+Client::Client(const std::string& socket_path) {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (socket_path.size() >= sizeof(address.sun_path)) {
+    throw std::system_error(
+        std::make_error_code(std::errc::filename_too_long), socket_path);
+  }
+  std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+
+  fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd_ < 0) {
+    throw_errno("socket");
+  }
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  const auto* raw_address = reinterpret_cast<const sockaddr*>(&address);
+  if (connect(fd_, raw_address, sizeof(address)) != 0) {
+    const int error = errno;
+    close(fd_);
+    throw std::system_error(error, std::generic_category(), "connect");
+  }
+}
+
+Client::~Client() {
+  close(fd_);
+}
+
+void Client::send_script(std::string_view sql) {
+  std::string frame;
+  encode_frame(frame, FrameType::Script, sql);
+  size_t sent = 0;
+  while (sent < frame.size()) {
+    const ssize_t size =
+        send(fd_, frame.data() + sent, frame.size() - sent, MSG_NOSIGNAL);
+    if (size < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw_errno("send");
+    }
+    sent += static_cast<size_t>(size);
+  }
+}
+
+void Client::finish_sending() {
+  if (shutdown(fd_, SHUT_WR) != 0) {
+    throw_errno("shutdown");
+  }
+}
+
+Frame Client::read_frame() {
+  constexpr size_t kReadChunk = 64 * 1024;
+  std::array<char, kReadChunk> chunk{};
+  while (true) {
+    if (auto frame = reader_.next()) {
+      return std::move(*frame);
+    }
+    const ssize_t size = read(fd_, chunk.data(), chunk.size());
+    if (size < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw_errno("read");
+    }
+    if (size == 0) {
+      throw ProtocolError("Connection closed by server");
+    }
+    reader_.append(chunk.data(), static_cast<size_t>(size));
+  }
+}
+
+}  // namespace rdb::net
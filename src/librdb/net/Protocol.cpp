@@ -0,0 +1,228 @@
+#include <cstring>
+#include <librdb/net/Protocol.hpp>
+
+namespace rdb::net {
+
+namespace {
+
+enum class CellTag : uint8_t { Int = 1, Real = 2, Text = 3 };
+
+template <typename T>
+void put(std::string& out, T value) {
+  char bytes[sizeof(T)];
+  std::memcpy(bytes, &value, sizeof(T));
+  out.append(bytes, sizeof(T));
+}
+
+void put_string(std::string& out, std::string_view value) {
+  put(out, static_cast<uint32_t>(value.size()));
+  out.append(value);
+}
+
+class PayloadReader {
+ public:
+  explicit PayloadReader(std::string_view payload) : payload_(payload) {}
+
+  template <typename T>
+  T get() {
+    require(sizeof(T));
+    T value;
+    std::memcpy(&value, payload_.data(), sizeof(T));
+    payload_.remove_prefix(sizeof(T));
+    return value;
+  }
+
+  std::string get_string() {
+    const auto size = get<uint32_t>();
+    require(size);
+    std::string value(payload_.substr(0, size));
+    payload_.remove_prefix(size);
+    return value;
+  }
+
+ private:
+  void require(size_t size) const {
+    if (payload_.size() < size) {
+      throw ProtocolError("Truncated payload");
+    }
+  }
+
+  std::string_view payload_;
+};
+
+// Starts a frame whose payload length finish_frame() fills in, and returns
+// the offset of its header.
+size_t start_frame(std::string& out, FrameType type) {
+  const size_t header = out.size();
+  put(out, uint32_t{0});
+  put(out, static_cast<uint8_t>(type));
+  return header;
+}
+
+void finish_frame(std::string& out, size_t header) {
+  const size_t size = out.size() - header - kFrameHeaderSize;
+  if (size > kMaxFramePayload) {
+    out.resize(header);
+    throw ProtocolError("Frame is too large");
+  }
+  const auto length = static_cast<uint32_t>(size);
+  std::memcpy(&out[header], &length, sizeof(length));
+}
+
+void put_cell(std::string& out, const exec::Cell& cell) {
+  if (const int* i = std::get_if<int>(&cell)) {
+    put(out, static_cast<uint8_t>(CellTag::Int));
+    put(out, static_cast<int32_t>(*i));
+  } else if (const float* f = std::get_if<float>(&cell)) {
+    put(out, static_cast<uint8_t>(CellTag::Real));
+    put(out, *f);
+  } else {
+    put(out, static_cast<uint8_t>(CellTag::Text));
+    put_string(out, std::get<std::string>(cell));
+  }
+}
+
+}  // namespace
+
+void encode_frame(std::string& out, FrameType type, std::string_view payload) {
+  const size_t header = start_frame(out, type);
+  out.append(payload);
+  finish_frame(out, header);
+}
+
+void encode_ok(std::string& out, uint64_t affected_rows) {
+  std::string payload;
+  put(payload, affected_rows);
+  encode_frame(out, FrameType::Ok, payload);
+}
+
+void encode_columns(std::string& out, const std::vector<std::string>& names) {
+  const size_t header = start_frame(out, FrameType::Columns);
+  put(out, static_cast<uint32_t>(names.size()));
+  for (const auto& name : names) {
+    put_string(out, name);
+  }
+  finish_frame(out, header);
+}
+
+size_t encode_rows(
+    std::string& out,
+    const std::vector<std::vector<exec::Cell>>& rows,
+    size_t begin) {
+  const size_t header = start_frame(out, FrameType::Rows);
+  const size_t counts = out.size();
+  put(out, static_cast<uint32_t>(rows[begin].size()));
+  put(out, uint32_t{0});
+  size_t end = begin;
+  while (end < rows.size() && out.size() - counts < kRowsChunkBytes) {
+    for (const auto& cell : rows[end]) {
+      put_cell(out, cell);
+    }
+    ++end;
+  }
+  const auto row_count = static_cast<uint32_t>(end - begin);
+  std::memcpy(&out[counts + sizeof(uint32_t)], &row_count, sizeof(row_count));
+  finish_frame(out, header);
+  return end;
+}
+
+void encode_rows_end(std::string& out) {
+  std::string payload;
+  put(payload, uint32_t{0});
+  put(payload, uint32_t{0});
+  encode_frame(out, FrameType::Rows, payload);
+}
+
+void encode_result(std::string& out, const exec::Result& result) {
+  if (result.column_names_.empty()) {
+    encode_ok(out, result.affected_rows_);
+    return;
+  }
+  encode_columns(out, result.column_names_);
+  for (size_t row = 0; row < result.rows_.size();) {
+    row = encode_rows(out, result.rows_, row);
+  }
+  encode_rows_end(out);
+}
+
+void encode_done(std::string& out, uint32_t statement_count) {
+  std::string payload;
+  put(payload, statement_count);
+  encode_frame(out, FrameType::Done, payload);
+}
+
+std::vector<std::string> decode_columns(std::string_view payload) {
+  PayloadReader reader(payload);
+  std::vector<std::string> names;
+  const auto count = reader.get<uint32_t>();
+  for (uint32_t i = 0; i < count; ++i) {
+    names.push_back(reader.get_string());
+  }
+  return names;
+}
+
+std::vector<std::vector<exec::Cell>> decode_rows(std::string_view payload) {
+  PayloadReader reader(payload);
+  const auto column_count = reader.get<uint32_t>();
+  const auto row_count = reader.get<uint32_t>();
+  std::vector<std::vector<exec::Cell>> rows;
+  for (uint32_t i = 0; i < row_count; ++i) {
+    std::vector<exec::Cell> row;
+    row.reserve(column_count);
+    for (uint32_t j = 0; j < column_count; ++j) {
+      switch (static_cast<CellTag>(reader.get<uint8_t>())) {
+        case CellTag::Int:
+          row.emplace_back(static_cast<int>(reader.get<int32_t>()));
+          break;
+        case CellTag::Real:
+          row.emplace_back(reader.get<float>());
+          break;
+        case CellTag::Text:
+          row.emplace_back(reader.get_string());
+          break;
+        default:
+          throw ProtocolError("Unknown cell tag");
+      }
+    }
+    rows.push_back(std::move(row));
+  }
+  return rows;
+}
+
+uint64_t decode_ok(std::string_view payload) {
+  return PayloadReader(payload).get<uint64_t>();
+}
+
+uint32_t decode_done(std::string_view payload) {
+  return PayloadReader(payload).get<uint32_t>();
+}
+
+std::optional<Frame> FrameReader::next() {
+  const std::string_view pending =
+      std::string_view(buffer_).substr(consumed_);
+  if (pending.size() < kFrameHeaderSize) {
+    return std::nullopt;
+  }
+  uint32_t size = 0;
+  std::memcpy(&size, pending.data(), sizeof(size));
+  const auto type = static_cast<FrameType>(pending[sizeof(size)]);
+  if (size > kMaxFramePayload) {
+    throw ProtocolError("Frame is too large");
+  }
+  if (type < FrameType::Script || type > FrameType::Columns) {
+    throw ProtocolError("Unknown frame type");
+  }
+  if (pending.size() < kFrameHeaderSize + size) {
+    return std::nullopt;
+  }
+  Frame frame{type, std::string(pending.substr(kFrameHeaderSize, size))};
+  consumed_ += kFrameHeaderSize + size;
+  // Compact once the consumed prefix dominates the buffer.
+  if (consumed_ * 2 >= buffer_.size()) {
+    buffer_.erase(0, consumed_);
+    consumed_ = 0;
+  }
+  return frame;
+}
+
+}  // namespace rdb::net
@@ -0,0 +1,390 @@
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <librdb/memory/MemoryTracker.hpp>
+#include <librdb/net/Protocol.hpp>
+#include <librdb/net/Server.hpp>
+#include <librdb/sql/Parser.hpp>
+#include <librdb/storage/StatementLog.hpp>
+#include <system_error>
+
+namespace rdb::net {
+
+namespace {
+
+// A connection stops reading new frames while this much output is pending,
+// so a client that pipelines without reading can't exhaust server memory.
+constexpr size_t kMaxPendingOutput = size_t{4} << 20U;
+constexpr size_t kReadChunk = 64 * 1024;
+constexpr int kMaxEvents = 64;
+
+[[noreturn]] void throw_errno(const char* what) {
+  throw std::system_error(errno, std::generic_category(), what);
+}
+
+sockaddr_un make_address(const std::string& socket_path) {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (socket_path.size() >= sizeof(address.sun_path)) {
+    throw std::system_error(
+        std::make_error_code(std::errc::filename_too_long), socket_path);
+  }
+  std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+  return address;
+}
+
+}  // namespace
+
+// A script whose statements are executed one at a time, so that a
+// connection's output is sent while the rest of the script waits.
+struct Server::Script {
+  explicit Script(std::string sql) : sql_(std::move(sql)) {}
+
+  // The statements point into the text.
+  std::string sql_;
+  sql::Parser::Result parsed_;
+  size_t next_statement_ = 0;
+  uint32_t executed_ = 0;
+  // The result of the SELECT being sent, and its first row still to send.
+  std::optional<exec::Result> result_;
+  size_t next_row_ = 0;
+};
+
+struct Server::Connection {
+  Connection(int fd, std::optional<size_t> memory_limit)
+      : fd_(fd),
+        memory_("session", &memory::MemoryTracker::process(), memory_limit) {}
+
+  size_t pending_output() const { return output_.size() - written_; }
+
+  // Whether the connection can be closed: its output can't be sent, or the
+  // peer is done sending and every script is answered.
+  bool finished() const {
+    return write_failed_ || (closing_ && !script_ && pending_output() == 0);
+  }
+
+  int fd_;
+  FrameReader reader_;
+  std::string output_;
+  size_t written_ = 0;
+  uint32_t events_ = 0;
+  // No more frames are read; the ones received are still answered.
+  bool closing_ = false;
+  // The output was dropped after a failed send.
+  bool write_failed_ = false;
+  memory::MemoryTracker memory_;
+  exec::Transaction transaction_;
+  // Charges its statements to `memory_`.
+  std::unique_ptr<Script> script_;
+};
+
+Server::Server(
+    exec::Executor& executor,
+    std::string socket_path,
+    std::optional<size_t> session_memory_limit)
+    : executor_(executor),
+      socket_path_(std::move(socket_path)),
+      session_memory_limit_(session_memory_limit) {
+  const sockaddr_un address = make_address(socket_path_);
+  listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (listen_fd_ < 0) {
+    throw_errno("socket");
+  }
+  unlink(socket_path_.c_str());
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  const auto* raw_address = reinterpret_cast<const sockaddr*>(&address);
+  if (bind(listen_fd_, raw_address, sizeof(address)) != 0) {
+    fail_setup("bind", false);
+  }
+  if (listen(listen_fd_, SOMAXCONN) != 0) {
+    fail_setup("listen", true);
+  }
+  epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_fd_ < 0) {
+    fail_setup("epoll_create1", true);
+  }
+  stop_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (stop_fd_ < 0) {
+    fail_setup("eventfd", true);
+  }
+  for (const int fd : {listen_fd_, stop_fd_}) {
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+      fail_setup("epoll_ctl", true);
+    }
+  }
+}
+
+void Server::fail_setup(const char* what, bool bound) {
+  // close() and unlink() may change errno.
+  const int error = errno;
+  for (const int fd : {stop_fd_, epoll_fd_, listen_fd_}) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+  if (bound) {
+    unlink(socket_path_.c_str());
+  }
+  throw std::system_error(error, std::generic_category(), what);
+}
+
+Server::~Server() {
+  for (const auto& [fd, connection] : connections_) {
+    close(fd);
+  }
+  close(stop_fd_);
+  close(epoll_fd_);
+  close(listen_fd_);
+  unlink(socket_path_.c_str());
+}
+
+void Server::run() {
+  std::array<epoll_event, kMaxEvents> events{};
+  while (true) {
+    const int count = epoll_wait(epoll_fd_, events.data(), kMaxEvents, -1);
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw_errno("epoll_wait");
+    }
+    for (int i = 0; i < count; ++i) {
+      const int fd = events[i].data.fd;
+      if (fd == stop_fd_) {
+        uint64_t value = 0;
+        [[maybe_unused]] auto ignored = read(stop_fd_, &value, sizeof(value));
+        return;
+      }
+      if (fd == listen_fd_) {
+        accept_connections();
+        continue;
+      }
+      auto it = connections_.find(fd);
+      if (it == connections_.end()) {
+        continue;
+      }
+      Connection& connection = *it->second;
+      if ((events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) != 0) {
+        handle_readable(connection);
+      }
+      if (!connection.write_failed_ && (events[i].events & EPOLLOUT) != 0) {
+        handle_writable(connection);
+      }
+      if (log_error_) {
+        fail_stop();
+      }
+      if (connection.finished()) {
+        close_connection(fd);
+      } else {
+        update_events(connection);
+      }
+    }
+  }
+}
+
+void Server::stop() {
+  const uint64_t value = 1;
+  [[maybe_unused]] auto ignored = write(stop_fd_, &value, sizeof(value));
+}
+
+void Server::fail_stop() {
+  // Best effort: the sockets are non-blocking, and the process is going
+  // down anyway.
+  for (const auto& [fd, connection] : connections_) {
+    handle_writable(*connection);
+  }
+  throw storage::StorageError(*log_error_);
+}
+
+void Server::accept_connections() {
+  while (true) {
+    const int fd = accept4(
+        listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) {
+      return;
+    }
+    auto connection = std::make_unique<Connection>(fd, session_memory_limit_);
+    connection->events_ = EPOLLIN;
+    epoll_event event{};
+    event.events = connection->events_;
+    event.data.fd = fd;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event);
+    connections_.emplace(fd, std::move(connection));
+  }
+}
+
+void Server::handle_readable(Connection& connection) {
+  std::array<char, kReadChunk> chunk{};
+  while (connection.pending_output() < kMaxPendingOutput) {
+    const ssize_t size = read(connection.fd_, chunk.data(), chunk.size());
+    if (size > 0) {
+      connection.reader_.append(chunk.data(), static_cast<size_t>(size));
+      process_frames(connection);
+      continue;
+    }
+    if (size < 0 && (errno == EAGAIN || errno == EINTR)) {
+      break;
+    }
+    // EOF or a hard error: finish the frames already received, then close.
+    connection.closing_ = true;
+    break;
+  }
+  process_frames(connection);
+  handle_writable(connection);
+}
+
+void Server::handle_writable(Connection& connection) {
+  while (connection.pending_output() != 0) {
+    const ssize_t size = send(
+        connection.fd_,
+        connection.output_.data() + connection.written_,
+        connection.pending_output(),
+        MSG_NOSIGNAL);
+    if (size < 0) {
+      if (errno == EAGAIN || errno == EINTR) {
+        break;
+      }
+      connection.write_failed_ = true;
+      connection.output_.clear();
+      connection.written_ = 0;
+      connection.script_.reset();
+      return;
+    }
+    connection.written_ += static_cast<size_t>(size);
+  }
+  if (connection.pending_output() == 0) {
+    connection.output_.clear();
+    connection.written_ = 0;
+  }
+  // Frames held back by the output limit can make progress now.
+  process_frames(connection);
+}
+
+void Server::process_frames(Connection& connection) {
+  while (!log_error_ && !connection.write_failed_ &&
+         connection.pending_output() < kMaxPendingOutput) {
+    if (connection.script_) {
+      const memory::MemoryScope memory_scope(connection.memory_);
+      continue_script(connection);
+      continue;
+    }
+    std::optional<Frame> frame;
+    try {
+      frame = connection.reader_.next();
+    } catch (const ProtocolError& e) {
+      encode_frame(connection.output_, FrameType::Error, e.what());
+      connection.closing_ = true;
+      return;
+    }
+    if (!frame) {
+      return;
+    }
+    if (frame->type_ != FrameType::Script) {
+      encode_frame(
+          connection.output_, FrameType::Error, "Expected Script frame");
+      encode_done(connection.output_, 0);
+      continue;
+    }
+    const memory::MemoryScope memory_scope(connection.memory_);
+    start_script(connection, std::move(frame->payload_));
+  }
+}
+
+void Server::start_script(Connection& connection, std::string sql) {
+  auto script = std::make_unique<Script>(std::move(sql));
+  const sql::TokenBuffer tokens(script->sql_);
+  sql::Parser parser(tokens);
+  script->parsed_ = parser.parse_sql_script();
+  // A script with syntax errors is rejected as a whole.
+  if (!script->parsed_.errors_.empty()) {
+    for (const auto& error : script->parsed_.errors_) {
+      encode_frame(connection.output_, FrameType::Error, error);
+    }
+    encode_done(connection.output_, 0);
+    return;
+  }
+  connection.script_ = std::move(script);
+}
+
+void Server::continue_script(Connection& connection) {
+  Script& script = *connection.script_;
+  std::string& out = connection.output_;
+  try {
+    if (script.result_) {
+      const auto& rows = script.result_->rows_;
+      if (script.next_row_ < rows.size()) {
+        script.next_row_ = encode_rows(out, rows, script.next_row_);
+        return;
+      }
+      encode_rows_end(out);
+      script.result_.reset();
+      ++script.executed_;
+      return;
+    }
+    const auto& statements = script.parsed_.script_.statements_;
+    if (script.next_statement_ < statements.size()) {
+      const sql::Statement& statement = *statements[script.next_statement_];
+      ++script.next_statement_;
+      exec::Result result =
+          executor_.execute(statement, connection.transaction_);
+      if (result.column_names_.empty()) {
+        encode_ok(out, result.affected_rows_);
+        ++script.executed_;
+      } else {
+        encode_columns(out, result.column_names_);
+        script.result_ = std::move(result);
+        script.next_row_ = 0;
+      }
+      return;
+    }
+  } catch (const exec::ExecutionError& e) {
+    encode_frame(out, FrameType::Error, e.what());
+  } catch (const ProtocolError& e) {
+    // A row that doesn't fit into a frame ends its result.
+    encode_frame(out, FrameType::Error, e.what());
+  } catch (const storage::StorageError& e) {
+    // The write was applied but couldn't be logged, so the catalog is
+    // ahead of what a restart recovers. run() stops the server before
+    // another statement can see the write.
+    encode_frame(out, FrameType::Error, e.what());
+    log_error_ = e.what();
+  }
+  encode_done(out, script.executed_);
+  connection.script_.reset();
+}
+
+void Server::update_events(Connection& connection) {
+  uint32_t events = 0;
+  if (!connection.closing_ && connection.pending_output() < kMaxPendingOutput) {
+    events |= EPOLLIN;
+  }
+  if (connection.pending_output() != 0) {
+    events |= EPOLLOUT;
+  }
+  if (events == connection.events_) {
+    return;
+  }
+  connection.events_ = events;
+  epoll_event event{};
+  event.events = events;
+  event.data.fd = connection.fd_;
+  epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, connection.fd_, &event);
+}
+
+void Server::close_connection(int fd) {
+  epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+  close(fd);
+  connections_.erase(fd);
+}
+
+}  // namespace rdb::net
@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <librdb/sql/IncrementalParser.hpp>
+#include <librdb/sql/Scanner.hpp>
+#include <librdb/sql/TokenBuffer.hpp>
+#include <stdexcept>
+
+namespace rdb::sql {
+
+namespace {
+
+Location advance_location(Location location, std::string_view text) {
+  for (const char c : text) {
+    ++location.offset_;
+    if (c == '\n') {
+      ++location.rows_;
+      location.cols_ = 0;
+    } else {
+      ++location.cols_;
+    }
+  }
+  return location;
+}
+
+// Converts a location inside a text that starts at `base` to a script one.
+Location to_script(const Location& base, const Location& local) {
+  return Location(
+      base.offset_ + local.offset_,
+      base.rows_ + local.rows_,
+      local.rows_ == 0 ? base.cols_ + local.cols_ : local.cols_);
+}
+
+// Splits text after every semicolon token. The last piece is the possibly
+// empty remainder that isn't terminated by a semicolon.
+std::vector<std::string_view> split_segments(std::string_view text) {
+  std::vector<std::string_view> pieces;
+  size_t piece_begin = 0;
+  size_t offset = 0;
+  while (true) {
+    const auto token =
+        scanner::scan_token(text, scanner::skip_spaces(text, offset));
+    if (token.kind_ == Token::Kind::Eof) {
+      break;
+    }
+    if (token.kind_ == Token::Kind::Semicolon) {
+      pieces.push_back(text.substr(piece_begin, token.end_ - piece_begin));
+      piece_begin = token.end_;
+    }
+    offset = token.end_;
+  }
+  pieces.push_back(text.substr(piece_begin));
+  return pieces;
+}
+
+template <typename T>
+void splice(
+    std::vector<T>& target,
+    size_t begin,
+    size_t end,
+    std::vector<T>& replacement) {
+  const auto first = target.begin() + static_cast<ptrdiff_t>(begin);
+  target.erase(first, target.begin() + static_cast<ptrdiff_t>(end));
+  target.insert(
+      target.begin() + static_cast<ptrdiff_t>(begin),
+      std::make_move_iterator(replacement.begin()),
+      std::make_move_iterator(replacement.end()));
+}
+
+}  // namespace
+
+IncrementalParser::IncrementalParser(std::string_view text) {
+  reparse(0, 0, std::string(text));
+  size_ = text.size();
+}
+
+void IncrementalParser::edit(
+    size_t offset,
+    size_t removed,
+    std::string_view inserted) {
+  if (offset > size_ || removed > size_ - offset) {
+    throw std::out_of_range("Edit is outside the script");
+  }
+  const auto segment_at = [this](size_t position) {
+    const auto it = std::upper_bound(
+        segments_.begin(),
+        segments_.end(),
+        position,
+        [](size_t value, const Segment& segment) {
+          return value < segment.begin_.offset_;
+        });
+    return static_cast<size_t>(
+        std::max(it - segments_.begin(), ptrdiff_t{1}) - 1);
+  };
+
+  size_t first = 0;
+  size_t end = 0;
+  std::string text;
+  if (!segments_.empty()) {
+    first = segment_at(offset);
+    end = (removed == 0 ? first : segment_at(offset + removed - 1)) + 1;
+    for (size_t i = first; i < end; ++i) {
+      text += *segments_[i].text_;
+    }
+    text.replace(offset - segments_[first].begin_.offset_, removed, inserted);
+  } else {
+    text = inserted;
+  }
+  reparse(first, end, std::move(text));
+  size_ = size_ - removed + inserted.size();
+}
+
+std::string IncrementalParser::text() const {
+  std::string text;
+  text.reserve(size_);
+  for (const auto& segment : segments_) {
+    text += *segment.text_;
+  }
+  return text;
+}
+
+// Replaces segments [first, end) by the segments of `text`, extending the
+// range while the new text doesn't end at a segment boundary.
+void IncrementalParser::reparse(size_t first, size_t end, std::string text) {
+  Reparsed reparsed;
+  Location begin =
+      first < segments_.size() ? segments_[first].begin_ : Location(0, 0, 0);
+  std::string pending = std::move(text);
+  while (true) {
+    auto pieces = split_segments(pending);
+    const std::string remainder(pieces.back());
+    pieces.pop_back();
+    for (const auto piece : pieces) {
+      parse_segment(std::string(piece), begin, reparsed);
+      begin = advance_location(begin, piece);
+    }
+    if (end == segments_.size()) {
+      if (!remainder.empty()) {
+        parse_segment(remainder, begin, reparsed);
+        begin = advance_location(begin, remainder);
+      }
+      break;
+    }
+    if (remainder.empty()) {
+      break;
+    }
+    pending = remainder + *segments_[end++].text_;
+  }
+  reparsed_segments_ = reparsed.segments_.size();
+
+  size_t token_begin = 0;
+  size_t statement_begin = 0;
+  size_t error_begin = 0;
+  for (size_t i = 0; i < first; ++i) {
+    token_begin += segments_[i].token_count_;
+    statement_begin += segments_[i].statement_count_;
+    error_begin += segments_[i].error_count_;
+  }
+  size_t token_end = token_begin;
+  size_t statement_end = statement_begin;
+  size_t error_end = error_begin;
+  for (size_t i = first; i < end; ++i) {
+    token_end += segments_[i].token_count_;
+    statement_end += segments_[i].statement_count_;
+    error_end += segments_[i].error_count_;
+  }
+
+  // Everything after the re-parsed range moves by the change in length;
+  // columns only change on the line where the range ends.
+  const Location old_end =
+      end < segments_.size() ? segments_[end].begin_ : begin;
+  const auto shift = [&old_end, &begin](const Location& location) {
+    return Location(
+        location.offset_ - old_end.offset_ + begin.offset_,
+        location.rows_ - old_end.rows_ + begin.rows_,
+        location.rows_ == old_end.rows_
+            ? location.cols_ - old_end.cols_ + begin.cols_
+            : location.cols_);
+  };
+  for (size_t i = end; i < segments_.size(); ++i) {
+    segments_[i].begin_ = shift(segments_[i].begin_);
+  }
+  for (size_t i = token_end; i < tokens_.size(); ++i) {
+    const Token& token = tokens_[i];
+    tokens_[i] = Token(token.kind(), token.text(), shift(token.location()));
+  }
+
+  splice(segments_, first, end, reparsed.segments_);
+  splice(tokens_, token_begin, token_end, reparsed.tokens_);
+  splice(
+      result_.script_.statements_,
+      statement_begin,
+      statement_end,
+      reparsed.result_.script_.statements_);
+  splice(result_.errors_, error_begin, error_end, reparsed.result_.errors_);
+}
+
+void IncrementalParser::parse_segment(
+    std::string text,
+    const Location& begin,
+    Reparsed& out) {
+  Segment segment{
+      std::make_unique<const std::string>(std::move(text)), begin, 0, 0, 0};
+  const TokenBuffer tokens(*segment.text_);
+  for (size_t i = 0; i + 1 < tokens.size(); ++i) {
+    out.tokens_.emplace_back(
+        tokens.kind(i), tokens.text(i), to_script(begin, tokens.location(i)));
+  }
+  segment.token_count_ = tokens.size() - 1;
+
+  Parser parser(tokens);
+  Parser::Result result = parser.parse_sql_script();
+  segment.statement_count_ = result.script_.statements_.size();
+  segment.error_count_ = result.errors_.size();
+  for (auto& statement : result.script_.statements_) {
+    out.result_.script_.statements_.push_back(std::move(statement));
+  }
+  for (auto& error : result.errors_) {
+    out.result_.errors_.push_back(std::move(error));
+  }
+  out.segments_.push_back(std::move(segment));
+}
+
+}  // namespace rdb::sql
@@ -0,0 +1,40 @@
+#include <algorithm>
+#include <cstring>
+#include <librdb/sql/NewlineIndex.hpp>
+
+namespace rdb::sql {
+
+NewlineIndex::NewlineIndex(std::string_view text) {
+  const char* const begin = text.data();
+  const char* const end = begin + text.size();
+  for (const char* it = begin; it != end;) {
+    const auto* newline = static_cast<const char*>(
+        std::memchr(it, '\n', static_cast<size_t>(end - it)));
+    if (newline == nullptr) {
+      break;
+    }
+    newlines_.push_back(static_cast<size_t>(newline - begin));
+    it = newline + 1;
+  }
+}
+
+Location NewlineIndex::locate(size_t offset) const {
+  const auto row =
+      std::lower_bound(newlines_.begin(), newlines_.end(), offset) -
+      newlines_.begin();
+  return location(offset, static_cast<size_t>(row));
+}
+
+Location NewlineIndex::locate(size_t offset, size_t& row) const {
+  while (row < newlines_.size() && newlines_[row] < offset) {
+    ++row;
+  }
+  return location(offset, row);
+}
+
+Location NewlineIndex::location(size_t offset, size_t row) const {
+  const size_t line_begin = row == 0 ? 0 : newlines_[row - 1] + 1;
+  return Location(offset, row, offset - line_begin);
+}
+
+}  // namespace rdb::sql
@@ -1,4 +1,6 @@
+#include <array>
 #include <charconv>
+#include <librdb/metrics/Metrics.hpp>
 #include <librdb/sql/Parser.hpp>
 #include <sstream>
 
@@ -11,28 +13,222 @@ class SyntaxError : public std::runtime_error {
   using std::runtime_error::runtime_error;
 };
 
+struct ParserMetrics {
+  std::array<metrics::Counter*, Statement::kKindCount> statements_;
+  // Indexed by statement kind; the last counter is for statements that don't
+  // start with a known keyword.
+  std::array<metrics::Counter*, Statement::kKindCount + 1> errors_;
+};
+
+const ParserMetrics& parser_metrics() {
+  static const ParserMetrics parser_metrics = [] {
+    auto& registry = metrics::Registry::global();
+    ParserMetrics result{};
+    for (size_t i = 0; i <= Statement::kKindCount; ++i) {
+      const std::string kind =
+          i == Statement::kKindCount
+          ? "unknown"
+          : std::string(statement_kind_to_str(Statement::Kind(i)));
+      if (i != Statement::kKindCount) {
+        result.statements_[i] = &registry.counter(
+            "rdb_parser_statements_total",
+            "Statements parsed successfully.",
+            {{"statement", kind}});
+      }
+      result.errors_[i] = &registry.counter(
+          "rdb_parser_errors_total",
+          "Statements rejected with a syntax error.",
+          {{"statement", kind}});
+    }
+    return result;
+  }();
+  return parser_metrics;
+}
+
+size_t error_metric_index(Token::Kind first_token) {
+  switch (first_token) {
+    case Token::Kind::KwDrop:
+      return size_t(Statement::Kind::DropTable);
+    case Token::Kind::KwInsert:
+      return size_t(Statement::Kind::Insert);
+    case Token::Kind::KwSelect:
+      return size_t(Statement::Kind::Select);
+    case Token::Kind::KwDelete:
+      return size_t(Statement::Kind::Delete);
+    case Token::Kind::KwCreate:
+      return size_t(Statement::Kind::CreateTable);
+    case Token::Kind::KwExplain:
+      return size_t(Statement::Kind::Explain);
+    case Token::Kind::KwBegin:
+      return size_t(Statement::Kind::Begin);
+    case Token::Kind::KwCommit:
+      return size_t(Statement::Kind::Commit);
+    case Token::Kind::KwRollback:
+      return size_t(Statement::Kind::Rollback);
+    case Token::Kind::KwAnalyze:
+      return size_t(Statement::Kind::Analyze);
+    default:
+      return Statement::kKindCount;
+  }
+}
+
+Operand number_operand(Token::Kind kind, std::string_view text) {
+  if (kind == Token::Kind::Int) {
+    constexpr int BITNESS = 10;
+    const auto value =
+        static_cast<int>(std::strtol(text.data(), nullptr, BITNESS));
+    return Operand(Operand::Kind::Int, value);
+  }
+  const auto value = static_cast<float>(std::strtod(text.data(), nullptr));
+  return Operand(Operand::Kind::Real, value);
+}
+
+// Conditions can't be used as numbers.
+void require_value(const Expression& expression) {
+  if (expression.is_condition()) {
+    throw SyntaxError("Expected a value, got a condition");
+  }
+}
+
+Expression arithmetic(
+    Expression::Kind kind,
+    Expression first,
+    Expression second) {
+  require_value(first);
+  require_value(second);
+  return Expression(kind, {std::move(first), std::move(second)});
+}
+
+size_t expression_bytes(const Expression& expression) {
+  size_t bytes = expression.operands_.capacity() * sizeof(Expression);
+  for (const auto& operand : expression.operands_) {
+    bytes += expression_bytes(operand);
+  }
+  return bytes;
+}
+
+size_t expression_bytes(const std::optional<Expression>& expression) {
+  return expression ? expression_bytes(*expression) : 0;
+}
+
+// Heap memory of a parsed statement: the object and what its vectors hold.
+class StatementBytes : public StatementVisitor {
+ public:
+  size_t bytes() const { return bytes_; }
+
+  void visit(const DropTableStatement& /*statement*/) override {
+    bytes_ += sizeof(DropTableStatement);
+  }
+
+  void visit(const InsertStatement& statement) override {
+    bytes_ += sizeof(InsertStatement) +
+              statement.column_names().capacity() * sizeof(std::string_view) +
+              statement.values().capacity() * sizeof(Value);
+  }
+
+  void visit(const SelectStatement& statement) override {
+    bytes_ += sizeof(SelectStatement) +
+              statement.column_list().capacity() * sizeof(std::string_view) +
+              statement.aggregates().capacity() *
+                  sizeof(SelectStatement::Aggregate) +
+              statement.group_by().capacity() * sizeof(std::string_view) +
+              expression_bytes(statement.expression());
+  }
+
+  void visit(const DeleteStatement& statement) override {
+    bytes_ +=
+        sizeof(DeleteStatement) + expression_bytes(statement.expression());
+  }
+
+  void visit(const CreateTableStatement& statement) override {
+    bytes_ += sizeof(CreateTableStatement) +
+              statement.column_defs().capacity() * sizeof(ColumnDef);
+  }
+
+  void visit(const ExplainStatement& statement) override {
+    bytes_ += sizeof(ExplainStatement);
+    statement.statement().accept(*this);
+  }
+
+  void visit(const TransactionStatement& /*statement*/) override {
+    bytes_ += sizeof(TransactionStatement);
+  }
+
+  void visit(const AnalyzeStatement& /*statement*/) override {
+    bytes_ += sizeof(AnalyzeStatement);
+  }
+
+ private:
+  size_t bytes_ = 0;
+};
+
 }  // namespace
 
 Parser::Result Parser::parse_sql_script() {
   Parser::Result result;
-  while (true) {
-    const Token next_token = lexer_.peek();
-    if (next_token.kind() == Token::Kind::Eof) {
-      break;
-    }
-    try {
-      result.script_.statements_.push_back(parse_sql_statement());
-    } catch (const SyntaxError& e) {
-      result.errors_.emplace_back(e.what());
-      panic();
+  result.memory_ = memory::Reservation(memory::MemoryTracker::current());
+  while (parse_next_statement(result)) {
+  }
+  return result;
+}
+
+bool Parser::parse_next_statement(Result& result) {
+  const ParserMetrics& metrics = parser_metrics();
+  const Token::Kind next_kind = peek_kind();
+  if (next_kind == Token::Kind::Eof) {
+    return false;
+  }
+  try {
+    StatementPtr statement = parse_sql_statement();
+    StatementBytes statement_bytes;
+    statement->accept(statement_bytes);
+    result.memory_.add(statement_bytes.bytes() + sizeof(StatementPtr));
+    result.script_.statements_.push_back(std::move(statement));
+    metrics.statements_[size_t(result.script_.statements_.back()->kind())]
+        ->add();
+  } catch (const memory::MemoryLimitError& e) {
+    result.errors_.emplace_back(e.what());
+    metrics.errors_[error_metric_index(next_kind)]->add();
+  } catch (const SyntaxError& e) {
+    result.errors_.emplace_back(e.what());
+    metrics.errors_[error_metric_index(next_kind)]->add();
+    panic();
+  }
+  return true;
+}
+
+Parser::Result Parser::parse_prepared_statement() {
+  const ParserMetrics& metrics = parser_metrics();
+  Parser::Result result;
+  result.memory_ = memory::Reservation(memory::MemoryTracker::current());
+  const Token::Kind first_kind = peek_kind();
+  placeholders_allowed_ = true;
+  placeholder_count_ = 0;
+  try {
+    StatementPtr statement = parse_sql_statement();
+    if (peek_kind() != Token::Kind::Eof) {
+      throw SyntaxError(
+          "Expected Eof, got " + std::string(kind_to_str(peek_kind())));
     }
+    StatementBytes statement_bytes;
+    statement->accept(statement_bytes);
+    result.memory_.add(statement_bytes.bytes() + sizeof(StatementPtr));
+    result.script_.statements_.push_back(std::move(statement));
+    metrics.statements_[size_t(result.script_.statements_.back()->kind())]
+        ->add();
+  } catch (const memory::MemoryLimitError& e) {
+    result.errors_.emplace_back(e.what());
+    metrics.errors_[error_metric_index(first_kind)]->add();
+  } catch (const SyntaxError& e) {
+    result.errors_.emplace_back(e.what());
+    metrics.errors_[error_metric_index(first_kind)]->add();
   }
+  placeholders_allowed_ = false;
   return result;
 }
 
 StatementPtr Parser::parse_sql_statement() {
-  const Token token = lexer_.peek();
-  const Token::Kind kind = token.kind();
+  const Token::Kind kind = peek_kind();
   if (kind == Token::Kind::KwDrop) {
     return parse_drop_table_statement();
   }
@@ -48,28 +244,38 @@ StatementPtr Parser::parse_sql_statement() {
   if (kind == Token::Kind::KwCreate) {
     return parse_create_table_statement();
   }
+  if (kind == Token::Kind::KwExplain) {
+    return parse_explain_statement();
+  }
+  if (kind == Token::Kind::KwBegin || kind == Token::Kind::KwCommit ||
+      kind == Token::Kind::KwRollback) {
+    return parse_transaction_statement();
+  }
+  if (kind == Token::Kind::KwAnalyze) {
+    return parse_analyze_statement();
+  }
   throw SyntaxError("Expected statement type");
 }
 
 DropTableStatementPtr Parser::parse_drop_table_statement() {
   fetch_token(Token::Kind::KwDrop);
   fetch_token(Token::Kind::KwTable);
-  const Token table_name = fetch_token(Token::Kind::Id);
+  const std::string_view table_name = fetch_token(Token::Kind::Id);
   fetch_token(Token::Kind::Semicolon);
-  return std::make_unique<const DropTableStatement>(table_name.text());
+  return std::make_unique<const DropTableStatement>(table_name);
 }
 
 InsertStatementPtr Parser::parse_insert_statement() {
   fetch_token(Token::Kind::KwInsert);
   fetch_token(Token::Kind::KwInto);
-  const Token table_name = fetch_token(Token::Kind::Id);
+  const std::string_view table_name = fetch_token(Token::Kind::Id);
 
   fetch_token(Token::Kind::LBracket);
   std::vector<std::string_view> column_names;
-  column_names.push_back(fetch_token(Token::Kind::Id).text());
-  while (lexer_.peek().kind() == Token::Kind::Comma) {
+  column_names.push_back(fetch_token(Token::Kind::Id));
+  while (peek_kind() == Token::Kind::Comma) {
     fetch_token(Token::Kind::Comma);
-    column_names.push_back(fetch_token(Token::Kind::Id).text());
+    column_names.push_back(fetch_token(Token::Kind::Id));
   }
   fetch_token(Token::Kind::RBracket);
   fetch_token(Token::Kind::KwValues);
@@ -79,7 +285,7 @@ InsertStatementPtr Parser::parse_insert_statement() {
   const Value first_value = parse_value();
   values.push_back(first_value);
 
-  while (lexer_.peek().kind() == Token::Kind::Comma) {
+  while (peek_kind() == Token::Kind::Comma) {
     fetch_token(Token::Kind::Comma);
     const Value next_value = parse_value();
     values.push_back(next_value);
@@ -88,63 +294,148 @@ InsertStatementPtr Parser::parse_insert_statement() {
   fetch_token(Token::Kind::RBracket);
   fetch_token(Token::Kind::Semicolon);
   return std::make_unique<const InsertStatement>(
-      table_name.text(), column_names, values);
+      table_name, column_names, values);
 }
 
 SelectStatementPtr Parser::parse_select_statement() {
   fetch_token(Token::Kind::KwSelect);
 
   std::vector<std::string_view> column_list;
-  column_list.push_back(fetch_token(Token::Kind::Id).text());
-  while (lexer_.peek().kind() == Token::Kind::Id) {
-    column_list.push_back(fetch_token(Token::Kind::Id).text());
+  std::vector<SelectStatement::Aggregate> aggregates;
+  parse_select_item(column_list, aggregates);
+  while (peek_kind() != Token::Kind::KwFrom &&
+         peek_kind() != Token::Kind::Eof &&
+         peek_kind() != Token::Kind::Semicolon) {
+    parse_select_item(column_list, aggregates);
   }
 
   fetch_token(Token::Kind::KwFrom);
-  const Token table_name = fetch_token(Token::Kind::Id);
+  const std::string_view table_name = fetch_token(Token::Kind::Id);
+
+  std::optional<Join> join;
+  if (peek_kind() == Token::Kind::KwJoin) {
+    fetch_token(Token::Kind::KwJoin);
+    const std::string_view join_table_name = fetch_token(Token::Kind::Id);
+    fetch_token(Token::Kind::KwOn);
+    const std::string_view left_column = fetch_token(Token::Kind::Id);
+    fetch_token(Token::Kind::OpEqual);
+    const std::string_view right_column = fetch_token(Token::Kind::Id);
+    join.emplace(join_table_name, left_column, right_column);
+  }
 
-  if (lexer_.peek().kind() != Token::Kind::KwWhere) {
-    fetch_token(Token::Kind::Semicolon);
-    return std::make_unique<const SelectStatement>(
-        column_list, table_name.text());
+  std::optional<Expression> expression;
+  if (peek_kind() == Token::Kind::KwWhere) {
+    fetch_token(Token::Kind::KwWhere);
+    expression = parse_condition();
   }
 
-  fetch_token(Token::Kind::KwWhere);
-  const Expression expression = parse_expression();
+  std::vector<std::string_view> group_by;
+  if (peek_kind() == Token::Kind::KwGroup) {
+    fetch_token(Token::Kind::KwGroup);
+    fetch_token(Token::Kind::KwBy);
+    group_by.push_back(fetch_token(Token::Kind::Id));
+    while (peek_kind() == Token::Kind::Id) {
+      group_by.push_back(fetch_token(Token::Kind::Id));
+    }
+  }
+
+  std::optional<SelectStatement::OrderBy> order_by;
+  if (peek_kind() == Token::Kind::KwOrder) {
+    fetch_token(Token::Kind::KwOrder);
+    fetch_token(Token::Kind::KwBy);
+    std::vector<std::string_view> order_column;
+    std::vector<SelectStatement::Aggregate> order_aggregate;
+    parse_select_item(order_column, order_aggregate);
+    bool descending = false;
+    if (peek_kind() == Token::Kind::KwAsc) {
+      fetch_token(Token::Kind::KwAsc);
+    } else if (peek_kind() == Token::Kind::KwDesc) {
+      fetch_token(Token::Kind::KwDesc);
+      descending = true;
+    }
+    order_by.emplace(order_aggregate.front(), order_column.front(), descending);
+  }
+
+  std::optional<size_t> limit;
+  if (peek_kind() == Token::Kind::KwLimit) {
+    fetch_token(Token::Kind::KwLimit);
+    const std::string_view text = fetch_token(Token::Kind::Int);
+    if (text.front() == '-') {
+      throw SyntaxError("LIMIT must not be negative");
+    }
+    constexpr int BITNESS = 10;
+    limit = size_t(std::strtoull(text.data(), nullptr, BITNESS));
+  }
   fetch_token(Token::Kind::Semicolon);
 
   return std::make_unique<const SelectStatement>(
-      column_list, table_name.text(), expression);
+      column_list,
+      table_name,
+      std::move(expression),
+      std::move(aggregates),
+      std::move(group_by),
+      join,
+      order_by,
+      limit);
+}
+
+void Parser::parse_select_item(
+    std::vector<std::string_view>& column_list,
+    std::vector<SelectStatement::Aggregate>& aggregates) {
+  static const std::unordered_map<Token::Kind, SelectStatement::Aggregate>
+      token_to_aggregate = {
+          {Token::Kind::KwCount, SelectStatement::Aggregate::Count},
+          {Token::Kind::KwSum, SelectStatement::Aggregate::Sum},
+          {Token::Kind::KwMin, SelectStatement::Aggregate::Min},
+          {Token::Kind::KwMax, SelectStatement::Aggregate::Max},
+          {Token::Kind::KwAvg, SelectStatement::Aggregate::Avg}};
+
+  const auto it = token_to_aggregate.find(peek_kind());
+  if (it == token_to_aggregate.end()) {
+    column_list.push_back(fetch_token(Token::Kind::Id));
+    aggregates.push_back(SelectStatement::Aggregate::None);
+    return;
+  }
+  fetch_token(it->first);
+  fetch_token(Token::Kind::LBracket);
+  if (it->second == SelectStatement::Aggregate::Count &&
+      peek_kind() == Token::Kind::OpMultiply) {
+    column_list.push_back(fetch_token(Token::Kind::OpMultiply));
+  } else {
+    column_list.push_back(fetch_token(Token::Kind::Id));
+  }
+  aggregates.push_back(it->second);
+  fetch_token(Token::Kind::RBracket);
 }
 
 DeleteStatementPtr Parser::parse_delete_statement() {
   fetch_token(Token::Kind::KwDelete);
   fetch_token(Token::Kind::KwFrom);
-  const Token table_name = fetch_token(Token::Kind::Id);
+  const std::string_view table_name = fetch_token(Token::Kind::Id);
 
-  if (lexer_.peek().kind() != Token::Kind::KwWhere) {
+  if (peek_kind() != Token::Kind::KwWhere) {
     fetch_token(Token::Kind::Semicolon);
-    return std::make_unique<const DeleteStatement>(table_name.text());
+    return std::make_unique<const DeleteStatement>(table_name);
   }
 
   fetch_token(Token::Kind::KwWhere);
-  const Expression expression = parse_expression();
+  const Expression expression = parse_condition();
   fetch_token(Token::Kind::Semicolon);
 
-  return std::make_unique<const DeleteStatement>(table_name.text(), expression);
+  return std::make_unique<const DeleteStatement>(table_name, expression);
 }
 
 CreateTableStatementPtr Parser::parse_create_table_statement() {
   fetch_token(Token::Kind::KwCreate);
   fetch_token(Token::Kind::KwTable);
-  const Token table_name = fetch_token(Token::Kind::Id);
+  const std::string_view table_name = fetch_token(Token::Kind::Id);
 
   fetch_token(Token::Kind::LBracket);
   std::vector<ColumnDef> column_defs;
   const ColumnDef first_column_def = parse_column_def();
   column_defs.push_back(first_column_def);
 
-  while (lexer_.peek().kind() == Token::Kind::Comma) {
+  while (peek_kind() == Token::Kind::Comma) {
     fetch_token(Token::Kind::Comma);
     const ColumnDef next_column_def = parse_column_def();
     column_defs.push_back(next_column_def);
@@ -154,118 +445,298 @@ CreateTableStatementPtr Parser::parse_create_table_statement() {
   fetch_token(Token::Kind::Semicolon);
 
   return std::make_unique<const CreateTableStatement>(
-      table_name.text(), column_defs);
+      table_name, column_defs);
+}
+
+ExplainStatementPtr Parser::parse_explain_statement() {
+  fetch_token(Token::Kind::KwExplain);
+  const bool analyze = peek_kind() == Token::Kind::KwAnalyze;
+  if (analyze) {
+    fetch_token(Token::Kind::KwAnalyze);
+  }
+  const Token::Kind kind = peek_kind();
+  if (kind == Token::Kind::KwExplain || kind == Token::Kind::KwBegin ||
+      kind == Token::Kind::KwCommit || kind == Token::Kind::KwRollback ||
+      kind == Token::Kind::KwAnalyze) {
+    throw SyntaxError("Expected statement type");
+  }
+  return std::make_unique<const ExplainStatement>(
+      parse_sql_statement(), analyze);
+}
+
+TransactionStatementPtr Parser::parse_transaction_statement() {
+  const Token::Kind kind = peek_kind();
+  fetch_token(kind);
+  fetch_token(Token::Kind::Semicolon);
+  switch (kind) {
+    case Token::Kind::KwBegin:
+      return std::make_unique<const TransactionStatement>(
+          Statement::Kind::Begin);
+    case Token::Kind::KwCommit:
+      return std::make_unique<const TransactionStatement>(
+          Statement::Kind::Commit);
+    default:
+      return std::make_unique<const TransactionStatement>(
+          Statement::Kind::Rollback);
+  }
+}
+
+AnalyzeStatementPtr Parser::parse_analyze_statement() {
+  fetch_token(Token::Kind::KwAnalyze);
+  const std::string_view table_name = fetch_token(Token::Kind::Id);
+  fetch_token(Token::Kind::Semicolon);
+  return std::make_unique<const AnalyzeStatement>(table_name);
 }
 
 Value Parser::parse_value() {
-  const Token token = lexer_.peek();
-  if (token.kind() == Token::Kind::Int) {
-    fetch_token(Token::Kind::Int);
+  const Token::Kind kind = peek_kind();
+  if (kind == Token::Kind::Int) {
+    const std::string_view text = fetch_token(Token::Kind::Int);
     constexpr int BITNESS = 10;
-    return int(std::strtol(token.text().data(), nullptr, BITNESS));
+    return int(std::strtol(text.data(), nullptr, BITNESS));
+  }
+  if (kind == Token::Kind::Real) {
+    const std::string_view text = fetch_token(Token::Kind::Real);
+    return float(std::strtod(text.data(), nullptr));
   }
-  if (token.kind() == Token::Kind::Real) {
-    fetch_token(Token::Kind::Real);
-    return float(std::strtod(token.text().data(), nullptr));
+  if (kind == Token::Kind::String) {
+    const std::string_view text = fetch_token(Token::Kind::String);
+    return text;
   }
-  if (token.kind() == Token::Kind::String) {
-    fetch_token(Token::Kind::String);
-    return token.text();
+  if (kind == Token::Kind::Placeholder) {
+    return parse_placeholder();
   }
   throw SyntaxError("Expected Int, Real or String");
 }
 
 Operand Parser::parse_operand() {
-  const Token token = lexer_.peek();
-  if (token.kind() == Token::Kind::Int) {
-    fetch_token(Token::Kind::Int);
-    constexpr int BITNESS = 10;
-    const auto value = static_cast<int>(std::strtol(token.text().data(), nullptr, BITNESS));
-    return Operand(Operand::Kind::Int, value);
-  }
-  if (token.kind() == Token::Kind::Real) {
-    fetch_token(Token::Kind::Real);
-    const auto value = static_cast<float>(std::strtod(token.text().data(), nullptr));
-    return Operand(Operand::Kind::Real, value);
+  const Token::Kind kind = peek_kind();
+  if (kind == Token::Kind::Int || kind == Token::Kind::Real) {
+    const Operand operand = number_operand(kind, peek_text());
+    skip_token();
+    return operand;
   }
-  if (token.kind() == Token::Kind::String) {
-    fetch_token(Token::Kind::String);
-    const std::string_view value = token.text();
+  if (kind == Token::Kind::String) {
+    const std::string_view text = fetch_token(Token::Kind::String);
+    const std::string_view value = text;
     return Operand(Operand::Kind::Text, value);
   }
 
-  if (token.kind() == Token::Kind::Id) {
-    fetch_token(Token::Kind::Id);
-    const std::string_view value = token.text();
+  if (kind == Token::Kind::Id) {
+    const std::string_view text = fetch_token(Token::Kind::Id);
+    const std::string_view value = text;
     return Operand(Operand::Kind::Id, value);
   }
 
+  if (kind == Token::Kind::Placeholder) {
+    return Operand(Operand::Kind::Placeholder, parse_placeholder());
+  }
+
   throw SyntaxError("Expected Int, Real, String or Id");
 }
 
+Placeholder Parser::parse_placeholder() {
+  fetch_token(Token::Kind::Placeholder);
+  if (!placeholders_allowed_) {
+    throw SyntaxError("Placeholders are only allowed in prepared statements");
+  }
+  return Placeholder{placeholder_count_++};
+}
+
+Expression Parser::parse_condition() {
+  Expression condition = parse_expression();
+  require_condition(condition);
+  return condition;
+}
+
 Expression Parser::parse_expression() {
-  const Operand first_operand = parse_operand();
-
-  const Token token = lexer_.peek();
-  static const std::unordered_map<Token::Kind, Expression::Operation> operation_to_kind = {
-      {Token::Kind::OpLess, Expression::Operation::Less},
-      {Token::Kind::OpGreater, Expression::Operation::Greater},
-      {Token::Kind::OpLessEq, Expression::Operation::LessEq},
-      {Token::Kind::OpGreaterEq, Expression::Operation::GreaterEq},
-      {Token::Kind::OpEqual, Expression::Operation::Equal},
-      {Token::Kind::OpNotEqual, Expression::Operation::NotEqual}};      
-      
-  auto it = operation_to_kind.find(token.kind());
+  Expression expression = parse_conjunction();
+  while (peek_kind() == Token::Kind::KwOr) {
+    require_condition(expression);
+    skip_token();
+    Expression second_operand = parse_conjunction();
+    require_condition(second_operand);
+    expression = Expression(
+        Expression::Kind::Or,
+        {std::move(expression), std::move(second_operand)});
+  }
+  return expression;
+}
+
+Expression Parser::parse_conjunction() {
+  Expression expression = parse_negation();
+  while (peek_kind() == Token::Kind::KwAnd) {
+    require_condition(expression);
+    skip_token();
+    Expression second_operand = parse_negation();
+    require_condition(second_operand);
+    expression = Expression(
+        Expression::Kind::And,
+        {std::move(expression), std::move(second_operand)});
+  }
+  return expression;
+}
+
+Expression Parser::parse_negation() {
+  if (peek_kind() != Token::Kind::KwNot) {
+    return parse_comparison();
+  }
+  skip_token();
+  Expression operand = parse_negation();
+  require_condition(operand);
+  return Expression(Expression::Kind::Not, {std::move(operand)});
+}
+
+Expression Parser::parse_comparison() {
+  Expression first_operand = parse_sum();
+
+  const Token::Kind kind = peek_kind();
+  static const std::unordered_map<Token::Kind, Expression::Operation>
+      operation_to_kind = {
+          {Token::Kind::OpLess, Expression::Operation::Less},
+          {Token::Kind::OpGreater, Expression::Operation::Greater},
+          {Token::Kind::OpLessEq, Expression::Operation::LessEq},
+          {Token::Kind::OpGreaterEq, Expression::Operation::GreaterEq},
+          {Token::Kind::OpEqual, Expression::Operation::Equal},
+          {Token::Kind::OpNotEqual, Expression::Operation::NotEqual}};
+
+  auto it = operation_to_kind.find(kind);
   if (it == (operation_to_kind.end())) {
-    throw SyntaxError(
-        "Expected OperationType, got " +
-        std::string(kind_to_str(token.kind())));
+    return first_operand;
   }
   fetch_token(it->first);
 
-  const Operand second_operand = parse_operand();
-  return Expression(first_operand, it->second, second_operand);
+  Expression second_operand = parse_sum();
+  require_value(first_operand);
+  require_value(second_operand);
+  return Expression(
+      std::move(first_operand), it->second, std::move(second_operand));
+}
+
+Expression Parser::parse_sum() {
+  Expression sum = parse_product(parse_factor());
+  while (true) {
+    const Token::Kind kind = peek_kind();
+    if (kind == Token::Kind::OpPlus || kind == Token::Kind::OpMinus) {
+      skip_token();
+      sum = arithmetic(
+          kind == Token::Kind::OpPlus ? Expression::Kind::Add
+                                      : Expression::Kind::Subtract,
+          std::move(sum),
+          parse_product(parse_factor()));
+    } else if (
+        (kind == Token::Kind::Int || kind == Token::Kind::Real) &&
+        (peek_text().front() == '+' || peek_text().front() == '-')) {
+      // `a -1` is lexed as `a` and `-1`: the sign is the operator.
+      const std::string_view text = peek_text();
+      Expression literal(number_operand(kind, text.substr(1)));
+      skip_token();
+      sum = arithmetic(
+          text.front() == '+' ? Expression::Kind::Add
+                              : Expression::Kind::Subtract,
+          std::move(sum),
+          parse_product(std::move(literal)));
+    } else {
+      return sum;
+    }
+  }
+}
+
+Expression Parser::parse_product(Expression first) {
+  Expression product = std::move(first);
+  while (true) {
+    const Token::Kind kind = peek_kind();
+    if (kind != Token::Kind::OpMultiply && kind != Token::Kind::OpDivide) {
+      return product;
+    }
+    skip_token();
+    product = arithmetic(
+        kind == Token::Kind::OpMultiply ? Expression::Kind::Multiply
+                                        : Expression::Kind::Divide,
+        std::move(product),
+        parse_factor());
+  }
+}
+
+Expression Parser::parse_factor() {
+  if (peek_kind() != Token::Kind::LBracket) {
+    return parse_operand();
+  }
+  fetch_token(Token::Kind::LBracket);
+  Expression expression = parse_expression();
+  fetch_token(Token::Kind::RBracket);
+  return expression;
 }
 
 ColumnDef Parser::parse_column_def() {
 
-  const Token name = fetch_token(Token::Kind::Id);
-  const Token token = lexer_.peek();
+  const std::string_view name = fetch_token(Token::Kind::Id);
+  const Token::Kind kind = peek_kind();
   static const std::unordered_map<Token::Kind, ColumnDef::Kind> token_to_kind = {
       {Token::Kind::KwInt, ColumnDef::Kind::Int},
       {Token::Kind::KwReal, ColumnDef::Kind::Real},
       {Token::Kind::KwText, ColumnDef::Kind::Text}};      
 
-  auto it = token_to_kind.find(token.kind());
+  auto it = token_to_kind.find(kind);
   if (it == (token_to_kind.end())) {
     throw SyntaxError(
         "Expected INT, REAL or TEXT, got " +
-        std::string(kind_to_str(token.kind())));
+        std::string(kind_to_str(kind)));
   }
 
   fetch_token(it->first);
-  return ColumnDef(name.text(), it->second);
+  return ColumnDef(name, it->second);
+}
+
+// A value where a condition is expected is missing its comparison, which
+// would have come next.
+void Parser::require_condition(const Expression& expression) {
+  if (!expression.is_condition()) {
+    throw SyntaxError(
+        "Expected OperationType, got " +
+        std::string(kind_to_str(peek_kind())));
+  }
 }
 
 void Parser::panic() {
   while (true) {
-    const Token preview = lexer_.get();
-    if ((preview.kind() == Token::Kind::Eof) ||
-        (preview.kind() == Token::Kind::Semicolon)) {
+    const Token::Kind kind = peek_kind();
+    if (kind == Token::Kind::Eof) {
+      break;
+    }
+    skip_token();
+    if (kind == Token::Kind::Semicolon) {
       break;
     }
   }
 }
 
-Token Parser::fetch_token(Token::Kind expected_kind) {
-  const Token token = lexer_.peek();
-  if (token.kind() != expected_kind) {
+Token::Kind Parser::peek_kind() {
+  return cursor_ ? cursor_->kind() : lexer_->peek().kind();
+}
+
+std::string_view Parser::peek_text() {
+  return cursor_ ? cursor_->text() : lexer_->peek().text();
+}
+
+void Parser::skip_token() {
+  if (cursor_) {
+    cursor_->advance();
+  } else {
+    lexer_->get();
+  }
+}
+
+std::string_view Parser::fetch_token(Token::Kind expected_kind) {
+  const Token::Kind kind = peek_kind();
+  if (kind != expected_kind) {
     throw SyntaxError(
         "Expected " + std::string(kind_to_str(expected_kind)) + ", got " +
-        std::string(kind_to_str(token.kind())));
+        std::string(kind_to_str(kind)));
   }
-  return lexer_.get();
+  const std::string_view text = peek_text();
+  skip_token();
+  return text;
 }
 
 }  // namespace rdb::sql
-
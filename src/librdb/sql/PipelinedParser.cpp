@@ -0,0 +1,87 @@
+#include <librdb/memory/MemoryTracker.hpp>
+#include <librdb/sql/Lexer.hpp>
+#include <librdb/sql/PipelinedParser.hpp>
+#include <utility>
+
+namespace rdb::sql {
+
+PipelinedParser::PipelinedParser(std::string_view sql, size_t queue_capacity)
+    : queue_(queue_capacity) {
+  memory::MemoryTracker& tracker = memory::MemoryTracker::current();
+  thread_ = std::thread([this, sql, &tracker] { run(sql, tracker); });
+}
+
+PipelinedParser::~PipelinedParser() {
+  stop_.store(true);
+  notify();
+  thread_.join();
+}
+
+std::optional<Parser::Result> PipelinedParser::next() {
+  while (true) {
+    // The end is checked before the queue: the parser pushes everything
+    // before it sets it.
+    const bool finished = finished_.load(std::memory_order_acquire);
+    if (std::optional<Parser::Result> result = queue_.try_pop()) {
+      notify();
+      return result;
+    }
+    if (finished) {
+      return std::nullopt;
+    }
+    wait([this] {
+      return !queue_.empty() || finished_.load(std::memory_order_acquire);
+    });
+  }
+}
+
+void PipelinedParser::run(
+    std::string_view sql,
+    memory::MemoryTracker& tracker) {
+  const memory::MemoryScope scope(tracker);
+  Lexer lexer(sql);
+  Parser parser(lexer);
+  while (!stop_.load()) {
+    Parser::Result result;
+    result.memory_ = memory::Reservation(tracker);
+    if (!parser.parse_next_statement(result)) {
+      break;
+    }
+    while (!queue_.try_push(std::move(result))) {
+      wait([this] {
+        return queue_.size() < queue_.capacity() || stop_.load();
+      });
+      if (stop_.load()) {
+        return;
+      }
+    }
+    notify();
+  }
+  finished_.store(true, std::memory_order_release);
+  notify();
+}
+
+template <typename Ready>
+void PipelinedParser::wait(Ready ready) {
+  std::unique_lock lock(mutex_);
+  waiting_.fetch_add(1, std::memory_order_relaxed);
+  // Pairs with the fence in notify(): either this thread sees the change in
+  // ready(), or the one that made it sees it waiting.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  changed_.wait(lock, ready);
+  waiting_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void PipelinedParser::notify() {
+  // The queue and the flags are published with release stores, which a
+  // later load may pass without the fence.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (waiting_.load(std::memory_order_relaxed) == 0) {
+    return;
+  }
+  // Taking the lock orders the change before a waiter's check of it.
+  { const std::lock_guard lock(mutex_); }
+  changed_.notify_all();
+}
+
+}  // namespace rdb::sql
@@ -0,0 +1,209 @@
+#include <array>
+#include <charconv>
+#include <librdb/sql/StatementPrinter.hpp>
+
+namespace rdb::sql {
+
+namespace {
+
+// Enough for any int, size_t and "%f" of any float: FLT_MAX has 39 integer
+// digits.
+constexpr size_t kNumberChars = 64;
+
+template <typename T, typename... Format>
+void print_number(T value, std::string& out, Format... format) {
+  std::array<char, kNumberChars> chars{};
+  const auto result = std::to_chars(
+      chars.data(), chars.data() + chars.size(), value, format...);
+  out.append(chars.data(), result.ptr);
+}
+
+void print_operand(
+    const Expression& operand,
+    int min_precedence,
+    std::string& out) {
+  if (precedence(operand.kind_) < min_precedence) {
+    out += '(';
+    print_expression(operand, out);
+    out += ')';
+    return;
+  }
+  print_expression(operand, out);
+}
+
+void print_select_item(
+    SelectStatement::Aggregate aggregate,
+    std::string_view column,
+    std::string& out) {
+  if (aggregate == SelectStatement::Aggregate::None) {
+    out += column;
+    return;
+  }
+  out += aggregate_to_str(aggregate);
+  out += '(';
+  out += column;
+  out += ')';
+}
+
+class StatementPrinter : public StatementVisitor {
+ public:
+  explicit StatementPrinter(std::string& out) : out_(out) {}
+
+  void visit(const DropTableStatement& statement) override {
+    out_ += "DROP TABLE ";
+    out_ += statement.table_name();
+    out_ += ';';
+  }
+
+  void visit(const InsertStatement& statement) override {
+    out_ += "INSERT INTO ";
+    out_ += statement.table_name();
+    out_ += " ( ";
+    for (const auto column_name : statement.column_names()) {
+      out_ += column_name;
+      out_ += ' ';
+    }
+    out_ += ") VALUES ( ";
+    for (const auto& value : statement.values()) {
+      print_value(value, out_);
+      out_ += ' ';
+    }
+    out_ += ");";
+  }
+
+  void visit(const SelectStatement& statement) override {
+    out_ += "SELECT ";
+    for (size_t i = 0; i < statement.column_list().size(); ++i) {
+      print_select_item(
+          statement.aggregates()[i], statement.column_list()[i], out_);
+      out_ += ' ';
+    }
+    out_ += "FROM ";
+    out_ += statement.table_name();
+    if (const auto& join = statement.join()) {
+      out_ += " JOIN ";
+      out_ += join->table_name_;
+      out_ += " ON ";
+      out_ += join->left_column_;
+      out_ += " = ";
+      out_ += join->right_column_;
+    }
+    print_where(statement.expression());
+    if (!statement.group_by().empty()) {
+      out_ += " GROUP BY";
+      for (const auto column : statement.group_by()) {
+        out_ += ' ';
+        out_ += column;
+      }
+    }
+    if (const auto& order_by = statement.order_by()) {
+      out_ += " ORDER BY ";
+      print_select_item(order_by->aggregate_, order_by->column_, out_);
+      out_ += order_by->descending_ ? " DESC" : " ASC";
+    }
+    if (const auto& limit = statement.limit()) {
+      out_ += " LIMIT ";
+      print_number(*limit, out_);
+    }
+    out_ += ';';
+  }
+
+  void visit(const DeleteStatement& statement) override {
+    out_ += "DELETE FROM ";
+    out_ += statement.table_name();
+    print_where(statement.expression());
+    out_ += ';';
+  }
+
+  void visit(const CreateTableStatement& statement) override {
+    out_ += "CREATE TABLE ";
+    out_ += statement.table_name();
+    out_ += " ( ";
+    for (const auto& column_def : statement.column_defs()) {
+      out_ += column_def.column_name_;
+      out_ += ' ';
+      out_ += column_kind_to_str(column_def.kind_);
+      out_ += ' ';
+    }
+    out_ += ");";
+  }
+
+  void visit(const ExplainStatement& statement) override {
+    out_ += statement.analyze() ? "EXPLAIN ANALYZE " : "EXPLAIN ";
+    statement.statement().accept(*this);
+  }
+
+  void visit(const TransactionStatement& statement) override {
+    switch (statement.kind()) {
+      case Statement::Kind::Begin:
+        out_ += "BEGIN;";
+        break;
+      case Statement::Kind::Commit:
+        out_ += "COMMIT;";
+        break;
+      default:
+        out_ += "ROLLBACK;";
+        break;
+    }
+  }
+
+  void visit(const AnalyzeStatement& statement) override {
+    out_ += "ANALYZE ";
+    out_ += statement.table_name();
+    out_ += ';';
+  }
+
+ private:
+  void print_where(const std::optional<Expression>& expression) {
+    if (expression) {
+      out_ += " WHERE ";
+      print_expression(*expression, out_);
+    }
+  }
+
+  std::string& out_;
+};
+
+}  // namespace
+
+void print_statement(const Statement& statement, std::string& out) {
+  StatementPrinter printer(out);
+  statement.accept(printer);
+}
+
+void print_expression(const Expression& expression, std::string& out) {
+  const int own = precedence(expression.kind_);
+  switch (expression.kind_) {
+    case Expression::Kind::Operand:
+      print_value(expression.operand_->value_, out);
+      return;
+    case Expression::Kind::Not:
+      out += "NOT ";
+      print_operand(expression.operands_[0], own, out);
+      return;
+    default:
+      print_operand(expression.operands_[0], own, out);
+      out += ' ';
+      // Short enough for the small string buffer, so this doesn't allocate.
+      out += binary_operator_to_str(expression);
+      out += ' ';
+      print_operand(expression.operands_[1], own + 1, out);
+      return;
+  }
+}
+
+void print_value(const Value& value, std::string& out) {
+  if (const int* i = std::get_if<int>(&value)) {
+    print_number(*i, out);
+  } else if (const float* f = std::get_if<float>(&value)) {
+    // std::to_string() prints floats as "%f" does.
+    constexpr int kPrecision = 6;
+    print_number(*f, out, std::chars_format::fixed, kPrecision);
+  } else if (const auto* text = std::get_if<std::string_view>(&value)) {
+    out += *text;
+  } else {
+    out += '?';
+  }
+}
+
+}  // namespace rdb::sql
@@ -15,6 +15,9 @@ std::string var_to_str(const Value& value) {
   if (const std::string_view* s = std::get_if<std::string_view>(&value)) {
     return {s->data(), s->size()};
   }
+  if (std::holds_alternative<Placeholder>(value)) {
+    return "?";
+  }
   return "";
 }
 
@@ -36,6 +39,78 @@ std::string operation_to_str(Expression::Operation operation) {
   return "Unexpected";
 }
 
+int precedence(Expression::Kind kind) {
+  switch (kind) {
+    case Expression::Kind::Or:
+      return 1;
+    case Expression::Kind::And:
+      return 2;
+    case Expression::Kind::Not:
+      return 3;
+    case Expression::Kind::Comparison:
+      return 4;
+    case Expression::Kind::Add:
+    case Expression::Kind::Subtract:
+      return 5;
+    case Expression::Kind::Multiply:
+    case Expression::Kind::Divide:
+      return 6;
+    case Expression::Kind::Operand:
+      return 7;
+  }
+  return 0;
+}
+
+std::string binary_operator_to_str(const Expression& expression) {
+  switch (expression.kind_) {
+    case Expression::Kind::Comparison:
+      return operation_to_str(expression.operation_);
+    case Expression::Kind::Add:
+      return "+";
+    case Expression::Kind::Subtract:
+      return "-";
+    case Expression::Kind::Multiply:
+      return "*";
+    case Expression::Kind::Divide:
+      return "/";
+    case Expression::Kind::And:
+      return "AND";
+    case Expression::Kind::Or:
+      return "OR";
+    default:
+      return "Unexpected";
+  }
+}
+
+namespace {
+
+// Parenthesizes `operand` if it would otherwise bind differently. Operators
+// of equal precedence group to the left, so a right operand of the same
+// precedence needs parentheses.
+std::string operand_to_str(const Expression& operand, int min_precedence) {
+  const std::string text = expression_to_str(operand);
+  if (precedence(operand.kind_) < min_precedence) {
+    return "(" + text + ")";
+  }
+  return text;
+}
+
+}  // namespace
+
+std::string expression_to_str(const Expression& expression) {
+  const int own = precedence(expression.kind_);
+  switch (expression.kind_) {
+    case Expression::Kind::Operand:
+      return var_to_str(expression.operand_->value_);
+    case Expression::Kind::Not:
+      return "NOT " + operand_to_str(expression.operands_[0], own);
+    default:
+      return operand_to_str(expression.operands_[0], own) + " " +
+             binary_operator_to_str(expression) + " " +
+             operand_to_str(expression.operands_[1], own + 1);
+  }
+}
+
 std::string column_kind_to_str(ColumnDef::Kind kind) {
   switch (kind) {
     case ColumnDef::Kind::Int:
@@ -50,6 +125,32 @@ std::string column_kind_to_str(ColumnDef::Kind kind) {
 
 Statement::~Statement() = default;
 
+std::string_view statement_kind_to_str(Statement::Kind kind) {
+  switch (kind) {
+    case Statement::Kind::DropTable:
+      return "drop_table";
+    case Statement::Kind::Insert:
+      return "insert";
+    case Statement::Kind::Select:
+      return "select";
+    case Statement::Kind::Delete:
+      return "delete";
+    case Statement::Kind::CreateTable:
+      return "create_table";
+    case Statement::Kind::Explain:
+      return "explain";
+    case Statement::Kind::Begin:
+      return "begin";
+    case Statement::Kind::Commit:
+      return "commit";
+    case Statement::Kind::Rollback:
+      return "rollback";
+    case Statement::Kind::Analyze:
+      return "analyze";
+  }
+  return "Unexpected";
+}
+
 std::string DropTableStatement::to_str() const {
   std::stringstream out;
   out << "DROP TABLE " << table_name() << ";";
@@ -70,17 +171,87 @@ std::string InsertStatement::to_str() const {
   return out.str();
 }
 
+std::string_view aggregate_to_str(SelectStatement::Aggregate aggregate) {
+  switch (aggregate) {
+    case SelectStatement::Aggregate::None:
+      return "";
+    case SelectStatement::Aggregate::Count:
+      return "COUNT";
+    case SelectStatement::Aggregate::Sum:
+      return "SUM";
+    case SelectStatement::Aggregate::Min:
+      return "MIN";
+    case SelectStatement::Aggregate::Max:
+      return "MAX";
+    case SelectStatement::Aggregate::Avg:
+      return "AVG";
+  }
+  return "Unexpected";
+}
+
+namespace {
+
+std::string select_item_to_str(
+    SelectStatement::Aggregate aggregate,
+    std::string_view column) {
+  if (aggregate == SelectStatement::Aggregate::None) {
+    return std::string(column);
+  }
+  return std::string(aggregate_to_str(aggregate)) + "(" + std::string(column) +
+         ")";
+}
+
+}  // namespace
+
+bool SelectStatement::aggregated() const {
+  if (!group_by_.empty()) {
+    return true;
+  }
+  for (const Aggregate aggregate : aggregates_) {
+    if (aggregate != Aggregate::None) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::string SelectStatement::item_to_str(size_t index) const {
+  return select_item_to_str(aggregates_[index], column_list_[index]);
+}
+
+std::string SelectStatement::order_by_to_str() const {
+  if (!order_by_) {
+    return "";
+  }
+  return select_item_to_str(order_by_->aggregate_, order_by_->column_) +
+         (order_by_->descending_ ? " DESC" : " ASC");
+}
+
 std::string SelectStatement::to_str() const {
   std::stringstream out;
   out << "SELECT ";
-  for (const auto& column : column_list()) {
-    out << column << " ";
+  for (size_t i = 0; i < column_list().size(); ++i) {
+    out << item_to_str(i) << " ";
   }
   out << "FROM " << table_name();
+  if (join()) {
+    out << " JOIN " << join()->table_name_ << " ON " << join()->left_column_
+        << " = " << join()->right_column_;
+  }
   if (expression() != std::nullopt) {
-    out << " WHERE " << var_to_str(expression()->first_operand_.value_) << " "
-        << operation_to_str(expression()->operation_) << " "
-        << var_to_str(expression()->second_operand_.value_);
+    out << " WHERE " << expression_to_str(*expression());
+  }
+  if (!group_by().empty()) {
+    out << " GROUP BY";
+    for (const auto& column : group_by()) {
+      out << " " << column;
+    }
+  }
+  if (order_by()) {
+    out << " ORDER BY " << order_by_to_str();
+  }
+  if (limit()) {
+    out << " LIMIT " << *limit();
   }
   out << ";";
   return out.str();
@@ -90,9 +261,7 @@ std::string DeleteStatement::to_str() const {
   std::stringstream out;
   out << "DELETE FROM " << table_name();
   if (expression() != std::nullopt) {
-    out << " WHERE " << var_to_str(expression()->first_operand_.value_) << " "
-        << operation_to_str(expression()->operation_) << " "
-        << var_to_str(expression()->second_operand_.value_);
+    out << " WHERE " << expression_to_str(*expression());
   }
   out << ";";
   return out.str();
@@ -109,6 +278,29 @@ std::string CreateTableStatement::to_str() const {
   return out.str();
 }
 
+std::string ExplainStatement::to_str() const {
+  std::stringstream out;
+  out << "EXPLAIN " << (analyze() ? "ANALYZE " : "") << statement().to_str();
+  return out.str();
+}
+
+std::string TransactionStatement::to_str() const {
+  switch (kind_) {
+    case Kind::Begin:
+      return "BEGIN;";
+    case Kind::Commit:
+      return "COMMIT;";
+    default:
+      return "ROLLBACK;";
+  }
+}
+
+std::string AnalyzeStatement::to_str() const {
+  std::stringstream out;
+  out << "ANALYZE " << table_name() << ";";
+  return out.str();
+}
+
 std::ostream& operator<<(std::ostream& os, const Statement& statement) {
   os << statement.to_str();
   return os;
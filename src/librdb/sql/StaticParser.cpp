@@ -0,0 +1,51 @@
+#include <librdb/sql/StaticParser.hpp>
+
+namespace rdb::sql {
+
+namespace {
+
+Operand make_operand(const StaticOperand& operand) {
+  return Operand(operand.kind_, operand.value_);
+}
+
+}  // namespace
+
+StatementPtr StaticStatement::make() const {
+  const std::vector<std::string_view> names(
+      names_.begin(), names_.begin() + static_cast<ptrdiff_t>(name_count_));
+  std::optional<Expression> expression;
+  if (has_expression_) {
+    expression.emplace(
+        make_operand(first_operand_),
+        operation_,
+        make_operand(second_operand_));
+  }
+
+  switch (kind_) {
+    case Kind::DropTable:
+      return std::make_unique<const DropTableStatement>(table_name_);
+    case Kind::Insert:
+      return std::make_unique<const InsertStatement>(
+          table_name_,
+          names,
+          std::vector<Value>(
+              values_.begin(),
+              values_.begin() + static_cast<ptrdiff_t>(value_count_)));
+    case Kind::Select:
+      return std::make_unique<const SelectStatement>(
+          names, table_name_, expression);
+    case Kind::Delete:
+      return std::make_unique<const DeleteStatement>(table_name_, expression);
+    case Kind::CreateTable: {
+      std::vector<ColumnDef> column_defs;
+      for (size_t i = 0; i < name_count_; ++i) {
+        column_defs.emplace_back(names_[i], column_kinds_[i]);
+      }
+      return std::make_unique<const CreateTableStatement>(
+          table_name_, column_defs);
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace rdb::sql
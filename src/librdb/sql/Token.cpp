@@ -24,6 +24,8 @@ std::string_view kind_to_str(Token::Kind kind) {
       return "LBracket";
     case Token::Kind::RBracket:
       return "RBracket";
+    case Token::Kind::Placeholder:
+      return "Placeholder";
     case Token::Kind::OpLess:
       return "Less";
     case Token::Kind::OpGreater:
@@ -36,6 +38,14 @@ std::string_view kind_to_str(Token::Kind kind) {
       return "Equal";
     case Token::Kind::OpNotEqual:
       return "Not equal";
+    case Token::Kind::OpPlus:
+      return "Plus";
+    case Token::Kind::OpMinus:
+      return "Minus";
+    case Token::Kind::OpMultiply:
+      return "Multiply";
+    case Token::Kind::OpDivide:
+      return "Divide";
     case Token::Kind::KwSelect:
       return "KwSelect";
     case Token::Kind::KwFrom:
@@ -62,6 +72,48 @@ std::string_view kind_to_str(Token::Kind kind) {
       return "KwReal";
     case Token::Kind::KwText:
       return "KwText";
+    case Token::Kind::KwExplain:
+      return "KwExplain";
+    case Token::Kind::KwAnalyze:
+      return "KwAnalyze";
+    case Token::Kind::KwAnd:
+      return "KwAnd";
+    case Token::Kind::KwOr:
+      return "KwOr";
+    case Token::Kind::KwNot:
+      return "KwNot";
+    case Token::Kind::KwCount:
+      return "KwCount";
+    case Token::Kind::KwSum:
+      return "KwSum";
+    case Token::Kind::KwMin:
+      return "KwMin";
+    case Token::Kind::KwMax:
+      return "KwMax";
+    case Token::Kind::KwAvg:
+      return "KwAvg";
+    case Token::Kind::KwGroup:
+      return "KwGroup";
+    case Token::Kind::KwBy:
+      return "KwBy";
+    case Token::Kind::KwJoin:
+      return "KwJoin";
+    case Token::Kind::KwOn:
+      return "KwOn";
+    case Token::Kind::KwOrder:
+      return "KwOrder";
+    case Token::Kind::KwAsc:
+      return "KwAsc";
+    case Token::Kind::KwDesc:
+      return "KwDesc";
+    case Token::Kind::KwLimit:
+      return "KwLimit";
+    case Token::Kind::KwBegin:
+      return "KwBegin";
+    case Token::Kind::KwCommit:
+      return "KwCommit";
+    case Token::Kind::KwRollback:
+      return "KwRollback";
   }
   return "Unexpected";
 }
@@ -0,0 +1,54 @@
+#include <limits>
+#include <librdb/metrics/Metrics.hpp>
+#include <librdb/sql/Scanner.hpp>
+#include <librdb/sql/TokenBuffer.hpp>
+#include <stdexcept>
+
+namespace rdb::sql {
+
+namespace {
+
+metrics::Counter& tokens_counter() {
+  static metrics::Counter& counter = metrics::Registry::global().counter(
+      "rdb_lexer_tokens_total", "Tokens produced by the lexer.");
+  return counter;
+}
+
+}  // namespace
+
+TokenBuffer::TokenBuffer(std::string_view input)
+    : input_(input), newlines_(input) {
+  if (input.size() >= std::numeric_limits<uint32_t>::max()) {
+    throw std::length_error("Script is too large to tokenize");
+  }
+  size_t offset = 0;
+  while (true) {
+    const auto scanned =
+        scanner::scan_token(input, scanner::skip_spaces(input, offset));
+    kinds_.push_back(uint8_t(scanned.kind_));
+    offsets_.push_back(uint32_t(scanned.begin_));
+    lengths_.push_back(uint32_t(scanned.end_ - scanned.begin_));
+    if (scanned.kind_ == Token::Kind::Eof) {
+      break;
+    }
+    offset = scanned.end_;
+  }
+  tokens_counter().add(kinds_.size());
+}
+
+std::string_view TokenBuffer::text(size_t index) const {
+  if (kind(index) == Token::Kind::Eof) {
+    return "<EOF>";
+  }
+  return input_.substr(offsets_[index], lengths_[index]);
+}
+
+Location TokenBuffer::location(size_t index) const {
+  return newlines_.locate(offsets_[index]);
+}
+
+Token TokenBuffer::token(size_t index) const {
+  return Token(kind(index), text(index), location(index));
+}
+
+}  // namespace rdb::sql
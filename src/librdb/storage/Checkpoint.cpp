@@ -0,0 +1,284 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <librdb/storage/Checkpoint.hpp>
+#include <librdb/storage/TableImage.hpp>
+#include <optional>
+
+namespace rdb::storage {
+
+namespace {
+
+constexpr char kCatalogMagic[8] = {'R', 'D', 'B', 'C', 'A', 'T', 'L', 'G'};
+constexpr uint32_t kFormatVersion = 1;
+constexpr const char* kCatalogFile = "CATALOG";
+constexpr const char* kTableSuffix = ".rdbt";
+constexpr const char* kLogSuffix = ".log";
+
+[[noreturn]] void throw_errno(const std::string& what) {
+  throw StorageError(what + ": " + std::strerror(errno));
+}
+
+std::string table_file_name(
+    const std::string& table_name,
+    uint64_t generation) {
+  return table_name + "." + std::to_string(generation) + kTableSuffix;
+}
+
+// Buffered sequential writer that syncs the file when it's finished.
+class FileWriter : public ImageWriter {
+ public:
+  explicit FileWriter(std::string path) : path_(std::move(path)) {
+    fd_ = ::open(
+        path_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+      throw_errno("Can't create " + path_);
+    }
+  }
+
+  ~FileWriter() {
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+  }
+
+  FileWriter(const FileWriter&) = delete;
+  FileWriter& operator=(const FileWriter&) = delete;
+
+  void append(const void* data, size_t size) override {
+    const auto* bytes = static_cast<const char*>(data);
+    if (buffer_.size() + size > kBufferSize) {
+      write_buffer();
+      if (size > kBufferSize) {
+        write_all(bytes, size);
+        return;
+      }
+    }
+    buffer_.append(bytes, size);
+  }
+
+  void finish() {
+    write_buffer();
+    if (::fsync(fd_) != 0) {
+      throw_errno("Can't sync " + path_);
+    }
+    ::close(fd_);
+    fd_ = -1;
+  }
+
+ private:
+  static constexpr size_t kBufferSize = size_t{1} << 20U;
+
+  void write_buffer() {
+    write_all(buffer_.data(), buffer_.size());
+    buffer_.clear();
+  }
+
+  void write_all(const char* data, size_t size) {
+    while (size != 0) {
+      const ssize_t result = ::write(fd_, data, size);
+      if (result < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        throw_errno("Can't write " + path_);
+      }
+      data += result;
+      size -= static_cast<size_t>(result);
+    }
+  }
+
+  std::string path_;
+  int fd_ = -1;
+  std::string buffer_;
+};
+
+void write_table(const exec::Table& table, const std::string& path) {
+  FileWriter writer(path);
+  write_table_image(table, writer);
+  writer.finish();
+}
+
+// Maps a whole file read-only. The mapping lives as long as the pointer.
+std::shared_ptr<const void> map_file(const std::string& path, size_t& size) {
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw_errno("Can't open " + path);
+  }
+  struct stat status {};
+  if (::fstat(fd, &status) != 0) {
+    ::close(fd);
+    throw_errno("Can't stat " + path);
+  }
+  size = static_cast<size_t>(status.st_size);
+  if (size == 0) {
+    ::close(fd);
+    throw StorageError(path + " is too small");
+  }
+  void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    throw_errno("Can't map " + path);
+  }
+  return std::shared_ptr<const void>(
+      data, [size](const void* mapping) {
+        ::munmap(const_cast<void*>(mapping), size);
+      });
+}
+
+exec::TablePtr load_table(const std::string& path) {
+  size_t size = 0;
+  std::shared_ptr<const void> mapping = map_file(path, size);
+  const auto* image = static_cast<const char*>(mapping.get());
+  return read_table_image(std::move(mapping), image, size, path);
+}
+
+void sync_directory(const std::string& directory) {
+  const int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd < 0) {
+    throw_errno("Can't open " + directory);
+  }
+  const int result = ::fsync(fd);
+  ::close(fd);
+  if (result != 0) {
+    throw_errno("Can't sync " + directory);
+  }
+}
+
+struct CatalogFile {
+  uint64_t generation_ = 0;
+  std::vector<std::string> table_names_;
+};
+
+std::optional<CatalogFile> read_catalog_file(const std::string& path) {
+  std::ifstream input(path, std::ios::binary);
+  if (!input) {
+    return std::nullopt;
+  }
+  const auto read = [&input, &path](void* data, size_t size) {
+    if (!input.read(
+            static_cast<char*>(data), static_cast<std::streamsize>(size))) {
+      throw StorageError(path + " is damaged");
+    }
+  };
+  char magic[8];
+  uint32_t version = 0;
+  uint32_t table_count = 0;
+  CatalogFile catalog_file;
+  read(magic, sizeof(magic));
+  read(&version, sizeof(version));
+  read(&table_count, sizeof(table_count));
+  read(&catalog_file.generation_, sizeof(catalog_file.generation_));
+  if (std::memcmp(magic, kCatalogMagic, sizeof(magic)) != 0 ||
+      version != kFormatVersion) {
+    throw StorageError(path + " is damaged");
+  }
+  for (uint32_t i = 0; i < table_count; ++i) {
+    uint32_t name_size = 0;
+    read(&name_size, sizeof(name_size));
+    std::string name(name_size, '\0');
+    read(name.data(), name_size);
+    catalog_file.table_names_.push_back(std::move(name));
+  }
+  return catalog_file;
+}
+
+}  // namespace
+
+uint64_t write_checkpoint(
+    const exec::Catalog& catalog,
+    const std::string& directory) {
+  namespace fs = std::filesystem;
+  std::error_code error;
+  fs::create_directories(directory, error);
+  if (error) {
+    throw StorageError("Can't create " + directory + ": " + error.message());
+  }
+  const std::string catalog_path = directory + "/" + kCatalogFile;
+  const auto previous = read_catalog_file(catalog_path);
+  const uint64_t generation = previous ? previous->generation_ + 1 : 1;
+
+  const auto tables = catalog.tables();
+  for (const auto& table : tables) {
+    write_table(
+        *table,
+        directory + "/" + table_file_name(table->name(), generation));
+  }
+
+  const std::string temporary_path = catalog_path + ".tmp";
+  {
+    FileWriter writer(temporary_path);
+    const auto table_count = static_cast<uint32_t>(tables.size());
+    writer.append(kCatalogMagic, sizeof(kCatalogMagic));
+    writer.append(&kFormatVersion, sizeof(kFormatVersion));
+    writer.append(&table_count, sizeof(table_count));
+    writer.append(&generation, sizeof(generation));
+    for (const auto& table : tables) {
+      const auto name_size = static_cast<uint32_t>(table->name().size());
+      writer.append(&name_size, sizeof(name_size));
+      writer.append(table->name().data(), name_size);
+    }
+    writer.finish();
+  }
+  if (::rename(temporary_path.c_str(), catalog_path.c_str()) != 0) {
+    throw_errno("Can't replace " + catalog_path);
+  }
+  sync_directory(directory);
+
+  // Files of older generations are no longer referenced. Mapped tables
+  // keep their pages after the file is removed.
+  const std::string current_table_suffix =
+      "." + std::to_string(generation) + kTableSuffix;
+  const std::string current_log = log_path(directory, generation);
+  for (const auto& entry : fs::directory_iterator(directory, error)) {
+    const std::string name = entry.path().filename().string();
+    const auto ends_with = [&name](const std::string& suffix) {
+      return name.size() >= suffix.size() &&
+          name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+    const bool old_table =
+        ends_with(kTableSuffix) && !ends_with(current_table_suffix);
+    const bool old_log = ends_with(kLogSuffix) &&
+        entry.path().string() != fs::path(current_log).string();
+    if (old_table || old_log) {
+      fs::remove(entry.path(), error);
+    }
+  }
+  return generation;
+}
+
+uint64_t load_checkpoint(exec::Catalog& catalog, const std::string& directory) {
+  std::error_code error;
+  std::filesystem::create_directories(directory, error);
+  if (error) {
+    throw StorageError("Can't create " + directory + ": " + error.message());
+  }
+  const auto catalog_file = read_catalog_file(directory + "/" + kCatalogFile);
+  if (!catalog_file) {
+    return 0;
+  }
+  for (const auto& table_name : catalog_file->table_names_) {
+    auto table = load_table(
+        directory + "/" +
+        table_file_name(table_name, catalog_file->generation_));
+    if (table->name() != table_name) {
+      throw StorageError("Checkpoint of " + table_name + " is damaged");
+    }
+    if (!catalog.create(std::move(table))) {
+      throw StorageError("Table " + table_name + " already exists");
+    }
+  }
+  return catalog_file->generation_;
+}
+
+std::string log_path(const std::string& directory, uint64_t generation) {
+  return directory + "/statements." + std::to_string(generation) + kLogSuffix;
+}
+
+}  // namespace rdb::storage
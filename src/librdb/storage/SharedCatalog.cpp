@@ -0,0 +1,291 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <librdb/storage/SharedCatalog.hpp>
+#include <librdb/storage/StatementLog.hpp>
+#include <librdb/storage/TableImage.hpp>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace rdb::storage {
+
+namespace {
+
+constexpr char kRegionMagic[8] = {'R', 'D', 'B', 'S', 'H', 'A', 'R', 'E'};
+constexpr uint32_t kFormatVersion = 1;
+constexpr uint64_t kAlignment = 64;
+
+static_assert(
+    std::atomic<uint64_t>::is_always_lock_free,
+    "Counters in shared memory are lock-free atomics");
+
+struct alignas(kAlignment) Slot {
+  // Odd while the writer fills the slot, 2 * version once it holds one.
+  std::atomic<uint64_t> sequence_;
+  // Readers running a SELECT on the slot's version.
+  std::atomic<uint64_t> readers_;
+  uint64_t table_count_;
+};
+
+// A region starts with a RegionHeader, followed by the two slots' data.
+// Slot data starts with a TableEntry per table; offsets are from the start
+// of the slot data.
+struct RegionHeader {
+  char magic_[8];
+  uint32_t version_;
+  uint32_t reserved_;
+  uint64_t slot_bytes_;
+  std::atomic<uint64_t> published_;
+  Slot slots_[2];
+};
+
+struct TableEntry {
+  uint64_t offset_;
+  uint64_t size_;
+};
+
+uint64_t align(uint64_t offset) {
+  return (offset + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+[[noreturn]] void throw_errno(const std::string& what) {
+  throw StorageError(what + ": " + std::strerror(errno));
+}
+
+RegionHeader& header_of(const std::shared_ptr<void>& region) {
+  return *static_cast<RegionHeader*>(region.get());
+}
+
+char* slot_data(const std::shared_ptr<void>& region, size_t slot) {
+  const uint64_t slot_bytes = header_of(region).slot_bytes_;
+  return static_cast<char*>(region.get()) + align(sizeof(RegionHeader)) +
+      slot * slot_bytes;
+}
+
+// Maps `size` bytes of the shared memory object open as `fd`, which it
+// closes. The mapping lives as long as the pointer.
+std::shared_ptr<void> map_region(
+    int fd,
+    size_t size,
+    const std::string& name) {
+  void* data =
+      ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    throw_errno("Can't map " + name);
+  }
+  return std::shared_ptr<void>(
+      data, [size](void* mapping) { ::munmap(mapping, size); });
+}
+
+// Copies table images into a slot.
+class SlotWriter : public ImageWriter {
+ public:
+  SlotWriter(char* data, size_t capacity, const std::string& name)
+      : data_(data), capacity_(capacity), name_(name) {}
+
+  size_t offset() const { return offset_; }
+
+  void append(const void* data, size_t size) override {
+    if (size > capacity_ - offset_) {
+      throw StorageError("Tables don't fit into " + name_);
+    }
+    std::memcpy(data_ + offset_, data, size);
+    offset_ += size;
+  }
+
+  void pad_to(size_t offset) {
+    const std::string zeros(offset - offset_, '\0');
+    append(zeros.data(), zeros.size());
+  }
+
+ private:
+  char* data_;
+  size_t capacity_;
+  const std::string& name_;
+  size_t offset_ = 0;
+};
+
+}  // namespace
+
+SharedCatalogWriter::SharedCatalogWriter(std::string name, size_t slot_bytes)
+    : name_(std::move(name)) {
+  slot_bytes = align(slot_bytes);
+  const size_t size = align(sizeof(RegionHeader)) + 2 * slot_bytes;
+  const int fd =
+      ::shm_open(name_.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+  if (fd < 0) {
+    throw_errno("Can't create " + name_);
+  }
+  if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+    ::close(fd);
+    ::shm_unlink(name_.c_str());
+    throw_errno("Can't size " + name_);
+  }
+  try {
+    region_ = map_region(fd, size, name_);
+  } catch (const StorageError&) {
+    ::shm_unlink(name_.c_str());
+    throw;
+  }
+  auto* header = new (region_.get()) RegionHeader{};
+  header->version_ = kFormatVersion;
+  header->slot_bytes_ = slot_bytes;
+  // Readers check the magic last written.
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(header->magic_, kRegionMagic, sizeof(kRegionMagic));
+}
+
+SharedCatalogWriter::~SharedCatalogWriter() {
+  ::shm_unlink(name_.c_str());
+}
+
+uint64_t SharedCatalogWriter::publish(const exec::Catalog& catalog) {
+  RegionHeader& header = header_of(region_);
+  const uint64_t version = header.published_.load() + 1;
+  const size_t slot_index = version % 2;
+  Slot& slot = header.slots_[slot_index];
+  // Sequentially consistent, like the readers' count and check: either a
+  // reader sees the odd sequence, or the writer sees the reader.
+  slot.sequence_.store(2 * version - 1);
+  while (slot.readers_.load() != 0) {
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+  }
+
+  const auto tables = catalog.tables();
+  SlotWriter writer(slot_data(region_, slot_index), header.slot_bytes_, name_);
+  std::vector<TableEntry> entries(tables.size());
+  writer.pad_to(align(entries.size() * sizeof(TableEntry)));
+  for (size_t i = 0; i < tables.size(); ++i) {
+    entries[i].offset_ = writer.offset();
+    write_table_image(*tables[i], writer);
+    entries[i].size_ = writer.offset() - entries[i].offset_;
+    writer.pad_to(align(writer.offset()));
+  }
+  std::memcpy(
+      slot_data(region_, slot_index),
+      entries.data(),
+      entries.size() * sizeof(TableEntry));
+  slot.table_count_ = tables.size();
+
+  slot.sequence_.store(2 * version, std::memory_order_release);
+  header.published_.store(version, std::memory_order_release);
+  return version;
+}
+
+uint64_t SharedCatalogWriter::version() const {
+  return header_of(region_).published_.load(std::memory_order_acquire);
+}
+
+SharedCatalogReader::SharedCatalogReader(const std::string& name)
+    : name_(name) {
+  const int fd = ::shm_open(name_.c_str(), O_RDWR | O_CLOEXEC, 0);
+  if (fd < 0) {
+    throw_errno("Can't open " + name_);
+  }
+  struct stat status {};
+  if (::fstat(fd, &status) != 0) {
+    ::close(fd);
+    throw_errno("Can't stat " + name_);
+  }
+  const auto size = static_cast<size_t>(status.st_size);
+  if (size < align(sizeof(RegionHeader))) {
+    ::close(fd);
+    throw StorageError(name_ + " isn't a shared catalog");
+  }
+  region_ = map_region(fd, size, name_);
+  const RegionHeader& header = header_of(region_);
+  const bool valid =
+      std::memcmp(header.magic_, kRegionMagic, sizeof(kRegionMagic)) == 0;
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (!valid || header.version_ != kFormatVersion ||
+      header.slot_bytes_ % kAlignment != 0 ||
+      size < align(sizeof(RegionHeader)) + 2 * header.slot_bytes_) {
+    throw StorageError(name_ + " isn't a shared catalog");
+  }
+  catalog_ = std::make_unique<exec::Catalog>();
+  executor_ = std::make_unique<exec::Executor>(*catalog_);
+}
+
+exec::Result SharedCatalogReader::execute(
+    const sql::SelectStatement& statement) {
+  const size_t slot = enter();
+  try {
+    exec::Result result = executor_->execute(statement);
+    leave(slot);
+    return result;
+  } catch (...) {
+    leave(slot);
+    throw;
+  }
+}
+
+size_t SharedCatalogReader::enter() {
+  RegionHeader& header = header_of(region_);
+  while (true) {
+    const uint64_t version = header.published_.load();
+    const size_t slot_index = version % 2;
+    Slot& slot = header.slots_[slot_index];
+    // Sequentially consistent, like the writer's store and check: either
+    // the writer sees the reader, or the reader sees the odd sequence.
+    slot.readers_.fetch_add(1);
+    if (slot.sequence_.load() != 2 * version) {
+      // The writer moved on and fills the slot again.
+      slot.readers_.fetch_sub(1);
+      continue;
+    }
+    if (version != version_) {
+      try {
+        load(version, slot_index);
+      } catch (...) {
+        slot.readers_.fetch_sub(1);
+        throw;
+      }
+    }
+    return slot_index;
+  }
+}
+
+void SharedCatalogReader::leave(size_t slot) {
+  header_of(region_).slots_[slot].readers_.fetch_sub(1);
+}
+
+void SharedCatalogReader::load(uint64_t version, size_t slot_index) {
+  const RegionHeader& header = header_of(region_);
+  const char* data = slot_data(region_, slot_index);
+  const uint64_t slot_bytes = header.slot_bytes_;
+  const uint64_t table_count = header.slots_[slot_index].table_count_;
+  const std::string source = name_ + " version " + std::to_string(version);
+  if (table_count > slot_bytes / sizeof(TableEntry)) {
+    throw StorageError(source + " is damaged");
+  }
+  std::vector<TableEntry> entries(table_count);
+  std::memcpy(entries.data(), data, table_count * sizeof(TableEntry));
+  // The tables keep the mapping alive.
+  const std::shared_ptr<const void> owner = region_;
+  auto catalog = std::make_unique<exec::Catalog>();
+  for (const TableEntry& entry : entries) {
+    if (entry.offset_ > slot_bytes ||
+        entry.size_ > slot_bytes - entry.offset_ ||
+        entry.offset_ % kAlignment != 0) {
+      throw StorageError(source + " is damaged");
+    }
+    if (!catalog->create(read_table_image(
+            owner, data + entry.offset_, entry.size_, source))) {
+      throw StorageError(source + " is damaged");
+    }
+  }
+
+  executor_ = std::make_unique<exec::Executor>(*catalog);
+  catalog_ = std::move(catalog);
+  version_ = version;
+}
+
+}  // namespace rdb::storage
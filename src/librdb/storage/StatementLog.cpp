@@ -0,0 +1,380 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <librdb/storage/StatementLog.hpp>
+#include <memory>
+#include <vector>
+
+namespace rdb::storage {
+
+namespace {
+
+constexpr size_t kRecordHeaderSize = 8;
+
+enum class ValueTag : uint8_t { Int = 1, Real = 2, Text = 3 };
+
+// How a DELETE's condition is stored. Records written before conditions
+// became trees hold a single comparison.
+enum class ConditionTag : uint8_t { None = 0, Comparison = 1, Tree = 2 };
+
+template <typename T>
+void put(std::string& out, T value) {
+  char bytes[sizeof(T)];
+  std::memcpy(bytes, &value, sizeof(T));
+  out.append(bytes, sizeof(T));
+}
+
+void put_string(std::string& out, std::string_view value) {
+  put(out, static_cast<uint32_t>(value.size()));
+  out.append(value);
+}
+
+uint32_t checksum(std::string_view bytes) {
+  // FNV-1a.
+  uint32_t hash = 2166136261U;
+  for (const char c : bytes) {
+    hash = (hash ^ static_cast<uint8_t>(c)) * 16777619U;
+  }
+  return hash;
+}
+
+class RecordEncoder : public sql::StatementVisitor {
+ public:
+  explicit RecordEncoder(std::string& out) : out_(out) {}
+
+  void visit(const sql::DropTableStatement& statement) override {
+    put(out_, static_cast<uint8_t>(statement.kind()));
+    put_string(out_, statement.table_name());
+  }
+
+  void visit(const sql::InsertStatement& statement) override {
+    put(out_, static_cast<uint8_t>(statement.kind()));
+    put_string(out_, statement.table_name());
+    put(out_, static_cast<uint32_t>(statement.column_names().size()));
+    for (const auto column_name : statement.column_names()) {
+      put_string(out_, column_name);
+    }
+    put(out_, static_cast<uint32_t>(statement.values().size()));
+    for (const auto& value : statement.values()) {
+      put_value(value);
+    }
+  }
+
+  void visit(const sql::SelectStatement& /*statement*/) override {
+    throw std::logic_error("SELECT isn't logged");
+  }
+
+  void visit(const sql::DeleteStatement& statement) override {
+    put(out_, static_cast<uint8_t>(statement.kind()));
+    put_string(out_, statement.table_name());
+    const auto& expression = statement.expression();
+    if (!expression) {
+      put(out_, static_cast<uint8_t>(ConditionTag::None));
+      return;
+    }
+    put(out_, static_cast<uint8_t>(ConditionTag::Tree));
+    put_expression(*expression);
+  }
+
+  void visit(const sql::CreateTableStatement& statement) override {
+    put(out_, static_cast<uint8_t>(statement.kind()));
+    put_string(out_, statement.table_name());
+    put(out_, static_cast<uint32_t>(statement.column_defs().size()));
+    for (const auto& column_def : statement.column_defs()) {
+      put_string(out_, column_def.column_name_);
+      put(out_, static_cast<uint8_t>(column_def.kind_));
+    }
+  }
+
+  void visit(const sql::ExplainStatement& statement) override {
+    statement.statement().accept(*this);
+  }
+
+  void visit(const sql::TransactionStatement& statement) override {
+    put(out_, static_cast<uint8_t>(statement.kind()));
+  }
+
+  void visit(const sql::AnalyzeStatement& /*statement*/) override {
+    throw std::logic_error("ANALYZE isn't logged");
+  }
+
+ private:
+  void put_value(const sql::Value& value) {
+    if (const int* i = std::get_if<int>(&value)) {
+      put(out_, static_cast<uint8_t>(ValueTag::Int));
+      put(out_, static_cast<int32_t>(*i));
+    } else if (const float* f = std::get_if<float>(&value)) {
+      put(out_, static_cast<uint8_t>(ValueTag::Real));
+      put(out_, *f);
+    } else if (const auto* text = std::get_if<std::string_view>(&value)) {
+      put(out_, static_cast<uint8_t>(ValueTag::Text));
+      put_string(out_, *text);
+    } else {
+      throw std::logic_error("Placeholders aren't logged");
+    }
+  }
+
+  void put_operand(const sql::Operand& operand) {
+    put(out_, static_cast<uint8_t>(operand.kind_));
+    put_value(operand.value_);
+  }
+
+  // Prefix order: the kind, then the operand or the comparison's
+  // operation, then the operands.
+  void put_expression(const sql::Expression& expression) {
+    put(out_, static_cast<uint8_t>(expression.kind_));
+    if (expression.kind_ == sql::Expression::Kind::Operand) {
+      put_operand(*expression.operand_);
+      return;
+    }
+    if (expression.kind_ == sql::Expression::Kind::Comparison) {
+      put(out_, static_cast<uint8_t>(expression.operation_));
+    }
+    for (const auto& operand : expression.operands_) {
+      put_expression(operand);
+    }
+  }
+
+  std::string& out_;
+};
+
+// Decodes a record payload into a statement whose strings point into it.
+class RecordDecoder {
+ public:
+  explicit RecordDecoder(std::string_view payload) : payload_(payload) {}
+
+  sql::StatementPtr decode() {
+    const auto kind = sql::Statement::Kind(get<uint8_t>());
+    if (kind == sql::Statement::Kind::Begin ||
+        kind == sql::Statement::Kind::Commit) {
+      return std::make_unique<const sql::TransactionStatement>(kind);
+    }
+    const std::string_view table_name = get_string();
+    switch (kind) {
+      case sql::Statement::Kind::DropTable:
+        return std::make_unique<const sql::DropTableStatement>(table_name);
+      case sql::Statement::Kind::Insert: {
+        std::vector<std::string_view> column_names(get<uint32_t>());
+        for (auto& column_name : column_names) {
+          column_name = get_string();
+        }
+        std::vector<sql::Value> values;
+        for (auto count = get<uint32_t>(); count != 0; --count) {
+          values.push_back(get_value());
+        }
+        return std::make_unique<const sql::InsertStatement>(
+            table_name, column_names, values);
+      }
+      case sql::Statement::Kind::Delete: {
+        switch (ConditionTag(get<uint8_t>())) {
+          case ConditionTag::None:
+            return std::make_unique<const sql::DeleteStatement>(table_name);
+          case ConditionTag::Comparison: {
+            const sql::Operand first = get_operand();
+            const auto operation = sql::Expression::Operation(get<uint8_t>());
+            const sql::Operand second = get_operand();
+            return std::make_unique<const sql::DeleteStatement>(
+                table_name, sql::Expression(first, operation, second));
+          }
+          case ConditionTag::Tree:
+            return std::make_unique<const sql::DeleteStatement>(
+                table_name, get_expression());
+        }
+        throw StorageError("Unexpected condition in log");
+      }
+      case sql::Statement::Kind::CreateTable: {
+        std::vector<sql::ColumnDef> column_defs;
+        for (auto count = get<uint32_t>(); count != 0; --count) {
+          const std::string_view column_name = get_string();
+          column_defs.emplace_back(
+              column_name, sql::ColumnDef::Kind(get<uint8_t>()));
+        }
+        return std::make_unique<const sql::CreateTableStatement>(
+            table_name, column_defs);
+      }
+      default:
+        throw StorageError("Unexpected statement in log");
+    }
+  }
+
+ private:
+  template <typename T>
+  T get() {
+    require(sizeof(T));
+    T value;
+    std::memcpy(&value, payload_.data(), sizeof(T));
+    payload_.remove_prefix(sizeof(T));
+    return value;
+  }
+
+  std::string_view get_string() {
+    const auto size = get<uint32_t>();
+    require(size);
+    const std::string_view value = payload_.substr(0, size);
+    payload_.remove_prefix(size);
+    return value;
+  }
+
+  sql::Value get_value() {
+    switch (ValueTag(get<uint8_t>())) {
+      case ValueTag::Int:
+        return static_cast<int>(get<int32_t>());
+      case ValueTag::Real:
+        return get<float>();
+      case ValueTag::Text:
+        return get_string();
+    }
+    throw StorageError("Unexpected value in log");
+  }
+
+  sql::Operand get_operand() {
+    const auto kind = sql::Operand::Kind(get<uint8_t>());
+    return sql::Operand(kind, get_value());
+  }
+
+  sql::Expression get_expression() {
+    const auto kind = sql::Expression::Kind(get<uint8_t>());
+    switch (kind) {
+      case sql::Expression::Kind::Operand:
+        return get_operand();
+      case sql::Expression::Kind::Comparison: {
+        const auto operation = sql::Expression::Operation(get<uint8_t>());
+        sql::Expression first = get_expression();
+        return sql::Expression(std::move(first), operation, get_expression());
+      }
+      case sql::Expression::Kind::Not:
+        return sql::Expression(kind, {get_expression()});
+      case sql::Expression::Kind::Add:
+      case sql::Expression::Kind::Subtract:
+      case sql::Expression::Kind::Multiply:
+      case sql::Expression::Kind::Divide:
+      case sql::Expression::Kind::And:
+      case sql::Expression::Kind::Or: {
+        sql::Expression first = get_expression();
+        return sql::Expression(kind, {std::move(first), get_expression()});
+      }
+    }
+    throw StorageError("Unexpected expression in log");
+  }
+
+  void require(size_t size) const {
+    if (payload_.size() < size) {
+      throw StorageError("Truncated log record");
+    }
+  }
+
+  std::string_view payload_;
+};
+
+[[noreturn]] void throw_errno(const std::string& what) {
+  throw StorageError(what + ": " + std::strerror(errno));
+}
+
+}  // namespace
+
+StatementLog::StatementLog(std::string path, bool sync)
+    : path_(std::move(path)), sync_(sync) {
+  fd_ = ::open(path_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+  if (fd_ < 0) {
+    throw_errno("Can't open " + path_);
+  }
+}
+
+StatementLog::~StatementLog() {
+  ::close(fd_);
+}
+
+void StatementLog::append(const sql::Statement& statement) {
+  const size_t header = buffer_.size();
+  put(buffer_, uint32_t{0});
+  put(buffer_, uint32_t{0});
+  RecordEncoder encoder(buffer_);
+  statement.accept(encoder);
+  const std::string_view payload =
+      std::string_view(buffer_).substr(header + kRecordHeaderSize);
+  const auto size = static_cast<uint32_t>(payload.size());
+  const uint32_t sum = checksum(payload);
+  std::memcpy(&buffer_[header], &size, sizeof(size));
+  std::memcpy(&buffer_[header + sizeof(size)], &sum, sizeof(sum));
+}
+
+void StatementLog::flush() {
+  if (buffer_.empty()) {
+    return;
+  }
+  size_t written = 0;
+  while (written < buffer_.size()) {
+    const ssize_t result =
+        ::write(fd_, buffer_.data() + written, buffer_.size() - written);
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw_errno("Can't write " + path_);
+    }
+    written += static_cast<size_t>(result);
+  }
+  buffer_.clear();
+  if (sync_ && ::fdatasync(fd_) != 0) {
+    throw_errno("Can't sync " + path_);
+  }
+  ++flush_count_;
+}
+
+StatementLog::Replayed StatementLog::replay(
+    const std::string& path,
+    exec::Executor& executor) {
+  std::ifstream input(path, std::ios::binary | std::ios::ate);
+  if (!input) {
+    return {};
+  }
+  const auto log_size = static_cast<uint64_t>(input.tellg());
+  input.seekg(0);
+
+  Replayed replayed;
+  // A transaction whose COMMIT record is missing is dropped with it.
+  exec::Transaction transaction;
+  // Records are read one at a time, so replay needs memory for the largest
+  // record rather than the whole log.
+  uint64_t offset = 0;
+  std::string payload;
+  while (log_size - offset >= kRecordHeaderSize) {
+    char header[kRecordHeaderSize];
+    if (!input.read(header, sizeof(header))) {
+      throw StorageError("Can't read " + path);
+    }
+    uint32_t size = 0;
+    uint32_t sum = 0;
+    std::memcpy(&size, header, sizeof(size));
+    std::memcpy(&sum, header + sizeof(size), sizeof(sum));
+    if (log_size - offset - kRecordHeaderSize < size) {
+      break;
+    }
+    payload.resize(size);
+    if (!input.read(payload.data(), size)) {
+      throw StorageError("Can't read " + path);
+    }
+    if (checksum(payload) != sum) {
+      break;
+    }
+    // The transaction copies its statements, so the payload can be reused.
+    const sql::StatementPtr statement = RecordDecoder(payload).decode();
+    try {
+      executor.execute(*statement, transaction);
+    } catch (const exec::ExecutionError& e) {
+      throw StorageError(
+          "Can't replay " + statement->to_str() + ": " + e.what());
+    }
+    ++replayed.statements_;
+    offset += kRecordHeaderSize + size;
+    if (!transaction.active()) {
+      replayed.end_offset_ = offset;
+    }
+  }
+  return replayed;
+}
+
+}  // namespace rdb::storage
@@ -0,0 +1,211 @@
+#include <cstring>
+#include <librdb/storage/StatementLog.hpp>
+#include <librdb/storage/TableImage.hpp>
+#include <string>
+#include <vector>
+
+namespace rdb::storage {
+
+namespace {
+
+constexpr char kTableMagic[8] = {'R', 'D', 'B', 'T', 'A', 'B', 'L', 'E'};
+constexpr uint32_t kFormatVersion = 1;
+constexpr uint64_t kAlignment = 64;
+
+// An image starts with a TableHeader and one ColumnHeader per column.
+// Offsets are from the start of the image. TEXT columns store row_count_ + 1
+// offsets into their bytes.
+struct TableHeader {
+  char magic_[8];
+  uint32_t version_;
+  uint32_t column_count_;
+  uint64_t row_count_;
+  uint64_t name_offset_;
+  uint64_t name_size_;
+};
+
+struct ColumnHeader {
+  uint32_t kind_;
+  uint32_t name_size_;
+  uint64_t name_offset_;
+  uint64_t values_offset_;
+  uint64_t values_size_;
+  uint64_t offsets_offset_;
+};
+
+uint64_t align(uint64_t offset) {
+  return (offset + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+// Counts the bytes written, so that arrays can be padded to their offset.
+class Output {
+ public:
+  explicit Output(ImageWriter& writer) : writer_(writer) {}
+
+  void append(const void* data, size_t size) {
+    writer_.append(data, size);
+    offset_ += size;
+  }
+
+  void pad_to(uint64_t offset) {
+    const std::string zeros(offset - offset_, '\0');
+    append(zeros.data(), zeros.size());
+  }
+
+ private:
+  ImageWriter& writer_;
+  uint64_t offset_ = 0;
+};
+
+// Images store INT and REAL values plain, so they can be used in place;
+// encoded blocks are decoded one at a time.
+template <typename T>
+void write_values(const exec::Column& column, Output& output) {
+  std::vector<T> scratch;
+  for (size_t block = 0; block < column.block_count(); ++block) {
+    output.append(
+        column.block_values(block, scratch),
+        column.block_rows(block) * sizeof(T));
+  }
+}
+
+}  // namespace
+
+void write_table_image(const exec::Table& table, ImageWriter& writer) {
+  const auto& columns = table.columns();
+  const uint64_t row_count = table.row_count();
+
+  // Lay out names first and then the column arrays.
+  TableHeader header{};
+  std::memcpy(header.magic_, kTableMagic, sizeof(kTableMagic));
+  header.version_ = kFormatVersion;
+  header.column_count_ = static_cast<uint32_t>(columns.size());
+  header.row_count_ = row_count;
+  header.name_offset_ =
+      sizeof(TableHeader) + columns.size() * sizeof(ColumnHeader);
+  header.name_size_ = table.name().size();
+  uint64_t offset = header.name_offset_ + header.name_size_;
+
+  std::vector<ColumnHeader> column_headers(columns.size());
+  for (size_t i = 0; i < columns.size(); ++i) {
+    column_headers[i].kind_ = static_cast<uint32_t>(columns[i].kind());
+    column_headers[i].name_size_ =
+        static_cast<uint32_t>(columns[i].name().size());
+    column_headers[i].name_offset_ = offset;
+    offset += columns[i].name().size();
+  }
+  for (size_t i = 0; i < columns.size(); ++i) {
+    if (columns[i].kind() == exec::Column::Kind::Text) {
+      column_headers[i].offsets_offset_ = align(offset);
+      offset = column_headers[i].offsets_offset_ +
+          (row_count + 1) * sizeof(uint64_t);
+      column_headers[i].values_size_ = columns[i].byte_size();
+    } else {
+      column_headers[i].values_size_ = row_count * sizeof(int);
+    }
+    column_headers[i].values_offset_ = align(offset);
+    offset = column_headers[i].values_offset_ + column_headers[i].values_size_;
+  }
+
+  Output output(writer);
+  output.append(&header, sizeof(header));
+  output.append(
+      column_headers.data(), column_headers.size() * sizeof(ColumnHeader));
+  output.append(table.name().data(), table.name().size());
+  for (const auto& column : columns) {
+    output.append(column.name().data(), column.name().size());
+  }
+  for (size_t i = 0; i < columns.size(); ++i) {
+    const auto& column = columns[i];
+    if (column.kind() == exec::Column::Kind::Text) {
+      output.pad_to(column_headers[i].offsets_offset_);
+      uint64_t text_offset = 0;
+      output.append(&text_offset, sizeof(text_offset));
+      for (size_t row = 0; row < row_count; ++row) {
+        text_offset += column.text(row).size();
+        output.append(&text_offset, sizeof(text_offset));
+      }
+      output.pad_to(column_headers[i].values_offset_);
+      for (size_t row = 0; row < row_count; ++row) {
+        const std::string_view text = column.text(row);
+        output.append(text.data(), text.size());
+      }
+    } else {
+      output.pad_to(column_headers[i].values_offset_);
+      if (column.kind() == exec::Column::Kind::Int) {
+        write_values<int>(column, output);
+      } else {
+        write_values<float>(column, output);
+      }
+    }
+  }
+}
+
+exec::TablePtr read_table_image(
+    std::shared_ptr<const void> owner,
+    const char* image,
+    size_t size,
+    const std::string& source) {
+  const auto check = [&source](bool condition) {
+    if (!condition) {
+      throw StorageError(source + " is damaged");
+    }
+  };
+  const auto in_image = [size](uint64_t offset, uint64_t length) {
+    return offset <= size && length <= size - offset;
+  };
+
+  check(size >= sizeof(TableHeader));
+  TableHeader header{};
+  std::memcpy(&header, image, sizeof(header));
+  check(std::memcmp(header.magic_, kTableMagic, sizeof(kTableMagic)) == 0);
+  check(header.version_ == kFormatVersion);
+  check(in_image(
+      sizeof(TableHeader),
+      uint64_t{header.column_count_} * sizeof(ColumnHeader)));
+  check(in_image(header.name_offset_, header.name_size_));
+  const uint64_t row_count = header.row_count_;
+
+  std::vector<exec::Column> columns;
+  columns.reserve(header.column_count_);
+  for (uint32_t i = 0; i < header.column_count_; ++i) {
+    ColumnHeader column{};
+    std::memcpy(
+        &column,
+        image + sizeof(TableHeader) + i * sizeof(ColumnHeader),
+        sizeof(column));
+    check(column.kind_ <= static_cast<uint32_t>(exec::Column::Kind::Text));
+    check(in_image(column.name_offset_, column.name_size_));
+    check(in_image(column.values_offset_, column.values_size_));
+    check(column.values_offset_ % kAlignment == 0);
+    const auto kind = exec::Column::Kind(column.kind_);
+    exec::Column::MappedData data{
+        owner, image + column.values_offset_, nullptr, row_count};
+    if (kind == exec::Column::Kind::Text) {
+      check(row_count < size / sizeof(uint64_t));
+      check(in_image(
+          column.offsets_offset_, (row_count + 1) * sizeof(uint64_t)));
+      check(column.offsets_offset_ % kAlignment == 0);
+      data.offsets_ =
+          reinterpret_cast<const uint64_t*>(image + column.offsets_offset_);
+      // Offsets are trusted to be ascending; checking each would mean
+      // reading the whole column up front.
+      check(
+          data.offsets_[0] == 0 &&
+          data.offsets_[row_count] == column.values_size_);
+    } else {
+      // A damaged row count could wrap the product around.
+      check(row_count <= size / sizeof(int));
+      check(column.values_size_ == row_count * sizeof(int));
+    }
+    columns.emplace_back(
+        std::string(image + column.name_offset_, column.name_size_),
+        kind,
+        std::move(data));
+  }
+  return std::make_shared<exec::Table>(
+      std::string(image + header.name_offset_, header.name_size_),
+      std::move(columns));
+}
+
+}  // namespace rdb::storage
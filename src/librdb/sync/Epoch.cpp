@@ -0,0 +1,96 @@
+#include <atomic>
+#include <librdb/sync/Epoch.hpp>
+#include <limits>
+
+namespace rdb::sync {
+
+namespace {
+
+// Epoch 0 marks a thread that isn't pinned.
+std::atomic<uint64_t> global_epoch{1};
+
+// The pinned epoch of one thread, on a cache line of its own. Records are
+// never freed: a record of an exited thread is reused by the next new one.
+struct alignas(64) ThreadRecord {
+  std::atomic<uint64_t> epoch_{0};
+  std::atomic<bool> in_use_{true};
+  ThreadRecord* next_ = nullptr;
+};
+
+std::atomic<ThreadRecord*> records{nullptr};
+
+ThreadRecord* acquire_record() {
+  for (ThreadRecord* record = records.load(); record != nullptr;
+       record = record->next_) {
+    bool in_use = false;
+    if (!record->in_use_.load(std::memory_order_relaxed) &&
+        record->in_use_.compare_exchange_strong(in_use, true)) {
+      return record;
+    }
+  }
+  auto* record = new ThreadRecord;
+  record->next_ = records.load();
+  while (!records.compare_exchange_weak(record->next_, record)) {
+  }
+  return record;
+}
+
+class ThreadState {
+ public:
+  ThreadState() : record_(acquire_record()) {}
+  ~ThreadState() { record_->in_use_.store(false); }
+
+  ThreadState(const ThreadState&) = delete;
+  ThreadState& operator=(const ThreadState&) = delete;
+
+  void pin() {
+    if (depth_++ == 0) {
+      // Sequentially consistent, so that a writer that doesn't see the pin
+      // published its changes before this thread reads them.
+      record_->epoch_.store(global_epoch.load());
+    }
+  }
+
+  void unpin() {
+    if (--depth_ == 0) {
+      record_->epoch_.store(0, std::memory_order_release);
+    }
+  }
+
+ private:
+  ThreadRecord* record_;
+  unsigned depth_ = 0;
+};
+
+ThreadState& thread_state() {
+  thread_local ThreadState state;
+  return state;
+}
+
+}  // namespace
+
+EpochGuard::EpochGuard() {
+  thread_state().pin();
+}
+
+EpochGuard::~EpochGuard() {
+  thread_state().unpin();
+}
+
+uint64_t advance_epoch() {
+  return global_epoch.fetch_add(1);
+}
+
+uint64_t oldest_pinned_epoch() {
+  uint64_t oldest = std::numeric_limits<uint64_t>::max();
+  for (const ThreadRecord* record = records.load(); record != nullptr;
+       record = record->next_) {
+    const uint64_t epoch = record->epoch_.load();
+    if (epoch != 0 && epoch < oldest) {
+      oldest = epoch;
+    }
+  }
+  return oldest;
+}
+
+}  // namespace rdb::sync
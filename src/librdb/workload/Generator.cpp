@@ -0,0 +1,481 @@
+#include <algorithm>
+#include <cmath>
+#include <librdb/workload/Generator.hpp>
+#include <utility>
+
+namespace rdb::workload {
+
+namespace {
+
+constexpr std::string_view kOperations[] = {"<", ">", "<=", ">=", "=", "!="};
+constexpr std::string_view kArithmetic[] = {"+", "-", "*", "/"};
+constexpr std::string_view kTextChars =
+    "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 ";
+
+// Relative frequencies of a plain SELECT, one of aggregates, one of
+// aggregates with GROUP BY and a JOIN.
+constexpr unsigned kSelectWeights[] = {6, 2, 2, 1};
+
+// Fractions of SELECTs with ORDER BY and with LIMIT.
+constexpr double kOrderByRate = 0.3;
+constexpr double kLimitRate = 0.2;
+constexpr size_t kMaxLimit = 100;
+
+// Relative frequencies of a comparison, AND, OR and NOT in a WHERE
+// condition. Below kMaxConditionDepth only comparisons are generated.
+constexpr unsigned kConditionWeights[] = {12, 3, 2, 1};
+constexpr size_t kMaxConditionDepth = 3;
+// Fraction of comparisons on INT and REAL columns that compute a value.
+constexpr double kArithmeticRate = 0.25;
+
+}  // namespace
+
+Generator::Generator(const GeneratorOptions& options)
+    : options_(options), state_(options.seed_) {
+  options_.tables_ = std::max<size_t>(options_.tables_, 1);
+  options_.max_columns_ = std::max<size_t>(options_.max_columns_, 1);
+  options_.distinct_values_ = std::max<size_t>(options_.distinct_values_, 1);
+  if (options_.skew_ > 0) {
+    rank_cdf_.reserve(options_.distinct_values_);
+    double total = 0;
+    for (size_t rank = 1; rank <= options_.distinct_values_; ++rank) {
+      total += 1 / std::pow(double(rank), options_.skew_);
+      rank_cdf_.push_back(total);
+    }
+    for (auto& probability : rank_cdf_) {
+      probability /= total;
+    }
+  }
+}
+
+std::string Generator::next_statement() {
+  if (transaction_writes_ != 0) {
+    return transaction_write();
+  }
+  if (tables_.size() < options_.tables_) {
+    return create_table();
+  }
+
+  const StatementMix& mix = options_.mix_;
+  const unsigned weights[] = {
+      mix.create_table_,
+      mix.drop_table_,
+      mix.insert_,
+      mix.select_,
+      mix.delete_,
+      mix.explain_,
+      mix.transaction_,
+      mix.analyze_};
+  // An INSERT if all weights are 0.
+  const size_t choice = weighted(weights, std::size(weights));
+
+  // Table churn stays between one table and twice the configured count.
+  if (choice == 0 && tables_.size() < 2 * options_.tables_) {
+    return create_table();
+  }
+  if (choice == 1 && tables_.size() > 1) {
+    return drop_table();
+  }
+
+  std::string statement;
+  switch (choice) {
+    case 3:
+      statement = select();
+      break;
+    case 4:
+      statement = delete_rows();
+      break;
+    case 5:
+      statement = explain();
+      break;
+    case 6:
+      transaction_writes_ = 2 + uniform(16);
+      return "BEGIN;";
+    case 7:
+      return analyze();
+    default:
+      statement = insert();
+      break;
+  }
+  if (options_.error_rate_ > 0 && chance(options_.error_rate_)) {
+    return inject_error(std::move(statement));
+  }
+  return statement;
+}
+
+size_t Generator::write(
+    std::ostream& out,
+    size_t max_statements,
+    size_t max_bytes) {
+  size_t statements = 0;
+  size_t bytes = 0;
+  while ((max_statements == 0 || statements < max_statements) &&
+         (max_bytes == 0 || bytes < max_bytes)) {
+    const std::string statement = next_statement();
+    out << statement << '\n';
+    bytes += statement.size() + 1;
+    ++statements;
+  }
+  return statements;
+}
+
+// splitmix64: tiny, fast and identical on every platform, unlike the
+// distributions of <random>.
+uint64_t Generator::next_random() {
+  uint64_t z = (state_ += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30U)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27U)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31U);
+}
+
+size_t Generator::uniform(size_t bound) {
+  return static_cast<size_t>(next_random() % bound);
+}
+
+size_t Generator::weighted(const unsigned* weights, size_t count) {
+  unsigned total = 0;
+  for (size_t i = 0; i < count; ++i) {
+    total += weights[i];
+  }
+  if (total == 0) {
+    return count;
+  }
+  auto point = static_cast<unsigned>(uniform(total));
+  size_t choice = 0;
+  while (point >= weights[choice]) {
+    point -= weights[choice++];
+  }
+  return choice;
+}
+
+bool Generator::chance(double probability) {
+  constexpr double kScale = 1.0 / double(uint64_t{1} << 53U);
+  return double(next_random() >> 11U) * kScale < probability;
+}
+
+std::string Generator::create_table() {
+  Table table{"T" + std::to_string(next_table_id_++), {}};
+  const size_t width = 1 + uniform(options_.max_columns_);
+  std::string statement = "CREATE TABLE " + table.name_ + " (";
+  for (size_t i = 0; i < width; ++i) {
+    const auto kind = static_cast<ColumnKind>(uniform(3));
+    table.columns_.push_back(kind);
+    statement += (i == 0 ? "C" : ", C") + std::to_string(i);
+    switch (kind) {
+      case ColumnKind::Int:
+        statement += " INT";
+        break;
+      case ColumnKind::Real:
+        statement += " REAL";
+        break;
+      case ColumnKind::Text:
+        statement += " TEXT";
+        break;
+    }
+  }
+  tables_.push_back(std::move(table));
+  return statement + ");";
+}
+
+std::string Generator::drop_table() {
+  const size_t index = uniform(tables_.size());
+  std::string statement = "DROP TABLE " + tables_[index].name_ + ";";
+  tables_.erase(tables_.begin() + static_cast<ptrdiff_t>(index));
+  return statement;
+}
+
+std::string Generator::insert() {
+  const Table& table = tables_[uniform(tables_.size())];
+  std::string columns;
+  std::string values;
+  for (size_t i = 0; i < table.columns_.size(); ++i) {
+    columns += (i == 0 ? "C" : ", C") + std::to_string(i);
+    values += (i == 0 ? "" : ", ") + literal(table.columns_[i]);
+  }
+  return "INSERT INTO " + table.name_ + " (" + columns + ") VALUES (" +
+         values + ");";
+}
+
+std::string Generator::select() {
+  const size_t index = uniform(tables_.size());
+  const Table& table = tables_[index];
+  const size_t choice = weighted(kSelectWeights, std::size(kSelectWeights));
+  if (choice == 1 || choice == 2) {
+    return aggregate_select(table, choice == 2);
+  }
+  if (choice == 3 && tables_.size() > 1) {
+    // Any other table.
+    const size_t right =
+        (index + 1 + uniform(tables_.size() - 1)) % tables_.size();
+    if (auto statement = join_select(table, tables_[right])) {
+      return std::move(*statement);
+    }
+  }
+  std::string statement = "SELECT";
+  const size_t forced = uniform(table.columns_.size());
+  for (size_t i = 0; i < table.columns_.size(); ++i) {
+    if (i == forced || chance(0.5)) {
+      statement += " C" + std::to_string(i);
+    }
+  }
+  statement += " FROM " + table.name_;
+  if (chance(0.5)) {
+    statement += where(table);
+  }
+  const size_t sort_column = uniform(table.columns_.size());
+  return statement + order_by("C" + std::to_string(sort_column)) + ";";
+}
+
+std::string Generator::aggregate_select(const Table& table, bool grouped) {
+  std::vector<std::string> items;
+  std::string group_by;
+  if (grouped) {
+    const size_t key = uniform(table.columns_.size());
+    items.push_back("C" + std::to_string(key));
+    group_by = " GROUP BY C" + std::to_string(key);
+    const size_t second_key = uniform(table.columns_.size());
+    if (second_key != key && chance(0.3)) {
+      group_by += " C" + std::to_string(second_key);
+      if (chance(0.5)) {
+        items.push_back("C" + std::to_string(second_key));
+      }
+    }
+  }
+  const size_t aggregates = 1 + uniform(3);
+  for (size_t i = 0; i < aggregates; ++i) {
+    items.push_back(aggregate(table));
+  }
+  std::string statement = "SELECT";
+  for (const auto& item : items) {
+    statement += " " + item;
+  }
+  statement += " FROM " + table.name_;
+  if (chance(0.5)) {
+    statement += where(table);
+  }
+  // Aggregate SELECTs are ordered by one of their items.
+  return statement + group_by + order_by(items[uniform(items.size())]) + ";";
+}
+
+// An equality on the left table keeps the output small, as for DELETE.
+std::optional<std::string> Generator::join_select(
+    const Table& left,
+    const Table& right) {
+  std::optional<std::pair<size_t, size_t>> keys;
+  const size_t left_start = uniform(left.columns_.size());
+  const size_t right_start = uniform(right.columns_.size());
+  for (size_t i = 0; i < left.columns_.size() && !keys; ++i) {
+    const size_t left_key = (left_start + i) % left.columns_.size();
+    for (size_t j = 0; j < right.columns_.size(); ++j) {
+      const size_t right_key = (right_start + j) % right.columns_.size();
+      if (left.columns_[left_key] == right.columns_[right_key]) {
+        keys.emplace(left_key, right_key);
+        break;
+      }
+    }
+  }
+  if (!keys) {
+    return std::nullopt;
+  }
+
+  const std::string left_prefix = left.name_ + ".";
+  const std::string right_prefix = right.name_ + ".";
+  std::string statement = "SELECT";
+  const size_t items = 1 + uniform(3);
+  for (size_t i = 0; i < items; ++i) {
+    const Table& side = chance(0.5) ? left : right;
+    statement += " " + side.name_ + ".C" +
+                 std::to_string(uniform(side.columns_.size()));
+  }
+  const size_t filter = uniform(left.columns_.size());
+  statement += " FROM " + left.name_ + " JOIN " + right.name_ + " ON " +
+               left_prefix + "C" + std::to_string(keys->first) + " = " +
+               right_prefix + "C" + std::to_string(keys->second) +
+               " WHERE " + left_prefix + "C" + std::to_string(filter) + " = " +
+               literal(left.columns_[filter]);
+  if (chance(0.3)) {
+    statement += " AND " + condition(left, 1, left_prefix);
+  }
+  const Table& sorted = chance(0.5) ? left : right;
+  const size_t sort_column = uniform(sorted.columns_.size());
+  return statement +
+         order_by(sorted.name_ + ".C" + std::to_string(sort_column)) + ";";
+}
+
+// ORDER BY `item` in a random direction some of the time, and LIMIT some
+// of the time.
+std::string Generator::order_by(const std::string& item) {
+  std::string clauses;
+  if (chance(kOrderByRate)) {
+    constexpr std::string_view kDirections[] = {"", " ASC", " DESC"};
+    clauses += " ORDER BY " + item +
+               std::string(kDirections[uniform(std::size(kDirections))]);
+  }
+  if (chance(kLimitRate)) {
+    clauses += " LIMIT " + std::to_string(uniform(kMaxLimit + 1));
+  }
+  return clauses;
+}
+
+// SUM only reads REAL columns: a SUM of INTs fails once it leaves the
+// range of INT, which a long workload would reach.
+std::string Generator::aggregate(const Table& table) {
+  const size_t column = uniform(table.columns_.size());
+  const ColumnKind kind = table.columns_[column];
+  const std::string name = "C" + std::to_string(column);
+  switch (uniform(5)) {
+    case 0:
+      return chance(0.5) ? "COUNT(*)" : "COUNT(" + name + ")";
+    case 1:
+      return "MIN(" + name + ")";
+    case 2:
+      return "MAX(" + name + ")";
+    case 3:
+      if (kind != ColumnKind::Text) {
+        return "AVG(" + name + ")";
+      }
+      break;
+    default:
+      if (kind == ColumnKind::Real) {
+        return "SUM(" + name + ")";
+      }
+      break;
+  }
+  return "COUNT(" + name + ")";
+}
+
+std::string Generator::delete_rows() {
+  const Table& table = tables_[uniform(tables_.size())];
+  // Equality keeps deletes selective, so tables keep growing.
+  const size_t column = uniform(table.columns_.size());
+  return "DELETE FROM " + table.name_ + " WHERE C" + std::to_string(column) +
+         " = " + literal(table.columns_[column]) + ";";
+}
+
+std::string Generator::explain() {
+  return std::string(chance(0.5) ? "EXPLAIN ANALYZE " : "EXPLAIN ") + select();
+}
+
+// Only DML, so that the tables stay as the other statements expect them
+// whether the transaction commits or rolls back.
+std::string Generator::transaction_write() {
+  if (--transaction_writes_ == 0) {
+    return chance(0.9) ? "COMMIT;" : "ROLLBACK;";
+  }
+  const StatementMix& mix = options_.mix_;
+  std::string statement =
+      uniform(mix.insert_ + mix.delete_ + 1) < mix.delete_ ? delete_rows()
+                                                           : insert();
+  if (options_.error_rate_ > 0 && chance(options_.error_rate_)) {
+    return inject_error(std::move(statement));
+  }
+  return statement;
+}
+
+std::string Generator::analyze() {
+  return "ANALYZE " + tables_[uniform(tables_.size())].name_ + ";";
+}
+
+std::string Generator::where(const Table& table) {
+  return " WHERE " + condition(table, 0, "");
+}
+
+// Nested conditions are parenthesized, so the text nests as generated.
+std::string Generator::condition(
+    const Table& table,
+    size_t depth,
+    const std::string& prefix) {
+  const size_t choice =
+      depth < kMaxConditionDepth
+          ? weighted(kConditionWeights, std::size(kConditionWeights))
+          : 0;
+  switch (choice) {
+    case 1:
+    case 2: {
+      const std::string first = condition(table, depth + 1, prefix);
+      const std::string second = condition(table, depth + 1, prefix);
+      const std::string both =
+          first + (choice == 1 ? " AND " : " OR ") + second;
+      return depth == 0 ? both : "(" + both + ")";
+    }
+    case 3:
+      return "NOT " + condition(table, depth + 1, prefix);
+    default:
+      return comparison(table, prefix);
+  }
+}
+
+std::string Generator::comparison(
+    const Table& table,
+    const std::string& prefix) {
+  const size_t column = uniform(table.columns_.size());
+  const ColumnKind kind = table.columns_[column];
+  std::string value = prefix + "C" + std::to_string(column);
+  if (kind != ColumnKind::Text && chance(kArithmeticRate)) {
+    const std::string_view operation =
+        kArithmetic[uniform(std::size(kArithmetic))];
+    // Literals aren't negative, so a divisor of at least 1 is never 0.
+    const std::string operand =
+        operation == "/" ? std::to_string(1 + value_rank()) : literal(kind);
+    value += " " + std::string(operation) + " " + operand;
+  }
+  const std::string_view comparison =
+      kOperations[uniform(std::size(kOperations))];
+  return value + " " + std::string(comparison) + " " + literal(kind);
+}
+
+std::string Generator::literal(ColumnKind kind) {
+  switch (kind) {
+    case ColumnKind::Int:
+      return std::to_string(value_rank());
+    case ColumnKind::Real: {
+      const size_t hundredths = uniform(100);
+      return std::to_string(value_rank()) + (hundredths < 10 ? ".0" : ".") +
+             std::to_string(hundredths);
+    }
+    case ColumnKind::Text:
+      return text_literal();
+  }
+  return "0";
+}
+
+std::string Generator::text_literal() {
+  const size_t length = options_.long_string_rate_ > 0 &&
+                                chance(options_.long_string_rate_)
+                            ? options_.long_string_length_
+                            : uniform(options_.max_string_length_ + 1);
+  std::string text = "\"";
+  for (size_t i = 0; i < length; ++i) {
+    text += kTextChars[uniform(kTextChars.size())];
+  }
+  return text + "\"";
+}
+
+size_t Generator::value_rank() {
+  if (rank_cdf_.empty()) {
+    return uniform(options_.distinct_values_);
+  }
+  constexpr double kScale = 1.0 / double(uint64_t{1} << 53U);
+  const double point = double(next_random() >> 11U) * kScale;
+  const auto it = std::lower_bound(rank_cdf_.begin(), rank_cdf_.end(), point);
+  return std::min<size_t>(
+      static_cast<size_t>(it - rank_cdf_.begin()), rank_cdf_.size() - 1);
+}
+
+// The statement keeps its semicolon, so the parser recovers right after it
+// and every injected error costs exactly one statement.
+std::string Generator::inject_error(std::string statement) {
+  const size_t first_space = statement.find(' ');
+  if (chance(0.5)) {
+    statement.insert(first_space, " (");
+  } else {
+    std::transform(
+        statement.begin(),
+        statement.begin() + static_cast<ptrdiff_t>(first_space),
+        statement.begin(),
+        [](char c) { return static_cast<char>(c - 'A' + 'a'); });
+  }
+  return statement;
+}
+
+}  // namespace rdb::workload
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <librdb/exec/Executor.hpp>
+#include <librdb/sql/Parser.hpp>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rdb::test {
+
+// A line per row, with a space after every cell.
+inline std::string rows_to_str(const exec::Result& result) {
+  std::stringstream out;
+  for (const auto& row : result.rows_) {
+    for (const auto& cell : row) {
+      out << exec::cell_to_str(cell) << " ";
+    }
+    out << "\n";
+  }
+  return out.str();
+}
+
+// Runs every statement of the script through `execute` and prints the rows
+// of each result or the ExecutionError it throws.
+template <typename Execute>
+std::string run_script(std::string_view sql, Execute execute) {
+  const sql::TokenBuffer tokens(sql);
+  sql::Parser parser(tokens);
+  const sql::Parser::Result parsed = parser.parse_sql_script();
+  std::string out;
+  for (const auto& statement : parsed.script_.statements_) {
+    try {
+      out += rows_to_str(execute(*statement));
+    } catch (const exec::ExecutionError& e) {
+      out += std::string(e.what()) + "\n";
+    }
+  }
+  return out;
+}
+
+inline std::string run_script(exec::Executor& executor, std::string_view sql) {
+  return run_script(sql, [&executor](const sql::Statement& statement) {
+    return executor.execute(statement);
+  });
+}
+
+// Every `step`-th of `rows` rows, from the first.
+inline std::vector<size_t> every(size_t step, size_t rows) {
+  std::vector<size_t> selection;
+  for (size_t row = 0; row < rows; row += step) {
+    selection.push_back(row);
+  }
+  return selection;
+}
+
+}  // namespace rdb::test
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <librdb/exec/Aggregation.hpp>
+#include <librdb/exec/Table.hpp>
+#include <librdb/sql/Parser.hpp>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+using rdb::exec::Cell;
+using rdb::exec::Column;
+
+rdb::sql::SelectStatementPtr parse_select(std::string_view sql) {
+  rdb::sql::Lexer lexer(sql);
+  rdb::sql::Parser parser(lexer);
+  rdb::sql::Parser::Result result = parser.parse_sql_script();
+  EXPECT_TRUE(result.errors_.empty());
+  auto& statement = result.script_.statements_.at(0);
+  return rdb::sql::SelectStatementPtr(
+      static_cast<const rdb::sql::SelectStatement*>(statement.release()));
+}
+
+// Rows spanning many blocks, with a last block that isn't full.
+rdb::exec::Table make_table(size_t rows) {
+  rdb::exec::Table table(
+      "T",
+      {Column("Id", Column::Kind::Int),
+       Column("Group", Column::Kind::Int),
+       Column("Name", Column::Kind::Text),
+       Column("Price", Column::Kind::Real)});
+  for (size_t row = 0; row < rows; ++row) {
+    const int id = static_cast<int>(row);
+    table.append_row(
+        {id - 1000, id % 13 - 6, std::string(1, char('a' + id % 5)),
+         static_cast<float>(id % 100) / 4});
+  }
+  return table;
+}
+
+}  // namespace
+
+TEST(AggregationSuite, WorkersMergePartialResults) {
+  const size_t rows = rdb::exec::kBlockRows * 9 + 123;
+  const rdb::exec::Table table = make_table(rows);
+  const auto statement = parse_select(
+      "SELECT Name Group COUNT(*) SUM(Id) MIN(Price) MAX(Id) AVG(Price) "
+      "FROM T GROUP BY Group Name;");
+  const rdb::exec::Aggregation aggregation(table, *statement);
+
+  // Every other row, so that blocks are aggregated from partial selections.
+  std::vector<size_t> selection;
+  for (size_t row = 0; row < rows; row += 2) {
+    selection.push_back(row);
+  }
+
+  struct Expected {
+    int count_ = 0;
+    int sum_ = 0;
+    float min_ = 1e9F;
+    int max_ = -1'000'000;
+    double price_sum_ = 0;
+  };
+  std::map<std::tuple<int, std::string>, Expected> groups;
+  for (const size_t row : selection) {
+    const int id = static_cast<int>(row);
+    const float price = static_cast<float>(id % 100) / 4;
+    Expected& expected =
+        groups[{id % 13 - 6, std::string(1, char('a' + id % 5))}];
+    ++expected.count_;
+    expected.sum_ += id - 1000;
+    expected.min_ = std::min(expected.min_, price);
+    expected.max_ = std::max(expected.max_, id - 1000);
+    expected.price_sum_ += price;
+  }
+  std::vector<std::vector<Cell>> expected_rows;
+  for (const auto& [key, expected] : groups) {
+    expected_rows.push_back(
+        {std::get<1>(key), std::get<0>(key), expected.count_, expected.sum_,
+         expected.min_, expected.max_,
+         static_cast<float>(expected.price_sum_ / expected.count_)});
+  }
+
+  for (const size_t workers : {1, 2, 3, 8}) {
+    EXPECT_EQ(expected_rows, aggregation.run(selection, workers)) << workers;
+  }
+}
+
+TEST(AggregationSuite, UngroupedReductions) {
+  const size_t rows = rdb::exec::kBlockRows * 5 + 7;
+  const rdb::exec::Table table = make_table(rows);
+  const auto statement = parse_select(
+      "SELECT COUNT(*) SUM(Id) MIN(Id) MAX(Price) MIN(Name) AVG(Id) FROM T;");
+  const rdb::exec::Aggregation aggregation(table, *statement);
+
+  std::vector<size_t> all(rows);
+  for (size_t row = 0; row < rows; ++row) {
+    all[row] = row;
+  }
+  int64_t sum = 0;
+  for (size_t row = 0; row < rows; ++row) {
+    sum += static_cast<int>(row) - 1000;
+  }
+  const std::vector<std::vector<Cell>> expected = {
+      {static_cast<int>(rows), static_cast<int>(sum), -1000, 24.75F,
+       std::string("a"), static_cast<float>(static_cast<double>(sum) / rows)}};
+  for (const size_t workers : {1, 4}) {
+    EXPECT_EQ(expected, aggregation.run(all, workers)) << workers;
+  }
+
+  const std::vector<std::vector<Cell>> empty = {
+      {0, 0, 0, 0.0F, std::string(), 0.0F}};
+  EXPECT_EQ(empty, aggregation.run({}, 4));
+}
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <librdb/exec/Catalog.hpp>
+#include <librdb/sync/Epoch.hpp>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using rdb::exec::Column;
+using rdb::exec::Table;
+
+rdb::exec::TablePtr make_table(const std::string& name) {
+  std::vector<Column> columns;
+  columns.emplace_back("Id", Column::Kind::Int);
+  return std::make_shared<Table>(name, std::move(columns));
+}
+
+}  // namespace
+
+TEST(CatalogSuite, CreateDropTest) {
+  rdb::exec::Catalog catalog;
+  EXPECT_TRUE(catalog.create(make_table("B")));
+  EXPECT_TRUE(catalog.create(make_table("A")));
+  EXPECT_TRUE(catalog.create(make_table("C")));
+  EXPECT_FALSE(catalog.create(make_table("A")));
+
+  const rdb::sync::EpochGuard guard;
+  const Table* b = catalog.find("B");
+  ASSERT_NE(nullptr, b);
+  EXPECT_EQ("B", b->name());
+  EXPECT_EQ(nullptr, catalog.find("D"));
+
+  EXPECT_TRUE(catalog.drop("B"));
+  EXPECT_FALSE(catalog.drop("B"));
+  EXPECT_EQ(nullptr, catalog.find("B"));
+  // The dropped table lives on while the thread is pinned.
+  EXPECT_EQ(1, b->columns().size());
+
+  std::vector<std::string> names;
+  for (const auto& table : catalog.tables()) {
+    names.push_back(table->name());
+  }
+  EXPECT_EQ((std::vector<std::string>{"A", "C"}), names);
+}
+
+TEST(CatalogSuite, RetireDroppedTableTest) {
+  rdb::exec::Catalog catalog;
+  rdb::exec::TablePtr table = make_table("A");
+  const std::weak_ptr<const Table> weak = table;
+  ASSERT_TRUE(catalog.create(std::move(table)));
+  {
+    const rdb::sync::EpochGuard guard;
+    const Table* a = catalog.find("A");
+    ASSERT_TRUE(catalog.drop("A"));
+    catalog.reclaim();
+    EXPECT_FALSE(weak.expired());
+    EXPECT_EQ("A", a->name());
+  }
+  // Released once the reader left, without another CREATE or DROP.
+  catalog.reclaim();
+  EXPECT_TRUE(weak.expired());
+
+  // Nothing is pinned, so DROP releases the table itself.
+  table = make_table("B");
+  const std::weak_ptr<const Table> unused = table;
+  ASSERT_TRUE(catalog.create(std::move(table)));
+  ASSERT_TRUE(catalog.drop("B"));
+  EXPECT_TRUE(unused.expired());
+}
+
+TEST(CatalogSuite, ConcurrentLookupTest) {
+  rdb::exec::Catalog catalog;
+  ASSERT_TRUE(catalog.create(make_table("Stable")));
+  std::atomic<bool> stop{false};
+  std::atomic<size_t> mismatches{0};
+  std::vector<std::thread> readers;
+  for (int reader = 0; reader < 4; ++reader) {
+    readers.emplace_back([&] {
+      while (!stop) {
+        const rdb::sync::EpochGuard guard;
+        const auto stable = catalog.find("Stable");
+        const auto churn = catalog.find("Churn");
+        if (stable == nullptr || stable->name() != "Stable" ||
+            (churn != nullptr && churn->columns().size() != 1)) {
+          ++mismatches;
+        }
+      }
+    });
+  }
+  for (int i = 0; i < 2000; ++i) {
+    ASSERT_TRUE(catalog.create(make_table("Churn")));
+    ASSERT_TRUE(catalog.drop("Churn"));
+  }
+  stop = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(0, mismatches);
+  EXPECT_EQ(1, catalog.tables().size());
+}
@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+#include <librdb/exec/Encoding.hpp>
+#include <librdb/exec/Table.hpp>
+#include <random>
+#include <vector>
+
+namespace {
+
+using rdb::exec::Column;
+using rdb::exec::EncodedBlock;
+using rdb::exec::Encoding;
+using Operation = rdb::sql::Expression::Operation;
+
+constexpr Operation kOperations[] = {
+    Operation::Less,
+    Operation::LessEq,
+    Operation::Equal,
+    Operation::NotEqual,
+    Operation::GreaterEq,
+    Operation::Greater};
+
+template <typename T>
+bool holds(T lhs, Operation operation, T rhs) {
+  switch (operation) {
+    case Operation::Less:
+      return lhs < rhs;
+    case Operation::LessEq:
+      return lhs <= rhs;
+    case Operation::Equal:
+      return lhs == rhs;
+    case Operation::NotEqual:
+      return lhs != rhs;
+    case Operation::GreaterEq:
+      return lhs >= rhs;
+    case Operation::Greater:
+      return lhs > rhs;
+  }
+  return false;
+}
+
+std::vector<uint32_t> keys_of(const std::vector<int>& values) {
+  std::vector<uint32_t> keys;
+  for (const int value : values) {
+    keys.push_back(rdb::exec::to_key(value));
+  }
+  return keys;
+}
+
+// Checks decoding and every comparison with every value in the block and
+// its neighbours as the constant.
+void check_block(const std::vector<int>& values, Encoding expected) {
+  const std::vector<uint32_t> keys = keys_of(values);
+  const EncodedBlock block = EncodedBlock::encode(keys.data(), keys.size());
+  EXPECT_EQ(block.encoding(), expected);
+  ASSERT_EQ(block.size(), values.size());
+
+  std::vector<uint32_t> decoded(keys.size());
+  block.decode(decoded.data());
+  EXPECT_EQ(decoded, keys);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    EXPECT_EQ(block.at(i), keys[i]);
+  }
+
+  std::vector<int> constants;
+  for (const int value : values) {
+    constants.insert(constants.end(), {value - 1, value, value + 1});
+  }
+  for (const int constant : constants) {
+    for (const Operation operation : kOperations) {
+      std::vector<size_t> expected_rows;
+      for (size_t i = 0; i < values.size(); ++i) {
+        if (holds(values[i], operation, constant)) {
+          expected_rows.push_back(100 + i);
+        }
+      }
+      std::vector<size_t> rows;
+      block.filter(operation, rdb::exec::to_key(constant), 100, rows);
+      EXPECT_EQ(rows, expected_rows) << "constant " << constant;
+    }
+  }
+}
+
+}  // namespace
+
+TEST(EncodingSuite, KeysKeepOrder) {
+  const std::vector<int> ints = {-2147483647 - 1, -5, -1, 0, 1, 7, 2147483647};
+  for (size_t i = 0; i + 1 < ints.size(); ++i) {
+    EXPECT_LT(rdb::exec::to_key(ints[i]), rdb::exec::to_key(ints[i + 1]));
+    EXPECT_EQ(rdb::exec::from_key<int>(rdb::exec::to_key(ints[i])), ints[i]);
+  }
+  const std::vector<float> floats = {-1e30F, -2.5F, -0.25F, 0.0F, 0.5F, 3e20F};
+  for (size_t i = 0; i + 1 < floats.size(); ++i) {
+    EXPECT_LT(rdb::exec::to_key(floats[i]), rdb::exec::to_key(floats[i + 1]));
+    EXPECT_EQ(
+        rdb::exec::from_key<float>(rdb::exec::to_key(floats[i])), floats[i]);
+  }
+}
+
+TEST(EncodingSuite, RunLength) {
+  std::vector<int> values;
+  for (int run = 0; run < 10; ++run) {
+    values.insert(values.end(), 50, run % 3 - 1);
+  }
+  check_block(values, Encoding::RunLength);
+}
+
+TEST(EncodingSuite, Delta) {
+  std::vector<int> values;
+  for (int i = 0; i < 300; ++i) {
+    values.push_back(-1'000'000 + i * 7'919);
+  }
+  check_block(values, Encoding::Delta);
+}
+
+TEST(EncodingSuite, FrameOfReference) {
+  std::mt19937 random(42);
+  std::uniform_int_distribution<int> distribution(-20, 20);
+  std::vector<int> values;
+  for (int i = 0; i < 300; ++i) {
+    values.push_back(-50'000 + distribution(random));
+  }
+  check_block(values, Encoding::FrameOfReference);
+}
+
+TEST(EncodingSuite, Plain) {
+  std::mt19937 random(7);
+  std::uniform_int_distribution<int> distribution;
+  std::vector<int> values;
+  for (int i = 0; i < 200; ++i) {
+    values.push_back(distribution(random) - distribution(random));
+  }
+  check_block(values, Encoding::Plain);
+}
+
+TEST(EncodingSuite, ColumnFiltersEncodedBlocks) {
+  Column ints("Id", Column::Kind::Int);
+  Column reals("Price", Column::Kind::Real);
+  const size_t rows = rdb::exec::kBlockRows * 2 + 100;
+  for (size_t row = 0; row < rows; ++row) {
+    ints.push_back(static_cast<int>(row % 1000) - 500);
+    reals.push_back(static_cast<float>(row) / 4 - 100);
+  }
+  ASSERT_EQ(ints.block_count(), 3);
+  EXPECT_TRUE(ints.block_encoding(0));
+  EXPECT_FALSE(ints.block_encoding(2));
+  EXPECT_LT(ints.byte_size(), rows * sizeof(int));
+  EXPECT_LT(reals.byte_size(), rows * sizeof(float));
+
+  rdb::exec::ColumnReader reader(reals);
+  for (size_t row = 0; row < rows; ++row) {
+    ASSERT_EQ(
+        std::get<float>(reader.at(row)), static_cast<float>(row) / 4 - 100);
+  }
+
+  for (const Operation operation : kOperations) {
+    std::vector<size_t> expected_ints;
+    std::vector<size_t> expected_reals;
+    for (size_t row = 0; row < rows; ++row) {
+      if (holds(std::get<int>(ints.at(row)), operation, -3)) {
+        expected_ints.push_back(row);
+      }
+      if (holds(std::get<float>(reals.at(row)), operation, 1000.25F)) {
+        expected_reals.push_back(row);
+      }
+    }
+    std::vector<size_t> int_rows;
+    std::vector<size_t> real_rows;
+    for (size_t block = 0; block < ints.block_count(); ++block) {
+      ints.filter_block(block, operation, -3, int_rows);
+      reals.filter_block(block, operation, 1000.25F, real_rows);
+    }
+    EXPECT_EQ(int_rows, expected_ints);
+    EXPECT_EQ(real_rows, expected_reals);
+  }
+
+  std::vector<bool> erase_mask(rows);
+  for (size_t row = 0; row < rows; row += 2) {
+    erase_mask[row] = true;
+  }
+  ints.erase_rows(erase_mask);
+  ASSERT_EQ(ints.size(), rows / 2);
+  EXPECT_EQ(std::get<int>(ints.at(0)), -499);
+  EXPECT_EQ(
+      std::get<int>(ints.at(rows / 2 - 1)),
+      static_cast<int>((rows - 1) % 1000) - 500);
+}
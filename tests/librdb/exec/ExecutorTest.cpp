@@ -0,0 +1,746 @@
+#include <gtest/gtest.h>
+#include <librdb/exec/Executor.hpp>
+#include <librdb/sql/Parser.hpp>
+#include <librdb/sync/Epoch.hpp>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace {
+
+std::string run_script(rdb::exec::Executor& executor, std::string_view sql) {
+  rdb::sql::Lexer lexer(sql);
+  rdb::sql::Parser parser(lexer);
+  const rdb::sql::Parser::Result parsed = parser.parse_sql_script();
+  std::stringstream out;
+  for (const auto& i : parsed.errors_) {
+    out << i << "\n";
+  }
+  for (const auto& statement : parsed.script_.statements_) {
+    try {
+      const rdb::exec::Result result = executor.execute(*statement);
+      if (result.column_names_.empty()) {
+        out << "OK " << result.affected_rows_ << "\n";
+        continue;
+      }
+      for (const auto& row : result.rows_) {
+        for (const auto& cell : row) {
+          out << rdb::exec::cell_to_str(cell) << " ";
+        }
+        out << "\n";
+      }
+    } catch (const rdb::exec::ExecutionError& e) {
+      out << e.what() << "\n";
+    }
+  }
+  return out.str();
+}
+
+}  // namespace
+
+TEST(ExecutorSuite, InsertSelectTest) {
+  rdb::exec::Catalog catalog;
+  rdb::exec::Executor executor(catalog);
+  const std::string output = run_script(
+      executor,
+      "CREATE TABLE T (Id INT, Price REAL, Name TEXT);"
+      "INSERT INTO T (Id, Price, Name) VALUES (1, 2.5, \"one\");"
+      "INSERT INTO T (Name, Id) VALUES (\"two\", 2);"
+      "INSERT INTO T (Id, Price) VALUES (3, 4);"
+      "SELECT Name Id FROM T;"
+      "SELECT Id FROM T WHERE Price >= 2.5;"
+      "SELECT Id FROM T WHERE Name = \"two\";"
+      "SELECT Id FROM T WHERE 2 < Id;");
+  const std::string expected =
+      "OK 0\n"
+      "OK 1\n"
+      "OK 1\n"
+      "OK 1\n"
+      "one 1 \n"
+      "two 2 \n"
+      " 3 \n"
+      "1 \n"
+      "3 \n"
+      "2 \n"
+      "3 \n";
+  EXPECT_EQ(expected, output);
+}
+
+TEST(ExecutorSuite, DeleteDropTest) {
+  rdb::exec::Catalog catalog;
+  rdb::exec::Executor executor(catalog);
+  const std::string output = run_script(
+      executor,
+      "CREATE TABLE T (Id INT);"
+      "INSERT INTO T (Id) VALUES (1);"
+      "INSERT INTO T (Id) VALUES (2);"
+      "INSERT INTO T (Id) VALUES (3);"
+      "DELETE FROM T WHERE Id != 2;"
+      "SELECT Id FROM T;"
+      "DELETE FROM T;"
+      "SELECT Id FROM T;"
+      "DROP TABLE T;"
+      "SELECT Id FROM T;");
+  const std::string expected =
+      "OK 0\n"
+      "OK 1\n"
+      "OK 1\n"
+      "OK 1\n"
+      "OK 2\n"
+      "2 \n"
+      "OK 1\n"
+      "OK 0\n"
+      "Unknown table T\n";
+  EXPECT_EQ(expected, output);
+}
+
+TEST(ExecutorSuite, DropReleasesTableTest) {
+  rdb::exec::Catalog catalog;
+  rdb::exec::Executor executor(catalog);
+  run_script(executor, "CREATE TABLE T (Id INT); CREATE TABLE U (Id INT);");
+  std::weak_ptr<const rdb::exec::Table> table = catalog.tables().back();
+  {
+    // A reader pinned while the table is dropped.
+    const rdb::sync::EpochGuard guard;
+    EXPECT_EQ("OK 0\n", run_script(executor, "DROP TABLE U;"));
+  }
+  EXPECT_FALSE(table.expired());
+  // The next statement frees it, although it's no CREATE or DROP.
+  EXPECT_EQ("", run_script(executor, "SELECT Id FROM T;"));
+  EXPECT_TRUE(table.expired());
+}
+
+TEST(ExecutorSuite, ErrorsTest) {
+  rdb::exec::Catalog catalog;
+  rdb::exec::Executor executor(catalog);
+  const std::string output = run_script(
+      executor,
+      "CREATE TABLE T (Id INT, Id TEXT);"
+      "CREATE TABLE T (Id INT, Name TEXT);"
+      "CREATE TABLE T (Id INT);"
+      "INSERT INTO T (Id) VALUES (1.5);"
+      "INSERT INTO T (Id, Name) VALUES (1);"
+      "INSERT INTO T (Age) VALUES (1);"
+      "SELECT Age FROM T;"
+      "SELECT Id FROM T WHERE Name > 1;"
+      "DROP TABLE Missing;");
+  const std::string expected =
+      "Duplicate column Id\n"
+      "OK 0\n"
+      "Table T already exists\n"
+      "Column Id expects INT\n"
+      "Expected 2 values, got 1\n"
+      "Unknown column Age\n"
+      "Unknown column Age\n"
+      "Can't compare Name with 1\n"
+      "Unknown table Missing\n";
+  EXPECT_EQ(expected, output);
+}
+
+TEST(ExecutorSuite, ExplainTest) {
+  rdb::exec::Catalog catalog;
+  rdb::exec::Executor executor(catalog);
+  const std::string output = run_script(
+      executor,
+      "CREATE TABLE T (Id INT, Name TEXT);"
+      "INSERT INTO T (Id, Name) VALUES (1, \"one\");"
+      "INSERT INTO T (Id, Name) VALUES (2, \"two\");"
+      "EXPLAIN SELECT Name FROM T WHERE Id > 1;"
+      "EXPLAIN DELETE FROM T;"
+      "EXPLAIN INSERT INTO T (Id) VALUES (3);"
+      "EXPLAIN DROP TABLE T;"
+      "EXPLAIN SELECT Age FROM T;"
+      "SELECT Id FROM T;");
+  const std::string expected =
+      "OK 0\n"
+      "OK 1\n"
+      "OK 1\n"
+      "Project Name \n"
+      "    -> Seq Scan on T \n"
+      "         Workers: 1 \n"
+      "         Filter: Id > 1 \n"
+      "Delete on T \n"
+      "    -> Seq Scan on T \n"
+      "         Workers: 1 \n"
+      "Insert on T \n"
+      "Drop Table T \n"
+      "Unknown column Age\n"
+      "1 \n"
+      "2 \n";
+  EXPECT_EQ(expected, output);
+}
+
+TEST(ExecutorSuite, ExplainAnalyzeTest) {
+  rdb::exec::Catalog catalog;
+  rdb::exec::Executor executor(catalog);
+  run_script(
+      executor,
+      "CREATE TABLE T (Id INT, Name TEXT);"
+      "INSERT INTO T (Id, Name) VALUES (1, \"one\");"
+      "INSERT INTO T (Id, Name) VALUES (2, \"three\");");
+  std::string output = run_script(
+      executor,
+      "EXPLAIN ANALYZE SELECT Name FROM T WHERE Id > 1;"
+      "EXPLAIN ANALYZE DELETE FROM T WHERE Id = 1;"
+      "SELECT Id FROM T;");
+  output = std::regex_replace(output, std::regex("time=[0-9.]+ ms"), "time=X");
+  const std::string expected =
+      "Project Name (time=X rows_in=1 rows_out=1 blocks=1 bytes=5) \n"
+      "    -> Seq Scan on T (time=X rows_in=2 rows_out=1 blocks=1 bytes=8) \n"
+      "         Workers: 1 \n"
+      "         Filter: Id > 1 \n"
+      "Delete on T (time=X rows_in=1 rows_out=1 blocks=2 bytes=9) \n"
+      "    -> Seq Scan on T (time=X rows_in=2 rows_out=1 blocks=1 bytes=8) \n"
+      "         Workers: 1 \n"
+      "         Filter: Id = 1 \n"
+      "2 \n";
+  EXPECT_EQ(expected, output);
+}
+
+TEST(ExecutorSuite, ConditionTest) {
+  rdb::exec::Catalog catalog;
+  rdb::exec::Executor executor(catalog);
+  const std::string output = run_script(
+      executor,
+      "CREATE TABLE T (Id INT, Price REAL, Name TEXT);"
+      "INSERT INTO T (Id, Price, Name) VALUES (1, 2.5, \"one\");"
+      "INSERT INTO T (Id, Price, Name) VALUES (2, 0.5, \"two\");"
+      "INSERT INTO T (Id, Price, Name) VALUES (3, 4, \"three\");"
+      "INSERT INTO T (Id, Price, Name) VALUES (0, 1, \"zero\");"
+      "SELECT Id FROM T WHERE Id > 1 AND Price < 3;"
+      "SELECT Id FROM T WHERE Id = 1 OR Name = \"three\";"
+      "SELECT Id FROM T WHERE NOT (Id >= 1 AND Id <= 2);"
+      "SELECT Id FROM T WHERE Id * 2 + 1 = 5 OR Price * 2 = Id;"
+      "SELECT Id FROM T WHERE 7 / 2 = 3 AND Id / 2 > Price;"
+      "SELECT Id FROM T WHERE Id != 0 AND 6 / Id = 3;"
+      "SELECT Id FROM T WHERE 6 / Id = 3;"
+      "SELECT Id FROM T WHERE Price / 0 > 1;"
+      "SELECT Id FROM T WHERE Id -1 >= 1;"
+      "SELECT Id FROM T WHERE Name + 1 > 2;"
+      "SELECT Id FROM T WHERE Id > 1 OR Name > 1;"
+      "DELETE FROM T WHERE Id = 0 OR Price > 2 AND NOT Name = \"one\";"
+      "SELECT Id FROM T;");
+  const std::string expected =
+      "OK 0\n"
+      "OK 1\n"
+      "OK 1\n"
+      "OK 1\n"
+      "OK 1\n"
+      "2 \n"
+      "1 \n"
+      "3 \n"
+      "3 \n"
+      "0 \n"
+      "2 \n"
+      "2 \n"
+      "2 \n"
+      "Division by zero\n"
+      "1 \n"
+      "2 \n"
+      "3 \n"
+      "0 \n"
+      "2 \n"
+      "3 \n"
+      "Can't compute Name + 1 on TEXT\n"
+      "Can't compare Name with 1\n"
+      "OK 2\n"
+      "1 \n"
+      "2 \n";
+  EXPECT_EQ(expected, output);
+}
+
+// Conditions over several encoded blocks against the same conditions
+// evaluated row by row.
+TEST(ExecutorSuite, ConditionBlocksTest) {
+  rdb::exec::Catalog catalog;
+  rdb::exec::Executor executor(catalog);
+  std::string script = "CREATE TABLE T (Id INT, Group INT, Price REAL);";
+  constexpr int kRows = 10'000;
+  for (int id = 0; id < kRows; ++id) {
+    script += "INSERT INTO T (Id, Group, Price) VALUES (" + std::to_string(id) +
+              ", " + std::to_string(id / 1000 - 5) + ", " +
+              std::to_string(id % 7) + ".5);";
+  }
+  run_script(executor, script);
+
+  const auto expect_rows = [&executor](
+                               std::string_view condition,
+                               const auto& matches) {
+    std::string expected;
+    for (int id = 0; id < kRows; ++id) {
+      if (matches(id, id / 1000 - 5, id % 7 + 0.5)) {
+        expected += std::to_string(id) + " \n";
+      }
+    }
+    EXPECT_EQ(
+        expected,
+        run_script(
+            executor,
+            "SELECT Id FROM T WHERE " + std::string(condition) + ";"))
+        << condition;
+  };
+  expect_rows("Group = 0 OR Id > 9000", [](int id, int group, double) {
+    return group == 0 || id > 9000;
+  });
+  expect_rows(
+      "Group < 0 AND Price > 5 AND NOT Id / 3 * 3 = Id",
+      [](int id, int group, double price) {
+        return group < 0 && price > 5 && id / 3 * 3 != id;
+      });
+  expect_rows(
+      "Id * Group - Price > 1000 OR Id < 5",
+      [](int id, int group, double price) {
+        return id * group - price > 1000 || id < 5;
+      });
+}
+
+// TEXT equality skips the blocks whose bloom filter rules the text out.
+TEST(ExecutorSuite, TextBloomFilterTest) {
+  rdb::exec::Catalog catalog;
+  rdb::exec::Executor executor(catalog);
+  std::string script = "CREATE TABLE T (Id INT, Key TEXT);";
+  constexpr int kRows = 10'000;
+  for (int id = 0; id < kRows; ++id) {
+    script += "INSERT INTO T (Id, Key) VALUES (" + std::to_string(id) +
+              ", \"key-" + std::to_string(id) + "\");";
+  }
+  run_script(executor, script);
+  EXPECT_EQ(
+      "5000 \n",
+      run_script(executor, "SELECT Id FROM T WHERE Key = \"key-5000\";"));
+  EXPECT_EQ(
+      "3 \n",
+      run_script(
+          executor, "SELECT Id FROM T WHERE \"none\" = Key OR Id = 3;"));
+
+  // Each of the three blocks is probed; the two without the key are
+  // skipped unless the filter lets one through by chance.
+  const std::string output = run_script(
+      executor, "EXPLAIN ANALYZE SELECT Id FROM T WHERE Key = \"key-9999\";");
+  std::smatch match;
+  ASSERT_TRUE(std::regex_search(
+      output, match,
+      std::regex(
+          "Bloom Filter: probes=3 skipped=([0-9]+) false_positives=([0-9]+) "
+          "false_positive_rate=[0-9.]+%")))
+      << output;
+  EXPECT_EQ(2, std::stoi(match[1]) + std::stoi(match[2]));
+
+  // Erasing rows rebuilds the filters.
+  run_script(executor, "DELETE FROM T WHERE Id < 5000;");
+  EXPECT_EQ(
+      "7000 \n",
+      run_script(executor, "SELECT Id FROM T WHERE Key = \"key-7000\";"));
+  EXPECT_EQ(
+      "", run_script(executor, "SELECT Id FROM T WHERE Key = \"key-100\";"));
+}
+
+TEST(ExecutorSuite, AggregateTest) {
+  rdb::exec::Catalog catalog;
+  rdb::exec::Executor executor(catalog);
+  const std::string output = run_script(
+      executor,
+      "CREATE TABLE T (Id INT, Name TEXT, Price REAL);"
+      "SELECT COUNT(*) SUM(Id) MIN(Name) AVG(Price) FROM T;"
+      "SELECT Name COUNT(*) FROM T GROUP BY Name;"
+      "INSERT INTO T (Id, Name, Price) VALUES (1, \"b\", 1.5);"
+      "INSERT INTO T (Id, Name, Price) VALUES (2, \"a\", 2.5);"
+      "INSERT INTO T (Id, Name, Price) VALUES (3, \"b\", -0.5);"
+      "INSERT INTO T (Id, Name, Price) VALUES (4, \"c\", 0);"
+      "SELECT COUNT(*) COUNT(Name) SUM(Id) SUM(Price) FROM T;"
+      "SELECT MIN(Id) MAX(Id) MIN(Name) MAX(Name) AVG(Id) FROM T;"
+      "SELECT Name COUNT(*) SUM(Id) MAX(Price) FROM T GROUP BY Name;"
+      "SELECT COUNT(Id) Name FROM T WHERE Id > 1 GROUP BY Name;"
+      "SELECT SUM(Price) FROM T WHERE Id > 1 GROUP BY Name Id;"
+      "SELECT Name FROM T GROUP BY Name;"
+      "SELECT Name COUNT(*) FROM T;"
+      "SELECT SUM(Name) FROM T;"
+      "SELECT MAX(Age) FROM T;"
+      "SELECT COUNT(*) FROM T GROUP BY Age;"
+      "INSERT INTO T (Id) VALUES (2147483647);"
+      "SELECT SUM(Id) FROM T;"
+      "EXPLAIN SELECT Name SUM(Id) FROM T WHERE Id > 1 GROUP BY Name;"
+      "EXPLAIN SELECT COUNT(*) FROM T;");
+  const std::string expected =
+      "OK 0\n"
+      "0 0  0.000000 \n"
+      "OK 1\n"
+      "OK 1\n"
+      "OK 1\n"
+      "OK 1\n"
+      "4 4 10 3.500000 \n"
+      "1 4 a c 2.500000 \n"
+      "a 1 2 2.500000 \n"
+      "b 2 4 1.500000 \n"
+      "c 1 4 0.000000 \n"
+      "1 a \n"
+      "1 b \n"
+      "1 c \n"
+      "2.500000 \n"
+      "-0.500000 \n"
+      "0.000000 \n"
+      "a \n"
+      "b \n"
+      "c \n"
+      "Column Name must be aggregated or in GROUP BY\n"
+      "Can't compute SUM on TEXT\n"
+      "Unknown column Age\n"
+      "Unknown column Age\n"
+      "OK 1\n"
+      "Integer overflow in SUM(Id)\n"
+      "Aggregate Name SUM(Id) \n"
+      "  Group Key: Name \n"
+      "  Workers: 1 \n"
+      "    -> Seq Scan on T \n"
+      "         Workers: 1 \n"
+      "         Filter: Id > 1 \n"
+      "Aggregate COUNT(*) \n"
+      "  Workers: 1 \n"
+      "    -> Seq Scan on T \n"
+      "         Workers: 1 \n";
+  EXPECT_EQ(expected, output);
+}
+
+TEST(ExecutorSuite, JoinTest) {
+  rdb::exec::Catalog catalog;
+  rdb::exec::Executor executor(catalog);
+  run_script(
+      executor,
+      "CREATE TABLE Users (Id INT, Name TEXT);"
+      "CREATE TABLE Orders (Id INT, UserId INT, Price REAL);"
+      "INSERT INTO Users (Id, Name) VALUES (1, \"ann\");"
+      "INSERT INTO Users (Id, Name) VALUES (2, \"bob\");"
+      "INSERT INTO Users (Id, Name) VALUES (3, \"cid\");"
+      "INSERT INTO Orders (Id, UserId, Price) VALUES (10, 2, 1.5);"
+      "INSERT INTO Orders (Id, UserId, Price) VALUES (11, 1, 2.5);"
+      "INSERT INTO Orders (Id, UserId, Price) VALUES (12, 2, 3.5);"
+      "INSERT INTO Orders (Id, UserId, Price) VALUES (13, 4, 4.5);");
+  const std::string output = run_script(
+      executor,
+      "SELECT Name Orders.Id Price FROM Users JOIN Orders "
+      "ON Users.Id = UserId;"
+      "SELECT Orders.Id Name FROM Orders JOIN Users ON Users.Id = UserId "
+      "WHERE Price > 2;"
+      "SELECT Name FROM Users JOIN Orders ON UserId = Users.Id "
+      "WHERE Users.Id != 2;"
+      "SELECT Id FROM Users JOIN Orders ON Users.Id = UserId;"
+      "SELECT Name FROM Users JOIN Orders ON Users.Id = Users.Id;"
+      "SELECT Name FROM Users JOIN Orders ON Users.Name = UserId;"
+      "SELECT Name FROM Users JOIN Orders ON Users.Id = UserId "
+      "WHERE Name = \"ann\" OR Price > 2;"
+      "SELECT Name FROM Users JOIN Users ON Id = Id;"
+      "SELECT Users.Age FROM Users JOIN Orders ON Users.Id = UserId;"
+      "SELECT Name FROM Users JOIN Missing ON Users.Id = Missing.Id;"
+      "EXPLAIN SELECT Name FROM Users JOIN Orders ON Users.Id = UserId "
+      "WHERE Price > 2;");
+  const std::string expected =
+      "ann 11 2.500000 \n"
+      "bob 10 1.500000 \n"
+      "bob 12 3.500000 \n"
+      "11 ann \n"
+      "12 bob \n"
+      "ann \n"
+      "Ambiguous column Id\n"
+      "JOIN must compare columns of both tables\n"
+      "Can't join Name with UserId\n"
+      "WHERE of a JOIN can only read one table\n"
+      "Can't join Users with itself\n"
+      "Unknown column Users.Age\n"
+      "Unknown table Missing\n"
+      "Project Name \n"
+      "    -> Hash Join \n"
+      "         Hash Cond: Users.Id = UserId \n"
+      "         Workers: 1 \n"
+      "        -> Seq Scan on Users \n"
+      "             Workers: 1 \n"
+      "        -> Seq Scan on Orders \n"
+      "             Workers: 1 \n"
+      "             Filter: Price > 2 \n";
+  EXPECT_EQ(expected, output);
+}
+
+TEST(ExecutorSuite, OrderByLimitTest) {
+  rdb::exec::Catalog catalog;
+  rdb::exec::Executor executor(catalog);
+  run_script(
+      executor,
+      "CREATE TABLE Users (Id INT, Name TEXT);"
+      "CREATE TABLE Orders (Id INT, UserId INT, Price REAL);"
+      "INSERT INTO Users (Id, Name) VALUES (1, \"cid\");"
+      "INSERT INTO Users (Id, Name) VALUES (2, \"ann\");"
+      "INSERT INTO Users (Id, Name) VALUES (3, \"bob\");"
+      "INSERT INTO Orders (Id, UserId, Price) VALUES (10, 2, 1.5);"
+      "INSERT INTO Orders (Id, UserId, Price) VALUES (11, 1, 2.5);"
+      "INSERT INTO Orders (Id, UserId, Price) VALUES (12, 2, 3.5);"
+      "INSERT INTO Orders (Id, UserId, Price) VALUES (13, 3, 1.5);");
+  const std::string output = run_script(
+      executor,
+      "SELECT Id FROM Orders ORDER BY Price DESC;"
+      "SELECT Id FROM Orders ORDER BY Price LIMIT 3;"
+      "SELECT Name FROM Users WHERE Id > 1 ORDER BY Name;"
+      "SELECT Id FROM Orders LIMIT 2;"
+      "SELECT Name Price FROM Users JOIN Orders ON Users.Id = UserId "
+      "ORDER BY Name LIMIT 3;"
+      "SELECT UserId SUM(Price) FROM Orders GROUP BY UserId "
+      "ORDER BY SUM(Price) DESC;"
+      "SELECT UserId COUNT(*) FROM Orders GROUP BY UserId LIMIT 1;"
+      "SELECT Id FROM Orders ORDER BY Age;"
+      "SELECT Id FROM Orders ORDER BY MAX(Price);"
+      "SELECT UserId FROM Orders GROUP BY UserId ORDER BY Price;"
+      "EXPLAIN SELECT Id FROM Orders WHERE Price > 2 ORDER BY Price DESC "
+      "LIMIT 5;"
+      "EXPLAIN SELECT Id FROM Orders LIMIT 5;"
+      "EXPLAIN SELECT Name FROM Users JOIN Orders ON Users.Id = UserId "
+      "ORDER BY Price;");
+  const std::string expected =
+      "12 \n"
+      "11 \n"
+      "10 \n"
+      "13 \n"
+      "10 \n"
+      "13 \n"
+      "11 \n"
+      "ann \n"
+      "bob \n"
+      "10 \n"
+      "11 \n"
+      "ann 1.500000 \n"
+      "ann 3.500000 \n"
+      "bob 1.500000 \n"
+      "2 5.000000 \n"
+      "1 2.500000 \n"
+      "3 1.500000 \n"
+      "1 1 \n"
+      "Unknown column Age\n"
+      "Can't ORDER BY MAX(Price) ASC without aggregates\n"
+      "ORDER BY Price ASC must be in the column list\n"
+      "Project Id \n"
+      "    -> Sort \n"
+      "         Sort Key: Price DESC \n"
+      "         Limit: 5 \n"
+      "         Workers: 1 \n"
+      "        -> Seq Scan on Orders \n"
+      "             Workers: 1 \n"
+      "             Filter: Price > 2 \n"
+      "Project Id \n"
+      "    -> Limit 5 \n"
+      "        -> Seq Scan on Orders \n"
+      "             Workers: 1 \n"
+      "Project Name \n"
+      "    -> Sort \n"
+      "         Sort Key: Price ASC \n"
+      "         Workers: 1 \n"
+      "        -> Hash Join \n"
+      "             Hash Cond: Users.Id = UserId \n"
+      "             Workers: 1 \n"
+      "            -> Seq Scan on Users \n"
+      "                 Workers: 1 \n"
+      "            -> Seq Scan on Orders \n"
+      "                 Workers: 1 \n";
+  EXPECT_EQ(expected, output);
+}
+
+TEST(ExecutorSuite, MemoryLimitTest) {
+  rdb::exec::Catalog catalog;
+  rdb::exec::Executor executor(catalog);
+  std::string sql = "CREATE TABLE T (Id INT);";
+  for (int i = 0; i < 100; ++i) {
+    sql += "INSERT INTO T (Id) VALUES (" + std::to_string(i) + ");";
+  }
+  run_script(executor, sql);
+
+  rdb::sql::Lexer lexer("SELECT Id FROM T ORDER BY Id DESC;");
+  rdb::sql::Parser parser(lexer);
+  const rdb::sql::Parser::Result parsed = parser.parse_sql_script();
+  ASSERT_EQ(1, parsed.script_.statements_.size());
+  const auto& select = *parsed.script_.statements_[0];
+  const rdb::exec::Result result = executor.execute(select);
+  EXPECT_EQ(100, result.rows_.size());
+  EXPECT_LT(100 * sizeof(size_t), result.peak_memory_bytes_);
+
+  executor.set_statement_memory_limit(result.peak_memory_bytes_ - 1);
+  try {
+    executor.execute(select);
+    FAIL();
+  } catch (const rdb::exec::ExecutionError& e) {
+    EXPECT_EQ(
+        0, std::string(e.what()).find("Memory limit of statement exceeded"));
+  }
+  // The failed statement released its memory and leaves the executor usable.
+  EXPECT_EQ("99 \n", run_script(executor, "SELECT MAX(Id) FROM T;"));
+
+  executor.set_statement_memory_limit(result.peak_memory_bytes_);
+  EXPECT_EQ(100, executor.execute(select).rows_.size());
+}
+
+TEST(ExecutorSuite, TransactionTest) {
+  rdb::exec::Catalog catalog;
+  rdb::exec::Executor executor(catalog);
+  const std::string output = run_script(
+      executor,
+      "CREATE TABLE T (Id INT);"
+      "INSERT INTO T (Id) VALUES (1);"
+      "BEGIN;"
+      "INSERT INTO T (Id) VALUES (2);"
+      "INSERT INTO T (Id) VALUES (3);"
+      // Reads see the last committed state.
+      "SELECT Id FROM T;"
+      "INSERT INTO Missing (Id) VALUES (1);"
+      "CREATE TABLE U (Name TEXT);"
+      "INSERT INTO U (Name) VALUES (\"a\");"
+      "BEGIN;"
+      "COMMIT;"
+      "SELECT Id FROM T;"
+      "SELECT Name FROM U;"
+      "BEGIN;"
+      "DELETE FROM T;"
+      "DROP TABLE U;"
+      "ROLLBACK;"
+      "SELECT COUNT(Id) FROM T;"
+      "COMMIT;"
+      "ROLLBACK;"
+      // Dividing by zero while COMMIT applies the writes undoes them all.
+      "BEGIN;"
+      "INSERT INTO T (Id) VALUES (4);"
+      "CREATE TABLE V (Id INT);"
+      "DELETE FROM T WHERE Id / (Id - 4) > 0;"
+      "COMMIT;"
+      "SELECT Id FROM T;"
+      "SELECT Id FROM V;");
+  const std::string expected =
+      "OK 0\n"
+      "OK 1\n"
+      "OK 0\n"
+      "OK 0\n"
+      "OK 0\n"
+      "1 \n"
+      "Unknown table Missing\n"
+      "OK 0\n"
+      "OK 0\n"
+      "A transaction is already in progress\n"
+      "OK 3\n"
+      "1 \n"
+      "2 \n"
+      "3 \n"
+      "a \n"
+      "OK 0\n"
+      "OK 0\n"
+      "OK 0\n"
+      "OK 0\n"
+      "3 \n"
+      "No transaction in progress\n"
+      "No transaction in progress\n"
+      "OK 0\n"
+      "OK 0\n"
+      "OK 0\n"
+      "OK 0\n"
+      "Transaction rolled back: Division by zero\n"
+      "1 \n"
+      "2 \n"
+      "3 \n"
+      "Unknown table V\n";
+  EXPECT_EQ(expected, output);
+
+  // A transaction is checked again if the tables changed since BEGIN.
+  rdb::sql::Lexer lexer(
+      "BEGIN; INSERT INTO U (Name) VALUES (\"b\"); DROP TABLE U; COMMIT;");
+  rdb::sql::Parser parser(lexer);
+  const rdb::sql::Parser::Result parsed = parser.parse_sql_script();
+  const auto& statements = parsed.script_.statements_;
+  rdb::exec::Transaction transaction;
+  executor.execute(*statements[0], transaction);
+  executor.execute(*statements[1], transaction);
+  executor.execute(*statements[2]);
+  EXPECT_TRUE(transaction.active());
+  try {
+    executor.execute(*statements[3], transaction);
+    FAIL();
+  } catch (const rdb::exec::ExecutionError& e) {
+    EXPECT_EQ(
+        std::string("Transaction rolled back: Unknown table U"), e.what());
+  }
+  EXPECT_FALSE(transaction.active());
+}
+
+TEST(ExecutorSuite, AnalyzeTest) {
+  rdb::exec::Catalog catalog;
+  rdb::exec::Executor executor(catalog);
+  const std::string output = run_script(
+      executor,
+      "CREATE TABLE T (Id INT, Price REAL, Name TEXT);"
+      "INSERT INTO T (Id, Price, Name) VALUES (3, 1.5, \"a\");"
+      "INSERT INTO T (Id, Price, Name) VALUES (1, -2.5, \"b\");"
+      "INSERT INTO T (Id, Price, Name) VALUES (3, 0.0, \"a\");"
+      "ANALYZE T;"
+      "DELETE FROM T WHERE Id = 1;"
+      "ANALYZE T;"
+      "ANALYZE Missing;"
+      // Reordered operands give the same rows.
+      "SELECT Id FROM T WHERE Name = \"a\" AND Id = 3 OR Price < 0;");
+  const std::string expected =
+      "OK 0\n"
+      "OK 1\n"
+      "OK 1\n"
+      "OK 1\n"
+      "Id 2 2 1 3 \n"
+      "Price 3 3 -2.500000 1.500000 \n"
+      "Name 2 0   \n"
+      "OK 1\n"
+      "Id 1 1 3 3 \n"
+      "Price 2 2 0.000000 1.500000 \n"
+      "Name 1 0   \n"
+      "Unknown table Missing\n"
+      "3 \n"
+      "3 \n";
+  EXPECT_EQ(expected, output);
+}
+
+TEST(ExecutorSuite, PreparedStatementTest) {
+  rdb::exec::Catalog catalog;
+  rdb::exec::Executor executor(catalog);
+  run_script(executor, "CREATE TABLE T (Id INT, Price REAL, Name TEXT);");
+  rdb::exec::PreparedStatement insert =
+      executor.prepare("INSERT INTO T (Id, Price, Name) VALUES (?, ?, ?);");
+  ASSERT_EQ(3, insert.placeholder_count());
+  EXPECT_THROW(executor.execute(insert), rdb::exec::ExecutionError);
+  for (int id = 1; id <= 3; ++id) {
+    insert.bind(0, id);
+    // INT values fit REAL columns.
+    insert.bind(1, id * 2);
+    insert.bind(2, std::string(id, 'x'));
+    EXPECT_EQ(1, executor.execute(insert).affected_rows_);
+  }
+  EXPECT_THROW(insert.bind(0, 1.5F), rdb::exec::ExecutionError);
+  EXPECT_THROW(insert.bind(2, 1), rdb::exec::ExecutionError);
+  EXPECT_THROW(insert.bind(3, 1), rdb::exec::ExecutionError);
+  insert.clear_bindings();
+  EXPECT_THROW(executor.execute(insert), rdb::exec::ExecutionError);
+
+  rdb::exec::PreparedStatement select = executor.prepare(
+      "SELECT Id Name FROM T WHERE Price > ? AND (Name = ? OR Id - ? = 0);");
+  select.bind(0, 4.5F);
+  select.bind(1, "xx");
+  select.bind(2, 3);
+  const rdb::exec::Result result = executor.execute(select);
+  ASSERT_EQ(1, result.rows_.size());
+  EXPECT_EQ("3", rdb::exec::cell_to_str(result.rows_[0][0]));
+  select.bind(0, 0.0F);
+  EXPECT_EQ(2, executor.execute(select).rows_.size());
+  // The template is kept as written.
+  EXPECT_EQ(
+      "SELECT Id Name FROM T WHERE Price > ? AND (Name = ? OR Id - ? = 0);",
+      select.statement().to_str());
+
+  rdb::exec::PreparedStatement erase =
+      executor.prepare("DELETE FROM T WHERE ? <= Id;");
+  erase.bind(0, 2);
+  EXPECT_EQ(2, executor.execute(erase).affected_rows_);
+  EXPECT_EQ("1 \n", run_script(executor, "SELECT Id FROM T;"));
+
+  EXPECT_THROW(executor.prepare("SELECT Id FROM;"), rdb::exec::ExecutionError);
+  // Statements without placeholders run as parsed.
+  EXPECT_EQ(
+      1, executor.execute(executor.prepare("SELECT Id FROM T;")).rows_.size());
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <librdb/exec/Executor.hpp>
+#include <librdb/exec/HashJoin.hpp>
+#include <librdb/exec/Table.hpp>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "TestHelpers.hpp"
+
+namespace {
+
+using rdb::exec::Column;
+
+// Matches of every left row, found with an ordered multimap of the right
+// rows.
+std::vector<std::pair<size_t, size_t>> expected_join(
+    const Column& left,
+    const std::vector<size_t>& left_rows,
+    const Column& right,
+    const std::vector<size_t>& right_rows) {
+  std::multimap<rdb::exec::Cell, size_t> right_values;
+  for (const size_t right_row : right_rows) {
+    right_values.emplace(right.at(right_row), right_row);
+  }
+  std::vector<std::pair<size_t, size_t>> matches;
+  for (const size_t left_row : left_rows) {
+    const auto [begin, end] = right_values.equal_range(left.at(left_row));
+    for (auto it = begin; it != end; ++it) {
+      matches.emplace_back(left_row, it->second);
+    }
+  }
+  return matches;
+}
+
+using rdb::test::every;
+
+}  // namespace
+
+TEST(HashJoinSuite, MatchesExpectedPairs) {
+  // Over 13k build rows, enough for more than one radix partition.
+  Column left("Id", Column::Kind::Int);
+  Column right("Key", Column::Kind::Int);
+  const size_t left_size = 60'000;
+  const size_t right_size = 40'000;
+  for (size_t row = 0; row < left_size; ++row) {
+    left.push_back(static_cast<int>(row * 7 % 50'000) - 25'000);
+  }
+  for (size_t row = 0; row < right_size; ++row) {
+    right.push_back(static_cast<int>(row * 13 % 60'000) - 25'000);
+  }
+  const rdb::exec::HashJoin join(left, right);
+  const std::vector<size_t> left_rows = every(2, left_size);
+  const std::vector<size_t> right_rows = every(3, right_size);
+  const auto expected = expected_join(left, left_rows, right, right_rows);
+  ASSERT_FALSE(expected.empty());
+  for (const size_t workers : {1, 3}) {
+    EXPECT_EQ(expected, join.run(left_rows, right_rows, workers)) << workers;
+  }
+  // The smaller side is the build side either way.
+  const rdb::exec::HashJoin flipped(right, left);
+  std::vector<std::pair<size_t, size_t>> flipped_expected;
+  for (const auto& [left_row, right_row] : expected) {
+    flipped_expected.emplace_back(right_row, left_row);
+  }
+  std::sort(flipped_expected.begin(), flipped_expected.end());
+  EXPECT_EQ(flipped_expected, flipped.run(right_rows, left_rows, 2));
+}
+
+TEST(HashJoinSuite, DuplicateKeysAndKinds) {
+  Column left_text("Name", Column::Kind::Text);
+  Column right_text("Owner", Column::Kind::Text);
+  Column reals("Price", Column::Kind::Real);
+  for (const char* name : {"a", "b", "a", "c"}) {
+    left_text.push_back(std::string(name));
+  }
+  for (const char* name : {"a", "c", "a", "d"}) {
+    right_text.push_back(std::string(name));
+  }
+  const std::vector<size_t> all = {0, 1, 2, 3};
+  const std::vector<std::pair<size_t, size_t>> expected = {
+      {0, 0}, {0, 2}, {2, 0}, {2, 2}, {3, 1}};
+  EXPECT_EQ(
+      expected, rdb::exec::HashJoin(left_text, right_text).run(all, all, 2));
+
+  Column left_reals("Price", Column::Kind::Real);
+  for (const float value : {-0.0F, 1.5F, 0.0F}) {
+    left_reals.push_back(value);
+    reals.push_back(value);
+  }
+  const std::vector<size_t> three = {0, 1, 2};
+  const std::vector<std::pair<size_t, size_t>> zeros = {
+      {0, 0}, {0, 2}, {1, 1}, {2, 0}, {2, 2}};
+  EXPECT_EQ(zeros, rdb::exec::HashJoin(left_reals, reals).run(three, three, 1));
+
+  EXPECT_THROW(
+      rdb::exec::HashJoin(left_text, reals), rdb::exec::ExecutionError);
+}
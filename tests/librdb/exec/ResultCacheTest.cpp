@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include <librdb/exec/ResultCache.hpp>
+#include <librdb/sql/Parser.hpp>
+#include <string>
+#include <string_view>
+
+#include "TestHelpers.hpp"
+
+namespace {
+
+using rdb::test::run_script;
+
+}  // namespace
+
+TEST(ResultCacheSuite, InvalidationTest) {
+  rdb::exec::Catalog catalog;
+  rdb::exec::ResultCache cache(1 << 20);
+  rdb::exec::Executor executor(catalog, &cache);
+  run_script(
+      executor,
+      "CREATE TABLE T (A INT, B TEXT); CREATE TABLE U (A INT);"
+      "INSERT INTO T (A, B) VALUES (1, \"x\");"
+      "INSERT INTO U (A) VALUES (7);");
+
+  EXPECT_EQ("1 x \n", run_script(executor, "SELECT A B FROM T WHERE A > 0;"));
+  EXPECT_EQ("1 x \n", run_script(executor, "SELECT  A B\nFROM T WHERE A>0;"));
+  EXPECT_EQ("x \n", run_script(executor, "SELECT B FROM T WHERE A > 0;"));
+  EXPECT_EQ("7 \n", run_script(executor, "SELECT A FROM U;"));
+  EXPECT_EQ(1U, cache.stats().hits_);
+  EXPECT_EQ(3U, cache.stats().misses_);
+  EXPECT_EQ(3U, cache.size());
+
+  // Writes to another table and deletes of nothing keep the entries.
+  run_script(
+      executor, "INSERT INTO U (A) VALUES (8); DELETE FROM T WHERE A > 5;");
+  EXPECT_EQ("1 x \n", run_script(executor, "SELECT A B FROM T WHERE A > 0;"));
+  EXPECT_EQ(2U, cache.stats().hits_);
+  EXPECT_EQ(0U, cache.stats().invalidations_);
+
+  run_script(executor, "INSERT INTO T (A, B) VALUES (2, \"y\");");
+  EXPECT_EQ(
+      "1 x \n2 y \n", run_script(executor, "SELECT A B FROM T WHERE A > 0;"));
+  EXPECT_EQ(2U, cache.stats().invalidations_);
+
+  run_script(executor, "DELETE FROM T WHERE A = 1;");
+  EXPECT_EQ("2 y \n", run_script(executor, "SELECT A B FROM T WHERE A > 0;"));
+
+  run_script(executor, "DROP TABLE T; CREATE TABLE T (A INT, B TEXT);");
+  EXPECT_EQ("", run_script(executor, "SELECT A B FROM T WHERE A > 0;"));
+  EXPECT_EQ(2U, cache.stats().hits_);
+  EXPECT_EQ(
+      "Unknown table V\n", run_script(executor, "SELECT A FROM V;"));
+}
+
+TEST(ResultCacheSuite, BudgetTest) {
+  rdb::exec::Catalog catalog;
+  rdb::exec::ResultCache cache(2048);
+  rdb::exec::Executor executor(catalog, &cache);
+  run_script(executor, "CREATE TABLE T (A INT);");
+  for (int i = 0; i < 20; ++i) {
+    run_script(
+        executor, "INSERT INTO T (A) VALUES (" + std::to_string(i) + ");");
+  }
+  for (int i = 0; i < 20; ++i) {
+    run_script(
+        executor, "SELECT A FROM T WHERE A >= " + std::to_string(i) + ";");
+    EXPECT_LE(cache.byte_size(), 2048U);
+  }
+  EXPECT_GT(cache.stats().evictions_, 0U);
+  EXPECT_LT(cache.size(), 20U);
+
+  // The most recent result is still cached; a result over the budget isn't.
+  EXPECT_EQ("19 \n", run_script(executor, "SELECT A FROM T WHERE A >= 19;"));
+  EXPECT_EQ(1U, cache.stats().hits_);
+  rdb::exec::ResultCache tiny(16);
+  rdb::exec::Executor tiny_executor(catalog, &tiny);
+  run_script(tiny_executor, "SELECT A FROM T; SELECT A FROM T;");
+  EXPECT_EQ(0U, tiny.size());
+  EXPECT_EQ(0U, tiny.stats().hits_);
+}
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <librdb/exec/Sort.hpp>
+#include <librdb/exec/Table.hpp>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "TestHelpers.hpp"
+
+namespace {
+
+using rdb::exec::Cell;
+using rdb::exec::Column;
+
+// Positions in `rows` ordered with std::stable_sort on the cells.
+std::vector<size_t> expected_order(
+    const Column& column,
+    const std::vector<size_t>& rows,
+    bool descending,
+    size_t limit) {
+  std::vector<Cell> cells;
+  rdb::exec::ColumnReader reader(column);
+  for (size_t row = 0; row < column.size(); ++row) {
+    cells.push_back(reader.at(row));
+  }
+  std::vector<size_t> positions(rows.size());
+  std::iota(positions.begin(), positions.end(), size_t{0});
+  std::stable_sort(positions.begin(), positions.end(), [&](size_t a, size_t b) {
+    return descending ? cells[rows[b]] < cells[rows[a]]
+                      : cells[rows[a]] < cells[rows[b]];
+  });
+  positions.resize(std::min(positions.size(), limit));
+  return positions;
+}
+
+using rdb::test::every;
+
+}  // namespace
+
+TEST(SortSuite, HeapAndRadixSort) {
+  Column column("Time", Column::Kind::Int);
+  const size_t size = 40'000;
+  for (size_t row = 0; row < size; ++row) {
+    column.push_back(static_cast<int>(row * 7919 % 10'007) - 5'000);
+  }
+  const std::vector<size_t> rows = every(2, size);
+  for (const bool descending : {false, true}) {
+    for (const size_t limit : {size_t{0}, size_t{10}, size_t{5'000}, size}) {
+      const std::vector<size_t> expected =
+          expected_order(column, rows, descending, limit);
+      for (const size_t workers : {1, 3}) {
+        EXPECT_EQ(
+            expected,
+            rdb::exec::Sort(column, descending, limit).run(rows, workers));
+      }
+    }
+    EXPECT_EQ(
+        expected_order(column, rows, descending, size),
+        rdb::exec::Sort(column, descending, std::nullopt).run(rows, 2));
+  }
+}
+
+TEST(SortSuite, SpillsRunsOverBudget) {
+  Column column("Price", Column::Kind::Real);
+  const size_t size = 30'000;
+  for (size_t row = 0; row < size; ++row) {
+    column.push_back(static_cast<float>(row * 31 % 1'000) / 4 - 100);
+  }
+  column.push_back(-0.0F);
+  column.push_back(0.0F);
+  // Rows in descending order, as the right side of a join may be.
+  std::vector<size_t> rows = every(1, size + 2);
+  std::reverse(rows.begin(), rows.end());
+  // Runs of 4096 entries.
+  const size_t budget = 64 * 1024;
+  for (const bool descending : {false, true}) {
+    for (const size_t limit : {size_t{100}, size_t{20'000}}) {
+      EXPECT_EQ(
+          expected_order(column, rows, descending, limit),
+          rdb::exec::Sort(column, descending, limit, budget).run(rows, 2));
+    }
+  }
+}
+
+TEST(SortSuite, TextWithCommonPrefixes) {
+  Column column("Name", Column::Kind::Text);
+  const size_t size = 5'000;
+  for (size_t row = 0; row < size; ++row) {
+    column.push_back(
+        (row % 3 == 0 ? "customer-" : "cust") + std::to_string(row % 101));
+  }
+  column.push_back(std::string());
+  const std::vector<size_t> rows = every(1, size + 1);
+  for (const bool descending : {false, true}) {
+    for (const size_t limit : {size_t{7}, size}) {
+      EXPECT_EQ(
+          expected_order(column, rows, descending, limit),
+          rdb::exec::Sort(column, descending, limit).run(rows, 2));
+      EXPECT_EQ(
+          expected_order(column, rows, descending, limit),
+          rdb::exec::Sort(column, descending, limit, 1).run(rows, 1));
+    }
+  }
+}
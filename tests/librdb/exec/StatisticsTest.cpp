@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include <librdb/exec/BloomFilter.hpp>
+#include <librdb/exec/Encoding.hpp>
+#include <librdb/exec/Statistics.hpp>
+#include <librdb/exec/Table.hpp>
+#include <librdb/sql/Parser.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using rdb::exec::Column;
+
+// The WHERE condition of `DELETE FROM T WHERE <condition>;`.
+double selectivity(const rdb::exec::Table& table, std::string_view sql) {
+  rdb::sql::Lexer lexer(sql);
+  rdb::sql::Parser parser(lexer);
+  const rdb::sql::Parser::Result parsed = parser.parse_sql_script();
+  const auto& statement = static_cast<const rdb::sql::DeleteStatement&>(
+      *parsed.script_.statements_.at(0));
+  return rdb::exec::estimate_selectivity(table, *statement.expression());
+}
+
+}  // namespace
+
+TEST(StatisticsSuite, HyperLogLogTest) {
+  for (const uint64_t distinct : {10, 1'000, 100'000}) {
+    rdb::exec::HyperLogLog sketch;
+    // Every value twice.
+    for (uint64_t i = 0; i < 2 * distinct; ++i) {
+      sketch.add(rdb::exec::mix_hash(i % distinct));
+    }
+    EXPECT_NEAR(
+        static_cast<double>(distinct), sketch.estimate(), 0.1 * distinct);
+  }
+  EXPECT_EQ(0, rdb::exec::HyperLogLog().estimate());
+}
+
+TEST(StatisticsSuite, HistogramTest) {
+  std::vector<uint32_t> keys;
+  for (int value = 0; value < 1'000; ++value) {
+    keys.push_back(rdb::exec::to_key(value));
+  }
+  // A frequent value doesn't split across buckets.
+  keys.insert(keys.end(), 500, rdb::exec::to_key(1'000));
+  rdb::exec::Histogram histogram;
+  histogram.build(keys);
+  EXPECT_LT(histogram.bucket_count(), rdb::exec::Histogram::kMaxBuckets);
+  EXPECT_EQ(1'500, histogram.row_count());
+  EXPECT_EQ(rdb::exec::to_key(0), histogram.min_key());
+  EXPECT_EQ(rdb::exec::to_key(1'000), histogram.max_key());
+  EXPECT_EQ(0, histogram.fraction_below(rdb::exec::to_key(-1)));
+  EXPECT_NEAR(0.2, histogram.fraction_below(rdb::exec::to_key(300)), 0.01);
+  EXPECT_NEAR(
+      2.0 / 3, histogram.fraction_below(rdb::exec::to_key(1'000)), 0.01);
+  EXPECT_EQ(1, histogram.fraction_below(rdb::exec::to_key(1'001)));
+
+  // Keys outside the range widen it.
+  histogram.add(rdb::exec::to_key(2'000));
+  histogram.remove(rdb::exec::to_key(0));
+  histogram.remove(rdb::exec::to_key(-5));
+  EXPECT_EQ(1'500, histogram.row_count());
+  EXPECT_EQ(rdb::exec::to_key(2'000), histogram.max_key());
+}
+
+TEST(StatisticsSuite, SelectivityTest) {
+  rdb::exec::Table table(
+      "T",
+      {Column("Id", Column::Kind::Int), Column("Price", Column::Kind::Real),
+       Column("Name", Column::Kind::Text)});
+  for (int row = 0; row < 10'000; ++row) {
+    const std::string name = row % 4 == 0 ? "a" : "b";
+    table.append_row({row, static_cast<float>(row % 100), name});
+  }
+  EXPECT_NEAR(
+      0.25, selectivity(table, "DELETE FROM T WHERE Id < 2500;"), 0.02);
+  EXPECT_NEAR(
+      0.5, selectivity(table, "DELETE FROM T WHERE 5000 <= Id;"), 0.02);
+  EXPECT_NEAR(
+      0.01, selectivity(table, "DELETE FROM T WHERE Price = 7;"), 0.002);
+  EXPECT_EQ(0, selectivity(table, "DELETE FROM T WHERE Price = 100.5;"));
+  EXPECT_NEAR(
+      0.5, selectivity(table, "DELETE FROM T WHERE Name = \"a\";"), 0.02);
+  EXPECT_NEAR(
+      0.125,
+      selectivity(table, "DELETE FROM T WHERE Name = \"a\" AND Id < 2500;"),
+      0.02);
+  EXPECT_NEAR(
+      0.625,
+      selectivity(table, "DELETE FROM T WHERE Name = \"a\" OR Id < 2500;"),
+      0.02);
+  EXPECT_NEAR(
+      0.75, selectivity(table, "DELETE FROM T WHERE NOT Id < 2500;"), 0.02);
+  EXPECT_NEAR(
+      1.0 / 3, selectivity(table, "DELETE FROM T WHERE Id + 1 < 2500;"), 1e-9);
+
+  // Erasing most rows rebuilds the statistics.
+  std::vector<bool> erase_mask(table.row_count());
+  for (size_t row = 0; row < erase_mask.size(); ++row) {
+    erase_mask[row] = row >= 100;
+  }
+  table.erase_rows(erase_mask);
+  EXPECT_EQ(0, table.statistics().changed_rows_);
+  EXPECT_EQ(100, table.statistics().rebuilt_rows_);
+  EXPECT_NEAR(
+      0.01, selectivity(table, "DELETE FROM T WHERE Id = 7;"), 0.002);
+  EXPECT_EQ(0, selectivity(table, "DELETE FROM T WHERE Id = 5000;"));
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include <librdb/exec/Executor.hpp>
+#include <librdb/exec/WriteDispatcher.hpp>
+#include <librdb/sql/Parser.hpp>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace {
+
+// The rows of the table as text, in table order.
+std::string dump(rdb::exec::Catalog& catalog, std::string_view table_name) {
+  const std::string sql =
+      "SELECT Id Name FROM " + std::string(table_name) + ";";
+  rdb::sql::Lexer lexer(sql);
+  rdb::sql::Parser parser(lexer);
+  const rdb::sql::Parser::Result parsed = parser.parse_sql_script();
+  rdb::exec::Executor executor(catalog);
+  std::stringstream out;
+  for (const auto& row :
+       executor.execute(*parsed.script_.statements_.at(0)).rows_) {
+    for (const auto& cell : row) {
+      out << rdb::exec::cell_to_str(cell) << " ";
+    }
+    out << "\n";
+  }
+  return out.str();
+}
+
+}  // namespace
+
+TEST(WriteDispatcherSuite, SameAsSerialTest) {
+  std::stringstream sql;
+  sql << "CREATE TABLE A (Id INT, Name TEXT);"
+      << "CREATE TABLE B (Id INT, Name TEXT);"
+      << "CREATE TABLE C (Id INT, Name TEXT);";
+  for (int i = 0; i < 3000; ++i) {
+    sql << "INSERT INTO " << "ABC"[i % 3] << " (Id, Name) VALUES (" << i
+        << ", \"n" << i % 7 << "\");";
+    if (i % 500 == 250) {
+      sql << "DELETE FROM " << "ABC"[i % 3] << " WHERE Name = \"n3\";";
+    }
+  }
+  // The INSERT fails on a worker, the DROP on the dispatching thread.
+  sql << "INSERT INTO Missing (Id) VALUES (1);"
+      << "SELECT Id FROM B;"
+      << "DROP TABLE Missing;"
+      << "DELETE FROM C WHERE Id > 2900;";
+  const std::string script = sql.str();
+  rdb::sql::Lexer lexer(script);
+  rdb::sql::Parser parser(lexer);
+  const rdb::sql::Parser::Result parsed = parser.parse_sql_script();
+  ASSERT_TRUE(parsed.errors_.empty());
+
+  rdb::exec::Catalog serial_catalog;
+  rdb::exec::Executor executor(serial_catalog);
+  for (const auto& statement : parsed.script_.statements_) {
+    try {
+      executor.execute(*statement);
+    } catch (const rdb::exec::ExecutionError&) {
+    }
+  }
+
+  rdb::exec::Catalog catalog;
+  rdb::exec::WriteDispatcher dispatcher(catalog, 3, 16);
+  EXPECT_EQ(3U, dispatcher.worker_count());
+  for (const auto& statement : parsed.script_.statements_) {
+    dispatcher.dispatch(*statement);
+  }
+  const auto errors = dispatcher.wait();
+  ASSERT_EQ(2U, errors.size());
+  const size_t count = parsed.script_.statements_.size();
+  EXPECT_EQ(count - 4, errors[0].statement_);
+  EXPECT_EQ(count - 2, errors[1].statement_);
+  EXPECT_TRUE(dispatcher.wait().empty());
+
+  for (const std::string_view table_name : {"A", "B", "C"}) {
+    EXPECT_EQ(dump(serial_catalog, table_name), dump(catalog, table_name));
+  }
+  EXPECT_FALSE(dump(catalog, "B").empty());
+}
+
+TEST(WriteDispatcherSuite, TransactionTest) {
+  rdb::sql::Lexer lexer(
+      "CREATE TABLE A (Id INT, Name TEXT);"
+      "BEGIN;"
+      "INSERT INTO A (Id) VALUES (1);"
+      "ROLLBACK;"
+      "INSERT INTO A (Id) VALUES (2);"
+      "BEGIN;"
+      "INSERT INTO A (Id) VALUES (3);"
+      "COMMIT;"
+      "COMMIT;");
+  rdb::sql::Parser parser(lexer);
+  const rdb::sql::Parser::Result parsed = parser.parse_sql_script();
+  rdb::exec::Catalog catalog;
+  {
+    rdb::exec::WriteDispatcher dispatcher(catalog, 2, 4);
+    for (const auto& statement : parsed.script_.statements_) {
+      dispatcher.dispatch(*statement);
+    }
+    const auto errors = dispatcher.wait();
+    ASSERT_EQ(1U, errors.size());
+    EXPECT_EQ(8U, errors[0].statement_);
+    EXPECT_EQ("No transaction in progress", errors[0].message_);
+  }
+  EXPECT_EQ("2  \n3  \n", dump(catalog, "A"));
+}
@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include <librdb/exec/Executor.hpp>
+#include <librdb/memory/MemoryTracker.hpp>
+#include <librdb/sql/Parser.hpp>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using rdb::memory::MemoryLimitError;
+using rdb::memory::MemoryScope;
+using rdb::memory::MemoryTracker;
+using rdb::memory::Reservation;
+
+}  // namespace
+
+TEST(MemoryTrackerSuite, HierarchyTest) {
+  MemoryTracker session("session", nullptr, 1000);
+  {
+    MemoryTracker statement("statement", &session, 700);
+    statement.allocate(500);
+    EXPECT_EQ(500, statement.used());
+    EXPECT_EQ(500, session.used());
+
+    // The statement limit refuses the charge as a whole.
+    EXPECT_THROW(statement.allocate(201), MemoryLimitError);
+    EXPECT_EQ(500, statement.used());
+    EXPECT_EQ(500, session.used());
+
+    session.allocate(400);
+    // So does the session limit, after the statement was charged.
+    try {
+      statement.allocate(150);
+      FAIL();
+    } catch (const MemoryLimitError& e) {
+      EXPECT_EQ(
+          std::string("Memory limit of session exceeded: 1050 of 1000 bytes"),
+          e.what());
+    }
+    EXPECT_EQ(500, statement.used());
+    EXPECT_EQ(900, session.used());
+
+    statement.release(300);
+    EXPECT_EQ(200, statement.used());
+    EXPECT_EQ(500, statement.peak());
+    EXPECT_EQ(600, session.used());
+  }
+  // A destroyed tracker releases what is still charged to it.
+  EXPECT_EQ(400, session.used());
+  EXPECT_EQ(900, session.peak());
+}
+
+TEST(MemoryTrackerSuite, AllocatorTest) {
+  MemoryTracker statement("statement", nullptr, 1024);
+  EXPECT_EQ(&MemoryTracker::process(), &MemoryTracker::current());
+  {
+    const MemoryScope scope(statement);
+    EXPECT_EQ(&statement, &MemoryTracker::current());
+    rdb::memory::Vector<int> values;
+    values.reserve(100);
+    EXPECT_EQ(400, statement.used());
+    EXPECT_THROW(values.reserve(1000), MemoryLimitError);
+    EXPECT_EQ(400, statement.used());
+    values.assign(100, 1);
+    values.clear();
+    values.shrink_to_fit();
+    EXPECT_EQ(0, statement.used());
+  }
+  EXPECT_EQ(&MemoryTracker::process(), &MemoryTracker::current());
+}
+
+TEST(MemoryTrackerSuite, ReservationTest) {
+  MemoryTracker statement("statement", nullptr, 100);
+  {
+    Reservation reservation(statement);
+    reservation.resize(60);
+    reservation.add(20);
+    EXPECT_THROW(reservation.add(30), MemoryLimitError);
+    EXPECT_EQ(80, reservation.bytes());
+    EXPECT_EQ(80, statement.used());
+
+    const Reservation moved = std::move(reservation);
+    EXPECT_EQ(0, reservation.bytes());  // NOLINT(bugprone-use-after-move)
+    EXPECT_EQ(80, moved.bytes());
+    EXPECT_EQ(80, statement.used());
+  }
+  EXPECT_EQ(0, statement.used());
+}
+
+TEST(MemoryTrackerSuite, ReservationOutlivesTrackerTest) {
+  MemoryTracker process("process", nullptr);
+  Reservation reservation;
+  {
+    MemoryTracker session("session", &process);
+    reservation = Reservation(session);
+    reservation.resize(100);
+    EXPECT_EQ(100, process.used());
+  }
+  // The session released its bytes, and the reservation releases nothing.
+  EXPECT_EQ(0, process.used());
+  reservation.add(50);
+  reservation.resize(0);
+  EXPECT_EQ(0, process.used());
+
+  // Nor does a prepared statement that outlives its session.
+  std::optional<rdb::exec::PreparedStatement> prepared;
+  rdb::exec::Catalog catalog;
+  rdb::exec::Executor executor(catalog);
+  {
+    MemoryTracker session("session", &process);
+    const MemoryScope scope(session);
+    prepared = executor.prepare("SELECT Id FROM T WHERE Id = ?;");
+    EXPECT_LT(0, process.used());
+  }
+  prepared.reset();
+  EXPECT_EQ(0, process.used());
+}
+
+TEST(MemoryTrackerSuite, ParserTest) {
+  const std::string sql =
+      "SELECT Id Name FROM Users WHERE Id > 10 AND Name = \"ann\";"
+      "SELECT Id FROM Users;";
+  {
+    MemoryTracker session("session", nullptr);
+    const MemoryScope scope(session);
+    rdb::sql::Lexer lexer(sql);
+    rdb::sql::Parser parser(lexer);
+    const rdb::sql::Parser::Result result = parser.parse_sql_script();
+    EXPECT_EQ(std::vector<std::string>(), result.errors_);
+    EXPECT_EQ(2, result.script_.statements_.size());
+    EXPECT_LT(0, session.used());
+  }
+
+  MemoryTracker session("session", nullptr, 64);
+  const MemoryScope scope(session);
+  rdb::sql::Lexer lexer(sql);
+  rdb::sql::Parser parser(lexer);
+  const rdb::sql::Parser::Result result = parser.parse_sql_script();
+  ASSERT_EQ(2, result.errors_.size());
+  EXPECT_EQ(0, result.errors_[0].find("Memory limit of session exceeded"));
+  EXPECT_TRUE(result.script_.statements_.empty());
+}
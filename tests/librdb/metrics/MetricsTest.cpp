@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include <librdb/exec/Executor.hpp>
+#include <librdb/metrics/Metrics.hpp>
+#include <librdb/sql/Parser.hpp>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+TEST(MetricsSuite, CounterTest) {
+  rdb::metrics::Counter counter;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&counter] {
+      for (int j = 0; j < 1000; ++j) {
+        counter.add();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(4000U, counter.value());
+}
+
+TEST(MetricsSuite, HistogramBucketsTest) {
+  using rdb::metrics::Histogram;
+  for (const uint64_t value :
+       {0ULL, 15ULL, 16ULL, 17ULL, 1000ULL, 1ULL << 40U, ~0ULL}) {
+    const size_t bucket = Histogram::bucket_of(value);
+    EXPECT_LE(value, Histogram::bucket_upper_bound(bucket));
+    if (bucket != 0) {
+      EXPECT_GT(value, Histogram::bucket_upper_bound(bucket - 1));
+    }
+    EXPECT_LE(Histogram::bucket_upper_bound(bucket) - value, value / 16);
+  }
+  EXPECT_EQ(Histogram::kBuckets - 1, Histogram::bucket_of(~0ULL));
+
+  Histogram histogram;
+  for (uint64_t value = 1; value <= 100; ++value) {
+    histogram.record(value * 1000);
+  }
+  EXPECT_EQ(100U, histogram.count());
+  EXPECT_EQ(5050000U, histogram.sum());
+  EXPECT_NEAR(50000.0, double(histogram.quantile(0.5)), 50000.0 / 16);
+  EXPECT_NEAR(99000.0, double(histogram.quantile(0.99)), 99000.0 / 16);
+}
+
+TEST(MetricsSuite, HistogramThreadsTest) {
+  rdb::metrics::Histogram histogram;
+  std::vector<std::thread> threads;
+  for (uint64_t i = 1; i <= 4; ++i) {
+    threads.emplace_back([&histogram, i] {
+      for (int j = 0; j < 1000; ++j) {
+        histogram.record(i * 1000);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  const rdb::metrics::Histogram::Snapshot snapshot = histogram.snapshot();
+  EXPECT_EQ(4000U, snapshot.count_);
+  EXPECT_EQ(10'000'000U, snapshot.sum_);
+  EXPECT_EQ(1000U, snapshot.buckets_[rdb::metrics::Histogram::bucket_of(1000)]);
+  EXPECT_EQ(4000U, histogram.count());
+  EXPECT_NEAR(4000.0, double(snapshot.quantile(1)), 4000.0 / 16);
+}
+
+TEST(MetricsSuite, PrometheusTest) {
+  rdb::metrics::Registry registry;
+  const rdb::metrics::Labels labels = {{"path", "a\"b"}};
+  registry.counter("requests_total", "Requests.", labels).add(3);
+  EXPECT_EQ(
+      &registry.counter("requests_total", "Requests.", labels),
+      &registry.counter("requests_total", "Requests.", labels));
+  registry.histogram("latency_seconds", "Latency.").record(1500);
+  EXPECT_THROW(registry.histogram("requests_total", ""), std::logic_error);
+
+  const std::string text = registry.render_prometheus();
+  for (const std::string_view line :
+       {"# TYPE latency_seconds histogram\n",
+        "latency_seconds_bucket{le=\"1.024e-06\"} 0\n",
+        "latency_seconds_bucket{le=\"2.048e-06\"} 1\n",
+        "latency_seconds_bucket{le=\"+Inf\"} 1\n",
+        "latency_seconds_count 1\n",
+        "# TYPE requests_total counter\n",
+        "requests_total{path=\"a\\\"b\"} 3\n"}) {
+    EXPECT_NE(std::string::npos, text.find(line)) << line;
+  }
+}
+
+TEST(MetricsSuite, InstrumentationTest) {
+  auto& registry = rdb::metrics::Registry::global();
+  auto& tokens = registry.counter("rdb_lexer_tokens_total", "");
+  auto& selects = registry.counter(
+      "rdb_parser_statements_total", "", {{"statement", "select"}});
+  auto& unknown_errors = registry.counter(
+      "rdb_parser_errors_total", "", {{"statement", "unknown"}});
+  auto& select_latency = registry.histogram(
+      "rdb_statement_duration_seconds", "", {{"statement", "select"}});
+  auto& select_errors = registry.counter(
+      "rdb_statement_errors_total", "", {{"statement", "select"}});
+  const uint64_t tokens_before = tokens.value();
+  const uint64_t selects_before = selects.value();
+  const uint64_t unknown_errors_before = unknown_errors.value();
+  const uint64_t latency_before = select_latency.count();
+  const uint64_t select_errors_before = select_errors.value();
+
+  rdb::exec::Catalog catalog;
+  rdb::exec::Executor executor(catalog);
+  {
+    rdb::sql::Lexer lexer("CREATE TABLE T (A INT); SELECT A FROM T; TABLE;");
+    rdb::sql::Parser parser(lexer);
+    const auto result = parser.parse_sql_script();
+    for (const auto& statement : result.script_.statements_) {
+      executor.execute(*statement);
+    }
+  }
+  {
+    rdb::sql::Lexer lexer("SELECT B FROM T;");
+    rdb::sql::Parser parser(lexer);
+    const auto result = parser.parse_sql_script();
+    EXPECT_THROW(
+        executor.execute(*result.script_.statements_.front()),
+        rdb::exec::ExecutionError);
+  }
+
+  EXPECT_EQ(22U, tokens.value() - tokens_before);
+  EXPECT_EQ(2U, selects.value() - selects_before);
+  EXPECT_EQ(1U, unknown_errors.value() - unknown_errors_before);
+  EXPECT_EQ(1U, select_latency.count() - latency_before);
+  EXPECT_EQ(1U, select_errors.value() - select_errors_before);
+}
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <librdb/net/Protocol.hpp>
+#include <string>
+#include <vector>
+
+TEST(ProtocolSuite, RowsRoundTripTest) {
+  rdb::exec::Result result;
+  result.column_names_ = {"Id", "Price", "Name"};
+  result.rows_ = {{1, 2.5F, std::string("one")}, {-2, 0.0F, std::string()}};
+
+  std::string stream;
+  rdb::net::encode_result(stream, result);
+  rdb::net::FrameReader reader;
+  reader.append(stream.data(), stream.size());
+  auto frame = reader.next();
+  ASSERT_TRUE(frame);
+  EXPECT_EQ(rdb::net::FrameType::Columns, frame->type_);
+  EXPECT_EQ(result.column_names_, rdb::net::decode_columns(frame->payload_));
+  frame = reader.next();
+  ASSERT_TRUE(frame);
+  EXPECT_EQ(rdb::net::FrameType::Rows, frame->type_);
+  EXPECT_EQ(result.rows_, rdb::net::decode_rows(frame->payload_));
+  // An empty Rows frame ends the result.
+  frame = reader.next();
+  ASSERT_TRUE(frame);
+  EXPECT_EQ(rdb::net::FrameType::Rows, frame->type_);
+  EXPECT_TRUE(rdb::net::decode_rows(frame->payload_).empty());
+  EXPECT_FALSE(reader.next());
+}
+
+TEST(ProtocolSuite, RowChunksTest) {
+  std::vector<std::vector<rdb::exec::Cell>> rows;
+  for (int id = 0; id < 10'000; ++id) {
+    rows.push_back({id, std::string(50, 'x')});
+  }
+  std::string stream;
+  std::vector<size_t> ends;
+  for (size_t row = 0; row < rows.size();) {
+    row = rdb::net::encode_rows(stream, rows, row);
+    ends.push_back(row);
+  }
+  EXPECT_LT(1U, ends.size());
+
+  rdb::net::FrameReader reader;
+  reader.append(stream.data(), stream.size());
+  std::vector<std::vector<rdb::exec::Cell>> decoded;
+  for (const size_t end : ends) {
+    const auto frame = reader.next();
+    ASSERT_TRUE(frame);
+    // A chunk stops after the row that reaches the chunk size.
+    EXPECT_LT(frame->payload_.size(), rdb::net::kRowsChunkBytes + 64);
+    for (auto& row : rdb::net::decode_rows(frame->payload_)) {
+      decoded.push_back(std::move(row));
+    }
+    EXPECT_EQ(end, decoded.size());
+  }
+  EXPECT_EQ(rows, decoded);
+}
+
+TEST(ProtocolSuite, OversizedFrameTest) {
+  std::string stream = "prefix";
+  const std::string payload(rdb::net::kMaxFramePayload + 1, 'x');
+  EXPECT_THROW(
+      rdb::net::encode_frame(stream, rdb::net::FrameType::Error, payload),
+      rdb::net::ProtocolError);
+  // Nothing of the frame is left behind.
+  EXPECT_EQ("prefix", stream);
+}
+
+TEST(ProtocolSuite, PartialFramesTest) {
+  std::string stream;
+  rdb::net::encode_frame(stream, rdb::net::FrameType::Script, "DROP TABLE A;");
+  rdb::net::encode_frame(stream, rdb::net::FrameType::Script, "DROP TABLE B;");
+  rdb::exec::Result ok;
+  ok.affected_rows_ = 7;
+  rdb::net::encode_result(stream, ok);
+  rdb::net::encode_done(stream, 3);
+
+  rdb::net::FrameReader reader;
+  std::vector<rdb::net::Frame> frames;
+  for (const char byte : stream) {
+    reader.append(&byte, 1);
+    while (auto frame = reader.next()) {
+      frames.push_back(std::move(*frame));
+    }
+  }
+  ASSERT_EQ(4U, frames.size());
+  EXPECT_EQ("DROP TABLE A;", frames[0].payload_);
+  EXPECT_EQ("DROP TABLE B;", frames[1].payload_);
+  EXPECT_EQ(rdb::net::FrameType::Ok, frames[2].type_);
+  EXPECT_EQ(7U, rdb::net::decode_ok(frames[2].payload_));
+  EXPECT_EQ(3U, rdb::net::decode_done(frames[3].payload_));
+  EXPECT_EQ(0U, reader.buffered());
+}
+
+TEST(ProtocolSuite, MalformedFrameTest) {
+  const char header[] = {1, 0, 0, 0, 42};
+  rdb::net::FrameReader reader;
+  reader.append(header, sizeof(header));
+  EXPECT_THROW(reader.next(), rdb::net::ProtocolError);
+  EXPECT_THROW(rdb::net::decode_done("ab"), rdb::net::ProtocolError);
+}
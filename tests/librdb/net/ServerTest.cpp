@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <librdb/net/Client.hpp>
+#include <librdb/net/Server.hpp>
+#include <librdb/storage/StatementLog.hpp>
+#include <librdb/sync/Epoch.hpp>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#include "TestHelpers.hpp"
+
+namespace {
+
+std::string read_response(rdb::net::Client& client) {
+  std::string out;
+  while (true) {
+    const rdb::net::Frame frame = client.read_frame();
+    switch (frame.type_) {
+      case rdb::net::FrameType::Rows:
+        for (const auto& row : rdb::net::decode_rows(frame.payload_)) {
+          for (const auto& cell : row) {
+            out += rdb::exec::cell_to_str(cell) + " ";
+          }
+          out += "\n";
+        }
+        break;
+      case rdb::net::FrameType::Ok:
+        out += "OK " + std::to_string(rdb::net::decode_ok(frame.payload_)) +
+               "\n";
+        break;
+      case rdb::net::FrameType::Error:
+        out += frame.payload_ + "\n";
+        break;
+      case rdb::net::FrameType::Done:
+        out += "Done " + std::to_string(rdb::net::decode_done(frame.payload_));
+        return out;
+      case rdb::net::FrameType::Columns:
+      case rdb::net::FrameType::Script:
+        break;
+    }
+  }
+}
+
+// Fills table T (Id INT, Name TEXT) with `count` rows of 100-byte names.
+void fill_table(rdb::exec::Catalog& catalog, int count) {
+  const rdb::sync::EpochGuard guard;
+  rdb::exec::Table* table = catalog.find("T");
+  for (int id = 0; id < count; ++id) {
+    table->append_row({id, std::string(100, 'x')});
+  }
+}
+
+class FailingLog : public rdb::exec::WriteLog {
+ public:
+  void append(const rdb::sql::Statement& /*statement*/) override {}
+  void flush() override { throw rdb::storage::StorageError("Disk full"); }
+};
+
+}  // namespace
+
+TEST(ServerSuite, PipelinedScriptsTest) {
+  const std::string socket_path =
+      "/tmp/rdb_server_test_" + std::to_string(getpid()) + ".sock";
+  rdb::exec::Catalog catalog;
+  rdb::exec::Executor executor(catalog);
+  rdb::net::Server server(executor, socket_path);
+  std::thread server_thread([&server] { server.run(); });
+
+  {
+    rdb::net::Client writer(socket_path);
+    rdb::net::Client reader(socket_path);
+    writer.send_script("CREATE TABLE T (Id INT, Name TEXT);");
+    writer.send_script(
+        "INSERT INTO T (Id, Name) VALUES (1, \"a\");"
+        "INSERT INTO T (Id, Name) VALUES (2, \"b\");");
+    writer.send_script("SELECT Name FROM T; DROP;");
+    writer.send_script("SELECT Name FROM T WHERE Id > 1; SELECT X FROM T;");
+    EXPECT_EQ("OK 0\nDone 1", read_response(writer));
+    EXPECT_EQ("OK 1\nOK 1\nDone 2", read_response(writer));
+    EXPECT_EQ("Expected KwTable, got Semicolon\nDone 0", read_response(writer));
+    EXPECT_EQ("b \nUnknown column X\nDone 1", read_response(writer));
+
+    reader.send_script("SELECT Id Name FROM T;");
+    EXPECT_EQ("1 a \n2 b \nDone 1", read_response(reader));
+  }
+
+  server.stop();
+  server_thread.join();
+}
+
+TEST(ServerSuite, StreamedRowsTest) {
+  const std::string socket_path =
+      "/tmp/rdb_server_test_" + std::to_string(getpid()) + ".sock";
+  rdb::exec::Catalog catalog;
+  rdb::exec::Executor executor(catalog);
+  rdb::test::run_script(executor, "CREATE TABLE T (Id INT, Name TEXT);");
+  // Several times the output a connection buffers.
+  constexpr int kRows = 100'000;
+  fill_table(catalog, kRows);
+  rdb::net::Server server(executor, socket_path);
+  std::thread server_thread([&server] { server.run(); });
+
+  {
+    rdb::net::Client client(socket_path);
+    client.send_script("SELECT Id Name FROM T;");
+    client.send_script("SELECT COUNT(*) FROM T;");
+    rdb::net::Frame frame = client.read_frame();
+    ASSERT_EQ(rdb::net::FrameType::Columns, frame.type_);
+    EXPECT_EQ(
+        (std::vector<std::string>{"Id", "Name"}),
+        rdb::net::decode_columns(frame.payload_));
+    int next_id = 0;
+    size_t chunks = 0;
+    while (true) {
+      frame = client.read_frame();
+      ASSERT_EQ(rdb::net::FrameType::Rows, frame.type_);
+      const auto rows = rdb::net::decode_rows(frame.payload_);
+      if (rows.empty()) {
+        break;
+      }
+      EXPECT_LT(frame.payload_.size(), rdb::net::kRowsChunkBytes + 128);
+      for (const auto& row : rows) {
+        ASSERT_EQ(next_id++, std::get<int>(row.at(0)));
+      }
+      ++chunks;
+    }
+    EXPECT_EQ(kRows, next_id);
+    EXPECT_LT(1U, chunks);
+    EXPECT_EQ(1U, rdb::net::decode_done(client.read_frame().payload_));
+    EXPECT_EQ("100000 \nDone 1", read_response(client));
+  }
+
+  server.stop();
+  server_thread.join();
+}
+
+TEST(ServerSuite, FinishSendingTest) {
+  const std::string socket_path =
+      "/tmp/rdb_server_test_" + std::to_string(getpid()) + ".sock";
+  rdb::exec::Catalog catalog;
+  rdb::exec::Executor executor(catalog);
+  rdb::test::run_script(executor, "CREATE TABLE T (Id INT, Name TEXT);");
+  // More than a socket buffer holds, so the result is sent in parts.
+  constexpr int kRows = 20'000;
+  fill_table(catalog, kRows);
+  rdb::net::Server server(executor, socket_path);
+  std::thread server_thread([&server] { server.run(); });
+
+  {
+    rdb::net::Client client(socket_path);
+    client.send_script("SELECT Id Name FROM T;");
+    client.send_script("SELECT COUNT(*) FROM T;");
+    client.finish_sending();
+    const std::string rows = read_response(client);
+    EXPECT_EQ(kRows, std::count(rows.begin(), rows.end(), '\n'));
+    EXPECT_EQ("Done 1", rows.substr(rows.rfind('\n') + 1));
+    EXPECT_EQ("20000 \nDone 1", read_response(client));
+    // The server closes the connection once everything is answered.
+    EXPECT_THROW(client.read_frame(), rdb::net::ProtocolError);
+  }
+
+  server.stop();
+  server_thread.join();
+}
+
+TEST(ServerSuite, LogFailureTest) {
+  const std::string socket_path =
+      "/tmp/rdb_server_test_" + std::to_string(getpid()) + ".sock";
+  rdb::exec::Catalog catalog;
+  FailingLog log;
+  rdb::exec::Executor executor(catalog, nullptr, &log);
+  rdb::net::Server server(executor, socket_path);
+  bool stopped = false;
+  std::thread server_thread([&server, &stopped] {
+    EXPECT_THROW(server.run(), rdb::storage::StorageError);
+    stopped = true;
+  });
+
+  rdb::net::Client client(socket_path);
+  client.send_script("CREATE TABLE T (Id INT); SELECT Id FROM T;");
+  EXPECT_EQ("Disk full\nDone 0", read_response(client));
+  server_thread.join();
+  EXPECT_TRUE(stopped);
+}
+
+TEST(ServerSuite, BindErrorTest) {
+  rdb::exec::Catalog catalog;
+  rdb::exec::Executor executor(catalog);
+  EXPECT_THROW(
+      rdb::net::Server(executor, "/nonexistent/rdb_server_test.sock"),
+      std::system_error);
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include <librdb/sql/IncrementalParser.hpp>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace {
+
+std::string dump(
+    const std::vector<rdb::sql::Token>& tokens,
+    const rdb::sql::Parser::Result& result) {
+  std::stringstream out;
+  for (const auto& token : tokens) {
+    out << token << " @" << token.location().offset_ << '\n';
+  }
+  for (const auto& statement : result.script_.statements_) {
+    out << *statement << '\n';
+  }
+  for (const auto& error : result.errors_) {
+    out << error << '\n';
+  }
+  return out.str();
+}
+
+std::string dump_fresh(std::string_view text) {
+  std::vector<rdb::sql::Token> tokens;
+  {
+    rdb::sql::Lexer lexer(text);
+    for (auto token = lexer.get(); token.kind() != rdb::sql::Token::Kind::Eof;
+         token = lexer.get()) {
+      tokens.push_back(token);
+    }
+  }
+  rdb::sql::Lexer lexer(text);
+  rdb::sql::Parser parser(lexer);
+  return dump(tokens, parser.parse_sql_script());
+}
+
+void expect_matches_fresh(const rdb::sql::IncrementalParser& parser) {
+  const std::string text = parser.text();
+  EXPECT_EQ(text.size(), parser.size());
+  EXPECT_EQ(dump_fresh(text), dump(parser.tokens(), parser.result())) << text;
+}
+
+}  // namespace
+
+TEST(IncrementalParserSuite, LocalEditTest) {
+  rdb::sql::IncrementalParser parser(
+      "CREATE TABLE T (A INT);\n"
+      "INSERT INTO T (A) VALUES (1);\n"
+      "SELECT A FROM T WHERE A > 0; DROP TABLE T;\n");
+  expect_matches_fresh(parser);
+  EXPECT_EQ(5U, parser.reparsed_segments());
+
+  // "VALUES (1)" -> "VALUES (12345)"
+  parser.edit(50, 0, "2345");
+  expect_matches_fresh(parser);
+  EXPECT_EQ(1U, parser.reparsed_segments());
+
+  // Split one line into two and join them back.
+  parser.edit(33, 1, "\n\n");
+  expect_matches_fresh(parser);
+  EXPECT_EQ(1U, parser.reparsed_segments());
+  parser.edit(33, 2, " ");
+  expect_matches_fresh(parser);
+}
+
+TEST(IncrementalParserSuite, BoundaryEditsTest) {
+  rdb::sql::IncrementalParser parser(
+      "DROP TABLE A; DROP TABLE B; DROP TABLE C;");
+
+  // Removing a semicolon merges statements until the next boundary.
+  parser.edit(12, 1, "");
+  expect_matches_fresh(parser);
+  EXPECT_EQ(1U, parser.reparsed_segments());
+  EXPECT_EQ(1U, parser.result().errors_.size());
+  parser.edit(12, 0, ";");
+  expect_matches_fresh(parser);
+
+  // An unterminated string swallows the semicolon that ends its line.
+  parser.edit(25, 0, "\"");
+  expect_matches_fresh(parser);
+  parser.edit(25, 1, "");
+  expect_matches_fresh(parser);
+
+  // Edits at both ends and of the whole script.
+  parser.edit(0, 0, "  ");
+  expect_matches_fresh(parser);
+  parser.edit(parser.size(), 0, " SELECT X FROM T");
+  expect_matches_fresh(parser);
+  parser.edit(0, parser.size(), "");
+  expect_matches_fresh(parser);
+  EXPECT_TRUE(parser.tokens().empty());
+  parser.edit(0, 0, "DROP TABLE D;");
+  expect_matches_fresh(parser);
+
+  EXPECT_THROW(parser.edit(14, 0, "x"), std::out_of_range);
+  EXPECT_THROW(parser.edit(10, 4, ""), std::out_of_range);
+}
+
+TEST(IncrementalParserSuite, RandomEditsTest) {
+  const std::string_view fragments[] = {
+      ";", "\n", " ", "\"", "SELECT A FROM T", "WHERE A < 3", "DROP TABLE X;",
+      "INSERT INTO T (A) VALUES (1);", "(", "12", "!="};
+  rdb::sql::IncrementalParser parser(
+      "CREATE TABLE T (A INT, B TEXT);\nSELECT A B FROM T;\n"
+      "DELETE FROM T WHERE B = \"x;y\";\n");
+  uint64_t state = 7;
+  const auto next = [&state](size_t bound) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return static_cast<size_t>((state >> 33U) % bound);
+  };
+  for (int i = 0; i < 300; ++i) {
+    const size_t offset = next(parser.size() + 1);
+    const size_t removed =
+        next(std::min<size_t>(parser.size() - offset, 8) + 1);
+    parser.edit(offset, removed, fragments[next(std::size(fragments))]);
+    expect_matches_fresh(parser);
+  }
+}
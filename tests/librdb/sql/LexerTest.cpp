@@ -47,6 +47,21 @@ TEST(LexerSuite, IdTest) {
   EXPECT_EQ(expected_tokens, tokens);
 }
 
+TEST(LexerSuite, QualifiedIdTest) {
+  auto tokens = get_tokens("T.Id a.b.c x. JOIN ON");
+  const std::string expected_tokens =
+      "Id 'T.Id' Loc=0:0\n"
+      "Id 'a.b' Loc=5:0\n"
+      "Unknown '.' Loc=8:0\n"
+      "Id 'c' Loc=9:0\n"
+      "Id 'x' Loc=11:0\n"
+      "Unknown '.' Loc=12:0\n"
+      "KwJoin 'JOIN' Loc=14:0\n"
+      "KwOn 'ON' Loc=19:0\n"
+      "Eof '<EOF>' Loc=21:0\n";
+  EXPECT_EQ(expected_tokens, tokens);
+}
+
 TEST(LexerSuite, KeywordsTest) {
   auto tokens = get_tokens("SELECT value FROM table");
   const std::string expected_tokens =
@@ -97,7 +112,7 @@ TEST(LexerSuite, IntTest) {
       "Int '1' Loc=14:0\n"
       "Int '0' Loc=16:0\n"
       "Int '1' Loc=17:0\n"
-      "Unknown '-' Loc=19:0\n"
+      "Minus '-' Loc=19:0\n"
       "Id 'abc' Loc=20:0\n"
       "Eof '<EOF>' Loc=23:0\n";
   EXPECT_EQ(expected_tokens, tokens);
@@ -141,3 +156,17 @@ TEST(LexerSuite, OperationTest) {
       "Eof '<EOF>' Loc=16:0\n";
   EXPECT_EQ(expected_tokens, tokens);
 }
+
+TEST(LexerSuite, PlaceholderTest) {
+  auto tokens = get_tokens("Id=?,(?)");
+  const std::string expected_tokens =
+      "Id 'Id' Loc=0:0\n"
+      "Equal '=' Loc=2:0\n"
+      "Placeholder '?' Loc=3:0\n"
+      "Comma ',' Loc=4:0\n"
+      "LBracket '(' Loc=5:0\n"
+      "Placeholder '?' Loc=6:0\n"
+      "RBracket ')' Loc=7:0\n"
+      "Eof '<EOF>' Loc=8:0\n";
+  EXPECT_EQ(expected_tokens, tokens);
+}
@@ -0,0 +1,31 @@
+#include <gtest/gtest.h>
+#include <librdb/sql/NewlineIndex.hpp>
+#include <string>
+
+TEST(NewlineIndexSuite, LocateTest) {
+  const std::string text = "\nab\n\ncd e\nf";
+  const rdb::sql::NewlineIndex index(text);
+  EXPECT_EQ(4U, index.newline_count());
+
+  size_t row = 0;
+  size_t cols = 0;
+  size_t expected_row = 0;
+  for (size_t offset = 0; offset <= text.size(); ++offset) {
+    const auto location = index.locate(offset);
+    EXPECT_EQ(offset, location.offset_);
+    EXPECT_EQ(expected_row, location.rows_) << offset;
+    EXPECT_EQ(cols, location.cols_) << offset;
+
+    const auto monotonic = index.locate(offset, row);
+    EXPECT_EQ(expected_row, monotonic.rows_) << offset;
+    EXPECT_EQ(cols, monotonic.cols_) << offset;
+
+    if (offset < text.size() && text[offset] == '\n') {
+      ++expected_row;
+      cols = 0;
+    } else {
+      ++cols;
+    }
+  }
+  EXPECT_EQ(0U, rdb::sql::NewlineIndex("").locate(0).rows_);
+}
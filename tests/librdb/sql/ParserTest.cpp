@@ -93,3 +93,172 @@ TEST(ParserSuite, CreateTableTest) {
       "Expected Id, got KwInt\n";
   EXPECT_EQ(expected_statements, statements);
 }
+
+TEST(ParserSuite, ExplainTest) {
+  rdb::sql::Lexer lexer(
+      "EXPLAIN SELECT C1 FROM Table;"
+      "EXPLAIN ANALYZE DELETE FROM Table WHERE A < 1;"
+      "EXPLAIN EXPLAIN DROP TABLE A;"
+      "EXPLAIN ANALYZE;");
+  rdb::sql::Parser parser(lexer);
+  const std::string statements = dump_statements(parser);
+  const std::string expected_statements =
+      "EXPLAIN SELECT C1 FROM Table;\n"
+      "EXPLAIN ANALYZE DELETE FROM Table WHERE A < 1;\n"
+      "Expected statement type\n"
+      "Expected statement type\n";
+  EXPECT_EQ(expected_statements, statements);
+}
+
+TEST(ParserSuite, ConditionTest) {
+  rdb::sql::Lexer lexer(
+      "SELECT A FROM T WHERE A > 1 AND B < 5 OR NOT C = \"x\";"
+      "SELECT A FROM T WHERE A > 1 AND (B < 5 OR C = 2);"
+      "DELETE FROM T WHERE A + B * 2 >= (A - 1) / -2;"
+      "DELETE FROM T WHERE A-1 < B -2.5 * C;"
+      "SELECT A FROM T WHERE A - (B - C) = A - B - C;"
+      "SELECT A FROM T WHERE NOT (A = 1 OR A = 2);"
+      "SELECT A FROM T WHERE (A + 1);"
+      "SELECT A FROM T WHERE (A > 1) + 1 > 2;"
+      "SELECT A FROM T WHERE A > 1 AND;"
+      "SELECT A FROM T WHERE (A > 1;");
+  rdb::sql::Parser parser(lexer);
+  const std::string statements = dump_statements(parser);
+  const std::string expected_statements =
+      "SELECT A FROM T WHERE A > 1 AND B < 5 OR NOT C = \"x\";\n"
+      "SELECT A FROM T WHERE A > 1 AND (B < 5 OR C = 2);\n"
+      "DELETE FROM T WHERE A + B * 2 >= (A - 1) / -2;\n"
+      "DELETE FROM T WHERE A - 1 < B - 2.500000 * C;\n"
+      "SELECT A FROM T WHERE A - (B - C) = A - B - C;\n"
+      "SELECT A FROM T WHERE NOT (A = 1 OR A = 2);\n"
+      "Expected OperationType, got Semicolon\n"
+      "Expected a value, got a condition\n"
+      "Expected Int, Real, String or Id\n"
+      "Expected RBracket, got Semicolon\n";
+  EXPECT_EQ(expected_statements, statements);
+}
+
+TEST(ParserSuite, AggregateTest) {
+  rdb::sql::Lexer lexer(
+      "SELECT Name COUNT(*) SUM(Price) FROM T WHERE Id > 1 GROUP BY Name;"
+      "SELECT MIN(A) MAX(B) AVG(C) COUNT(D) FROM T;"
+      "SELECT A B FROM T GROUP BY A B;"
+      "SELECT SUM(*) FROM T;"
+      "SELECT COUNT(A FROM T;"
+      "SELECT A FROM T GROUP A;");
+  rdb::sql::Parser parser(lexer);
+  const std::string statements = dump_statements(parser);
+  const std::string expected_statements =
+      "SELECT Name COUNT(*) SUM(Price) FROM T WHERE Id > 1 GROUP BY Name;\n"
+      "SELECT MIN(A) MAX(B) AVG(C) COUNT(D) FROM T;\n"
+      "SELECT A B FROM T GROUP BY A B;\n"
+      "Expected Id, got Multiply\n"
+      "Expected RBracket, got KwFrom\n"
+      "Expected KwBy, got Id\n";
+  EXPECT_EQ(expected_statements, statements);
+}
+
+TEST(ParserSuite, JoinTest) {
+  rdb::sql::Lexer lexer(
+      "SELECT A.Name B.Id FROM A JOIN B ON A.Id = B.AId WHERE B.Id > 1;"
+      "SELECT Name FROM A JOIN B ON Id = AId;"
+      "SELECT Name FROM A JOIN B ON Id < AId;"
+      "SELECT Name FROM A JOIN B Id = AId;");
+  rdb::sql::Parser parser(lexer);
+  const std::string statements = dump_statements(parser);
+  const std::string expected_statements =
+      "SELECT A.Name B.Id FROM A JOIN B ON A.Id = B.AId WHERE B.Id > 1;\n"
+      "SELECT Name FROM A JOIN B ON Id = AId;\n"
+      "Expected Equal, got Less\n"
+      "Expected KwOn, got Id\n";
+  EXPECT_EQ(expected_statements, statements);
+}
+
+TEST(ParserSuite, OrderByLimitTest) {
+  rdb::sql::Lexer lexer(
+      "SELECT Name FROM T WHERE Id > 1 ORDER BY Time DESC LIMIT 10;"
+      "SELECT Name FROM T ORDER BY Name;"
+      "SELECT Name SUM(Id) FROM T GROUP BY Name ORDER BY SUM(Id) ASC;"
+      "SELECT Name FROM A JOIN B ON Id = AId LIMIT 0;"
+      "SELECT Name FROM T LIMIT -1;"
+      "SELECT Name FROM T LIMIT 1.5;"
+      "SELECT Name FROM T ORDER Name;"
+      "SELECT Name FROM T LIMIT 5 ORDER BY Name;");
+  rdb::sql::Parser parser(lexer);
+  const std::string statements = dump_statements(parser);
+  const std::string expected_statements =
+      "SELECT Name FROM T WHERE Id > 1 ORDER BY Time DESC LIMIT 10;\n"
+      "SELECT Name FROM T ORDER BY Name ASC;\n"
+      "SELECT Name SUM(Id) FROM T GROUP BY Name ORDER BY SUM(Id) ASC;\n"
+      "SELECT Name FROM A JOIN B ON Id = AId LIMIT 0;\n"
+      "LIMIT must not be negative\n"
+      "Expected Int, got Real\n"
+      "Expected KwBy, got Id\n"
+      "Expected Semicolon, got KwOrder\n";
+  EXPECT_EQ(expected_statements, statements);
+}
+
+TEST(ParserSuite, TransactionTest) {
+  rdb::sql::Lexer lexer(
+      "BEGIN; COMMIT; ROLLBACK;"
+      "BEGIN TABLE;"
+      "EXPLAIN COMMIT;");
+  rdb::sql::Parser parser(lexer);
+  const std::string statements = dump_statements(parser);
+  const std::string expected_statements =
+      "BEGIN;\n"
+      "COMMIT;\n"
+      "ROLLBACK;\n"
+      "Expected Semicolon, got KwTable\n"
+      "Expected statement type\n";
+  EXPECT_EQ(expected_statements, statements);
+}
+
+TEST(ParserSuite, AnalyzeTest) {
+  rdb::sql::Lexer lexer(
+      "ANALYZE T;"
+      "ANALYZE;"
+      "EXPLAIN ANALYZE ANALYZE T;");
+  rdb::sql::Parser parser(lexer);
+  const std::string statements = dump_statements(parser);
+  const std::string expected_statements =
+      "ANALYZE T;\n"
+      "Expected Id, got Semicolon\n"
+      "Expected statement type\n";
+  EXPECT_EQ(expected_statements, statements);
+}
+
+TEST(ParserSuite, PlaceholderTest) {
+  {
+    rdb::sql::Lexer lexer(
+        "INSERT INTO T (Id, Name) VALUES (?, \"a\");"
+        "SELECT Id FROM T;");
+    rdb::sql::Parser parser(lexer);
+    const std::string statements = dump_statements(parser);
+    const std::string expected_statements =
+        "SELECT Id FROM T;\n"
+        "Placeholders are only allowed in prepared statements\n";
+    EXPECT_EQ(expected_statements, statements);
+  }
+  const auto prepare = [](std::string_view sql) {
+    rdb::sql::Lexer lexer(sql);
+    rdb::sql::Parser parser(lexer);
+    const rdb::sql::Parser::Result result = parser.parse_prepared_statement();
+    std::stringstream out;
+    for (const auto& i : result.script_.statements_) {
+      out << *i << " " << parser.placeholder_count();
+    }
+    for (const auto& i : result.errors_) {
+      out << i;
+    }
+    return out.str();
+  };
+  EXPECT_EQ(
+      "INSERT INTO T ( Id Name ) VALUES ( ? ? ); 2",
+      prepare("INSERT INTO T (Id, Name) VALUES (?, ?);"));
+  EXPECT_EQ(
+      "DELETE FROM T WHERE Id > ? AND ? + Id < 3; 2",
+      prepare("DELETE FROM T WHERE Id > ? AND ? + Id < 3;"));
+  EXPECT_EQ("Expected Eof, got KwSelect", prepare("BEGIN; SELECT Id FROM T;"));
+  EXPECT_EQ("Expected Id, got Placeholder", prepare("DROP TABLE ?;"));
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <librdb/memory/MemoryTracker.hpp>
+#include <librdb/sql/Lexer.hpp>
+#include <librdb/sql/Parser.hpp>
+#include <librdb/sql/PipelinedParser.hpp>
+#include <sstream>
+#include <string>
+
+namespace {
+
+std::string make_script(size_t statements) {
+  std::string sql = "CREATE TABLE T (Id INT, Name TEXT);";
+  for (size_t i = 0; i < statements; ++i) {
+    sql += "INSERT INTO T (Id, Name) VALUES (" + std::to_string(i) +
+           ", \"name\");";
+  }
+  return sql;
+}
+
+}  // namespace
+
+TEST(PipelinedParserSuite, StatementsInOrderTest) {
+  const std::string sql =
+      "CREATE TABLE T (Id INT);"
+      "INSERT INTO T (Id) VALUES (1);"
+      "SELECT FROM T;"
+      "SELECT Id FROM T WHERE Id > 0;"
+      "DROP T;"
+      "DROP TABLE T;";
+  for (const size_t capacity : {1, 2, 64}) {
+    rdb::sql::PipelinedParser parser(sql, capacity);
+    std::stringstream out;
+    while (const auto result = parser.next()) {
+      ASSERT_EQ(
+          1, result->script_.statements_.size() + result->errors_.size());
+      for (const auto& statement : result->script_.statements_) {
+        out << *statement << "\n";
+      }
+      for (const auto& error : result->errors_) {
+        out << error << "\n";
+      }
+    }
+    EXPECT_FALSE(parser.next());
+    const std::string expected =
+        "CREATE TABLE T ( Id INT );\n"
+        "INSERT INTO T ( Id ) VALUES ( 1 );\n"
+        "Expected Id, got KwFrom\n"
+        "SELECT Id FROM T WHERE Id > 0;\n"
+        "Expected KwTable, got Id\n"
+        "DROP TABLE T;\n";
+    EXPECT_EQ(expected, out.str());
+  }
+}
+
+TEST(PipelinedParserSuite, BoundedMemoryTest) {
+  const std::string sql = make_script(20'000);
+  rdb::memory::MemoryTracker whole(
+      "whole", &rdb::memory::MemoryTracker::process());
+  {
+    const rdb::memory::MemoryScope scope(whole);
+    rdb::sql::Lexer lexer(sql);
+    rdb::sql::Parser parser(lexer);
+    EXPECT_EQ(20'001, parser.parse_sql_script().script_.statements_.size());
+  }
+  rdb::memory::MemoryTracker pipelined(
+      "pipelined", &rdb::memory::MemoryTracker::process());
+  {
+    const rdb::memory::MemoryScope scope(pipelined);
+    rdb::sql::PipelinedParser parser(sql, 16);
+    size_t statements = 0;
+    while (const auto result = parser.next()) {
+      statements += result->script_.statements_.size();
+    }
+    EXPECT_EQ(20'001, statements);
+  }
+  EXPECT_EQ(0, pipelined.used());
+  // The queue, the statement being parsed and the one taken.
+  EXPECT_LT(pipelined.peak() * 100, whole.peak());
+}
+
+TEST(PipelinedParserSuite, StopsEarlyTest) {
+  const std::string sql = make_script(10'000);
+  rdb::sql::PipelinedParser parser(sql, 4);
+  ASSERT_TRUE(parser.next());
+  // The destructor stops the parser while it waits for room.
+}
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include <librdb/sql/Parser.hpp>
+#include <librdb/sql/StatementPrinter.hpp>
+#include <librdb/workload/Generator.hpp>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace {
+
+// Prints every statement of `sql` into one reused buffer and compares it
+// with to_str(). Returns the number of statements.
+size_t expect_same_text(std::string_view sql) {
+  rdb::sql::Lexer lexer(sql);
+  rdb::sql::Parser parser(lexer);
+  const rdb::sql::Parser::Result result = parser.parse_sql_script();
+  EXPECT_TRUE(result.errors_.empty());
+  std::string out;
+  for (const auto& statement : result.script_.statements_) {
+    out.clear();
+    rdb::sql::print_statement(*statement, out);
+    EXPECT_EQ(statement->to_str(), out);
+  }
+  return result.script_.statements_.size();
+}
+
+}  // namespace
+
+TEST(StatementPrinterSuite, SameAsToStrTest) {
+  EXPECT_EQ(
+      12U,
+      expect_same_text(
+          "CREATE TABLE T (Id INT, Price REAL, Name TEXT);"
+          "INSERT INTO T (Id, Price, Name) VALUES (-12, 0.1, \"a b\");"
+          "INSERT INTO T (Price) VALUES "
+          "(340282346638528859811704183484516925440.0);"
+          "SELECT Id Name FROM T WHERE NOT (Id > 1 OR Price <= -2.5) AND "
+          "(Id - (Price - 1)) * 2 / 3 != Name;"
+          "SELECT COUNT(*) SUM(Price) Name FROM T GROUP BY Name "
+          "ORDER BY SUM(Price) DESC LIMIT 18446744073709551615;"
+          "SELECT Name FROM T JOIN U ON Id = UserId ORDER BY Name;"
+          "DELETE FROM T WHERE Id = 1 OR Id = 2 AND Id = 3;"
+          "DELETE FROM T;"
+          "EXPLAIN ANALYZE SELECT Id FROM T LIMIT 0;"
+          "DROP TABLE T;"
+          "BEGIN; ROLLBACK;"));
+
+  rdb::workload::GeneratorOptions options;
+  options.mix_.transaction_ = 5;
+  options.skew_ = 1.1;
+  rdb::workload::Generator generator(options);
+  std::stringstream script;
+  generator.write(script, 2000, 0);
+  EXPECT_EQ(2000U, expect_same_text(script.str()));
+}
+
+TEST(StatementPrinterSuite, AppendsTest) {
+  rdb::sql::Lexer lexer("DROP TABLE A; DROP TABLE B;");
+  rdb::sql::Parser parser(lexer);
+  const rdb::sql::Parser::Result result = parser.parse_sql_script();
+  ASSERT_EQ(2U, result.script_.statements_.size());
+  std::string out = "-- ";
+  for (const auto& statement : result.script_.statements_) {
+    rdb::sql::print_statement(*statement, out);
+  }
+  EXPECT_EQ("-- DROP TABLE A;DROP TABLE B;", out);
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <librdb/sql/Parser.hpp>
+#include <librdb/sql/StaticParser.hpp>
+#include <string>
+#include <string_view>
+
+using namespace rdb::sql::literals;
+
+namespace {
+
+constexpr auto kSelect = "SELECT Col1 Col2 FROM Table WHERE Val <= 5;"_sql;
+static_assert(kSelect.kind_ == rdb::sql::StaticStatement::Kind::Select);
+static_assert(kSelect.table_name_ == "Table");
+static_assert(kSelect.name_count_ == 2 && kSelect.names_[1] == "Col2");
+static_assert(kSelect.has_expression_);
+static_assert(std::get<int>(kSelect.second_operand_.value_) == 5);
+
+constexpr auto kInsert =
+    rdb::sql::parse_static("INSERT INTO T (A, B) VALUES (-12, 4.56);");
+static_assert(kInsert.value_count_ == 2);
+static_assert(std::get<int>(kInsert.values_[0]) == -12);
+static_assert(std::get<float>(kInsert.values_[1]) == 4.56F);
+
+std::string parse_at_runtime(std::string_view input) {
+  rdb::sql::Lexer lexer(input);
+  rdb::sql::Parser parser(lexer);
+  return parser.parse_sql_script().script_.statements_.front()->to_str();
+}
+
+}  // namespace
+
+TEST(StaticParserSuite, MatchesRuntimeParserTest) {
+  constexpr std::string_view inputs[] = {
+      "DROP TABLE Table;",
+      "INSERT INTO Table (Col1, Col2, Col3) VALUES (123, 4.56, \"7B9\");",
+      "SELECT Col1 Col2 Col3 FROM Table WHERE Val <= 5;",
+      "SELECT C1 FROM Table;",
+      "DELETE FROM Table WHERE Val != null;",
+      "DELETE FROM Table WHERE 1.5 > \"x\";",
+      "CREATE TABLE Table (Name1 INT, Name2 REAL, Name3 TEXT);"};
+  for (const auto input : inputs) {
+    EXPECT_EQ(
+        parse_at_runtime(input),
+        rdb::sql::parse_static(input).make()->to_str());
+  }
+}
+
+TEST(StaticParserSuite, ErrorsTest) {
+  EXPECT_THROW(
+      rdb::sql::parse_static("DROP Table;"), rdb::sql::StaticSyntaxError);
+  EXPECT_THROW(
+      rdb::sql::parse_static("DROP TABLE A; DROP TABLE B;"),
+      rdb::sql::StaticSyntaxError);
+  EXPECT_THROW(
+      rdb::sql::parse_static("INSERT INTO T (A) VALUES (2147483648);"),
+      rdb::sql::StaticSyntaxError);
+  EXPECT_THROW(
+      rdb::sql::parse_static("INSERT INTO T (A) VALUES (1.0000000000000001);"),
+      rdb::sql::StaticSyntaxError);
+  EXPECT_THROW(
+      {
+        try {
+          rdb::sql::parse_static("SELECT C1 FROM Table WHERE;");
+        } catch (const rdb::sql::StaticSyntaxError& e) {
+          EXPECT_STREQ("Expected Int, Real, String or Id", e.what());
+          throw;
+        }
+      },
+      rdb::sql::StaticSyntaxError);
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include <librdb/sql/Parser.hpp>
+#include <librdb/sql/TokenBuffer.hpp>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace {
+
+constexpr std::string_view kScript =
+    "\nCREATE TABLE T (A INT, B TEXT);\n"
+    "  INSERT INTO T (A, B) VALUES (-1, \"x y\");\n"
+    "SELECT A B FROM T WHERE A >= 0.5; SELECT FROM;\n"
+    "DELETE FROM T WHERE B != \"x\n"
+    "DROP TABLE $; EXPLAIN ANALYZE SELECT A FROM T;  ";
+
+std::string dump(const rdb::sql::Parser::Result& result) {
+  std::stringstream out;
+  for (const auto& statement : result.script_.statements_) {
+    out << *statement << '\n';
+  }
+  for (const auto& error : result.errors_) {
+    out << error << '\n';
+  }
+  return out.str();
+}
+
+}  // namespace
+
+TEST(TokenBufferSuite, MatchesLexerTest) {
+  const rdb::sql::TokenBuffer tokens(kScript);
+  rdb::sql::Lexer lexer(kScript);
+  std::stringstream expected;
+  std::stringstream actual;
+  for (auto token = lexer.get();; token = lexer.get()) {
+    expected << token << " @" << token.location().offset_ << '\n';
+    if (token.kind() == rdb::sql::Token::Kind::Eof) {
+      break;
+    }
+  }
+  for (size_t i = 0; i < tokens.size(); ++i) {
+    const auto token = tokens.token(i);
+    actual << token << " @" << token.location().offset_ << '\n';
+  }
+  EXPECT_EQ(expected.str(), actual.str());
+}
+
+TEST(TokenBufferSuite, CursorTest) {
+  const rdb::sql::TokenBuffer tokens("DROP TABLE T;");
+  ASSERT_EQ(5U, tokens.size());
+  rdb::sql::TokenCursor cursor(tokens);
+  EXPECT_EQ(rdb::sql::Token::Kind::KwDrop, cursor.kind());
+  EXPECT_EQ("T", cursor.text(2));
+  EXPECT_EQ(rdb::sql::Token::Kind::Eof, cursor.kind(4));
+  EXPECT_EQ(rdb::sql::Token::Kind::Eof, cursor.kind(100));
+  for (int i = 0; i < 10; ++i) {
+    cursor.advance();
+  }
+  EXPECT_EQ(4U, cursor.position());
+  EXPECT_EQ("<EOF>", cursor.text());
+
+  EXPECT_EQ(1U, rdb::sql::TokenBuffer("").size());
+  EXPECT_EQ(1U, rdb::sql::TokenBuffer(" \n\t").size());
+}
+
+TEST(TokenBufferSuite, ParserTest) {
+  rdb::sql::Lexer lexer(kScript);
+  rdb::sql::Parser lexer_parser(lexer);
+  const rdb::sql::TokenBuffer tokens(kScript);
+  rdb::sql::Parser buffer_parser(tokens);
+  const auto expected = dump(lexer_parser.parse_sql_script());
+  EXPECT_EQ(expected, dump(buffer_parser.parse_sql_script()));
+  EXPECT_NE(std::string::npos, expected.find("EXPLAIN ANALYZE"));
+}
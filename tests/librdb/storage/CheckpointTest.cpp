@@ -0,0 +1,246 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <librdb/sql/Parser.hpp>
+#include <librdb/storage/Checkpoint.hpp>
+#include <librdb/storage/TableImage.hpp>
+#include <librdb/sync/Epoch.hpp>
+#include <string>
+#include <string_view>
+
+#include "TestHelpers.hpp"
+
+namespace {
+
+using rdb::test::run_script;
+
+class StorageTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    directory_ = "/tmp/rdb_storage_test_" + std::to_string(getpid());
+    std::filesystem::remove_all(directory_);
+  }
+
+  void TearDown() override { std::filesystem::remove_all(directory_); }
+
+  std::string directory_;
+};
+
+constexpr std::string_view kScript =
+    "CREATE TABLE T (Id INT, Price REAL, Name TEXT);"
+    "CREATE TABLE Empty (Name TEXT);"
+    "INSERT INTO T (Id, Price, Name) VALUES (1, 2.5, \"one\");"
+    "INSERT INTO T (Name, Id) VALUES (\"\", 2);"
+    "INSERT INTO T (Id, Price, Name) VALUES (3, 0.1, \"three\");"
+    "INSERT INTO T (Id, Name) VALUES (4, \"four\");"
+    "DELETE FROM T WHERE Name = \"four\" OR NOT (Id - 1) * 2 < 100;"
+    "CREATE TABLE Dropped (A INT); DROP TABLE Dropped;";
+
+constexpr std::string_view kQueries =
+    "SELECT Id Price Name FROM T; SELECT Name FROM Empty;"
+    "SELECT A FROM Dropped;";
+
+}  // namespace
+
+TEST_F(StorageTest, CheckpointTest) {
+  rdb::exec::Catalog catalog;
+  rdb::exec::Executor executor(catalog);
+  run_script(executor, kScript);
+  const std::string expected = run_script(executor, kQueries);
+  EXPECT_EQ(0U, rdb::storage::load_checkpoint(catalog, directory_));
+  EXPECT_EQ(1U, rdb::storage::write_checkpoint(catalog, directory_));
+
+  rdb::exec::Catalog loaded;
+  EXPECT_EQ(1U, rdb::storage::load_checkpoint(loaded, directory_));
+  const rdb::sync::EpochGuard guard;
+  for (const auto& column : loaded.find("T")->columns()) {
+    EXPECT_TRUE(column.mapped());
+  }
+  rdb::exec::Executor loaded_executor(loaded);
+  EXPECT_EQ(expected, run_script(loaded_executor, kQueries));
+
+  // Writing to a mapped table copies it first.
+  run_script(
+      loaded_executor,
+      "INSERT INTO T (Id, Name) VALUES (5, \"five\");"
+      "DELETE FROM T WHERE Id = 1;");
+  EXPECT_FALSE(loaded.find("T")->columns()[2].mapped());
+  EXPECT_EQ(
+      "2 0.000000  \n3 0.100000 three \n5 0.000000 five \n",
+      run_script(loaded_executor, "SELECT Id Price Name FROM T;"));
+
+  // A new generation replaces the old files while tables stay mapped.
+  EXPECT_EQ(2U, rdb::storage::write_checkpoint(loaded, directory_));
+  EXPECT_EQ(3U, rdb::storage::write_checkpoint(loaded, directory_));
+  std::set<std::string> files;
+  for (const auto& entry : std::filesystem::directory_iterator(directory_)) {
+    files.insert(entry.path().filename().string());
+  }
+  EXPECT_EQ(
+      (std::set<std::string>{"CATALOG", "Empty.3.rdbt", "T.3.rdbt"}), files);
+
+  rdb::exec::Catalog reloaded;
+  EXPECT_EQ(3U, rdb::storage::load_checkpoint(reloaded, directory_));
+  rdb::exec::Executor reloaded_executor(reloaded);
+  EXPECT_EQ(
+      run_script(loaded_executor, kQueries),
+      run_script(reloaded_executor, kQueries));
+  EXPECT_THROW(
+      rdb::storage::load_checkpoint(reloaded, directory_),
+      rdb::storage::StorageError);
+}
+
+TEST_F(StorageTest, DamagedCheckpointTest) {
+  rdb::exec::Catalog catalog;
+  rdb::exec::Executor executor(catalog);
+  run_script(executor, kScript);
+  rdb::storage::write_checkpoint(catalog, directory_);
+  std::filesystem::resize_file(directory_ + "/T.1.rdbt", 100);
+  rdb::exec::Catalog loaded;
+  EXPECT_THROW(
+      rdb::storage::load_checkpoint(loaded, directory_),
+      rdb::storage::StorageError);
+}
+
+TEST_F(StorageTest, DamagedImageTest) {
+  class StringWriter : public rdb::storage::ImageWriter {
+   public:
+    void append(const void* data, size_t size) override {
+      text_.append(static_cast<const char*>(data), size);
+    }
+    std::string text_;
+  };
+  rdb::exec::Table table(
+      "T", {rdb::exec::Column("Id", rdb::exec::Column::Kind::Int)});
+  table.append_row({7});
+  StringWriter writer;
+  rdb::storage::write_table_image(table, writer);
+  // Images are read in place from 64-byte aligned memory.
+  alignas(64) char image[1024];
+  const size_t size = writer.text_.size();
+  ASSERT_LE(size, sizeof(image));
+  std::memcpy(image, writer.text_.data(), size);
+  EXPECT_EQ(
+      1U,
+      rdb::storage::read_table_image(nullptr, image, size, "T")->row_count());
+
+  // 4 * (2^62 + 1) wraps around to the size of the one value.
+  const uint64_t row_count = (uint64_t{1} << 62U) + 1;
+  std::memcpy(image + 16, &row_count, sizeof(row_count));
+  EXPECT_THROW(
+      rdb::storage::read_table_image(nullptr, image, size, "T"),
+      rdb::storage::StorageError);
+}
+
+TEST_F(StorageTest, LogReplayTest) {
+  std::filesystem::create_directories(directory_);
+  const std::string path = rdb::storage::log_path(directory_, 0);
+  rdb::exec::Catalog catalog;
+  std::string expected;
+  {
+    rdb::storage::StatementLog log(path, false);
+    rdb::exec::Executor executor(catalog, nullptr, &log);
+    run_script(executor, kScript);
+    // Failed statements and reads aren't logged.
+    run_script(
+        executor, "INSERT INTO T (Id) VALUES (\"x\"); SELECT Id FROM T;");
+    run_script(executor, "EXPLAIN ANALYZE DELETE FROM T WHERE Price > 2;");
+    expected = run_script(executor, kQueries);
+    EXPECT_EQ(10U, log.flush_count());
+  }
+  {
+    // A record cut short by a crash is ignored.
+    std::ofstream log(path, std::ios::app | std::ios::binary);
+    log.write("\x20\x00\x00\x00\x01\x02", 6);
+  }
+
+  rdb::exec::Catalog replayed;
+  rdb::exec::Executor replay_executor(replayed);
+  EXPECT_EQ(
+      10U,
+      rdb::storage::StatementLog::replay(path, replay_executor).statements_);
+  EXPECT_EQ(expected, run_script(replay_executor, kQueries));
+  EXPECT_EQ(
+      0U,
+      rdb::storage::StatementLog::replay(path + ".missing", replay_executor)
+          .statements_);
+  EXPECT_THROW(
+      rdb::storage::StatementLog::replay(path, replay_executor),
+      rdb::storage::StorageError);
+}
+
+TEST_F(StorageTest, TransactionLogTest) {
+  std::filesystem::create_directories(directory_);
+  const std::string path = rdb::storage::log_path(directory_, 0);
+  rdb::exec::Catalog catalog;
+  std::string expected;
+  {
+    rdb::storage::StatementLog log(path, false);
+    rdb::exec::Executor executor(catalog, nullptr, &log);
+    run_script(executor, "CREATE TABLE T (Id INT);");
+    run_script(
+        executor,
+        "BEGIN; INSERT INTO T (Id) VALUES (1); INSERT INTO T (Id) VALUES (2);"
+        "CREATE TABLE U (Id INT); INSERT INTO U (Id) VALUES (3); COMMIT;");
+    // Rolled back transactions aren't logged.
+    run_script(executor, "BEGIN; INSERT INTO T (Id) VALUES (4); ROLLBACK;");
+    expected = run_script(executor, "SELECT Id FROM T; SELECT Id FROM U;");
+    EXPECT_EQ("1 \n2 \n3 \n", expected);
+    EXPECT_EQ(2U, log.flush_count());
+    run_script(executor, "BEGIN; INSERT INTO T (Id) VALUES (5); COMMIT;");
+  }
+  // A crash lost the COMMIT record, a kind byte after the header.
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 9);
+
+  rdb::exec::Catalog replayed;
+  rdb::exec::Executor replay_executor(replayed);
+  EXPECT_EQ(
+      9U,
+      rdb::storage::StatementLog::replay(path, replay_executor).statements_);
+  EXPECT_EQ(
+      expected,
+      run_script(replay_executor, "SELECT Id FROM T; SELECT Id FROM U;"));
+}
+
+TEST_F(StorageTest, TornTailRecoveryTest) {
+  std::filesystem::create_directories(directory_);
+  const std::string path = rdb::storage::log_path(directory_, 0);
+  const auto recover = [&path](rdb::exec::Catalog& catalog) {
+    rdb::exec::Executor executor(catalog);
+    const auto replayed = rdb::storage::StatementLog::replay(path, executor);
+    std::filesystem::resize_file(path, replayed.end_offset_);
+    return replayed.statements_;
+  };
+  {
+    rdb::exec::Catalog catalog;
+    rdb::storage::StatementLog log(path, false);
+    rdb::exec::Executor executor(catalog, nullptr, &log);
+    run_script(
+        executor, "CREATE TABLE T (Id INT); INSERT INTO T (Id) VALUES (1);");
+    // The COMMIT record never made it.
+    run_script(executor, "BEGIN; INSERT INTO T (Id) VALUES (2); COMMIT;");
+  }
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 9);
+  {
+    // And the crash tore the record after it.
+    std::ofstream log(path, std::ios::app | std::ios::binary);
+    log.write("\x20\x00\x00\x00\x01\x02", 6);
+  }
+
+  {
+    rdb::exec::Catalog catalog;
+    EXPECT_EQ(4U, recover(catalog));
+    rdb::storage::StatementLog log(path, false);
+    rdb::exec::Executor executor(catalog, nullptr, &log);
+    run_script(executor, "INSERT INTO T (Id) VALUES (3);");
+  }
+  // The write acknowledged after the first recovery survives the next.
+  rdb::exec::Catalog catalog;
+  EXPECT_EQ(3U, recover(catalog));
+  rdb::exec::Executor executor(catalog);
+  EXPECT_EQ("1 \n3 \n", run_script(executor, "SELECT Id FROM T;"));
+}
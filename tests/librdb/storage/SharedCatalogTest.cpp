@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <librdb/sql/Parser.hpp>
+#include <librdb/storage/SharedCatalog.hpp>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "TestHelpers.hpp"
+
+namespace {
+
+using rdb::test::run_script;
+
+std::string run_script(
+    rdb::storage::SharedCatalogReader& reader,
+    std::string_view sql) {
+  return run_script(sql, [&reader](const rdb::sql::Statement& statement) {
+    return reader.execute(
+        static_cast<const rdb::sql::SelectStatement&>(statement));
+  });
+}
+
+class SharedCatalogTest : public ::testing::Test {
+ protected:
+  std::string name_ = "/rdb_shared_catalog_test_" + std::to_string(getpid());
+};
+
+constexpr std::string_view kScript =
+    "CREATE TABLE T (Id INT, Price REAL, Name TEXT);"
+    "CREATE TABLE Empty (Name TEXT);"
+    "INSERT INTO T (Id, Price, Name) VALUES (1, 2.5, \"one\");"
+    "INSERT INTO T (Name, Id) VALUES (\"\", 2);"
+    "INSERT INTO T (Id, Price, Name) VALUES (3, 0.1, \"three\");";
+
+constexpr std::string_view kQueries =
+    "SELECT Id Price Name FROM T WHERE Id > 1;"
+    "SELECT COUNT(*) SUM(Price) FROM T; SELECT Name FROM Empty;";
+
+}  // namespace
+
+TEST_F(SharedCatalogTest, PublishTest) {
+  rdb::exec::Catalog catalog;
+  rdb::exec::Executor executor(catalog);
+  rdb::storage::SharedCatalogWriter writer(name_, 1 << 20);
+  rdb::storage::SharedCatalogReader reader(name_);
+  EXPECT_EQ("Unknown table T\n", run_script(reader, "SELECT Id FROM T;"));
+  EXPECT_EQ(0U, reader.version());
+
+  run_script(executor, kScript);
+  EXPECT_EQ(1U, writer.publish(catalog));
+  EXPECT_EQ(run_script(executor, kQueries), run_script(reader, kQueries));
+  EXPECT_EQ(1U, reader.version());
+
+  // The reader moves to new versions as they are published.
+  run_script(executor, "INSERT INTO T (Id, Name) VALUES (4, \"four\");");
+  EXPECT_EQ(2U, writer.publish(catalog));
+  run_script(executor, "DROP TABLE Empty; DELETE FROM T WHERE Id = 1;");
+  EXPECT_EQ(3U, writer.publish(catalog));
+  EXPECT_EQ(run_script(executor, kQueries), run_script(reader, kQueries));
+  EXPECT_EQ(3U, reader.version());
+}
+
+TEST_F(SharedCatalogTest, ReaderProcessTest) {
+  rdb::exec::Catalog catalog;
+  rdb::exec::Executor executor(catalog);
+  rdb::storage::SharedCatalogWriter writer(name_, 1 << 20);
+  run_script(executor, kScript);
+  writer.publish(catalog);
+
+  int pipe_fds[2];
+  ASSERT_EQ(0, ::pipe(pipe_fds));
+  const pid_t child = ::fork();
+  ASSERT_NE(-1, child);
+  if (child == 0) {
+    ::close(pipe_fds[0]);
+    rdb::storage::SharedCatalogReader reader(name_);
+    const std::string out = run_script(reader, kQueries);
+    const bool written =
+        ::write(pipe_fds[1], out.data(), out.size()) ==
+        static_cast<ssize_t>(out.size());
+    ::_exit(written ? 0 : 1);
+  }
+  ::close(pipe_fds[1]);
+  std::string out;
+  char buffer[256];
+  ssize_t size = 0;
+  while ((size = ::read(pipe_fds[0], buffer, sizeof(buffer))) > 0) {
+    out.append(buffer, static_cast<size_t>(size));
+  }
+  ::close(pipe_fds[0]);
+  int status = 0;
+  ASSERT_EQ(child, ::waitpid(child, &status, 0));
+  EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+  EXPECT_EQ(run_script(executor, kQueries), out);
+}
+
+TEST_F(SharedCatalogTest, ConcurrentPublishTest) {
+  rdb::exec::Catalog catalog;
+  rdb::exec::Executor executor(catalog);
+  rdb::storage::SharedCatalogWriter writer(name_, 1 << 20);
+  run_script(executor, "CREATE TABLE T (Id INT, Name TEXT);");
+  writer.publish(catalog);
+
+  // Every version holds rows 1 to n, which a SELECT sees all or none of.
+  constexpr int kVersions = 200;
+  std::thread publisher([&] {
+    for (int id = 1; id < kVersions; ++id) {
+      const std::string insert = "INSERT INTO T (Id, Name) VALUES (" +
+          std::to_string(id) + ", \"" + std::to_string(id) + "\");";
+      run_script(executor, insert);
+      writer.publish(catalog);
+    }
+  });
+  rdb::storage::SharedCatalogReader reader(name_);
+  while (reader.version() < kVersions) {
+    const rdb::sql::TokenBuffer tokens("SELECT COUNT(*) SUM(Id) FROM T;");
+    rdb::sql::Parser parser(tokens);
+    const auto parsed = parser.parse_sql_script();
+    const rdb::exec::Result result =
+        reader.execute(static_cast<const rdb::sql::SelectStatement&>(
+            *parsed.script_.statements_.front()));
+    const auto rows = std::get<int>(result.rows_.at(0).at(0));
+    ASSERT_EQ(static_cast<int>(reader.version()) - 1, rows);
+    if (rows != 0) {
+      ASSERT_EQ(rows * (rows + 1) / 2, std::get<int>(result.rows_[0][1]));
+    }
+  }
+  publisher.join();
+}
+
+TEST_F(SharedCatalogTest, ErrorsTest) {
+  EXPECT_THROW(
+      rdb::storage::SharedCatalogReader reader(name_),
+      rdb::storage::StorageError);
+  rdb::storage::SharedCatalogWriter writer(name_, 256);
+  EXPECT_THROW(
+      rdb::storage::SharedCatalogWriter(name_, 256),
+      rdb::storage::StorageError);
+
+  rdb::exec::Catalog catalog;
+  rdb::exec::Executor executor(catalog);
+  run_script(executor, kScript);
+  EXPECT_THROW(writer.publish(catalog), rdb::storage::StorageError);
+  EXPECT_EQ(0U, writer.version());
+  // A failed publication leaves the last version in place.
+  rdb::storage::SharedCatalogReader reader(name_);
+  EXPECT_EQ("Unknown table T\n", run_script(reader, "SELECT Id FROM T;"));
+}
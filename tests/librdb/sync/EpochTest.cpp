@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <librdb/sync/Epoch.hpp>
+#include <memory>
+#include <optional>
+
+namespace {
+
+// Counts its destructions.
+struct Counted {
+  explicit Counted(int& destroyed) : destroyed_(destroyed) {}
+  ~Counted() { ++destroyed_; }
+
+  Counted(const Counted&) = delete;
+  Counted& operator=(const Counted&) = delete;
+
+  int& destroyed_;
+};
+
+}  // namespace
+
+TEST(EpochSuite, ReclaimTest) {
+  int destroyed = 0;
+  rdb::sync::RetireList<Counted> retired;
+  EXPECT_EQ(UINT64_MAX, rdb::sync::oldest_pinned_epoch());
+
+  std::optional<rdb::sync::EpochGuard> reader;
+  reader.emplace();
+  {
+    // Nested guards keep the epoch of the outermost one.
+    const rdb::sync::EpochGuard nested;
+  }
+  const uint64_t pinned = rdb::sync::oldest_pinned_epoch();
+  EXPECT_NE(UINT64_MAX, pinned);
+
+  retired.retire(std::make_unique<Counted>(destroyed));
+  retired.reclaim();
+  // The reader may still see the object.
+  EXPECT_EQ(0, destroyed);
+  EXPECT_EQ(1, retired.size());
+
+  reader.reset();
+  // A reader pinned after the retirement can't see it.
+  const rdb::sync::EpochGuard later_reader;
+  EXPECT_LT(pinned, rdb::sync::oldest_pinned_epoch());
+  retired.reclaim();
+  EXPECT_EQ(1, destroyed);
+  EXPECT_EQ(0, retired.size());
+}
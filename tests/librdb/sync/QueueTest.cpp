@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <librdb/sync/MpscQueue.hpp>
+#include <librdb/sync/SpscQueue.hpp>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+TEST(QueueSuite, SpscTest) {
+  rdb::sync::SpscQueue<std::unique_ptr<int>> queue(3);
+  EXPECT_EQ(4U, queue.capacity());
+  EXPECT_TRUE(queue.empty());
+  EXPECT_FALSE(queue.try_pop());
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(queue.try_push(std::make_unique<int>(i)));
+  }
+  auto rejected = std::make_unique<int>(4);
+  EXPECT_FALSE(queue.try_push(std::move(rejected)));
+  // A rejected value is left alone.
+  ASSERT_NE(nullptr, rejected);
+  EXPECT_EQ(0, **queue.try_pop());
+  EXPECT_TRUE(queue.try_push(std::move(rejected)));
+  for (int i = 1; i < 5; ++i) {
+    EXPECT_EQ(i, **queue.try_pop());
+  }
+  EXPECT_TRUE(queue.empty());
+
+  // Values cross threads in order.
+  constexpr int kValues = 100'000;
+  rdb::sync::SpscQueue<int> ints(64);
+  std::thread producer([&] {
+    for (int i = 0; i < kValues; ++i) {
+      while (!ints.try_push(int{i})) {
+        std::this_thread::yield();
+      }
+    }
+  });
+  int expected = 0;
+  while (expected < kValues) {
+    if (const auto value = ints.try_pop()) {
+      ASSERT_EQ(expected, *value);
+      ++expected;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+}
+
+TEST(QueueSuite, MpscTest) {
+  constexpr int kProducers = 4;
+  constexpr int kValues = 20'000;
+  rdb::sync::MpscQueue<std::pair<int, int>> queue;
+  EXPECT_FALSE(queue.try_pop());
+  std::vector<std::thread> producers;
+  for (int producer = 0; producer < kProducers; ++producer) {
+    producers.emplace_back([&queue, producer] {
+      for (int i = 0; i < kValues; ++i) {
+        queue.push({producer, i});
+      }
+    });
+  }
+  // Every producer's values arrive in the order it pushed them.
+  std::vector<int> next(kProducers, 0);
+  int popped = 0;
+  while (popped < kProducers * kValues) {
+    if (const auto value = queue.try_pop()) {
+      ASSERT_EQ(next[value->first], value->second);
+      ++next[value->first];
+      ++popped;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  EXPECT_FALSE(queue.try_pop());
+
+  // Values left in the queue are freed with it.
+  rdb::sync::MpscQueue<std::unique_ptr<int>> owning;
+  owning.push(std::make_unique<int>(1));
+  owning.push(std::make_unique<int>(2));
+  EXPECT_EQ(1, **owning.try_pop());
+}
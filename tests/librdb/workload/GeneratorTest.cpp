@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include <librdb/exec/Executor.hpp>
+#include <librdb/sql/Parser.hpp>
+#include <librdb/workload/Generator.hpp>
+#include <set>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace {
+
+std::string generate(
+    const rdb::workload::GeneratorOptions& options,
+    size_t statements) {
+  rdb::workload::Generator generator(options);
+  std::stringstream out;
+  generator.write(out, statements, 0);
+  return out.str();
+}
+
+}  // namespace
+
+TEST(GeneratorSuite, DeterministicTest) {
+  rdb::workload::GeneratorOptions options;
+  options.seed_ = 42;
+  const std::string script = generate(options, 500);
+  EXPECT_EQ(script, generate(options, 500));
+  options.seed_ = 43;
+  EXPECT_NE(script, generate(options, 500));
+
+  rdb::workload::Generator generator(options);
+  std::stringstream out;
+  EXPECT_EQ(1U, generator.write(out, 0, 1));
+  EXPECT_EQ(5U, generator.write(out, 5, 1U << 20U));
+  EXPECT_GT(generator.write(out, 0, 4096), 5U);
+}
+
+TEST(GeneratorSuite, ExecutesCleanlyTest) {
+  rdb::workload::GeneratorOptions options;
+  options.mix_ = {5, 5, 40, 20, 10, 10, 5, 2};
+  options.skew_ = 1.2;
+  options.long_string_rate_ = 0.01;
+  options.long_string_length_ = 300;
+  const std::string script = generate(options, 2000);
+
+  rdb::sql::Lexer lexer(script);
+  rdb::sql::Parser parser(lexer);
+  const auto result = parser.parse_sql_script();
+  EXPECT_TRUE(result.errors_.empty());
+  ASSERT_EQ(2000U, result.script_.statements_.size());
+
+  rdb::exec::Catalog catalog;
+  rdb::exec::Executor executor(catalog);
+  std::set<rdb::sql::Statement::Kind> kinds;
+  for (const auto& statement : result.script_.statements_) {
+    kinds.insert(statement->kind());
+    EXPECT_NO_THROW(executor.execute(*statement)) << *statement;
+  }
+  EXPECT_EQ(rdb::sql::Statement::kKindCount, kinds.size());
+}
+
+// Every production of the grammar appears in a few thousand statements.
+TEST(GeneratorSuite, GrammarCoverageTest) {
+  const std::string script = generate({}, 5000);
+  for (const std::string_view production :
+       {" AND ", " OR ", "NOT ", " + ", " - ", " * ", " / ", "COUNT(*)",
+        "COUNT(C", "SUM(C", "MIN(C", "MAX(C", "AVG(C", " GROUP BY ",
+        " JOIN ", " ORDER BY ", " ASC", " DESC", " LIMIT "}) {
+    EXPECT_NE(std::string::npos, script.find(production)) << production;
+  }
+}
+
+TEST(GeneratorSuite, ErrorRateTest) {
+  rdb::workload::GeneratorOptions options;
+  options.error_rate_ = 0.1;
+  const std::string script = generate(options, 5000);
+
+  rdb::sql::Lexer lexer(script);
+  rdb::sql::Parser parser(lexer);
+  const auto result = parser.parse_sql_script();
+  EXPECT_EQ(5000U, result.script_.statements_.size() + result.errors_.size());
+  EXPECT_NEAR(500.0, double(result.errors_.size()), 100.0);
+}